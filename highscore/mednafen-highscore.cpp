@@ -1,5 +1,6 @@
 #include <mednafen/mednafen.h>
 #include <mednafen/state-driver.h>
+#include <mednafen/MemoryStream.h>
 
 #include "mednafen-highscore.h"
 
@@ -20,6 +21,12 @@ struct _MednafenCore
   uint32_t *input_buffer[13];
   int16_t *sound_buffer;
 
+  guint run_ahead;
+  gboolean rewind_enabled;
+  gboolean rewinding;
+
+  Mednafen::MemoryStream *state_buffer;
+
   char *rom_path;
   GFile *m3u_file;
   char *pce_cd_bios_path;
@@ -33,6 +40,13 @@ struct _MednafenCore
   int ss_reset_counter;
 };
 
+static const Mednafen::MDFNSetting highscore_settings[] = {
+  { "highscore.rewind", Mednafen::MDFNSF_NOFLAGS, "Enable state rewinding.",
+    "See the \"srwbudget\", \"srwinterval\" and \"srwcompressor\" settings to tune it.",
+    Mednafen::MDFNST_BOOL, "0" },
+  { NULL },
+};
+
 static void mednafen_atari_lynx_core_init (HsAtariLynxCoreInterface *iface);
 static void mednafen_neo_geo_pocket_core_init (HsNeoGeoPocketCoreInterface *iface);
 static void mednafen_pc_engine_core_init (HsPcEngineCoreInterface *iface);
@@ -325,12 +339,25 @@ mednafen_core_load_rom (HsCore      *core,
     return FALSE;
   }
 
+  Mednafen::MDFNI_MergeSettings (highscore_settings);
+
   g_autofree char *cache_dir = hs_core_get_cache_path (core);
   if (!Mednafen::MDFNI_InitFinalize (cache_dir)) {
     g_set_error (error, HS_CORE_ERROR, HS_CORE_ERROR_INTERNAL, "Failed to finish initializing Mednafen");
     return FALSE;
   }
 
+  // Zstandard is much cheaper than gzip for the large PlayStation and Saturn states
+  Mednafen::MDFNI_SetSetting ("filesys.state_comp_type", "zstd");
+
+  // Keep rewinding cheap with the large PlayStation and Saturn states
+  if (base_platform == HS_PLATFORM_PLAYSTATION || base_platform == HS_PLATFORM_SEGA_SATURN)
+    Mednafen::MDFNI_SetSetting ("srwinterval", "4");
+
+  // Allow overriding settings, e.g. to get the old gzip'd states back
+  g_autofree char *settings_path = g_build_filename (cache_dir, "mednafen.cfg", NULL);
+  Mednafen::MDFNI_LoadSettings (settings_path, true);
+
   Mednafen::MDFNI_SetSetting ("filesys.path_sav", "");
 
   if (!set_save_path (self, save_path, error))
@@ -484,8 +511,18 @@ mednafen_core_load_rom (HsCore      *core,
 
   setup_controllers (self);
 
+  // Set with "runahead" in the mednafen.cfg override file
+  self->run_ahead = Mednafen::MDFN_GetSettingUI ("runahead");
+  if (self->run_ahead > 0 && !self->game->SkipHonored) {
+    hs_core_log (core, HS_LOG_MESSAGE,
+                 "%s doesn't skip rendering, running %u frames ahead will be expensive",
+                 self->game->fullname, self->run_ahead);
+  }
+
   self->rom_path = g_strdup (rom_path);
 
+  self->rewind_enabled = Mednafen::MDFNI_EnableStateRewind (Mednafen::MDFN_GetSettingB ("highscore.rewind"));
+
   if (platform == HS_PLATFORM_PC_ENGINE_CD ||
       platform == HS_PLATFORM_PLAYSTATION ||
       platform == HS_PLATFORM_SEGA_SATURN) {
@@ -706,8 +743,9 @@ mednafen_core_run_frame (HsCore *core)
   spec.SoundBufMaxSize = SOUND_BUFFER_SIZE;
   spec.SoundVolume = 1.0;
   spec.soundmultiplier = 1.0;
+  spec.NeedRewind = self->rewinding;
 
-  Mednafen::MDFNI_Emulate (&spec);
+  Mednafen::MDFNI_EmulateRunAhead (&spec, self->run_ahead);
 
   int width = 0;
   if (self->game->multires)
@@ -749,6 +787,7 @@ mednafen_core_stop (HsCore *core)
 {
   MednafenCore *self = MEDNAFEN_CORE (core);
 
+  Mednafen::MDFNI_FlushStateSaves ();
   Mednafen::MDFNI_CloseGame ();
   Mednafen::MDFNI_Kill ();
 
@@ -811,8 +850,21 @@ mednafen_core_load_state (HsCore          *core,
                           const char      *path,
                           HsStateCallback  callback)
 {
-  if (!Mednafen::MDFNI_LoadState (path, "")) {
-    GError *error = NULL;
+  MednafenCore *self = MEDNAFEN_CORE (core);
+  GError *error = NULL;
+
+  // The state may still be in the process of being written
+  Mednafen::MDFNI_FlushStateSaves ();
+
+  g_autoptr (GMappedFile) file = g_mapped_file_new (path, FALSE, &error);
+  if (!file) {
+    callback (core, &error);
+    return;
+  }
+
+  if (!Mednafen::MDFNI_LoadStateMem (g_mapped_file_get_contents (file),
+                                     g_mapped_file_get_length (file),
+                                     self->state_buffer)) {
     g_set_error (&error, HS_CORE_ERROR, HS_CORE_ERROR_INTERNAL, "Failed to load state");
     callback (core, &error);
     return;
@@ -821,19 +873,63 @@ mednafen_core_load_state (HsCore          *core,
   callback (core, NULL);
 }
 
+typedef struct {
+  MednafenCore *self;
+  HsStateCallback callback;
+  char *error;
+} SaveStateData;
+
+static void
+save_state_done_cb (SaveStateData *data)
+{
+  GError *error = NULL;
+
+  if (data->error) {
+    g_set_error (&error, HS_CORE_ERROR, HS_CORE_ERROR_INTERNAL, "Failed to save state: %s", data->error);
+    data->callback (HS_CORE (data->self), &error);
+  } else {
+    data->callback (HS_CORE (data->self), NULL);
+  }
+
+  g_object_unref (data->self);
+  g_free (data->error);
+  g_free (data);
+}
+
+// Called on the state saving thread
+static void
+save_state_finished (void *cb_data, const char *error)
+{
+  SaveStateData *data = (SaveStateData *) cb_data;
+
+  data->error = g_strdup (error);
+
+  g_idle_add_once ((GSourceOnceFunc) save_state_done_cb, data);
+}
+
 static void
 mednafen_core_save_state (HsCore          *core,
                           const char      *path,
                           HsStateCallback  callback)
 {
-  if (!Mednafen::MDFNI_SaveState (path, "", NULL, NULL, NULL)) {
+  MednafenCore *self = MEDNAFEN_CORE (core);
+  unsigned comp = Mednafen::MDFN_GetSettingUI ("filesys.state_comp_type");
+  SaveStateData *data = g_new0 (SaveStateData, 1);
+
+  data->self = MEDNAFEN_CORE (g_object_ref (self));
+  data->callback = callback;
+
+  // Only the serialization happens here, compression and writing are done on a separate thread
+  if (!Mednafen::MDFNI_SaveStateAsync (path, comp, save_state_finished, data)) {
     GError *error = NULL;
+
     g_set_error (&error, HS_CORE_ERROR, HS_CORE_ERROR_INTERNAL, "Failed to save state");
     callback (core, &error);
+
+    g_object_unref (data->self);
+    g_free (data);
     return;
   }
-
-  callback (core, NULL);
 }
 
 static double
@@ -921,6 +1017,8 @@ mednafen_core_finalize (GObject *object)
 
   g_free (self->sound_buffer);
 
+  delete self->state_buffer;
+
   g_free (self->lynx_bios_path);
   g_free (self->pce_cd_bios_path);
 
@@ -976,6 +1074,8 @@ mednafen_core_init (MednafenCore *self)
     self->input_buffer[i] = g_new0 (uint32_t, 9);
 
   self->sound_buffer = g_new0 (int16_t, SOUND_BUFFER_SIZE);
+
+  self->state_buffer = new Mednafen::MemoryStream ();
 }
 
 static void
@@ -1054,6 +1154,53 @@ mednafen_wonderswan_core_init (HsWonderSwanCoreInterface *iface)
 {
 }
 
+void
+mednafen_core_set_rewinding (MednafenCore *self,
+                             gboolean      rewinding)
+{
+  g_return_if_fail (MEDNAFEN_IS_CORE (self));
+
+  self->rewinding = !!rewinding;
+}
+
+gboolean
+mednafen_core_get_rewind_enabled (MednafenCore *self)
+{
+  g_return_val_if_fail (MEDNAFEN_IS_CORE (self), FALSE);
+
+  return self->rewind_enabled;
+}
+
+void
+mednafen_core_set_rewind_enabled (MednafenCore *self,
+                                  gboolean      enabled)
+{
+  g_return_if_fail (MEDNAFEN_IS_CORE (self));
+
+  self->rewind_enabled = Mednafen::MDFNI_EnableStateRewind (enabled);
+
+  if (!self->rewind_enabled)
+    self->rewinding = FALSE;
+}
+
+void
+mednafen_core_set_rewind_budget (MednafenCore *self,
+                                 guint         budget_mib,
+                                 guint         interval)
+{
+  g_return_if_fail (MEDNAFEN_IS_CORE (self));
+
+  if (!Mednafen::MDFNI_SetSettingUI ("srwbudget", budget_mib) ||
+      !Mednafen::MDFNI_SetSettingUI ("srwinterval", interval))
+    return;
+
+  // The budget and interval are only read when rewinding starts, so restart it
+  if (self->rewind_enabled) {
+    Mednafen::MDFNI_EnableStateRewind (FALSE);
+    mednafen_core_set_rewind_enabled (self, TRUE);
+  }
+}
+
 GType
 hs_get_core_type (void)
 {
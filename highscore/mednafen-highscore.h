@@ -10,4 +10,13 @@ G_DECLARE_FINAL_TYPE (MednafenCore, mednafen_core, MEDNAFEN, CORE, HsCore)
 
 G_MODULE_EXPORT GType hs_get_core_type (void);
 
+G_MODULE_EXPORT void     mednafen_core_set_rewind_enabled (MednafenCore *self,
+                                                           gboolean      enabled);
+G_MODULE_EXPORT gboolean mednafen_core_get_rewind_enabled (MednafenCore *self);
+G_MODULE_EXPORT void     mednafen_core_set_rewinding      (MednafenCore *self,
+                                                           gboolean      rewinding);
+G_MODULE_EXPORT void     mednafen_core_set_rewind_budget  (MednafenCore *self,
+                                                           guint         budget_mib,
+                                                           guint         interval);
+
 G_END_DECLS
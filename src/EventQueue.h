@@ -0,0 +1,235 @@
+/******************************************************************************/
+/* Mednafen - Multi-system Emulator                                           */
+/******************************************************************************/
+/* EventQueue.h:
+**  Copyright (C) 2025 Mednafen Team
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public License
+** as published by the Free Software Foundation; either version 2
+** of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software Foundation, Inc.,
+** 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef __MDFN_EVENTQUEUE_H
+#define __MDFN_EVENTQUEUE_H
+
+namespace Mednafen
+{
+
+//
+// Fixed-capacity binary min-heap of int32 event timestamps, for emulation module event systems.  Events are identified
+// by an index in the range [0, count).
+//
+// Ties are broken the same way as the sorted doubly-linked event lists this replaces, so events fire in exactly the same
+// order: an event moved earlier goes after any events already at the new time, an event moved later goes before them,
+// and an event whose time doesn't change keeps its place.  This is done with a sequence number in the low 32 bits of
+// each 64-bit key, drawn from a counter that counts up for the former and down for the latter, so the heap only ever
+// compares single integers.  The sequence numbers are renumbered, preserving order, in the unlikely event that a
+// counter is about to wrap.
+//
+template<unsigned count>
+class EventQueue
+{
+ static_assert(count >= 1 && count <= 256, "Unsupported event count.");
+
+ public:
+
+ // All events at time "t", in index order.
+ void Reset(const int32 t)
+ {
+  SeqLo = 0x80000000U;
+  SeqHi = SeqLo + count - 1;
+
+  for(unsigned i = 0; i < count; i++)
+  {
+   Key[i] = MakeKey(t, SeqLo + i);
+   Which[i] = i;
+   Pos[i] = i;
+  }
+ }
+
+ INLINE unsigned Top(void) const
+ {
+  return Which[0];
+ }
+
+ INLINE int32 TopTime(void) const
+ {
+  return KeyTime(Key[0]);
+ }
+
+ INLINE int32 GetTime(const unsigned which) const
+ {
+  return KeyTime(Key[Pos[which]]);
+ }
+
+ INLINE void Set(const unsigned which, const int32 t)
+ {
+  if(MDFN_UNLIKELY(SeqLo == 0 || SeqHi == 0xFFFFFFFFU))
+   Renumber();
+  //
+  const unsigned pos = Pos[which];
+  const int32 old_t = KeyTime(Key[pos]);
+
+  if(t < old_t)
+  {
+   Key[pos] = MakeKey(t, ++SeqHi);
+   SiftUp(pos);
+  }
+  else if(t > old_t)
+  {
+   Key[pos] = MakeKey(t, --SeqLo);
+   SiftDown(pos);
+  }
+ }
+
+ //
+ // Subtracts "delta" from the time of every event not at "fixed_t"; "fixed_t" must be greater than any other
+ // event time both before and after, so the order of events is unaffected.
+ //
+ void Rebase(const int32 delta, const int32 fixed_t)
+ {
+  for(unsigned i = 0; i < count; i++)
+  {
+   const int32 t = KeyTime(Key[i]);
+
+   if(t != fixed_t)
+    Key[i] = MakeKey(t - delta, (uint32)Key[i]);
+  }
+ }
+
+ //
+ // Event indices in firing order, for save states.
+ //
+ void GetOrder(uint8* order) const
+ {
+  for(unsigned i = 0; i < count; i++)
+   order[i] = Which[i];
+
+  std::sort(order, order + count, [this](const uint8 a, const uint8 b) { return Key[Pos[a]] < Key[Pos[b]]; });
+ }
+
+ //
+ // Rebuilds the queue from event indices in firing order and per-event times.  Returns false, leaving the queue
+ // unchanged, if "order" isn't a permutation or the times aren't in order.
+ //
+ bool SetOrder(const uint8* order, const int32* times)
+ {
+  bool used[count] = { false };
+
+  for(unsigned i = 0; i < count; i++)
+  {
+   const unsigned which = order[i];
+
+   if(which >= count || used[which])
+    return false;
+
+   used[which] = true;
+
+   if(i && times[which] < times[order[i - 1]])
+    return false;
+  }
+  //
+  // A sorted array is a valid heap.
+  //
+  Reset(0);
+
+  for(unsigned i = 0; i < count; i++)
+   Place(i, MakeKey(times[order[i]], SeqLo + i), order[i]);
+
+  return true;
+ }
+
+ private:
+
+ static INLINE uint64 MakeKey(const int32 t, const uint32 seq)
+ {
+  return ((uint64)((uint32)t ^ 0x80000000U) << 32) | seq;
+ }
+
+ static INLINE int32 KeyTime(const uint64 key)
+ {
+  return (int32)((uint32)(key >> 32) ^ 0x80000000U);
+ }
+
+ INLINE void Place(const unsigned pos, const uint64 key, const unsigned which)
+ {
+  Key[pos] = key;
+  Which[pos] = which;
+  Pos[which] = pos;
+ }
+
+ INLINE void SiftUp(unsigned pos)
+ {
+  const uint64 key = Key[pos];
+  const unsigned which = Which[pos];
+
+  while(pos)
+  {
+   const unsigned parent = (pos - 1) >> 1;
+
+   if(Key[parent] <= key)
+    break;
+
+   Place(pos, Key[parent], Which[parent]);
+   pos = parent;
+  }
+
+  Place(pos, key, which);
+ }
+
+ INLINE void SiftDown(unsigned pos)
+ {
+  const uint64 key = Key[pos];
+  const unsigned which = Which[pos];
+
+  for(;;)
+  {
+   unsigned child = (pos << 1) + 1;
+
+   if(child >= count)
+    break;
+
+   if((child + 1) < count && Key[child + 1] < Key[child])
+    child++;
+
+   if(key <= Key[child])
+    break;
+
+   Place(pos, Key[child], Which[child]);
+   pos = child;
+  }
+
+  Place(pos, key, which);
+ }
+
+ MDFN_COLD void Renumber(void)
+ {
+  uint8 order[count];
+  int32 times[count];
+
+  GetOrder(order);
+
+  for(unsigned i = 0; i < count; i++)
+   times[i] = GetTime(i);
+
+  SetOrder(order, times);
+ }
+
+ uint64 Key[count];	// Heap order
+ uint8 Which[count];	// Heap order
+ uint8 Pos[count];	// Event order
+ uint32 SeqLo, SeqHi;
+};
+
+}
+#endif
@@ -231,7 +231,7 @@ uint8 *FileStream::map(void) noexcept
   else
   {
    prot |= PROT_WRITE;
-   prot |= MAP_SHARED;
+   flags |= MAP_SHARED;
   }
 
   if(length > SIZE_MAX)
@@ -245,7 +245,8 @@ uint8 *FileStream::map(void) noexcept
 
    #ifdef HAVE_MADVISE
    // Should probably make this controllable via flag or somesuch.
-   madvise(mapping, mapping_size, MADV_SEQUENTIAL | MADV_WILLNEED);
+   // (Not MADV_WILLNEED, which would read in the whole file up front; the advice values aren't flags that can be ORed together)
+   madvise(mapping, mapping_size, MADV_SEQUENTIAL);
    #endif
   }
 #endif
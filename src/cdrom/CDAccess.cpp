@@ -23,6 +23,7 @@
 #include "CDAccess.h"
 #include "CDAccess_Image.h"
 #include "CDAccess_CCD.h"
+#include "CDAccess_CHD.h"
 
 namespace Mednafen
 {
@@ -39,12 +40,19 @@ CDAccess::~CDAccess()
 
 }
 
+void CDAccess::Prefetch(int32 lba)
+{
+
+}
+
 CDAccess* CDAccess_Open(VirtualFS* vfs, const std::string& path, bool image_memcache)
 {
  CDAccess *ret = NULL;
 
  if(vfs->test_ext(path, ".ccd"))
   ret = new CDAccess_CCD(vfs, path, image_memcache);
+ else if(vfs->test_ext(path, ".chd"))
+  ret = new CDAccess_CHD(vfs, path, image_memcache);
  else
   ret = new CDAccess_Image(vfs, path, image_memcache);
 
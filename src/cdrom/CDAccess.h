@@ -44,6 +44,12 @@ class CDAccess
 
  virtual void Read_TOC(CDUtility::TOC *toc) = 0;
 
+ // Hint that sectors starting at 'lba' will likely be read soon; called from the same thread as Read_Raw_Sector() when it
+ // would otherwise be idle.  Backends that decode in large blocks(e.g. CHD) can use it to decode ahead of time.
+ //
+ // May throw exceptions, which the caller should ignore.
+ virtual void Prefetch(int32 lba);
+
  private:
  CDAccess(const CDAccess&);	// No copy constructor.
  CDAccess& operator=(const CDAccess&); // No assignment operator.
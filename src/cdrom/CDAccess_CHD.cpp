@@ -0,0 +1,475 @@
+/******************************************************************************/
+/* Mednafen - Multi-system Emulator                                           */
+/******************************************************************************/
+/* CDAccess_CHD.cpp:
+**  Copyright (C) 2025 Mednafen Team
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public License
+** as published by the Free Software Foundation; either version 2
+** of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software Foundation, Inc.,
+** 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+/*
+ Track layout follows what chdman writes: each track's frames(including any pregap frames stored in the image, "PGTYPE:V...")
+ are padded out to a multiple of 4 frames, and pregaps not stored in the image are synthesized, as with CUE sheets.
+
+ Audio samples are stored big-endian.
+*/
+
+#include <mednafen/mednafen.h>
+#include <mednafen/MemoryStream.h>
+
+#include "CDAccess.h"
+#include "CDAccess_Image.h"
+#include "CDAccess_CHD.h"
+#include "CHDFile.h"
+
+#include <trio/trio.h>
+
+namespace Mednafen
+{
+
+using namespace CDUtility;
+
+enum
+{
+ CHD_FORMAT_AUDIO = 0,
+ CHD_FORMAT_MODE1,
+ CHD_FORMAT_MODE1_RAW,
+ CHD_FORMAT_MODE2,
+ CHD_FORMAT_MODE2_FORM1,
+ CHD_FORMAT_MODE2_FORM2,
+ CHD_FORMAT_MODE2_FORM_MIX,
+ CHD_FORMAT_MODE2_RAW
+};
+
+static const struct
+{
+ const char* name;
+ uint8 format;
+} CHDTrackTypes[] =
+{
+ { "AUDIO", CHD_FORMAT_AUDIO },
+ { "MODE1", CHD_FORMAT_MODE1 },
+ { "MODE1/2048", CHD_FORMAT_MODE1 },
+ { "MODE1_RAW", CHD_FORMAT_MODE1_RAW },
+ { "MODE1/2352", CHD_FORMAT_MODE1_RAW },
+ { "MODE2", CHD_FORMAT_MODE2 },
+ { "MODE2/2336", CHD_FORMAT_MODE2 },
+ { "MODE2_FORM1", CHD_FORMAT_MODE2_FORM1 },
+ { "MODE2/2048", CHD_FORMAT_MODE2_FORM1 },
+ { "MODE2_FORM2", CHD_FORMAT_MODE2_FORM2 },
+ { "MODE2/2324", CHD_FORMAT_MODE2_FORM2 },
+ { "MODE2_FORM_MIX", CHD_FORMAT_MODE2_FORM_MIX },
+ { "MODE2_RAW", CHD_FORMAT_MODE2_RAW },
+ { "MODE2/2352", CHD_FORMAT_MODE2_RAW },
+ { "CDI/2352", CHD_FORMAT_MODE2_RAW },
+};
+
+CDAccess_CHD::CDAccess_CHD(VirtualFS* vfs, const std::string& path, bool image_memcache) : NumTracks(0), FirstTrack(0), total_sectors(0), disc_type(DISC_TYPE_CDDA_OR_M1)
+{
+ memset(Tracks, 0, sizeof(Tracks));
+
+ {
+  std::unique_ptr<Stream> fp;
+
+  if(image_memcache)
+   fp.reset(new MemoryStream(vfs->open(path, VirtualFS::MODE_READ)));
+  else
+  {
+   fp.reset(vfs->open(path, VirtualFS::MODE_READ));
+   fp->require_fast_seekable();
+  }
+
+  chd.reset(new CHDFile(fp.release()));
+ }
+
+ if(chd->GetUnitBytes() != 2352 + 96 || (chd->GetHunkBytes() % (2352 + 96)))
+  throw MDFN_Error(0, _("CHD file is not a CD image."));
+
+ frames_per_hunk = chd->GetHunkBytes() / (2352 + 96);
+
+ LoadTracks();
+
+ //
+ // Load SBI file, if present
+ //
+ {
+  std::string base_dir, file_base, file_ext;
+  char sbi_ext[4] = { 's', 'b', 'i', 0 };
+
+  vfs->get_file_path_components(path, &base_dir, &file_base, &file_ext);
+
+  if(file_ext.length() == 4 && file_ext[0] == '.')
+  {
+   for(unsigned i = 0; i < 3; i++)
+   {
+    if(file_ext[1 + i] >= 'A' && file_ext[1 + i] <= 'Z')
+     sbi_ext[i] += 'A' - 'a';
+   }
+  }
+
+  CDAccess_LoadSBI(vfs, vfs->eval_fip(base_dir, file_base + "." + sbi_ext, true), &SubQReplaceMap);
+ }
+}
+
+CDAccess_CHD::~CDAccess_CHD()
+{
+
+}
+
+void CDAccess_CHD::LoadTracks(void)
+{
+ std::vector<uint8> md;
+
+ if(chd->GetMetadata(CHD_MAKE_TAG('C','H','G','D'), 0, &md))
+  throw MDFN_Error(0, _("GD-ROM CHD images are not supported."));
+
+ int32 RunningLBA = -150;
+ uint64 chd_frame = 0;
+
+ FirstTrack = 1;
+
+ for(int32 i = 0; i < 99; i++)
+ {
+  char type[32], subtype[32], pgtype[32], pgsub[32];
+  int tnum = 0, frames = 0, pregap = 0, postgap = 0;
+
+  pgtype[0] = 0;
+
+  if(chd->GetMetadata(CHD_MAKE_TAG('C','H','T','2'), i, &md))
+  {
+   md.push_back(0);
+
+   if(trio_sscanf((const char*)md.data(), "TRACK:%d TYPE:%31s SUBTYPE:%31s FRAMES:%d PREGAP:%d PGTYPE:%31s PGSUB:%31s POSTGAP:%d", &tnum, type, subtype, &frames, &pregap, pgtype, pgsub, &postgap) != 8)
+    throw MDFN_Error(0, _("Malformed CHD track metadata: %s"), (const char*)md.data());
+  }
+  else if(chd->GetMetadata(CHD_MAKE_TAG('C','H','T','R'), i, &md))
+  {
+   md.push_back(0);
+
+   if(trio_sscanf((const char*)md.data(), "TRACK:%d TYPE:%31s SUBTYPE:%31s FRAMES:%d", &tnum, type, subtype, &frames) != 4)
+    throw MDFN_Error(0, _("Malformed CHD track metadata: %s"), (const char*)md.data());
+  }
+  else
+   break;
+
+  if(tnum != (FirstTrack + i))
+   throw MDFN_Error(0, _("CHD track metadata is out of order; expected track %d, got track %d."), FirstTrack + i, tnum);
+
+  TrackInfo* t = &Tracks[tnum];
+  bool type_found = false;
+
+  for(auto const& tt : CHDTrackTypes)
+  {
+   if(!strcmp(type, tt.name))
+   {
+    t->format = tt.format;
+    type_found = true;
+    break;
+   }
+  }
+
+  if(!type_found)
+   throw MDFN_Error(0, _("Unsupported CHD track type \"%s\" for track %d."), type, tnum);
+
+  if(frames < 0 || pregap < 0 || postgap < 0)
+   throw MDFN_Error(0, _("Malformed CHD track metadata: %s"), (const char*)md.data());
+
+  if(pgtype[0] == 'V')
+   t->pregap_dv = pregap;
+  else
+   t->pregap = pregap;
+
+  if(t->pregap_dv > frames)
+   throw MDFN_Error(0, _("Malformed CHD track metadata: %s"), (const char*)md.data());
+
+  if(tnum == FirstTrack)
+   t->pregap += 150;
+
+  t->sectors = frames - t->pregap_dv;
+  t->postgap = postgap;
+  t->subq_control = (t->format == CHD_FORMAT_AUDIO) ? 0 : SUBQ_CTRLF_DATA;
+  t->has_subchannel = strcmp(subtype, "NONE") != 0;
+  t->chd_frame = chd_frame;
+
+  RunningLBA += t->pregap;
+  RunningLBA += t->pregap_dv;
+  t->LBA = RunningLBA;
+  RunningLBA += t->sectors;
+  RunningLBA += t->postgap;
+
+  // chdman pads each track to a multiple of 4 frames.
+  chd_frame += ((uint32)frames + 3) &~ 3U;
+
+  if(t->format >= CHD_FORMAT_MODE2)
+   disc_type = DISC_TYPE_CD_XA;
+
+  NumTracks++;
+ }
+
+ if(!NumTracks)
+  throw MDFN_Error(0, _("CHD file does not contain CD track metadata."));
+
+ if(chd_frame > ((uint64)chd->GetHunkCount() * frames_per_hunk + 3))
+  throw MDFN_Error(0, _("CHD file is truncated."));
+
+ total_sectors = RunningLBA;
+ //
+ //
+ toc.Clear();
+ toc.first_track = FirstTrack;
+ toc.last_track = FirstTrack + NumTracks - 1;
+ toc.disc_type = disc_type;
+
+ for(int32 i = FirstTrack; i < FirstTrack + NumTracks; i++)
+ {
+  toc.tracks[i].lba = Tracks[i].LBA;
+  toc.tracks[i].adr = ADR_CURPOS;
+  toc.tracks[i].control = Tracks[i].subq_control;
+  toc.tracks[i].valid = true;
+ }
+
+ toc.tracks[100].lba = total_sectors;
+ toc.tracks[100].adr = ADR_CURPOS;
+ toc.tracks[100].control = Tracks[FirstTrack + NumTracks - 1].subq_control;
+ toc.tracks[100].valid = true;
+}
+
+const uint8* CDAccess_CHD::GetFrame(const TrackInfo* ct, int32 lba)
+{
+ const uint32 frame = ct->chd_frame + (lba - (ct->LBA - ct->pregap_dv));
+
+ return chd->ReadHunk(frame / frames_per_hunk) + (frame % frames_per_hunk) * (2352 + 96);
+}
+
+void CDAccess_CHD::Read_Raw_Sector(uint8 *buf, int32 lba)
+{
+ //
+ // Leadout synthesis
+ //
+ if(lba >= total_sectors)
+ {
+  uint8 data_synth_mode = (disc_type == DISC_TYPE_CD_XA ? 0x02 : 0x01);
+  const uint8 format = Tracks[FirstTrack + NumTracks - 1].format;
+
+  if(format == CHD_FORMAT_MODE1 || format == CHD_FORMAT_MODE1_RAW)
+   data_synth_mode = 0x01;
+  else if(format != CHD_FORMAT_AUDIO)
+   data_synth_mode = 0x02;
+
+  synth_leadout_sector_lba(data_synth_mode, toc, lba, buf);
+  return;
+ }
+
+ memset(buf + 2352, 0, 96);
+ const int32 track = MakeSubPQ(lba, buf + 2352);
+ const TrackInfo* ct = &Tracks[track];
+
+ //
+ // Handle pregap and postgap reading
+ //
+ if(lba < (ct->LBA - ct->pregap_dv) || lba >= (ct->LBA + ct->sectors))
+ {
+  int32 pg_offset = lba - ct->LBA;
+  const TrackInfo* et = ct;
+
+  if(pg_offset < -150)
+  {
+   if((Tracks[track].subq_control & SUBQ_CTRLF_DATA) && (FirstTrack < track) && !(Tracks[track - 1].subq_control & SUBQ_CTRLF_DATA))
+    et = &Tracks[track - 1];
+  }
+
+  memset(buf, 0, 2352);
+  switch(et->format)
+  {
+   case CHD_FORMAT_AUDIO:
+	break;
+
+   case CHD_FORMAT_MODE1:
+   case CHD_FORMAT_MODE1_RAW:
+	encode_mode1_sector(lba + 150, buf);
+	break;
+
+   default:
+	buf[12 +  6] = 0x20;
+	buf[12 + 10] = 0x20;
+	encode_mode2_form2_sector(lba + 150, buf);
+	break;
+  }
+  return;
+ }
+
+ const uint8* f = GetFrame(ct, lba);
+
+ switch(ct->format)
+ {
+  case CHD_FORMAT_AUDIO:
+	for(unsigned i = 0; i < 588 * 2; i++)
+	 MDFN_en16lsb(buf + i * 2, MDFN_de16msb(f + i * 2));
+	break;
+
+  case CHD_FORMAT_MODE1:
+	memcpy(buf + 16, f, 2048);
+	encode_mode1_sector(lba + 150, buf);
+	break;
+
+  case CHD_FORMAT_MODE1_RAW:
+  case CHD_FORMAT_MODE2_RAW:
+	memcpy(buf, f, 2352);
+	break;
+
+  case CHD_FORMAT_MODE2:
+  case CHD_FORMAT_MODE2_FORM_MIX:
+	memcpy(buf + 16, f, 2336);
+	encode_mode2_sector(lba + 150, buf);
+	break;
+
+  case CHD_FORMAT_MODE2_FORM1:
+	memset(buf, 0, 2352);
+	memcpy(buf + 24, f, 2048);
+	break;
+
+  case CHD_FORMAT_MODE2_FORM2:
+	memset(buf, 0, 2352);
+	memcpy(buf + 24, f, 2324);
+	break;
+ }
+
+ if(ct->has_subchannel)
+  memcpy(buf + 2352, f + 2352, 96);
+}
+
+bool CDAccess_CHD::Fast_Read_Raw_PW_TSRE(uint8* pwbuf, int32 lba) const noexcept
+{
+ int32 track;
+
+ if(lba >= total_sectors)
+ {
+  subpw_synth_leadout_lba(toc, lba, pwbuf);
+  return true;
+ }
+
+ memset(pwbuf, 0, 96);
+ try
+ {
+  track = MakeSubPQ(lba, pwbuf);
+ }
+ catch(...)
+ {
+  return false;
+ }
+
+ //
+ // Subchannel data stored in the CHD can't be synthesized.
+ //
+ if(Tracks[track].has_subchannel && lba >= (Tracks[track].LBA - Tracks[track].pregap_dv) && (lba < Tracks[track].LBA + Tracks[track].sectors))
+  return false;
+
+ return true;
+}
+
+void CDAccess_CHD::Prefetch(int32 lba)
+{
+ for(int32 track = FirstTrack; track < (FirstTrack + NumTracks); track++)
+ {
+  const TrackInfo* ct = &Tracks[track];
+
+  if(lba >= (ct->LBA - ct->pregap_dv) && lba < (ct->LBA + ct->sectors))
+  {
+   const uint32 hunk = (ct->chd_frame + (lba - (ct->LBA - ct->pregap_dv))) / frames_per_hunk;
+
+   chd->ReadHunk(hunk);
+
+   if((hunk + 1) < chd->GetHunkCount())
+    chd->ReadHunk(hunk + 1);
+   break;
+  }
+ }
+}
+
+//
+// Note: this function makes use of the current contents(as in |=) in SubPWBuf.
+//
+int32 CDAccess_CHD::MakeSubPQ(int32 lba, uint8 *SubPWBuf) const
+{
+ uint8 buf[0xC];
+ int32 track;
+ uint32 lba_relative;
+ uint8 pause_or = 0x00;
+ bool track_found = false;
+
+ for(track = FirstTrack; track < (FirstTrack + NumTracks); track++)
+ {
+  if(lba >= (Tracks[track].LBA - Tracks[track].pregap_dv - Tracks[track].pregap) && lba < (Tracks[track].LBA + Tracks[track].sectors + Tracks[track].postgap))
+  {
+   track_found = true;
+   break;
+  }
+ }
+
+ if(!track_found)
+  throw MDFN_Error(0, _("Could not find track for sector %d!"), lba);
+
+ if(lba < Tracks[track].LBA)
+  lba_relative = Tracks[track].LBA - 1 - lba;
+ else
+  lba_relative = lba - Tracks[track].LBA;
+
+ uint8 adr = 0x1; // Q channel data encodes position
+ uint8 control = Tracks[track].subq_control;
+
+ // Handle pause(D7 of interleaved subchannel byte) bit, should be set to 1 when in pregap or postgap.
+ if((lba < Tracks[track].LBA) || (lba >= Tracks[track].LBA + Tracks[track].sectors))
+  pause_or = 0x80;
+
+ // Handle pregap between audio->data track
+ if((lba - Tracks[track].LBA) < -150)
+ {
+  if((Tracks[track].subq_control & SUBQ_CTRLF_DATA) && (FirstTrack < track) && !(Tracks[track - 1].subq_control & SUBQ_CTRLF_DATA))
+   control = Tracks[track - 1].subq_control;
+ }
+
+ memset(buf, 0, 0xC);
+ buf[0] = (adr << 0) | (control << 4);
+ buf[1] = U8_to_BCD(track);
+ buf[2] = U8_to_BCD(lba >= Tracks[track].LBA);	// Index
+
+ // Track relative MSF address
+ ABA_to_AMSF_BCD(lba_relative, &buf[3], &buf[4], &buf[5]);
+ buf[6] = 0;
+ // Absolute MSF address
+ ABA_to_AMSF_BCD(LBA_to_ABA(lba), &buf[7], &buf[8], &buf[9]);
+
+ subq_generate_checksum(buf);
+
+ if(!SubQReplaceMap.empty())
+ {
+  auto it = SubQReplaceMap.find(LBA_to_ABA(lba));
+
+  if(it != SubQReplaceMap.end())
+   memcpy(buf, it->second.data(), 12);
+ }
+
+ for(int i = 0; i < 96; i++)
+  SubPWBuf[i] |= (((buf[i >> 3] >> (7 - (i & 0x7))) & 1) ? 0x40 : 0x00) | pause_or;
+
+ return track;
+}
+
+void CDAccess_CHD::Read_TOC(TOC *rtoc)
+{
+ *rtoc = toc;
+}
+
+}
@@ -0,0 +1,85 @@
+/******************************************************************************/
+/* Mednafen - Multi-system Emulator                                           */
+/******************************************************************************/
+/* CDAccess_CHD.h:
+**  Copyright (C) 2025 Mednafen Team
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public License
+** as published by the Free Software Foundation; either version 2
+** of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software Foundation, Inc.,
+** 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef __MDFN_CDROM_CDACCESS_CHD_H
+#define __MDFN_CDROM_CDACCESS_CHD_H
+
+#include "CDAccess.h"
+
+#include <map>
+
+namespace Mednafen
+{
+
+class CHDFile;
+
+class CDAccess_CHD : public CDAccess
+{
+ public:
+
+ CDAccess_CHD(VirtualFS* vfs, const std::string& path, bool image_memcache);
+ virtual ~CDAccess_CHD();
+
+ virtual void Read_Raw_Sector(uint8 *buf, int32 lba) override;
+
+ virtual bool Fast_Read_Raw_PW_TSRE(uint8* pwbuf, int32 lba) const noexcept override;
+
+ virtual void Read_TOC(CDUtility::TOC *toc) override;
+
+ virtual void Prefetch(int32 lba) override;
+
+ private:
+
+ struct TrackInfo
+ {
+  int32 LBA;
+  int32 pregap;		// Not stored in the CHD
+  int32 pregap_dv;	// Stored in the CHD
+  int32 sectors;	// Not including pregap sectors!
+  int32 postgap;
+  uint32 chd_frame;	// CHD frame of the first stored sector(including pregap_dv)
+
+  uint8 format;
+  uint8 subq_control;
+  bool has_subchannel;
+ };
+
+ std::unique_ptr<CHDFile> chd;
+ uint32 frames_per_hunk;
+
+ int32 NumTracks;
+ int32 FirstTrack;
+ int32 total_sectors;
+ uint8 disc_type;
+ TrackInfo Tracks[100];
+ CDUtility::TOC toc;
+
+ std::map<uint32, std::array<uint8, 12>> SubQReplaceMap;
+
+ void LoadTracks(void);
+ const uint8* GetFrame(const TrackInfo* ct, int32 lba);
+
+ // MakeSubPQ will OR the simulated P and Q subchannel data into SubPWBuf.
+ int32 MakeSubPQ(int32 lba, uint8 *SubPWBuf) const;
+};
+
+}
+#endif
@@ -319,7 +319,7 @@ std::string MDFN_toupper(const std::string &str)
 }
 #endif
 
-void CDAccess_Image::LoadSBI(VirtualFS* vfs, const std::string& sbi_path)
+void CDAccess_LoadSBI(VirtualFS* vfs, const std::string& sbi_path, std::map<uint32, std::array<uint8, 12>>* SubQReplaceMap)
 {
  MDFN_printf(_("Loading SBI file %s...\n"), vfs->get_human_path(sbi_path).c_str());
  {
@@ -360,9 +360,9 @@ void CDAccess_Image::LoadSBI(VirtualFS* vfs, const std::string& sbi_path)
 
     uint32 aba = AMSF_to_ABA(BCD_to_U8(ed[0]), BCD_to_U8(ed[1]), BCD_to_U8(ed[2]));
 
-    memcpy(SubQReplaceMap[aba].data(), tmpq, 12);
+    memcpy((*SubQReplaceMap)[aba].data(), tmpq, 12);
    }
-   MDFN_printf(_("Loaded Q subchannel replacements for %zu sectors.\n"), SubQReplaceMap.size());
+   MDFN_printf(_("Loaded Q subchannel replacements for %zu sectors.\n"), SubQReplaceMap->size());
   }
   catch(MDFN_Error &e)
   {
@@ -922,6 +922,21 @@ void CDAccess_Image::ImageOpen(VirtualFS* vfs, const std::string& path, bool ima
   }
  }
 
+ //
+ // Map binary track files into memory, so sectors can be copied straight out of the page cache instead of going through
+ // seek()+read().  Without image memcache, only done on 64-bit platforms, so multi-disc sets can't exhaust the address space.
+ //
+ for(int x = FirstTrack; x < (FirstTrack + NumTracks); x++)
+ {
+  CDRFILE_TRACK_INFO* t = &Tracks[x];
+
+  if(t->fp && !t->AReader && (image_memcache || SIZEOF_VOID_P >= 8))
+  {
+   t->map_data = t->fp->map();
+   t->map_size = t->map_data ? t->fp->map_size() : 0;
+  }
+ }
+
  //
  // Load SBI file, if present
  //
@@ -938,7 +953,7 @@ void CDAccess_Image::ImageOpen(VirtualFS* vfs, const std::string& path, bool ima
    }
   }
 
-  LoadSBI(vfs, vfs->eval_fip(base_dir, file_base + "." + sbi_ext, true));
+  CDAccess_LoadSBI(vfs, vfs->eval_fip(base_dir, file_base + "." + sbi_ext, true), &SubQReplaceMap);
  }
 
  GenerateTOC();
@@ -987,6 +1002,18 @@ CDAccess_Image::~CDAccess_Image()
  Cleanup();
 }
 
+// Reads 'count' bytes from the track's file, from the memory mapping at *src if there is one.
+static INLINE void ReadTrackData(CDRFILE_TRACK_INFO* ct, const uint8** src, uint8* dest, const uint32 count)
+{
+ if(*src)
+ {
+  memcpy(dest, *src, count);
+  *src += count;
+ }
+ else
+  ct->fp->read(dest, count);
+}
+
 void CDAccess_Image::Read_Raw_Sector(uint8 *buf, int32 lba)
 {
   uint8 SimuQ[0xC];
@@ -1095,36 +1122,45 @@ void CDAccess_Image::Read_Raw_Sector(uint8 *buf, int32 lba)
    {
     long SeekPos = ct->FileOffset;
     long LBARelPos = lba - ct->LBA;
+    const uint8* src = NULL;
 
     SeekPos += LBARelPos * DI_Size_Table[ct->DIFormat];
 
     if(ct->SubchannelMode)
      SeekPos += 96 * (lba - ct->LBA);
 
-    ct->fp->seek(SeekPos, SEEK_SET);
+    if(ct->map_data)
+    {
+     if((uint64)SeekPos + DI_Size_Table[ct->DIFormat] + (ct->SubchannelMode ? 96 : 0) > ct->map_size)
+      throw MDFN_Error(0, _("Error reading sector %d: %s"), lba, _("Unexpected EOF"));
+
+     src = ct->map_data + SeekPos;
+    }
+    else
+     ct->fp->seek(SeekPos, SEEK_SET);
 
     switch(ct->DIFormat)
     {
 	case DI_FORMAT_AUDIO:
-		ct->fp->read(buf, 2352);
+		ReadTrackData(ct, &src, buf, 2352);
 
 		if(ct->RawAudioMSBFirst)
 		 Endian_A16_Swap(buf, 588 * 2);
 		break;
 
 	case DI_FORMAT_MODE1:
-		ct->fp->read(buf + 12 + 3 + 1, 2048);
+		ReadTrackData(ct, &src, buf + 12 + 3 + 1, 2048);
 		encode_mode1_sector(lba + 150, buf);
 		break;
 
 	case DI_FORMAT_MODE1_RAW:
 	case DI_FORMAT_MODE2_RAW:
 	case DI_FORMAT_CDI_RAW:
-		ct->fp->read(buf, 2352);
+		ReadTrackData(ct, &src, buf, 2352);
 		break;
 
 	case DI_FORMAT_MODE2:
-		ct->fp->read(buf + 16, 2336);
+		ReadTrackData(ct, &src, buf + 16, 2336);
 		encode_mode2_sector(lba + 150, buf);
 		break;
 
@@ -1132,19 +1168,19 @@ void CDAccess_Image::Read_Raw_Sector(uint8 *buf, int32 lba)
 	// FIXME: M2F1, M2F2, does sub-header come before or after user data(standards say before, but I wonder
 	// about cdrdao...).
 	case DI_FORMAT_MODE2_FORM1:
-		ct->fp->read(buf + 24, 2048);
+		ReadTrackData(ct, &src, buf + 24, 2048);
 		//encode_mode2_form1_sector(lba + 150, buf);
 		break;
 
 	case DI_FORMAT_MODE2_FORM2:
-		ct->fp->read(buf + 24, 2324);
+		ReadTrackData(ct, &src, buf + 24, 2324);
 		//encode_mode2_form2_sector(lba + 150, buf);
 		break;
 
     }
 
     if(ct->SubchannelMode)
-     ct->fp->read(buf + 2352, 96);
+     ReadTrackData(ct, &src, buf + 2352, 96);
    }
   } // end if audible part of audio track read.
 }
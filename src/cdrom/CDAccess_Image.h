@@ -25,6 +25,8 @@ struct CDRFILE_TRACK_INFO
 
 	int32 sectors;	// Not including pregap sectors!
         Stream *fp;
+	const uint8* map_data;	// fp's data mapped into memory, or NULL if fp must be read via seek()+read().
+	uint64 map_size;
 	bool FirstFileInstance;
 	bool RawAudioMSBFirst;
 	long FileOffset;
@@ -90,7 +92,6 @@ class CDAccess_Image : public CDAccess
  std::string base_dir;
 
  void ImageOpen(VirtualFS* vfs, const std::string& path, bool image_memcache);
- void LoadSBI(VirtualFS* vfs, const std::string& sbi_path);
  void GenerateTOC(void);
  void Cleanup(void);
 
@@ -101,5 +102,11 @@ class CDAccess_Image : public CDAccess
  uint32 GetSectorCount(CDRFILE_TRACK_INFO *track);
 };
 
+//
+// Loads LibCrypt Q subchannel replacement data from the SBI file at 'sbi_path' into *SubQReplaceMap, keyed by ABA.  A
+// nonexistent SBI file is not an error.
+//
+void CDAccess_LoadSBI(VirtualFS* vfs, const std::string& sbi_path, std::map<uint32, std::array<uint8, 12>>* SubQReplaceMap);
+
 }
 #endif
@@ -47,6 +47,12 @@ bool CDInterface::NonDeterministic_CheckSectorReady(int32 lba)
  return true;
 }
 
+void CDInterface::GetReadAheadStats(ReadAheadStats* stats)
+{
+ stats->hits = 0;
+ stats->misses = 0;
+}
+
 uint8 CDInterface::ReadSectors(uint8* buf, int32 lba, uint32 sector_count)
 {
  uint8 ret = 0;
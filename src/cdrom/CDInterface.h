@@ -81,6 +81,17 @@ class CDInterface
  // For experimental and special use cases.
  virtual bool NonDeterministic_CheckSectorReady(int32 lba);
 
+ //
+ // Sector read-ahead statistics, for ReadRawSector() calls made so far; all zero
+ // for implementations that don't read ahead.
+ //
+ struct ReadAheadStats
+ {
+  uint64 hits;		// Sector was already buffered.
+  uint64 misses;	// Had to wait for the sector to be read.
+ };
+ virtual void GetReadAheadStats(ReadAheadStats* stats);
+
  INLINE void ReadTOC(CDUtility::TOC* read_target)
  {
   *read_target = disc_toc;
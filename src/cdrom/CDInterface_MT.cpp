@@ -22,6 +22,8 @@
 #include <mednafen/mednafen.h>
 #include "CDInterface_MT.h"
 
+#include <mednafen/Time.h>
+
 namespace Mednafen
 {
 
@@ -122,6 +124,159 @@ void CDInterface_MT::CDInterface_Queue::Write(const CDInterface_Message &message
  MThreading::Mutex_Unlock(ze_mutex);
 }
 
+void CDInterface_MT::SendCommand(const uint32 message, const int32 lba)
+{
+ // Should only happen if the read thread is stuck in a very slow read.
+ while(MDFN_UNLIKELY(!ReadThreadFIFO.CanWrite()))
+ {
+  MThreading::Sem_Post(ReadThreadWake);
+  Time::SleepMS(1);
+ }
+
+ ReadThreadFIFO.Write({ message, lba });
+
+ // Pairs with the fence in ReceiveCommand(), so that either the read thread sees the command before it sleeps,
+ // or we see that it's sleeping and wake it up.
+ std::atomic_thread_fence(std::memory_order_seq_cst);
+
+ if(ReadThreadSleeping.load(std::memory_order_relaxed))
+  MThreading::Sem_Post(ReadThreadWake);
+}
+
+// Returns false if no command was read, true if one was.  Will always return true if "blocking" is set.
+bool CDInterface_MT::ReceiveCommand(ReadCommand* cmd, const bool blocking)
+{
+ if(!ReadThreadFIFO.CanRead())
+ {
+  if(!blocking)
+   return false;
+
+  do
+  {
+   ReadThreadSleeping.store(true, std::memory_order_relaxed);
+   std::atomic_thread_fence(std::memory_order_seq_cst);
+
+   if(!ReadThreadFIFO.CanRead())
+    MThreading::Sem_Wait(ReadThreadWake);
+
+   ReadThreadSleeping.store(false, std::memory_order_relaxed);
+  } while(!ReadThreadFIFO.CanRead());
+ }
+
+ *cmd = ReadThreadFIFO.Read();
+
+ return true;
+}
+
+static INLINE unsigned RunHistoryHash(const int32 lba)
+{
+ return ((uint32)lba * 0x9E3779B1U) >> 24;
+}
+
+void CDInterface_MT::RA_Reset(void)
+{
+ ra_lba = 0;
+ ra_end = 0;
+ ra_window = 0;
+ last_read_lba = LBA_Read_Maximum + 1;
+ run_start = last_read_lba + 1;
+ run_limit = INT32_MAX;
+ prefetch_lba = LBA_Read_Maximum + 1;
+
+ for(auto& e : RunHistory)
+ {
+  e.start = LBA_Read_Minimum - 1;
+  e.length = 0;
+ }
+}
+
+void CDInterface_MT::RA_EndRun(void)
+{
+ const int32 length = last_read_lba + 1 - run_start;
+
+ if(length > 0)
+ {
+  RunHistoryEntry* e = &RunHistory[RunHistoryHash(run_start)];
+
+  e->start = run_start;
+  e->length = length;
+ }
+}
+
+//
+// Called for each sector read request and hint from the emulated drive, in order.
+//
+void CDInterface_MT::RA_Request(const int32 lba, const bool hint)
+{
+ static const int32 max_ra = 64;
+ static const int32 initial_ra = 4;
+ static const int32 window_step = 2;
+ static const int32 rewind_slack = 8;
+
+ static_assert((unsigned int)(max_ra + rewind_slack) < (SBSize / 2), "Max readahead too large.");
+
+ if(lba == (last_read_lba + 1))
+ {
+  //
+  // Sequential; widen the window as long as the run continues.
+  //
+  if(!hint)
+  {
+   ra_window = std::min<int32>(max_ra, ra_window + window_step);
+
+   // Run is longer than it was the last time, so stop limiting read-ahead to its learned length.
+   if(lba >= run_limit)
+    run_limit = INT32_MAX;
+
+   last_read_lba = lba;
+  }
+ }
+ else if(lba >= run_start && lba <= last_read_lba && lba >= (last_read_lba - rewind_slack))
+ {
+  //
+  // Short step backward within the current run(e.g. the emulated drive re-seeking to a sector it just read), which
+  // will normally still be buffered; don't treat it as a new run.
+  //
+  if(!hint)
+   last_read_lba = lba;
+ }
+ else
+ {
+  //
+  // Seek; start a new run, using what was learned the last time a run started at this sector, if anything.
+  //
+  const RunHistoryEntry* e = &RunHistory[RunHistoryHash(lba)];
+
+  RA_EndRun();
+  run_start = lba;
+
+  if(e->start == lba)
+  {
+   ra_window = std::max<int32>(1, std::min<int32>(max_ra, e->length));
+   run_limit = lba + e->length;
+  }
+  else
+  {
+   ra_window = initial_ra;
+   run_limit = INT32_MAX;
+  }
+
+  ra_lba = lba;
+  last_read_lba = hint ? (lba - 1) : lba;
+ }
+
+ ra_end = std::min<int32>(last_read_lba + 1 + ra_window, run_limit);
+
+ //
+ // Make sure the requested sector will be read, whatever the heuristics above decided.
+ //
+ if(!SB_IsBuffered(lba) && (lba < ra_lba || lba >= ra_end))
+ {
+  ra_lba = lba;
+  ra_end = std::max<int32>(ra_end, lba + 1);
+ }
+}
+
 static int ReadThreadStart_C(void* arg)
 {
  return ((CDInterface_MT*)arg)->ReadThreadStart();
@@ -131,10 +286,7 @@ int CDInterface_MT::ReadThreadStart()
 {
  bool Running = true;
 
- SBWritePos = 0;
- ra_lba = 0;
- ra_count = 0;
- last_read_lba = LBA_Read_Maximum + 1;
+ RA_Reset();
 
  try
  {
@@ -145,10 +297,7 @@ int CDInterface_MT::ReadThreadStart()
    throw(MDFN_Error(0, _("TOC first(%d)/last(%d) track numbers bad."), disc_toc.first_track, disc_toc.last_track));
   }
 
-  SBWritePos = 0;
-  ra_lba = 0;
-  ra_count = 0;
-  last_read_lba = LBA_Read_Maximum + 1;
+  RA_Reset();
   memset(SectorBuffers, 0, SBSize * sizeof(CDInterface_Sector_Buffer));
  }
  catch(std::exception &e)
@@ -161,55 +310,39 @@ int CDInterface_MT::ReadThreadStart()
 
  while(Running)
  {
-  CDInterface_Message msg;
+  const bool ra_pending = (ra_lba < ra_end && ra_lba <= LBA_Read_Maximum);
+  const bool prefetch_pending = (ra_lba != prefetch_lba && ra_lba <= LBA_Read_Maximum);
+  bool blocking = !ra_pending && !prefetch_pending;
+  ReadCommand cmd;
 
-  //printf("%d %d %d\n", last_read_lba, ra_lba, ra_count);
+  //printf("%d %d %d %d\n", last_read_lba, ra_lba, ra_end, ra_window);
 
-  // Only do a blocking-wait for a message if we don't have any sectors to read-ahead.
-  if(ReadThreadQueue.Read(&msg, ra_count ? false : true))
+  //
+  // Handle all pending commands before reading anything, and only do a blocking-wait for a command if
+  // we have nothing to read-ahead or prefetch.
+  //
+  while(Running && ReceiveCommand(&cmd, blocking))
   {
-   if(msg.message == CDInterface_MSG_DIEDIEDIE)
+   blocking = false;
+
+   if(cmd.message == CDInterface_MSG_DIEDIEDIE)
     Running = false;
-   else if(msg.message == CDInterface_MSG_READ_SECTOR)
-   {
-    static const int max_ra = 16;
-    static const int initial_ra = 1;
-    static const int speedmult_ra = 2;
-    //
-    const int32 new_lba = msg.args[0];
-
-    static_assert((unsigned int)max_ra < (SBSize / 4), "Max readahead too large.");
-
-    if(new_lba == (last_read_lba + 1))
-    {
-     int how_far_ahead = ra_lba - new_lba;
-
-     if(how_far_ahead <= max_ra)
-      ra_count = std::min(speedmult_ra, 1 + max_ra - how_far_ahead);
-     else
-      ra_count++;
-    }
-    else if(new_lba != last_read_lba)
-    {
-     ra_lba = new_lba;
-     ra_count = initial_ra;
-    }
-
-    last_read_lba = new_lba;
-   }
+   else if(cmd.message == CDInterface_MSG_READ_SECTOR || cmd.message == CDInterface_MSG_HINT_SECTOR)
+    RA_Request(cmd.lba, cmd.message == CDInterface_MSG_HINT_SECTOR);
   }
 
+  if(!Running)
+   break;
+
   //
-  // Don't read beyond what the disc (image) readers can handle sanely.
+  // Skip sectors that are still buffered.  Don't read beyond what the disc (image) readers can handle sanely.
   //
-  if(ra_count && ra_lba > LBA_Read_Maximum)
-  {
-   ra_count = 0;
-   //printf("Ephemeral scarabs: %d!\n", ra_lba);
-  }
+  while(ra_lba < ra_end && ra_lba <= LBA_Read_Maximum && SB_IsBuffered(ra_lba))
+   ra_lba++;
 
-  if(ra_count)
+  if(ra_lba < ra_end && ra_lba <= LBA_Read_Maximum)
   {
+   CDInterface_Sector_Buffer* sb = &SectorBuffers[ra_lba & (SBSize - 1)];
    uint8 tmpbuf[2352 + 96];
    bool error_condition = false;
 
@@ -228,11 +361,10 @@ int CDInterface_MT::ReadThreadStart()
    //
    MThreading::Mutex_Lock(SBMutex);
 
-   SectorBuffers[SBWritePos].lba = ra_lba;
-   memcpy(SectorBuffers[SBWritePos].data, tmpbuf, 2352 + 96);
-   SectorBuffers[SBWritePos].valid = true;
-   SectorBuffers[SBWritePos].error = error_condition;
-   SBWritePos = (SBWritePos + 1) % SBSize;
+   sb->lba = ra_lba;
+   memcpy(sb->data, tmpbuf, 2352 + 96);
+   sb->valid = true;
+   sb->error = error_condition;
 
    MThreading::Cond_Signal(SBCond);
 
@@ -241,7 +373,22 @@ int CDInterface_MT::ReadThreadStart()
    //
 
    ra_lba++;
-   ra_count--;
+  }
+  else if(ra_lba != prefetch_lba && ra_lba <= LBA_Read_Maximum)
+  {
+   //
+   // Caught up with the read-ahead, so let the backend decode ahead(e.g. the next CHD hunk) before blocking.
+   //
+   prefetch_lba = ra_lba;
+
+   try
+   {
+    disc_cdaccess->Prefetch(ra_lba);
+   }
+   catch(std::exception &e)
+   {
+    // Errors will be reported if and when the sectors are actually read.
+   }
   }
  }
 
@@ -250,49 +397,39 @@ int CDInterface_MT::ReadThreadStart()
 
 void CDInterface_MT::Cleanup(void)
 {
- bool thread_deaded_failed = false;
-
  if(CDReadThread)
  {
-  try
-  {
-   ReadThreadQueue.Write(CDInterface_Message(CDInterface_MSG_DIEDIEDIE));
-  }
-  catch(std::exception &e)
-  {
-   MDFND_OutputNotice(MDFN_NOTICE_ERROR, e.what());
-   thread_deaded_failed = true;
-  }
+  SendCommand(CDInterface_MSG_DIEDIEDIE);
+  MThreading::Thread_Wait(CDReadThread, NULL);
+  CDReadThread = NULL;
  }
 
- if(!thread_deaded_failed)
+ if(ReadThreadWake)
  {
-  if(CDReadThread)
-  {
-   MThreading::Thread_Wait(CDReadThread, NULL);
-   CDReadThread = NULL;
-  }
+  MThreading::Sem_Destroy(ReadThreadWake);
+  ReadThreadWake = NULL;
+ }
 
-  if(SBMutex)
-  {
-   MThreading::Mutex_Destroy(SBMutex);
-   SBMutex = NULL;
-  }
+ if(SBMutex)
+ {
+  MThreading::Mutex_Destroy(SBMutex);
+  SBMutex = NULL;
+ }
 
-  if(SBCond)
-  {
-   MThreading::Cond_Destroy(SBCond);
-   SBCond = NULL;
-  }
+ if(SBCond)
+ {
+  MThreading::Cond_Destroy(SBCond);
+  SBCond = NULL;
  }
 }
 
-CDInterface_MT::CDInterface_MT(std::unique_ptr<CDAccess> cda, const uint64 affinity) : disc_cdaccess(std::move(cda)), CDReadThread(NULL), SBMutex(NULL), SBCond(NULL)
+CDInterface_MT::CDInterface_MT(std::unique_ptr<CDAccess> cda, const uint64 affinity) : disc_cdaccess(std::move(cda)), CDReadThread(NULL), ReadThreadWake(NULL), ReadThreadSleeping(false), SBMutex(NULL), SBCond(NULL), ra_hits(0), ra_misses(0)
 {
  try
  {
   CDInterface_Message msg;
 
+  ReadThreadWake = MThreading::Sem_Create();
   SBMutex = MThreading::Mutex_Create();
   SBCond = MThreading::Cond_Create();
 
@@ -321,7 +458,6 @@ CDInterface_MT::~CDInterface_MT()
 
 bool CDInterface_MT::ReadRawSector(uint8 *buf, int32 lba)
 {
- bool found = false;
  bool error_condition = false;
 
  if(UnrecoverableError)
@@ -338,37 +474,36 @@ bool CDInterface_MT::ReadRawSector(uint8 *buf, int32 lba)
  }
  //fprintf(stderr, "%d\n", ra_lba - lba);
 
- ReadThreadQueue.Write(CDInterface_Message(CDInterface_MSG_READ_SECTOR, lba));
+ SendCommand(CDInterface_MSG_READ_SECTOR, lba);
 
  //
  //
  //
+ const CDInterface_Sector_Buffer* sb = &SectorBuffers[lba & (SBSize - 1)];
+ bool waited = false;
+
  MThreading::Mutex_Lock(SBMutex);
 
- do
+ while(!sb->valid || sb->lba != lba)
  {
-  for(int i = 0; i < SBSize; i++)
-  {
-   if(SectorBuffers[i].valid && SectorBuffers[i].lba == lba)
-   {
-    error_condition = SectorBuffers[i].error;
-    memcpy(buf, SectorBuffers[i].data, 2352 + 96);
-    found = true;
-   }
-  }
+  //int32 swt = MDFND_GetTime();
+  MThreading::Cond_Wait(SBCond, SBMutex);
+  //printf("SB Waited: %d\n", MDFND_GetTime() - swt);
+  waited = true;
+ }
 
-  if(!found)
-  {
-   //int32 swt = MDFND_GetTime();
-   MThreading::Cond_Wait(SBCond, SBMutex);
-   //printf("SB Waited: %d\n", MDFND_GetTime() - swt);
-  }
- } while(!found);
+ error_condition = sb->error;
+ memcpy(buf, sb->data, 2352 + 96);
 
  MThreading::Mutex_Unlock(SBMutex);
  //
  //
  //
+ if(waited)
+  ra_misses++;
+ else
+  ra_hits++;
+
  return !error_condition;
 }
 
@@ -390,7 +525,7 @@ bool CDInterface_MT::ReadRawSectorPWOnly(uint8* pwbuf, int32 lba, bool hint_full
  if(disc_cdaccess->Fast_Read_Raw_PW_TSRE(pwbuf, lba))
  {
   if(hint_fullread)
-   ReadThreadQueue.Write(CDInterface_Message(CDInterface_MSG_READ_SECTOR, lba));
+   SendCommand(CDInterface_MSG_HINT_SECTOR, lba);
 
   return true;
  }
@@ -411,7 +546,30 @@ void CDInterface_MT::HintReadSector(int32 lba)
  if(UnrecoverableError)
   return;
 
- ReadThreadQueue.Write(CDInterface_Message(CDInterface_MSG_READ_SECTOR, lba));
+ if(lba < LBA_Read_Minimum || lba > LBA_Read_Maximum)
+  return;
+
+ SendCommand(CDInterface_MSG_HINT_SECTOR, lba);
+}
+
+bool CDInterface_MT::NonDeterministic_CheckSectorReady(int32 lba)
+{
+ bool ret;
+
+ if(UnrecoverableError || lba < LBA_Read_Minimum || lba > LBA_Read_Maximum)
+  return true;
+
+ MThreading::Mutex_Lock(SBMutex);
+ ret = SectorBuffers[lba & (SBSize - 1)].valid && SectorBuffers[lba & (SBSize - 1)].lba == lba;
+ MThreading::Mutex_Unlock(SBMutex);
+
+ return ret;
+}
+
+void CDInterface_MT::GetReadAheadStats(ReadAheadStats* stats)
+{
+ stats->hits = ra_hits;
+ stats->misses = ra_misses;
 }
 
 }
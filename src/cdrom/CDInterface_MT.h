@@ -25,6 +25,7 @@
 #include <mednafen/cdrom/CDInterface.h>
 #include <mednafen/cdrom/CDAccess.h>
 #include <mednafen/MThreading.h>
+#include <mednafen/AtomicFIFO.h>
 #include <queue>
 
 namespace Mednafen
@@ -42,6 +43,9 @@ class CDInterface_MT : public CDInterface
  virtual bool ReadRawSector(uint8 *buf, int32 lba) override;
  virtual bool ReadRawSectorPWOnly(uint8* pwbuf, int32 lba, bool hint_fullread) override;
 
+ virtual bool NonDeterministic_CheckSectorReady(int32 lba) override;
+ virtual void GetReadAheadStats(ReadAheadStats* stats) override;
+
  // FIXME: Semi-private:
  int ReadThreadStart(void);
 
@@ -66,7 +70,11 @@ class CDInterface_MT : public CDInterface
   CDInterface_MSG_DIEDIEDIE,		// Emu -> read
 
   CDInterface_MSG_READ_SECTOR,		/* Emu -> read
-					args[0] = lba
+					lba = lba
+				*/
+
+  CDInterface_MSG_HINT_SECTOR,		/* Emu -> read; the emulated drive is seeking to, or will soon read, the sector.
+					lba = lba
 				*/
  };
 
@@ -102,12 +110,27 @@ class CDInterface_MT : public CDInterface
   MThreading::Cond *ze_cond;
  };
 
- // Queue for messages to the read thread.
- CDInterface_Queue ReadThreadQueue;
-
- // Queue for messages to the emu thread.
+ // Queue for messages to the emu thread(only used during startup).
  CDInterface_Queue EmuThreadQueue;
 
+ //
+ // Commands to the read thread; single producer(emu thread), single consumer(read thread).
+ //
+ struct ReadCommand
+ {
+  uint32 message;
+  int32 lba;
+ };
+ AtomicFIFO<ReadCommand, 256> ReadThreadFIFO;
+ MThreading::Sem* ReadThreadWake;
+ std::atomic<bool> ReadThreadSleeping;
+
+ void SendCommand(const uint32 message, const int32 lba = 0);
+ bool ReceiveCommand(ReadCommand* cmd, const bool blocking);
+
+ //
+ // Direct-mapped by LBA; only the read thread writes to it.
+ //
  enum { SBSize = 256 };
  struct CDInterface_Sector_Buffer
  {
@@ -116,18 +139,49 @@ class CDInterface_MT : public CDInterface
   int32 lba;
   uint8 data[2352 + 96];
  } SectorBuffers[SBSize];
+ static_assert(!(SBSize & (SBSize - 1)), "SBSize must be a power of 2.");
 
- uint32 SBWritePos;
- 
  MThreading::Mutex* SBMutex;
  MThreading::Cond* SBCond;
 
+ //
+ // Emu-thread-only:
+ //
+ uint64 ra_hits;
+ uint64 ra_misses;
+
  //
  // Read-thread-only:
  //
- int32 ra_lba;
- int32 ra_count;
+ void RA_Reset(void);
+ void RA_Request(const int32 lba, const bool hint);
+ void RA_EndRun(void);
+
+ INLINE bool SB_IsBuffered(const int32 lba) const
+ {
+  const CDInterface_Sector_Buffer* sb = &SectorBuffers[lba & (SBSize - 1)];
+
+  return sb->valid && sb->lba == lba;
+ }
+
+ int32 ra_lba;		// Next sector to read ahead.
+ int32 ra_end;		// Read ahead up to, but not including, this sector.
+ int32 ra_window;	// How far past the last sector requested to read ahead.
  int32 last_read_lba;
+ int32 run_start;	// First sector of the current sequential run.
+ int32 run_limit;	// Learned end of the current run, from RunHistory.
+ int32 prefetch_lba;
+
+ //
+ // Length of sequential runs previously started at a sector, direct-mapped by starting sector, so that
+ // e.g. a file system lookup that only reads one sector doesn't trigger a burst of useless read-ahead,
+ // while a stream that was previously read at length can get the full read-ahead window immediately.
+ //
+ struct RunHistoryEntry
+ {
+  int32 start;
+  int32 length;
+ } RunHistory[256];
 };
 
 }
@@ -0,0 +1,1451 @@
+/******************************************************************************/
+/* Mednafen - Multi-system Emulator                                           */
+/******************************************************************************/
+/* CHDFile.cpp - MAME CHD(v5) container reading
+**  Copyright (C) 2025 Mednafen Team
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public License
+** as published by the Free Software Foundation; either version 2
+** of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software Foundation, Inc.,
+** 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+/*
+ Only the codecs chdman uses for CD images are supported: zlib, zstd, and LZMA, plus the CD-specific wrappers(cdzl, cdzs, cdlz,
+ and cdfl) that split each hunk into sector data and subcode data and compress them separately.  The LZMA and FLAC decoders
+ are minimal implementations of just what chdman emits(raw LZMA1 streams with a known output size; headerless 16-bit stereo
+ FLAC frames), so no additional libraries are needed.
+
+ Parent(differential) CHDs are not supported.
+*/
+
+#include <mednafen/mednafen.h>
+#include <mednafen/hash/crc.h>
+
+#include "CHDFile.h"
+#include "lec.h"
+
+#include <zlib.h>
+#include <zstd/zstd.h>
+
+namespace Mednafen
+{
+
+enum : uint8
+{
+ CHD_COMP_TYPE_0 = 0,	// Codec #0
+ CHD_COMP_TYPE_1,	// Codec #1
+ CHD_COMP_TYPE_2,	// Codec #2
+ CHD_COMP_TYPE_3,	// Codec #3
+ CHD_COMP_NONE,		// Uncompressed
+ CHD_COMP_SELF,		// Same as another hunk in this file
+ CHD_COMP_PARENT,	// Same as a hunk in the parent file
+
+ // Only used in the compressed map:
+ CHD_COMP_RLE_SMALL,
+ CHD_COMP_RLE_LARGE,
+ CHD_COMP_SELF_0,
+ CHD_COMP_SELF_1,
+ CHD_COMP_PARENT_SELF,
+ CHD_COMP_PARENT_0,
+ CHD_COMP_PARENT_1
+};
+
+static const uint32 CD_FRAME_SIZE = 2352 + 96;
+
+//
+// MSB-first bit reader; reads past the end of the data return 0 bits, and are detected afterward with Overrun().
+//
+class CHDBitReader
+{
+ public:
+
+ INLINE CHDBitReader(const uint8* d, const size_t l) : data(d), len(l), bp(0)
+ {
+
+ }
+
+ // Returns the next 64 bits, of which at least 57 are valid.
+ INLINE uint64 Peek64(void) const
+ {
+  const size_t bi = bp >> 3;
+  uint64 w;
+
+  if(MDFN_LIKELY((bi + 8) <= len))
+   w = MDFN_de64msb(data + bi);
+  else
+  {
+   w = 0;
+   for(size_t i = bi; i < bi + 8; i++)
+    w = (w << 8) | ((i < len) ? data[i] : 0);
+  }
+
+  return w << (bp & 7);
+ }
+
+ // 0 <= n <= 32
+ INLINE uint32 Read(const unsigned n)
+ {
+  if(!n)
+   return 0;
+
+  const uint32 ret = Peek64() >> (64 - n);
+
+  bp += n;
+
+  return ret;
+ }
+
+ INLINE int32 ReadSigned(const unsigned n)
+ {
+  if(!n)
+   return 0;
+
+  return sign_x_to_s32(n, Read(n));
+ }
+
+ INLINE uint32 ReadUnary(void)
+ {
+  uint32 ret = 0;
+
+  for(;;)
+  {
+   const uint64 w = Peek64();
+
+   if(w)
+   {
+    const unsigned z = MDFN_lzcount64_0UD(w);
+
+    bp += z + 1;
+    return ret + z;
+   }
+
+   const unsigned avail = 64 - (bp & 7);
+
+   ret += avail;
+   bp += avail;
+
+   if(Overrun())
+    return ret;
+  }
+ }
+
+ INLINE void Align(void)
+ {
+  bp = (bp + 7) &~ (uint64)7;
+ }
+
+ INLINE bool Overrun(void) const
+ {
+  return bp > ((uint64)len << 3);
+ }
+
+ INLINE size_t BytePos(void) const
+ {
+  return (bp + 7) >> 3;
+ }
+
+ private:
+ const uint8* data;
+ size_t len;
+ uint64 bp;
+};
+
+class CHDCodec
+{
+ public:
+ virtual ~CHDCodec() { }
+
+ // Must decompress exactly dest_len bytes, or throw.
+ virtual void Decompress(const uint8* src, const uint32 src_len, uint8* dest, const uint32 dest_len) = 0;
+};
+
+class CHDCodec_Zlib final : public CHDCodec
+{
+ public:
+
+ CHDCodec_Zlib()
+ {
+  memset(&zs, 0, sizeof(zs));
+
+  if(inflateInit2(&zs, -MAX_WBITS) != Z_OK)
+   throw MDFN_Error(0, _("Error initializing zlib."));
+ }
+
+ virtual ~CHDCodec_Zlib() override
+ {
+  inflateEnd(&zs);
+ }
+
+ virtual void Decompress(const uint8* src, const uint32 src_len, uint8* dest, const uint32 dest_len) override
+ {
+  if(inflateReset(&zs) != Z_OK)
+   throw MDFN_Error(0, _("Error resetting zlib decompressor."));
+
+  zs.next_in = (Bytef*)src;
+  zs.avail_in = src_len;
+  zs.next_out = dest;
+  zs.avail_out = dest_len;
+
+  const int zerr = inflate(&zs, Z_FINISH);
+
+  if((zerr != Z_STREAM_END && zerr != Z_OK && zerr != Z_BUF_ERROR) || zs.total_out != dest_len)
+   throw MDFN_Error(0, _("zlib decompression of CHD hunk failed."));
+ }
+
+ private:
+ z_stream zs;
+};
+
+class CHDCodec_Zstd final : public CHDCodec
+{
+ public:
+
+ CHDCodec_Zstd()
+ {
+  if(!(dctx = ZSTD_createDCtx()))
+   throw MDFN_Error(0, _("Error creating zstd decompression context."));
+ }
+
+ virtual ~CHDCodec_Zstd() override
+ {
+  ZSTD_freeDCtx(dctx);
+ }
+
+ virtual void Decompress(const uint8* src, const uint32 src_len, uint8* dest, const uint32 dest_len) override
+ {
+  const size_t res = ZSTD_decompressDCtx(dctx, dest, dest_len, src, src_len);
+
+  if(ZSTD_isError(res) || res != dest_len)
+   throw MDFN_Error(0, _("zstd decompression of CHD hunk failed."));
+ }
+
+ private:
+ ZSTD_DCtx* dctx;
+};
+
+//
+// Raw LZMA1 decoding, lc=3 lp=0 pb=2, with no end marker; the entire output buffer serves as the dictionary.
+//
+class CHDCodec_LZMA final : public CHDCodec
+{
+ public:
+
+ virtual void Decompress(const uint8* src, const uint32 src_len, uint8* dest, const uint32 dest_len) override
+ {
+  in = src;
+  in_end = src + src_len;
+
+  Reset();
+
+  if(ReadByte() != 0)
+   Error();
+
+  code = 0;
+  range = 0xFFFFFFFF;
+  for(unsigned i = 0; i < 4; i++)
+   code = (code << 8) | ReadByte();
+
+  if(code == range)
+   Error();
+  //
+  //
+  uint32 pos = 0;
+  uint32 rep0 = 0, rep1 = 0, rep2 = 0, rep3 = 0;
+  unsigned state = 0;
+
+  while(pos < dest_len)
+  {
+   const unsigned pos_state = pos & ((1U << pb) - 1);
+
+   if(!DecodeBit(&IsMatch[(state << 4) + pos_state]))
+   {
+    const unsigned prev_byte = pos ? dest[pos - 1] : 0;
+    uint16* probs = &LitProbs[0x300 * (((pos & ((1U << lp) - 1)) << lc) + (prev_byte >> (8 - lc)))];
+    unsigned symbol = 1;
+
+    if(state >= 7)
+    {
+     unsigned match_byte = dest[pos - rep0 - 1];
+
+     do
+     {
+      const unsigned match_bit = (match_byte >> 7) & 1;
+      match_byte <<= 1;
+      const unsigned bit = DecodeBit(&probs[((1 + match_bit) << 8) + symbol]);
+      symbol = (symbol << 1) | bit;
+
+      if(match_bit != bit)
+       break;
+     } while(symbol < 0x100);
+    }
+
+    while(symbol < 0x100)
+     symbol = (symbol << 1) | DecodeBit(&probs[symbol]);
+
+    dest[pos++] = symbol;
+    state = (state < 4) ? 0 : ((state < 10) ? (state - 3) : (state - 6));
+    continue;
+   }
+
+   uint32 len;
+
+   if(DecodeBit(&IsRep[state]))
+   {
+    if(!pos)
+     Error();
+
+    if(!DecodeBit(&IsRepG0[state]))
+    {
+     if(!DecodeBit(&IsRep0Long[(state << 4) + pos_state]))
+     {
+      state = (state < 7) ? 9 : 11;
+      dest[pos] = dest[pos - rep0 - 1];
+      pos++;
+      continue;
+     }
+    }
+    else
+    {
+     uint32 dist;
+
+     if(!DecodeBit(&IsRepG1[state]))
+      dist = rep1;
+     else
+     {
+      if(!DecodeBit(&IsRepG2[state]))
+       dist = rep2;
+      else
+      {
+       dist = rep3;
+       rep3 = rep2;
+      }
+      rep2 = rep1;
+     }
+     rep1 = rep0;
+     rep0 = dist;
+    }
+    len = DecodeLen(&RepLen, pos_state);
+    state = (state < 7) ? 8 : 11;
+   }
+   else
+   {
+    rep3 = rep2;
+    rep2 = rep1;
+    rep1 = rep0;
+    len = DecodeLen(&MatchLen, pos_state);
+    state = (state < 7) ? 7 : 10;
+    rep0 = DecodeDistance(len);
+
+    if(rep0 == 0xFFFFFFFF)	// End marker
+     break;
+
+    if(rep0 >= pos)
+     Error();
+   }
+
+   len += 2;
+
+   if(len > (dest_len - pos))
+    Error();
+
+   const uint8* s = &dest[pos - rep0 - 1];
+   uint8* d = &dest[pos];
+
+   pos += len;
+
+   do
+   {
+    *d++ = *s++;
+   } while(--len);
+  }
+
+  if(pos != dest_len || in > (in_end + 1))
+   Error();
+ }
+
+ private:
+
+ enum : unsigned { lc = 3, lp = 0, pb = 2 };
+
+ struct LenDecoder
+ {
+  uint16 Choice;
+  uint16 Choice2;
+  uint16 Low[16][1 << 3];
+  uint16 Mid[16][1 << 3];
+  uint16 High[1 << 8];
+ };
+
+ const uint8* in;
+ const uint8* in_end;
+ uint32 range;
+ uint32 code;
+
+ uint16 IsMatch[12 << 4];
+ uint16 IsRep[12];
+ uint16 IsRepG0[12];
+ uint16 IsRepG1[12];
+ uint16 IsRepG2[12];
+ uint16 IsRep0Long[12 << 4];
+ uint16 PosSlot[4][1 << 6];
+ uint16 PosDecoders[1 + 128 - 14];
+ uint16 Align[1 << 4];
+ LenDecoder MatchLen;
+ LenDecoder RepLen;
+ uint16 LitProbs[0x300 << (lc + lp)];
+
+ static MDFN_COLD NO_INLINE void Error(void)
+ {
+  throw MDFN_Error(0, _("LZMA decompression of CHD hunk failed."));
+ }
+
+ static void InitProbs(uint16* p, size_t count)
+ {
+  while(count--)
+   *p++ = 1 << 10;
+ }
+
+ void Reset(void)
+ {
+  InitProbs(IsMatch, sizeof(IsMatch) / sizeof(uint16));
+  InitProbs(IsRep, sizeof(IsRep) / sizeof(uint16));
+  InitProbs(IsRepG0, sizeof(IsRepG0) / sizeof(uint16));
+  InitProbs(IsRepG1, sizeof(IsRepG1) / sizeof(uint16));
+  InitProbs(IsRepG2, sizeof(IsRepG2) / sizeof(uint16));
+  InitProbs(IsRep0Long, sizeof(IsRep0Long) / sizeof(uint16));
+  InitProbs(&PosSlot[0][0], sizeof(PosSlot) / sizeof(uint16));
+  InitProbs(PosDecoders, sizeof(PosDecoders) / sizeof(uint16));
+  InitProbs(Align, sizeof(Align) / sizeof(uint16));
+  InitProbs(&MatchLen.Choice, sizeof(MatchLen) / sizeof(uint16));
+  InitProbs(&RepLen.Choice, sizeof(RepLen) / sizeof(uint16));
+  InitProbs(LitProbs, sizeof(LitProbs) / sizeof(uint16));
+ }
+
+ INLINE uint8 ReadByte(void)
+ {
+  // Past the end, feed zeroes and let the final check catch gross overreads.
+  if(MDFN_UNLIKELY(in >= in_end))
+  {
+   in++;
+   return 0;
+  }
+
+  return *in++;
+ }
+
+ INLINE void Normalize(void)
+ {
+  if(range < (1U << 24))
+  {
+   range <<= 8;
+   code = (code << 8) | ReadByte();
+  }
+ }
+
+ INLINE unsigned DecodeBit(uint16* prob)
+ {
+  unsigned v = *prob;
+  const uint32 bound = (range >> 11) * v;
+  unsigned ret;
+
+  if(code < bound)
+  {
+   v += ((1 << 11) - v) >> 5;
+   range = bound;
+   ret = 0;
+  }
+  else
+  {
+   v -= v >> 5;
+   code -= bound;
+   range -= bound;
+   ret = 1;
+  }
+  *prob = v;
+  Normalize();
+
+  return ret;
+ }
+
+ INLINE uint32 DecodeDirectBits(unsigned num_bits)
+ {
+  uint32 ret = 0;
+
+  do
+  {
+   range >>= 1;
+   code -= range;
+   const uint32 t = 0 - (code >> 31);
+   code += range & t;
+
+   if(code == range)
+    Error();
+
+   Normalize();
+   ret = (ret << 1) + (t + 1);
+  } while(--num_bits);
+
+  return ret;
+ }
+
+ INLINE unsigned BitTreeDecode(uint16* probs, const unsigned num_bits)
+ {
+  unsigned m = 1;
+
+  for(unsigned i = 0; i < num_bits; i++)
+   m = (m << 1) + DecodeBit(&probs[m]);
+
+  return m - (1U << num_bits);
+ }
+
+ INLINE unsigned BitTreeReverseDecode(uint16* probs, const unsigned num_bits)
+ {
+  unsigned m = 1;
+  unsigned ret = 0;
+
+  for(unsigned i = 0; i < num_bits; i++)
+  {
+   const unsigned bit = DecodeBit(&probs[m]);
+
+   m = (m << 1) + bit;
+   ret |= bit << i;
+  }
+
+  return ret;
+ }
+
+ INLINE uint32 DecodeLen(LenDecoder* ld, const unsigned pos_state)
+ {
+  if(!DecodeBit(&ld->Choice))
+   return BitTreeDecode(ld->Low[pos_state], 3);
+
+  if(!DecodeBit(&ld->Choice2))
+   return 8 + BitTreeDecode(ld->Mid[pos_state], 3);
+
+  return 16 + BitTreeDecode(ld->High, 8);
+ }
+
+ INLINE uint32 DecodeDistance(const uint32 len)
+ {
+  const unsigned pos_slot = BitTreeDecode(PosSlot[std::min<uint32>(len, 3)], 6);
+
+  if(pos_slot < 4)
+   return pos_slot;
+
+  const unsigned num_direct_bits = (pos_slot >> 1) - 1;
+  uint32 dist = (2 | (pos_slot & 1)) << num_direct_bits;
+
+  if(pos_slot < 14)
+   dist += BitTreeReverseDecode(PosDecoders + dist - pos_slot, num_direct_bits);
+  else
+  {
+   dist += DecodeDirectBits(num_direct_bits - 4) << 4;
+   dist += BitTreeReverseDecode(Align, 4);
+  }
+
+  return dist;
+ }
+};
+
+//
+// Decodes a sequence of bare FLAC frames(no "fLaC" marker or metadata blocks) of 16-bit stereo audio into 'sample_count'
+// big-endian interleaved sample frames.
+//
+// Returns the number of bytes of 'src' consumed.
+//
+static uint32 FLAC_DecodeFrames(const uint8* src, const uint32 src_len, uint8* dest, const uint32 sample_count, std::vector<int32>* scratch)
+{
+ CHDBitReader br(src, src_len);
+ uint32 done = 0;
+
+ auto Error = []() MDFN_COLD { throw MDFN_Error(0, _("FLAC decompression of CHD hunk failed.")); };
+
+ while(done < sample_count)
+ {
+  br.Align();
+
+  if(br.Read(15) != 0x7FFC)	// 14-bit sync, then a reserved 0 bit
+   Error();
+
+  br.Read(1);	// Blocking strategy
+  const unsigned bs_code = br.Read(4);
+  const unsigned sr_code = br.Read(4);
+  const unsigned ch_assign = br.Read(4);
+  const unsigned ss_code = br.Read(3);
+  br.Read(1);
+
+  // Frame/sample number, UTF-8-style coded.
+  {
+   const unsigned lead = br.Read(8);
+   unsigned extra = 0;
+
+   if(lead & 0x80)
+   {
+    extra = MDFN_lzcount32((~lead << 24) | 0xFFFFFF) - 1;
+
+    if(extra < 1 || extra > 6)
+     Error();
+   }
+
+   for(unsigned i = 0; i < extra; i++)
+   {
+    if((br.Read(8) & 0xC0) != 0x80)
+     Error();
+   }
+  }
+
+  uint32 block_size;
+
+  if(bs_code == 0)
+   Error();
+  else if(bs_code == 1)
+   block_size = 192;
+  else if(bs_code <= 5)
+   block_size = 576 << (bs_code - 2);
+  else if(bs_code == 6)
+   block_size = br.Read(8) + 1;
+  else if(bs_code == 7)
+   block_size = br.Read(16) + 1;
+  else
+   block_size = 256 << (bs_code - 8);
+
+  if(sr_code == 12)
+   br.Read(8);
+  else if(sr_code == 13 || sr_code == 14)
+   br.Read(16);
+  else if(sr_code == 15)
+   Error();
+
+  br.Read(8);	// CRC-8; the hunk CRC covers corruption.
+
+  if((ss_code != 0 && ss_code != 4) || (ch_assign != 1 && (ch_assign < 8 || ch_assign > 10)))
+   Error();
+
+  if(block_size > (sample_count - done))
+   Error();
+
+  if(scratch->size() < (block_size * 2))
+   scratch->resize(block_size * 2);
+
+  for(unsigned ch = 0; ch < 2; ch++)
+  {
+   int32* s = scratch->data() + ch * block_size;
+   unsigned bps = 16;
+
+   if((ch_assign == 8 && ch == 1) || (ch_assign == 9 && ch == 0) || (ch_assign == 10 && ch == 1))
+    bps++;
+
+   if(br.Read(1))
+    Error();
+
+   const unsigned type = br.Read(6);
+   unsigned wasted = 0;
+
+   if(br.Read(1))
+    wasted = br.ReadUnary() + 1;
+
+   if(wasted >= bps)
+    Error();
+
+   bps -= wasted;
+
+   if(type == 0)	// Constant
+   {
+    const int32 v = br.ReadSigned(bps);
+
+    for(uint32 i = 0; i < block_size; i++)
+     s[i] = v;
+   }
+   else if(type == 1)	// Verbatim
+   {
+    for(uint32 i = 0; i < block_size; i++)
+     s[i] = br.ReadSigned(bps);
+   }
+   else if((type >= 8 && type <= 12) || type >= 32)	// Fixed or LPC
+   {
+    const bool lpc = (type >= 32);
+    const unsigned order = lpc ? ((type & 0x1F) + 1) : (type - 8);
+    int32 coeffs[32];
+    unsigned precision = 0;
+    int shift = 0;
+
+    if(order > block_size)
+     Error();
+
+    for(unsigned i = 0; i < order; i++)
+     s[i] = br.ReadSigned(bps);
+
+    if(lpc)
+    {
+     precision = br.Read(4) + 1;
+     shift = br.ReadSigned(5);
+
+     if(precision == 16 || shift < 0)
+      Error();
+
+     for(unsigned i = 0; i < order; i++)
+      coeffs[i] = br.ReadSigned(precision);
+    }
+    //
+    // Residual
+    //
+    {
+     const unsigned method = br.Read(2);
+
+     if(method > 1)
+      Error();
+
+     const unsigned param_bits = method ? 5 : 4;
+     const unsigned escape = (1U << param_bits) - 1;
+     const unsigned part_order = br.Read(4);
+     const uint32 part_samples = block_size >> part_order;
+     uint32 i = order;
+
+     if((part_samples << part_order) != block_size || part_samples < order)
+      Error();
+
+     for(uint32 part = 0; part < (1U << part_order); part++)
+     {
+      const unsigned param = br.Read(param_bits);
+      const uint32 end = (part + 1) * part_samples;
+
+      if(param == escape)
+      {
+       const unsigned nbits = br.Read(5);
+
+       for(; i < end; i++)
+        s[i] = br.ReadSigned(nbits);
+      }
+      else
+      {
+       for(; i < end; i++)
+       {
+        const uint32 v = (br.ReadUnary() << param) | br.Read(param);
+
+        s[i] = (v >> 1) ^ -(int32)(v & 1);
+       }
+      }
+
+      if(br.Overrun())
+       Error();
+     }
+    }
+    //
+    // Prediction
+    //
+    if(lpc)
+    {
+     for(uint32 i = order; i < block_size; i++)
+     {
+      int64 sum = 0;
+
+      for(unsigned j = 0; j < order; j++)
+       sum += (int64)coeffs[j] * s[i - 1 - j];
+
+      s[i] += (int32)(sum >> shift);
+     }
+    }
+    else
+    {
+     switch(order)
+     {
+      case 0: break;
+      case 1: for(uint32 i = 1; i < block_size; i++) s[i] += s[i - 1]; break;
+      case 2: for(uint32 i = 2; i < block_size; i++) s[i] += 2 * s[i - 1] - s[i - 2]; break;
+      case 3: for(uint32 i = 3; i < block_size; i++) s[i] += 3 * s[i - 1] - 3 * s[i - 2] + s[i - 3]; break;
+      case 4: for(uint32 i = 4; i < block_size; i++) s[i] += 4 * s[i - 1] - 6 * s[i - 2] + 4 * s[i - 3] - s[i - 4]; break;
+     }
+    }
+   }
+   else
+    Error();
+
+   if(wasted)
+   {
+    for(uint32 i = 0; i < block_size; i++)
+     s[i] = (uint32)s[i] << wasted;
+   }
+  }
+  //
+  // Channel decorrelation and output
+  //
+  {
+   const int32* s0 = scratch->data();
+   const int32* s1 = scratch->data() + block_size;
+   uint8* d = dest + done * 4;
+
+   for(uint32 i = 0; i < block_size; i++)
+   {
+    int32 l = s0[i];
+    int32 r = s1[i];
+
+    if(ch_assign == 8)
+     r = l - r;
+    else if(ch_assign == 9)
+     l = l + r;
+    else if(ch_assign == 10)
+    {
+     const int32 mid = ((uint32)l << 1) | (r & 1);
+
+     l = (mid + r) >> 1;
+     r = (mid - r) >> 1;
+    }
+
+    MDFN_en16msb(d + 0, l);
+    MDFN_en16msb(d + 2, r);
+    d += 4;
+   }
+  }
+
+  br.Align();
+  br.Read(16);	// CRC-16
+
+  if(br.Overrun())
+   Error();
+
+  done += block_size;
+ }
+
+ return br.BytePos();
+}
+
+//
+// cdzl, cdzs, cdlz, cdfl
+//
+class CHDCodec_CD final : public CHDCodec
+{
+ public:
+
+ CHDCodec_CD(const uint32 fourcc)
+ {
+  flac = false;
+
+  switch(fourcc)
+  {
+   case CHD_MAKE_TAG('c','d','z','l'): base.reset(new CHDCodec_Zlib()); sub.reset(new CHDCodec_Zlib()); break;
+   case CHD_MAKE_TAG('c','d','z','s'): base.reset(new CHDCodec_Zstd()); sub.reset(new CHDCodec_Zstd()); break;
+   case CHD_MAKE_TAG('c','d','l','z'): base.reset(new CHDCodec_LZMA()); sub.reset(new CHDCodec_Zlib()); break;
+   case CHD_MAKE_TAG('c','d','f','l'): flac = true; sub.reset(new CHDCodec_Zlib()); break;
+  }
+ }
+
+ virtual void Decompress(const uint8* src, const uint32 src_len, uint8* dest, const uint32 dest_len) override
+ {
+  const uint32 frames = dest_len / CD_FRAME_SIZE;
+
+  if(buffer.size() < dest_len)
+   buffer.resize(dest_len);
+
+  if(flac)
+  {
+   const uint32 offs = FLAC_DecodeFrames(src, src_len, &buffer[0], frames * 2352 / 4, &flac_scratch);
+
+   if(offs > src_len)
+    Error();
+
+   sub->Decompress(src + offs, src_len - offs, &buffer[frames * 2352], frames * 96);
+   Reassemble(nullptr, frames, dest);
+  }
+  else
+  {
+   const uint32 ecc_bytes = (frames + 7) / 8;
+   const uint32 complen_bytes = (dest_len < 65536) ? 2 : 3;
+   const uint32 header_bytes = ecc_bytes + complen_bytes;
+   uint32 complen_base;
+
+   if(src_len < header_bytes)
+    Error();
+
+   complen_base = MDFN_de16msb(src + ecc_bytes);
+   if(complen_bytes > 2)
+    complen_base = (complen_base << 8) | src[ecc_bytes + 2];
+
+   if(complen_base > (src_len - header_bytes))
+    Error();
+
+   base->Decompress(src + header_bytes, complen_base, &buffer[0], frames * 2352);
+   sub->Decompress(src + header_bytes + complen_base, src_len - header_bytes - complen_base, &buffer[frames * 2352], frames * 96);
+   Reassemble(src, frames, dest);
+  }
+ }
+
+ private:
+
+ static MDFN_COLD NO_INLINE void Error(void)
+ {
+  throw MDFN_Error(0, _("CD decompression of CHD hunk failed."));
+ }
+
+ void Reassemble(const uint8* ecc_flags, const uint32 frames, uint8* dest)
+ {
+  static const uint8 sync[12] = { 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00 };
+
+  for(uint32 f = 0; f < frames; f++)
+  {
+   uint8* d = dest + f * CD_FRAME_SIZE;
+
+   memcpy(d, &buffer[f * 2352], 2352);
+   memcpy(d + 2352, &buffer[frames * 2352 + f * 96], 96);
+
+   // chdman strips the sync pattern and ECC of sectors whose ECC it can regenerate.
+   if(ecc_flags && (ecc_flags[f >> 3] & (1U << (f & 7))))
+   {
+    memcpy(d, sync, sizeof(sync));
+    lec_generate_ecc(d);
+   }
+  }
+ }
+
+ std::unique_ptr<CHDCodec> base;
+ std::unique_ptr<CHDCodec> sub;
+ bool flac;
+ std::vector<uint8> buffer;
+ std::vector<int32> flac_scratch;
+};
+
+static CHDCodec* CreateCodec(const uint32 fourcc)
+{
+ switch(fourcc)
+ {
+  case CHD_MAKE_TAG('z','l','i','b'):
+	return new CHDCodec_Zlib();
+
+  case CHD_MAKE_TAG('z','s','t','d'):
+	return new CHDCodec_Zstd();
+
+  case CHD_MAKE_TAG('l','z','m','a'):
+	return new CHDCodec_LZMA();
+
+  case CHD_MAKE_TAG('c','d','z','l'):
+  case CHD_MAKE_TAG('c','d','z','s'):
+  case CHD_MAKE_TAG('c','d','l','z'):
+  case CHD_MAKE_TAG('c','d','f','l'):
+	return new CHDCodec_CD(fourcc);
+ }
+
+ char fcc[5];
+
+ for(unsigned i = 0; i < 4; i++)
+ {
+  const char c = fourcc >> ((3 - i) * 8);
+
+  fcc[i] = (c >= 0x20 && c < 0x7F) ? c : '?';
+ }
+ fcc[4] = 0;
+
+ throw MDFN_Error(0, _("CHD compression codec \"%s\" is not supported."), fcc);
+}
+
+//
+// Huffman decoder for the compressed map; 16 codes, max 8 bits per code.
+//
+class CHDMapHuffman
+{
+ public:
+
+ void Import(CHDBitReader* br)
+ {
+  uint8 numbits[16];
+  unsigned cur = 0;
+
+  while(cur < 16)
+  {
+   unsigned nb = br->Read(4);
+
+   if(nb != 1)
+    numbits[cur++] = nb;
+   else
+   {
+    nb = br->Read(4);
+
+    if(nb == 1)
+     numbits[cur++] = nb;
+    else
+    {
+     unsigned rep = br->Read(4) + 3;
+
+     if((cur + rep) > 16)
+      Error();
+
+     while(rep--)
+      numbits[cur++] = nb;
+    }
+   }
+  }
+  //
+  // Assign canonical codes.
+  //
+  uint32 histo[33] = { 0 };
+  uint32 codes[16];
+
+  for(unsigned i = 0; i < 16; i++)
+  {
+   if(numbits[i] > 8)
+    Error();
+
+   histo[numbits[i]]++;
+  }
+
+  uint32 start = 0;
+
+  for(unsigned len = 32; len > 0; len--)
+  {
+   const uint32 next = (start + histo[len]) >> 1;
+
+   if(len != 1 && (next * 2) != (start + histo[len]))
+    Error();
+
+   histo[len] = start;
+   start = next;
+  }
+
+  for(unsigned i = 0; i < 16; i++)
+  {
+   if(numbits[i])
+    codes[i] = histo[numbits[i]]++;
+  }
+  //
+  // Build the lookup table.
+  //
+  memset(lut, 0, sizeof(lut));
+
+  for(unsigned i = 0; i < 16; i++)
+  {
+   if(numbits[i])
+   {
+    const unsigned shift = 8 - numbits[i];
+
+    for(uint32 j = codes[i] << shift; j < ((codes[i] + 1) << shift); j++)
+     lut[j] = (i << 4) | numbits[i];
+   }
+  }
+ }
+
+ INLINE unsigned Decode(CHDBitReader* br)
+ {
+  const uint8 l = lut[br->Peek64() >> 56];
+
+  br->Read(l & 0xF);
+
+  return l >> 4;
+ }
+
+ private:
+
+ static MDFN_COLD NO_INLINE void Error(void)
+ {
+  throw MDFN_Error(0, _("CHD hunk map is corrupt."));
+ }
+
+ uint8 lut[256];
+};
+
+CHDFile::CHDFile(Stream* stream, const uint64 cache_size) : fp(stream)
+{
+ uint8 header[124];
+
+ fp->rewind();
+
+ if(fp->read(header, sizeof(header), false) != sizeof(header) || memcmp(header, "MComprHD", 8))
+  throw MDFN_Error(0, _("Not a CHD file."));
+
+ const uint32 header_len = MDFN_de32msb(&header[8]);
+ const uint32 version = MDFN_de32msb(&header[12]);
+
+ if(version != 5)
+  throw MDFN_Error(0, _("CHD version %u is not supported; convert it to version 5 with a recent chdman."), version);
+
+ if(header_len < sizeof(header))
+  throw MDFN_Error(0, _("CHD header is corrupt."));
+
+ for(unsigned i = 0; i < 4; i++)
+  compressors[i] = MDFN_de32msb(&header[16 + i * 4]);
+
+ logical_bytes = MDFN_de64msb(&header[32]);
+ map_offset = MDFN_de64msb(&header[40]);
+ meta_offset = MDFN_de64msb(&header[48]);
+ hunk_bytes = MDFN_de32msb(&header[56]);
+ unit_bytes = MDFN_de32msb(&header[60]);
+
+ for(unsigned i = 0; i < 20; i++)
+ {
+  if(header[104 + i])
+   throw MDFN_Error(0, _("CHD files with a parent are not supported."));
+ }
+
+ if(!hunk_bytes || hunk_bytes > (1U << 24) || !unit_bytes || (hunk_bytes % unit_bytes))
+  throw MDFN_Error(0, _("CHD header is corrupt."));
+
+ {
+  const uint64 hc = (logical_bytes + hunk_bytes - 1) / hunk_bytes;
+
+  if(hc > 0x7FFFFFFF / 12)
+   throw MDFN_Error(0, _("CHD header is corrupt."));
+
+  hunk_count = hc;
+ }
+
+ for(unsigned i = 0; i < 4; i++)
+ {
+  if(compressors[i])
+   codecs[i].reset(CreateCodec(compressors[i]));
+ }
+
+ LoadMap();
+ //
+ //
+ cache_count = std::max<uint64>(4, std::min<uint64>(hunk_count, cache_size / hunk_bytes));
+ cache_data.reset(new uint8[(size_t)cache_count * hunk_bytes]);
+ cache_entries.reset(new CacheEntry[cache_count]);
+ cache_map.reserve(cache_count);
+ cache_used = 0;
+ cache_head = cache_tail = ~0U;
+}
+
+CHDFile::~CHDFile()
+{
+
+}
+
+void CHDFile::LoadMap(void)
+{
+ if(!compressors[0])
+ {
+  map.reset(new uint8[(size_t)hunk_count * 4]);
+  fp->seek(map_offset, SEEK_SET);
+  fp->read(map.get(), (size_t)hunk_count * 4);
+  return;
+ }
+
+ uint8 mh[16];
+
+ fp->seek(map_offset, SEEK_SET);
+ fp->read(mh, sizeof(mh));
+
+ const uint32 map_bytes = MDFN_de32msb(&mh[0]);
+ const uint64 first_offs = ((uint64)MDFN_de16msb(&mh[4]) << 32) | MDFN_de32msb(&mh[6]);
+ const uint16 map_crc = MDFN_de16msb(&mh[10]);
+ const unsigned length_bits = mh[12];
+ const unsigned self_bits = mh[13];
+ const unsigned parent_bits = mh[14];
+
+ if(length_bits > 32 || self_bits > 32 || parent_bits > 32 || map_bytes > (fp->size() - std::min<uint64>(fp->size(), map_offset + 16)))
+  throw MDFN_Error(0, _("CHD hunk map is corrupt."));
+
+ std::unique_ptr<uint8[]> cmap(new uint8[map_bytes]);
+
+ fp->read(cmap.get(), map_bytes);
+ map.reset(new uint8[(size_t)hunk_count * 12]);
+ //
+ CHDBitReader br(cmap.get(), map_bytes);
+ CHDMapHuffman huff;
+
+ huff.Import(&br);
+
+ // Compression types
+ {
+  uint8 last_comp = 0;
+  uint32 rep_count = 0;
+
+  for(uint32 h = 0; h < hunk_count; h++)
+  {
+   uint8* m = &map[h * 12];
+
+   if(rep_count)
+   {
+    m[0] = last_comp;
+    rep_count--;
+   }
+   else
+   {
+    const unsigned v = huff.Decode(&br);
+
+    if(v == CHD_COMP_RLE_SMALL)
+    {
+     m[0] = last_comp;
+     rep_count = 2 + huff.Decode(&br);
+    }
+    else if(v == CHD_COMP_RLE_LARGE)
+    {
+     m[0] = last_comp;
+     rep_count = 2 + 16 + (huff.Decode(&br) << 4);
+     rep_count += huff.Decode(&br);
+    }
+    else
+     m[0] = last_comp = v;
+   }
+  }
+ }
+
+ // Lengths, offsets, CRCs
+ {
+  uint64 cur_offs = first_offs;
+  uint64 last_self = 0;
+  uint64 last_parent = 0;
+
+  for(uint32 h = 0; h < hunk_count; h++)
+  {
+   uint8* m = &map[h * 12];
+   uint64 offs = cur_offs;
+   uint32 length = 0;
+   uint16 crc = 0;
+
+   switch(m[0])
+   {
+    case CHD_COMP_TYPE_0:
+    case CHD_COMP_TYPE_1:
+    case CHD_COMP_TYPE_2:
+    case CHD_COMP_TYPE_3:
+	length = br.Read(length_bits);
+	crc = br.Read(16);
+	cur_offs += length;
+	break;
+
+    case CHD_COMP_NONE:
+	length = hunk_bytes;
+	crc = br.Read(16);
+	cur_offs += length;
+	break;
+
+    case CHD_COMP_SELF:
+	last_self = offs = br.Read(self_bits);
+	break;
+
+    case CHD_COMP_PARENT:
+	last_parent = offs = br.Read(parent_bits);
+	break;
+
+    case CHD_COMP_SELF_1:
+	last_self++;
+    case CHD_COMP_SELF_0:
+	m[0] = CHD_COMP_SELF;
+	offs = last_self;
+	break;
+
+    case CHD_COMP_PARENT_SELF:
+	m[0] = CHD_COMP_PARENT;
+	last_parent = offs = ((uint64)h * hunk_bytes) / unit_bytes;
+	break;
+
+    case CHD_COMP_PARENT_1:
+	last_parent += hunk_bytes / unit_bytes;
+    case CHD_COMP_PARENT_0:
+	m[0] = CHD_COMP_PARENT;
+	offs = last_parent;
+	break;
+
+    default:
+	throw MDFN_Error(0, _("CHD hunk map is corrupt."));
+   }
+
+   MDFN_en24msb(&m[1], length);
+   MDFN_en16msb(&m[4], offs >> 32);
+   MDFN_en32msb(&m[6], offs);
+   MDFN_en16msb(&m[10], crc);
+  }
+ }
+
+ if(br.Overrun() || crc16_ccitt(0xFFFF, map.get(), (size_t)hunk_count * 12) != map_crc)
+  throw MDFN_Error(0, _("CHD hunk map is corrupt."));
+}
+
+bool CHDFile::GetMetadata(const uint32 tag, const uint32 index, std::vector<uint8>* data)
+{
+ uint64 offs = meta_offset;
+ uint32 count = 0;
+
+ for(unsigned guard = 0; offs && guard < 65536; guard++)
+ {
+  uint8 mh[16];
+
+  fp->seek(offs, SEEK_SET);
+  fp->read(mh, sizeof(mh));
+
+  const uint32 mtag = MDFN_de32msb(&mh[0]);
+  const uint32 length = MDFN_de32msb(&mh[4]) & 0xFFFFFF;
+
+  if(mtag == tag)
+  {
+   if(count == index)
+   {
+    data->resize(length);
+    if(length)
+     fp->read(data->data(), length);
+
+    return true;
+   }
+   count++;
+  }
+
+  offs = MDFN_de64msb(&mh[8]);
+ }
+
+ return false;
+}
+
+void CHDFile::DecompressHunk(const uint32 hunknum, uint8* dest, const unsigned depth)
+{
+ if(!compressors[0])
+ {
+  const uint64 offs = (uint64)MDFN_de32msb(&map[hunknum * 4]) * hunk_bytes;
+
+  if(!offs)
+   memset(dest, 0, hunk_bytes);
+  else
+  {
+   fp->seek(offs, SEEK_SET);
+   fp->read(dest, hunk_bytes);
+  }
+  return;
+ }
+ //
+ //
+ const uint8* m = &map[hunknum * 12];
+ const uint32 length = MDFN_de24msb(&m[1]);
+ const uint64 offs = ((uint64)MDFN_de16msb(&m[4]) << 32) | MDFN_de32msb(&m[6]);
+ const uint16 crc = MDFN_de16msb(&m[10]);
+
+ switch(m[0])
+ {
+  case CHD_COMP_TYPE_0:
+  case CHD_COMP_TYPE_1:
+  case CHD_COMP_TYPE_2:
+  case CHD_COMP_TYPE_3:
+	if(!codecs[m[0]])
+	 throw MDFN_Error(0, _("CHD hunk %u is corrupt."), hunknum);
+
+	if(comp_buf.size() < length)
+	 comp_buf.resize(length);
+
+	fp->seek(offs, SEEK_SET);
+	fp->read(comp_buf.data(), length);
+	codecs[m[0]]->Decompress(comp_buf.data(), length, dest, hunk_bytes);
+	break;
+
+  case CHD_COMP_NONE:
+	fp->seek(offs, SEEK_SET);
+	fp->read(dest, hunk_bytes);
+	break;
+
+  case CHD_COMP_SELF:
+	{
+	 auto it = cache_map.find(offs);
+
+	 if(offs >= hunk_count || offs == hunknum || depth >= 4)
+	  throw MDFN_Error(0, _("CHD hunk %u is corrupt."), hunknum);
+
+	 if(it != cache_map.end())
+	  memcpy(dest, &cache_data[(size_t)it->second * hunk_bytes], hunk_bytes);
+	 else
+	  DecompressHunk(offs, dest, depth + 1);
+	}
+	return;
+
+  default:
+	throw MDFN_Error(0, _("CHD hunk %u references a parent CHD, which is not supported."), hunknum);
+ }
+
+ if(crc16_ccitt(0xFFFF, dest, hunk_bytes) != crc)
+  throw MDFN_Error(0, _("CHD hunk %u is corrupt."), hunknum);
+}
+
+void CHDFile::CacheUnlink(const uint32 ei)
+{
+ CacheEntry* e = &cache_entries[ei];
+
+ if(e->prev != ~0U)
+  cache_entries[e->prev].next = e->next;
+ else
+  cache_head = e->next;
+
+ if(e->next != ~0U)
+  cache_entries[e->next].prev = e->prev;
+ else
+  cache_tail = e->prev;
+}
+
+void CHDFile::CachePushFront(const uint32 ei)
+{
+ CacheEntry* e = &cache_entries[ei];
+
+ e->prev = ~0U;
+ e->next = cache_head;
+
+ if(cache_head != ~0U)
+  cache_entries[cache_head].prev = ei;
+ else
+  cache_tail = ei;
+
+ cache_head = ei;
+}
+
+const uint8* CHDFile::ReadHunk(const uint32 hunknum)
+{
+ if(hunknum >= hunk_count)
+  throw MDFN_Error(0, _("CHD hunk %u is out of range."), hunknum);
+
+ {
+  auto it = cache_map.find(hunknum);
+
+  if(it != cache_map.end())
+  {
+   if(cache_head != it->second)
+   {
+    CacheUnlink(it->second);
+    CachePushFront(it->second);
+   }
+
+   return &cache_data[(size_t)it->second * hunk_bytes];
+  }
+ }
+ //
+ //
+ uint32 ei;
+
+ if(cache_used < cache_count)
+  ei = cache_used++;
+ else
+ {
+  ei = cache_tail;
+  CacheUnlink(ei);
+  cache_map.erase(cache_entries[ei].hunknum);
+ }
+
+ uint8* const ret = &cache_data[(size_t)ei * hunk_bytes];
+
+ try
+ {
+  DecompressHunk(hunknum, ret, 0);
+ }
+ catch(...)
+ {
+  // Put the entry back at the tail, unmapped, so it's reused first.
+  cache_entries[ei].hunknum = ~0U;
+  cache_entries[ei].prev = cache_tail;
+  cache_entries[ei].next = ~0U;
+  if(cache_tail != ~0U)
+   cache_entries[cache_tail].next = ei;
+  else
+   cache_head = ei;
+  cache_tail = ei;
+  throw;
+ }
+
+ cache_entries[ei].hunknum = hunknum;
+ CachePushFront(ei);
+ cache_map[hunknum] = ei;
+
+ return ret;
+}
+
+}
@@ -0,0 +1,110 @@
+/******************************************************************************/
+/* Mednafen - Multi-system Emulator                                           */
+/******************************************************************************/
+/* CHDFile.h - MAME CHD(v5) container reading
+**  Copyright (C) 2025 Mednafen Team
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public License
+** as published by the Free Software Foundation; either version 2
+** of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software Foundation, Inc.,
+** 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef __MDFN_CDROM_CHDFILE_H
+#define __MDFN_CDROM_CHDFILE_H
+
+#include <mednafen/Stream.h>
+
+#include <unordered_map>
+
+namespace Mednafen
+{
+
+#define CHD_MAKE_TAG(a, b, c, d) (((uint32)(uint8)(a) << 24) | ((uint32)(uint8)(b) << 16) | ((uint32)(uint8)(c) << 8) | ((uint32)(uint8)(d) << 0))
+
+class CHDCodec;
+
+//
+// Read-only access to the hunks and metadata of a version 5 CHD file.  Decompressed hunks are kept in a bounded LRU cache.
+//
+// Not thread-safe; in the CD code, only the thread that calls CDAccess::Read_Raw_Sector() and CDAccess::Prefetch() uses it.
+//
+class CHDFile
+{
+ public:
+
+ // Takes ownership of 'stream'.
+ CHDFile(Stream* stream, const uint64 cache_size = 8 * 1024 * 1024);
+ ~CHDFile();
+
+ INLINE uint32 GetHunkBytes(void) const { return hunk_bytes; }
+ INLINE uint32 GetHunkCount(void) const { return hunk_count; }
+ INLINE uint32 GetUnitBytes(void) const { return unit_bytes; }
+
+ //
+ // Returns a pointer to the decompressed data of hunk 'hunknum', which remains valid until the next call to ReadHunk().
+ //
+ // throws exceptions on errors.
+ //
+ const uint8* ReadHunk(const uint32 hunknum);
+
+ //
+ // Copies the data of the 'index'th(0-based) metadata entry with tag 'tag' into *data, and returns true, or returns false
+ // if there is no such entry.
+ //
+ bool GetMetadata(const uint32 tag, const uint32 index, std::vector<uint8>* data);
+
+ private:
+
+ void LoadMap(void);
+ void DecompressHunk(const uint32 hunknum, uint8* dest, const unsigned depth);
+
+ std::unique_ptr<Stream> fp;
+
+ uint32 compressors[4];
+ std::unique_ptr<CHDCodec> codecs[4];
+ uint64 logical_bytes;
+ uint64 map_offset;
+ uint64 meta_offset;
+ uint32 hunk_bytes;
+ uint32 hunk_count;
+ uint32 unit_bytes;
+
+ // 12 bytes per hunk: compression type, 24-bit length, 48-bit offset, and 16-bit CRC; all big-endian.
+ // (For uncompressed CHDs, 4 bytes per hunk: 32-bit offset in units of hunk_bytes)
+ std::unique_ptr<uint8[]> map;
+
+ std::vector<uint8> comp_buf;
+
+ //
+ // LRU cache; entries are linked from most recently used(cache_head) to least recently used(cache_tail).
+ //
+ struct CacheEntry
+ {
+  uint32 hunknum;
+  uint32 prev;
+  uint32 next;
+ };
+ std::unique_ptr<uint8[]> cache_data;
+ std::unique_ptr<CacheEntry[]> cache_entries;
+ std::unordered_map<uint32, uint32> cache_map;
+ uint32 cache_count;
+ uint32 cache_used;
+ uint32 cache_head;
+ uint32 cache_tail;
+
+ void CacheUnlink(const uint32 ei);
+ void CachePushFront(const uint32 ei);
+};
+
+}
+#endif
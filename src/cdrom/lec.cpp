@@ -478,6 +478,15 @@ static void calc_Q_parity(u_int8_t *sector)
   }
 }
 
+/* Calculates the P and Q parities for the sector as-is, without touching the
+ * header, sync pattern or EDC.
+ */
+void lec_generate_ecc(u_int8_t *sector)
+{
+  calc_P_parity(sector);
+  calc_Q_parity(sector);
+}
+
 /* Encodes a MODE 0 sector.
  * 'adr' is the current physical sector address
  * 'sector' must be 2352 byte wide
@@ -69,6 +69,12 @@ void lec_encode_mode2_form1_sector(u_int32_t adr, u_int8_t *sector);
  */
 void lec_encode_mode2_form2_sector(u_int32_t adr, u_int8_t *sector);
 
+/* Calculates P and Q parity for a sector, including whatever header
+ * data is present(i.e. the header is not cleared for mode 2 sectors).
+ * 'sector' must be 2352 byte wide.
+ */
+void lec_generate_ecc(u_int8_t *sector);
+
 /* Scrambles and byte swaps an encoded sector.
  * 'sector' must be 2352 byte wide.
  */
@@ -42,6 +42,9 @@ extern "C" {
 #define CPUTEST_FLAG_SSE4         0x0100 ///< Penryn SSE4.1 functions
 #define CPUTEST_FLAG_SSE42        0x0200 ///< Nehalem SSE4.2 functions
 #define CPUTEST_FLAG_AVX          0x4000 ///< AVX functions: requires OS support even if YMM registers aren't used
+#define CPUTEST_FLAG_FMA3         0x0400 ///< Haswell FMA3 functions (Mednafen addition)
+#define CPUTEST_FLAG_AVX2         0x0800 ///< Haswell AVX2 functions (Mednafen addition)
+#define CPUTEST_FLAG_AVX512       0x1000 ///< AVX-512 Foundation functions: requires OS support for the ZMM and opmask registers (Mednafen addition)
 
 #define CPUTEST_FLAG_CMOV	  0x8000 // CMOVcc support (Mednafen addition)
 
@@ -35,6 +35,16 @@
            "=c" (ecx), "=d" (edx)\
          : "0" (index));
 
+// Mednafen addition(for leaf 7):
+#define cpuid_count(index,subindex,eax,ebx,ecx,edx)\
+    __asm__ volatile\
+        ("mov %%"REG_b", %%"REG_S"\n\t"\
+         "cpuid\n\t"\
+         "xchg %%"REG_b", %%"REG_S\
+         : "=a" (eax), "=S" (ebx),\
+           "=c" (ecx), "=d" (edx)\
+         : "0" (index), "2" (subindex));
+
 #define xgetbv(index,eax,edx)                                   \
     __asm__ (".byte 0x0f, 0x01, 0xd0" : "=a"(eax), "=d"(edx) : "c" (index))
 
@@ -106,8 +116,26 @@ int ff_get_cpu_flags_x86(void)
         if ((ecx & 0x18000000) == 0x18000000) {
             /* Check for OS support */
             xgetbv(0, eax, edx);
-            if ((eax & 0x6) == 0x6)
+            if ((eax & 0x6) == 0x6) {
                 rval |= CPUTEST_FLAG_AVX;
+
+                // Mednafen addition(fma3, avx2, avx512):
+                if (ecx & 0x00001000)
+                    rval |= CPUTEST_FLAG_FMA3;
+
+                if (max_std_level >= 7) {
+                    const int xcr0 = eax;
+
+                    cpuid_count(7, 0, eax, ebx, ecx, edx);
+
+                    if (ebx & 0x00000020)
+                        rval |= CPUTEST_FLAG_AVX2;
+
+                    /* Check for OS support of the opmask and upper ZMM state */
+                    if ((ebx & 0x00010000) && (xcr0 & 0xE0) == 0xE0)
+                        rval |= CPUTEST_FLAG_AVX512;
+                }
+            }
         }
 //#endif
 //#endif
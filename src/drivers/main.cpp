@@ -885,6 +885,10 @@ static bool DoArgs(int argc, char *argv[], char **filename)
 	char *cdtestpath = NULL;
 	int swiftresamptest = 0;
 	int owlresamptest = 0;
+	int owlresampbench = 0;
+	int eventqueuebench = 0;
+	int psxspantest = 0;
+	int ssdsptest = 0;
 	int vidbench = 0;
 	#ifdef WANT_SS_EMU
 	int ss_midsync;
@@ -941,6 +945,18 @@ static bool DoArgs(int argc, char *argv[], char **filename)
 	 // OwlResampler test.
 	 { "owlresamptest", NULL, &owlresamptest, 0, 0 },
 
+	 // OwlResampler MAC kernel throughput benchmark.
+	 { "owlresampbench", NULL, &owlresampbench, 0, 0 },
+
+	 // EventQueue vs. linked list event scheduling benchmark.
+	 { "eventqueuebench", NULL, &eventqueuebench, 0, 0 },
+
+	 // PS1 GPU SIMD vs. per-pixel polygon span drawing differential test.
+	 { "psxspantest", NULL, &psxspantest, 0, 0 },
+
+	 // Saturn SCSP DSP NOP skipping vs. running all steps differential test.
+	 { "ssdsptest", NULL, &ssdsptest, 0, 0 },
+
 	 { "vidbench", NULL, &vidbench, 0, 0 },
 
 	 #ifdef WANT_SS_EMU
@@ -1002,6 +1018,18 @@ static bool DoArgs(int argc, char *argv[], char **filename)
 	 if(owlresamptest)
 	  MDFNI_RunOwlResamplerTest();
 
+	 if(owlresampbench)
+	  MDFNI_RunOwlResamplerBenchmark();
+
+	 if(eventqueuebench)
+	  MDFNI_RunEventQueueBenchmark();
+
+	 if(psxspantest)
+	  MDFNI_RunPSXSpanTest();
+
+	 if(ssdsptest)
+	  MDFNI_RunSSDSPTest();
+
 	 if(vidbench)
 	  MDFN_RunVideoBenchmarks();
 
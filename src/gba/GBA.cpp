@@ -3391,5 +3391,6 @@ MDFN_HIDE extern const MDFNGI EmulatedGBA =
  160,	// Framebuffer height
 
  2,	// Number of output sound channels
+ true,	// Honors EmulateSpecStruct::skip
 };
 
@@ -715,6 +715,10 @@ struct MDFNGI
  int fb_height;		// Height of the framebuffer passed to the Emulate() function(not necessarily height of the image)
 
  int soundchan; 	// Number of output sound channels.  Only values of 1 and 2 are currently supported.
+
+ // true if the Emulate() function honors EmulateSpecStruct::skip by skipping(most of) the video rendering work.  Advisory, for the driver
+ // side to decide whether frame skipping or run-ahead are cheap.
+ bool SkipHonored;
  //
  //
  //
@@ -501,5 +501,6 @@ MDFN_HIDE extern const MDFNGI EmulatedLynx =
  102,	// Framebuffer height
 
  2,     // Number of output sound channels
+ true,  // Honors EmulateSpecStruct::skip
 };
 
@@ -141,6 +141,13 @@ bool MDFNI_SaveSettingsCompact(Stream* s);
 // Call multiple times after MDFNI_LoadGame() and before MDFNI_CloseGame()
 void MDFNI_Emulate(EmulateSpecStruct *espec);
 
+// Emulates a frame like MDFNI_Emulate(), then emulates "frames" more frames ahead with the same input, outputting the video of the last
+// one to espec, and then restores the emulation state to where it was after the first frame.  The sound output is that of the first frame only.
+//
+// Reduces the perceived input latency by "frames" frames, at the cost of the CPU time needed to emulate them.  Falls back to MDFNI_Emulate()
+// if "frames" is 0 or during netplay.  Doesn't allocate memory after the first call, unless espec->SoundBufMaxSize increases.
+void MDFNI_EmulateRunAhead(EmulateSpecStruct *espec, const unsigned frames);
+
 #if 0
 /* Support function for scaling multiple-horizontal-resolution frames to a single width; mostly intended for unofficial ports.
    The driver code really ought to handle multi-horizontal-resolution frames natively and properly itself, however.
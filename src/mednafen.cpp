@@ -46,6 +46,7 @@
 #include "state.h"
 #include "movie.h"
 #include "state_rewind.h"
+#include "state_async.h"
 #include "video.h"
 #include "video/Deinterlacer.h"
 #include "file.h"
@@ -95,6 +96,34 @@ static const MDFNSetting_EnumList Deinterlacer_List[] =
  { NULL, 0 },
 };
 
+static const MDFNSetting_EnumList StateCompType_List[] =
+{
+ { "none", MDFNSS_COMP_NONE, gettext_noop("None"),
+	gettext_noop("Fastest to save and load, but save states will be large.") },
+
+ { "zstd", MDFNSS_COMP_ZSTD, "Zstandard",
+	gettext_noop("Fast compression with a decent ratio; much cheaper than gzip for the large save states of systems like the PlayStation and Saturn.") },
+
+ { "gzip", MDFNSS_COMP_GZIP, "gzip",
+	gettext_noop("Compressed with the level specified by the \"filesys.state_comp_level\" setting.") },
+
+ { NULL, 0 },
+};
+
+static const MDFNSetting_EnumList SRWCompressor_List[] =
+{
+ { "none", SRW_COMP_NONE, gettext_noop("None"),
+	gettext_noop("Only the changed blocks are stored, uncompressed.") },
+
+ { "quicklz", SRW_COMP_QUICKLZ, "QuickLZ",
+	gettext_noop("Very fast, with a lower compression ratio.") },
+
+ { "zstd", SRW_COMP_ZSTD, "Zstandard",
+	gettext_noop("Zstandard at level 1; a bit slower than QuickLZ, but fits considerably more states in the \"srwbudget\" memory budget.  Falls back to QuickLZ if Mednafen was built without an external libzstd.") },
+
+ { NULL, 0 },
+};
+
 static const char* const fname_extra = gettext_noop("See fname_format.txt for more information.  Edit at your own risk.");
 
 static const MDFNSetting MednafenSettings[] =
@@ -106,8 +135,19 @@ static const MDFNSetting MednafenSettings[] =
 
   { "srwframes", MDFNSF_NOFLAGS, gettext_noop("Number of frames to keep states for when state rewinding is enabled."), 
 	gettext_noop("Caution: Setting this to a large value may cause excessive RAM usage in some circumstances, such as with games that stream large volumes of data off of CDs."), MDFNST_UINT, "600", "10", "99999" },
+  { "srwbudget", MDFNSF_NOFLAGS, gettext_noop("Memory budget, in MiB, for states kept when state rewinding is enabled."),
+	gettext_noop("The memory is allocated in one go when state rewinding is enabled, and the oldest states are discarded once it's full, regardless of the \"srwframes\" setting."), MDFNST_UINT, "64", "1", "4096" },
+  { "srwinterval", MDFNSF_NOFLAGS, gettext_noop("Number of frames between states kept when state rewinding is enabled."),
+	gettext_noop("Values above 1 reduce the CPU usage of state rewinding, which can be significant with systems that have large save states, like the PlayStation and Saturn, and make the memory budget last longer, at the cost of rewinding in coarser steps."), MDFNST_UINT, "1", "1", "60" },
+  { "srwcompressor", MDFNSF_NOFLAGS, gettext_noop("Compressor for states kept when state rewinding is enabled."), NULL, MDFNST_ENUM, "quicklz", NULL, NULL, NULL, NULL, SRWCompressor_List },
+
+  { "runahead", MDFNSF_NOFLAGS, gettext_noop("Number of frames to run ahead."),
+	gettext_noop("Reduces input latency by this many frames, by emulating that many frames ahead each frame, presenting the last one, and then restoring the emulation state.  Games that react to input with a delay will appear to react sooner, but the CPU usage will increase proportionally, especially with emulation modules that don't honor frame skipping.  Disabled during netplay."), MDFNST_UINT, "0", "0", "8" },
+
+  { "resamp_avx512", MDFNSF_NOFLAGS, gettext_noop("Use the AVX-512 OwlResampler kernel."),
+	gettext_noop("The AVX-512 kernel is somewhat faster than the default AVX2/FMA kernel, but on some CPUs(e.g. Skylake-X) running 512-bit instructions lowers the clock speed of the whole core for a while afterward, which can slow down emulation more than the resampler is sped up.  Only has an effect on CPUs with AVX-512 support, with emulated systems that use OwlResampler(e.g. PC Engine, PC-FX)."), MDFNST_BOOL, "0" },
 
-  { "cd.image_memcache", MDFNSF_NOFLAGS, gettext_noop("Cache entire CD images in memory."), gettext_noop("Reads the entire CD image(s) into memory at startup(which will cause a small delay).  Can help obviate emulation hiccups due to emulated CD access.  May cause more harm than good on low memory systems, systems with swap enabled, and/or when the disc images in question are on a fast SSD.\n\nCaution: When using a 32-bit build of Mednafen on Windows or a 32-bit operating system, Mednafen may run out of address space(and error out, possibly in the middle of emulation) if this option is enabled when loading large disc sets(e.g. 3+ discs) via M3U files."), MDFNST_BOOL, "0" },
+  { "cd.image_memcache", MDFNSF_NOFLAGS, gettext_noop("Cache entire CD images in memory."), gettext_noop("Reads the entire CD image(s) into memory at startup(which will cause a small delay).  Can help obviate emulation hiccups due to emulated CD access.  May cause more harm than good on low memory systems, systems with swap enabled, and/or when the disc images in question are on a fast SSD.  When disabled, binary CD image files are memory-mapped instead where supported(64-bit builds only), so only the parts of the images actually read are loaded into memory.\n\nCaution: When using a 32-bit build of Mednafen on Windows or a 32-bit operating system, Mednafen may run out of address space(and error out, possibly in the middle of emulation) if this option is enabled when loading large disc sets(e.g. 3+ discs) via M3U files."), MDFNST_BOOL, "0" },
   { "cd.m3u.recursion_limit", MDFNSF_NOFLAGS, gettext_noop("M3U recursion limit."), gettext_noop("A value of 0 effectively disables recursive loading of M3U files."), MDFNST_UINT, "9", "0", "99" },
   { "cd.m3u.disc_limit", MDFNSF_NOFLAGS, gettext_noop("M3U total number of disc images limit."), NULL, MDFNST_UINT, "25", "1", "999" },
   { "filesys.untrusted_fip_check", MDFNSF_NOFLAGS, gettext_noop("Enable untrusted file-inclusion path security check."),
@@ -132,6 +172,7 @@ static const MDFNSetting MednafenSettings[] =
   { "filesys.old_gz_naming", MDFNSF_SUPPRESS_DOC, gettext_noop("Enable old handling of .gz file extensions with respect to data file path construction."), NULL, MDFNST_BOOL, "0" },
 
   { "filesys.state_comp_level", MDFNSF_NOFLAGS, gettext_noop("Save state file compression level."), gettext_noop("gzip/deflate compression level for save states saved to files.  -1 will disable gzip compression and wrapping entirely."), MDFNST_INT, "6", "-1", "9" },
+  { "filesys.state_comp_type", MDFNSF_NOFLAGS, gettext_noop("Save state file compression type."), NULL, MDFNST_ENUM, "gzip", NULL, NULL, NULL, NULL, StateCompType_List },
 
 
   { "qtrecord.w_double_threshold", MDFNSF_NOFLAGS, gettext_noop("Double the raw image's width if it's below this threshold."), NULL, MDFNST_UINT, "384", "0", "1073741824" },
@@ -289,6 +330,14 @@ static std::unique_ptr<Deinterlacer> deint;
 
 static bool FFDiscard = false; // TODO:  Setting to discard sound samples instead of increasing pitch
 
+//
+// Run-ahead; the buffers are kept around between frames so that MDFNI_EmulateRunAhead() doesn't need to allocate memory after the first call.
+//
+static std::unique_ptr<MemoryStream> RunAheadState;
+static std::unique_ptr<int16[]> RunAheadSoundBuf;
+static int32 RunAheadSoundBufMaxSize = 0;
+static bool InRunAhead = false;
+
 static std::vector<CDInterface *> CDInterfaces;
 
 struct DriveMediaStatus
@@ -399,8 +448,13 @@ void MDFNI_StopWAVRecord(void)
 
 static MDFN_COLD void Cleanup(void)
 {
+ MDFNSS_EndAsyncSaves();
+ MDFNSS_EndZstdThreads();
  MDFNSRW_End();
  MDFNMOV_Stop();
+ RunAheadState.reset(nullptr);
+ RunAheadSoundBuf.reset(nullptr);
+ RunAheadSoundBufMaxSize = 0;
  MDFNMP_Kill();
  TBlur_Kill();
 
@@ -656,6 +710,7 @@ static const std::vector<FileExtensionSpecStruct> KnownCDExtensions =
  // M3U must be highest.
  { ".m3u", -40, "M3U" },
  { ".ccd", -50, "CloneCD" },
+ { ".chd", -55, "MAME CHD" },
  { ".cue", -60, "CUE" },
  { ".toc", -70, "cdrdao TOC" },
 };
@@ -1847,6 +1902,14 @@ static void ProcessAudio(EmulateSpecStruct *espec)
 
 void MDFN_MidSync(EmulateSpecStruct *espec, const unsigned flags)
 {
+ // Sound and input from run-ahead frames must not leak out to the driver side.
+ if(MDFN_UNLIKELY(InRunAhead))
+ {
+  espec->SoundBufSize_InternalProcessed = espec->SoundBufSize;
+  espec->MasterCycles_InternalProcessed = espec->MasterCycles;
+  return;
+ }
+
  ProcessAudio(espec);
  espec->SoundBufSize_InternalProcessed = espec->SoundBufSize;
  espec->MasterCycles_InternalProcessed = espec->MasterCycles;
@@ -1874,7 +1937,31 @@ void MDFN_MidLineUpdate(EmulateSpecStruct *espec, int y)
  //MDFND_MidLineUpdate(espec, y);
 }
 
-void MDFNI_Emulate(EmulateSpecStruct *espec)
+static void DeinterlaceVideo(EmulateSpecStruct* espec)
+{
+ if(espec->InterlaceOn)
+ {
+  if(!PrevInterlaced)
+   deint->ClearState();
+
+  deint->Process(espec->surface, espec->DisplayRect, espec->LineWidths, espec->InterlaceField);
+  PrevInterlaced = true;
+ }
+ else
+  PrevInterlaced = false;
+}
+
+static void BlurVideo(EmulateSpecStruct* espec)
+{
+ if(TBlur_IsOn())
+  TBlur_Run(espec);
+}
+
+//
+// "present" is false for the frame MDFNI_EmulateRunAhead() emulates before running ahead, whose video is never shown; the
+// deinterlacer and temporal blur are then left for the frame that is shown.
+//
+static void EmulateFrame(EmulateSpecStruct *espec, const bool present)
 {
 #if 0
  {
@@ -1939,7 +2026,7 @@ void MDFNI_Emulate(EmulateSpecStruct *espec)
  if(qtrecorder)
   espec->skip = 0;
 
- if(TBlur_IsOn())
+ if(TBlur_IsOn() && present)
   espec->skip = 0;
 
  if(espec->NeedRewind)
@@ -2018,16 +2105,8 @@ void MDFNI_Emulate(EmulateSpecStruct *espec)
  //
  //
 
- if(espec->InterlaceOn)
- {
-  if(!PrevInterlaced)
-   deint->ClearState();
-
-  deint->Process(espec->surface, espec->DisplayRect, espec->LineWidths, espec->InterlaceField);
-  PrevInterlaced = true;
- }
- else
-  PrevInterlaced = false;
+ if(present)
+  DeinterlaceVideo(espec);
 
  ProcessAudio(espec);
 
@@ -2059,8 +2138,106 @@ void MDFNI_Emulate(EmulateSpecStruct *espec)
   espec->SoundBufSize = sbs_backup;
  }
 
- if(TBlur_IsOn())
-  TBlur_Run(espec);
+ if(present)
+  BlurVideo(espec);
+}
+
+void MDFNI_Emulate(EmulateSpecStruct *espec)
+{
+ EmulateFrame(espec, true);
+}
+
+void MDFNI_EmulateRunAhead(EmulateSpecStruct* espec, const unsigned frames)
+{
+ if(!frames || MDFNnetplay || !MDFNGameInfo->StateAction)
+ {
+  MDFNI_Emulate(espec);
+  return;
+ }
+ //
+ //
+ const int skip_save = espec->skip;
+ bool need_restore = false;
+
+ espec->skip = true;
+ EmulateFrame(espec, false);
+ espec->skip = skip_save;
+
+ try
+ {
+  if(!RunAheadState)
+   RunAheadState.reset(new MemoryStream(65536));
+
+  RunAheadState->rewind();
+  MDFNSS_SaveSM(RunAheadState.get(), true);
+  need_restore = true;
+
+  if(espec->SoundBuf && RunAheadSoundBufMaxSize < espec->SoundBufMaxSize)
+  {
+   RunAheadSoundBuf.reset(new int16[espec->SoundBufMaxSize * MDFNGameInfo->soundchan]);
+   RunAheadSoundBufMaxSize = espec->SoundBufMaxSize;
+  }
+
+  EmulateSpecStruct ra = *espec;
+
+  InRunAhead = true;
+  for(unsigned i = 0; i < frames; i++)
+  {
+   ra.VideoFormatChanged = false;
+   ra.SoundFormatChanged = false;
+   ra.DisplayRect = { 0, 0, 0, 0 };
+   ra.InterlaceOn = false;
+   ra.InterlaceField = false;
+   ra.skip = (i == (frames - 1)) ? (skip_save && !TBlur_IsOn()) : true;
+   ra.SoundBuf = espec->SoundBuf ? RunAheadSoundBuf.get() : nullptr;
+   ra.SoundBufSize = 0;
+   ra.SoundBufSize_InternalProcessed = 0;
+   ra.SoundBufSize_DriverProcessed = 0;
+   ra.MasterCycles = 0;
+   ra.MasterCycles_InternalProcessed = 0;
+   ra.MasterCycles_DriverProcessed = 0;
+   ra.NeedRewind = false;
+   ra.NeedSoundReverse = false;
+
+   MDFNGameInfo->Emulate(&ra);
+  }
+  InRunAhead = false;
+
+  DeinterlaceVideo(&ra);
+  BlurVideo(&ra);
+
+  if(!ra.skip)
+  {
+   espec->DisplayRect = ra.DisplayRect;
+   espec->InterlaceOn = ra.InterlaceOn;
+   espec->InterlaceField = ra.InterlaceField;
+  }
+
+  RunAheadState->rewind();
+  MDFNSS_LoadSM(RunAheadState.get(), true);
+  need_restore = false;
+ }
+ catch(std::exception& e)
+ {
+  InRunAhead = false;
+  MDFN_Notify(MDFN_NOTICE_ERROR, _("Run-ahead error: %s"), e.what());
+
+  //
+  // Don't leave emulation "frames" frames ahead of where it should be.
+  //
+  if(need_restore)
+  {
+   try
+   {
+    RunAheadState->rewind();
+    MDFNSS_LoadSM(RunAheadState.get(), true);
+   }
+   catch(std::exception& re)
+   {
+    MDFN_Notify(MDFN_NOTICE_ERROR, _("Run-ahead state restore error: %s"), re.what());
+   }
+  }
+ }
 }
 
 static void StateAction_RINP(StateMem* sm, const unsigned load, const bool data_only)
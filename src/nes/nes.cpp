@@ -791,4 +791,5 @@ MDFN_HIDE extern const MDFNGI EmulatedNES =
  240,	// Framebuffer height
 
  1,     // Number of output sound channels
+ true,  // Honors EmulateSpecStruct::skip
 };
@@ -439,5 +439,6 @@ MDFN_HIDE extern const MDFNGI EmulatedNGP =
  152,	// Framebuffer height
 
  2,     // Number of output sound channels
+ true,  // Honors EmulateSpecStruct::skip
 };
 
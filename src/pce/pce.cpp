@@ -1263,5 +1263,6 @@ MDFN_HIDE extern const MDFNGI EmulatedPCE =
  270,	// Framebuffer height(TODO: decrease to 264(263 + spillover line))
 
  2,     // Number of output sound channels
+ true,  // Honors EmulateSpecStruct::skip
 };
 
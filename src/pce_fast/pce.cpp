@@ -744,5 +744,6 @@ MDFN_HIDE extern const MDFNGI EmulatedPCE_Fast =
  242,	// Framebuffer height
 
  2,     // Number of output sound channels
+ true,  // Honors EmulateSpecStruct::skip
 };
 
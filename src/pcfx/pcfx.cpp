@@ -1205,5 +1205,6 @@ MDFN_HIDE extern const MDFNGI EmulatedPCFX =
  512,	// Framebuffer height
 
  2,     // Number of output sound channels
+ true,  // Honors EmulateSpecStruct::skip
 };
 
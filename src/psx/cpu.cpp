@@ -61,6 +61,15 @@ PS_CPU::PS_CPU()
  CPUHook = NULL;
  ADDBT = NULL;
 
+ CachedInterp = false;
+ DecodedBlockEpoch = 0;
+ for(auto& db : DecodedBlocks)
+ {
+  db.PC = 0x1;
+  db.Epoch = 0;
+  db.Count = 0;
+ }
+
  GTE_Init();
 
  for(unsigned i = 0; i < 24; i++)
@@ -152,6 +161,7 @@ void PS_CPU::Power(void)
   ICache[i].TV = 0x2 | ((BIU & 0x800) ? 0x0 : 0x1);
   ICache[i].Data = 0;
  }
+ InvalidateDecodedBlocks();
 
  GTE_Power();
 }
@@ -219,6 +229,8 @@ void PS_CPU::StateAction(StateMem *sm, const unsigned load, const bool data_only
   ReadAbsorbWhich &= 0x1F;
   BACKED_LDWhich %= 0x21;
 
+  InvalidateDecodedBlocks();
+
   //printf("PC=0x%08x, new_PC=0x%08x, BDBT=0x%02x\n", BACKED_PC, BACKED_new_PC, BDBT);
  }
 }
@@ -253,6 +265,8 @@ void PS_CPU::SetBIU(uint32 val)
    for(unsigned i = 0; i < 1024; i++)
     ICache[i].TV |= 0x1;
   }
+
+  InvalidateDecodedBlocks();
  }
 
  PSX_DBG(PSX_DBG_CPU, "[CPU] Set BIU=0x%08x\n", BIU);
@@ -422,6 +436,8 @@ INLINE void PS_CPU::WriteMemory(pscpu_timestamp_t &timestamp, uint32 address, ui
  {
   if(BIU & BIU_ENABLE_ICACHE_S1)	// Instruction cache is enabled/active
   {
+   InvalidateDecodedBlocks();
+
    if(BIU & (BIU_TAG_TEST_MODE | BIU_INVALIDATE_MODE | BIU_LOCK_MODE))
    {
     const uint8 valid_bits = (BIU & BIU_TAG_TEST_MODE) ? ((value << ((address & 0x3) * 8)) & 0x0F) : 0x00;
@@ -470,6 +486,7 @@ INLINE void PS_CPU::WriteMemory(pscpu_timestamp_t &timestamp, uint32 address, ui
 // Fill size of 2-words seems to work on a PS1, and even behaves as if the line size is 2 words in regards to clearing
 // the valid bits(when the tag matches, of course), but is obviously not very efficient unless running code that's just endless branching.
 //
+template<bool CachedMode>
 INLINE uint32 PS_CPU::ReadInstruction(pscpu_timestamp_t &timestamp, uint32 address)
 {
  uint32 instr;
@@ -491,6 +508,9 @@ INLINE uint32 PS_CPU::ReadInstruction(pscpu_timestamp_t &timestamp, uint32 addre
    __ICache *ICI = &ICache[((address & 0xFF0) >> 2)];
    const uint8 *FMP = (uint8*)(FastMap[(address & 0xFFFFFFF0) >> FAST_MAP_SHIFT] + (address & 0xFFFFFFF0));
 
+   if(CachedMode)
+    InvalidateDecodedBlocksForLine(address);
+
    // | 0x2 to simulate (in)validity bits.
    ICI[0x00].TV = (address & 0xFFFFFFF0) | 0x0 | 0x2;
    ICI[0x01].TV = (address & 0xFFFFFFF0) | 0x4 | 0x2;
@@ -526,6 +546,69 @@ INLINE uint32 PS_CPU::ReadInstruction(pscpu_timestamp_t &timestamp, uint32 addre
  return instr;
 }
 
+void PS_CPU::InvalidateDecodedBlocks(void)
+{
+ DecodedBlockEpoch++;
+
+ if(MDFN_UNLIKELY(!DecodedBlockEpoch))
+ {
+  for(auto& db : DecodedBlocks)
+   db.PC = 0x1;
+ }
+}
+
+//
+// Returns NULL if the instruction at PC isn't in the instruction cache.
+//
+NO_INLINE const PS_CPU::DecodedBlock* PS_CPU::BuildDecodedBlock(const uint32 PC)
+{
+ DecodedBlock* db = &DecodedBlocks[(PC & 0xFFC) >> 2];
+ uint32 A = PC;
+ bool delay_slot = false;
+
+ db->PC = 0x1;
+ db->Epoch = DecodedBlockEpoch;
+ db->Count = 0;
+
+ while(db->Count < DecodedBlock_MaxInstrs && ICache[(A & 0xFFC) >> 2].TV == A)
+ {
+  const uint32 instr = ICache[(A & 0xFFC) >> 2].Data;
+  uint32 opf = instr & 0x3F;
+
+  if(instr & (0x3F << 26))
+   opf = 0x40 | (instr >> 26);
+
+  db->Instrs[db->Count].instr = instr;
+  db->Instrs[db->Count].opf = opf;
+  db->Count++;
+  A += 4;
+
+  if(delay_slot)
+   break;
+
+  switch(opf)
+  {
+   // JR, JALR, BCOND, J, JAL, BEQ, BNE, BLEZ, BGTZ
+   case 0x08: case 0x09: case 0x41: case 0x42: case 0x43: case 0x44: case 0x45: case 0x46: case 0x47:
+	delay_slot = true;
+	break;
+  }
+ }
+
+ if(!db->Count)
+  return NULL;
+
+ db->PC = PC;
+
+ return db;
+}
+
+void PS_CPU::SetCachedInterpreter(bool enabled)
+{
+ CachedInterp = enabled;
+ InvalidateDecodedBlocks();
+}
+
 uint32 NO_INLINE PS_CPU::Exception(uint32 code, uint32 PC, const uint32 NP, const uint32 instr)
 {
  uint32 handler = 0x80000080;
@@ -596,7 +679,7 @@ uint32 NO_INLINE PS_CPU::Exception(uint32 code, uint32 PC, const uint32 NP, cons
 #define GPR_RES(n) { unsigned tn = (n); ReadAbsorb[tn] = 0; }
 #define GPR_DEPRES_END ReadAbsorb[0] = back; }
 
-template<bool DebugMode, bool BIOSPrintMode, bool ILHMode>
+template<bool DebugMode, bool BIOSPrintMode, bool ILHMode, bool CachedMode>
 pscpu_timestamp_t PS_CPU::RunReal(pscpu_timestamp_t timestamp_in)
 {
  pscpu_timestamp_t timestamp = timestamp_in;
@@ -605,6 +688,12 @@ pscpu_timestamp_t PS_CPU::RunReal(pscpu_timestamp_t timestamp_in)
  uint32 new_PC;
  uint32 LDWhich;
  uint32 LDValue;
+
+ // Cached interpreter; the next instruction in the current block is used when PC == DB_PC, and no invalidation has occurred since the block was entered.
+ const DecodedInstr* DB_Next = NULL;
+ uint32 DB_PC = 0x1;
+ uint32 DB_EndPC = 0x1;
+ uint32 DB_Epoch = 0;
  
  //printf("%d %d\n", gte_ts_done, muldiv_ts_done);
 
@@ -663,25 +752,64 @@ pscpu_timestamp_t PS_CPU::RunReal(pscpu_timestamp_t timestamp_in)
    //
    // Instruction fetch
    //
-   if(MDFN_UNLIKELY(PC & 0x3))
+   if(CachedMode && MDFN_LIKELY(PC == DB_PC && DB_Epoch == DecodedBlockEpoch))
    {
-    // This will block interrupt processing, but since we're going more for keeping broken homebrew/hacks from working
-    // than super-duper-accurate pipeline emulation, it shouldn't be a problem.
-    CP0.BADA = PC;
-    new_PC = Exception(EXCEPTION_ADEL, PC, new_PC, 0);
-    goto OpDone;
+    instr = DB_Next->instr;
+    opf = DB_Next->opf;
+    DB_Next++;
+    DB_PC += 4;
+
+    if(DB_PC == DB_EndPC)
+     DB_PC = 0x1;
    }
+   else
+   {
+    if(MDFN_UNLIKELY(PC & 0x3))
+    {
+     // This will block interrupt processing, but since we're going more for keeping broken homebrew/hacks from working
+     // than super-duper-accurate pipeline emulation, it shouldn't be a problem.
+     CP0.BADA = PC;
+     new_PC = Exception(EXCEPTION_ADEL, PC, new_PC, 0);
+     goto OpDone;
+    }
 
-   instr = ReadInstruction(timestamp, PC);
+    const DecodedBlock* db = NULL;
 
+    if(CachedMode)
+    {
+     db = &DecodedBlocks[(PC & 0xFFC) >> 2];
 
-   // 
-   // Instruction decode
-   //
-   opf = instr & 0x3F;
+     if(db->PC != PC || db->Epoch != DecodedBlockEpoch)
+      db = BuildDecodedBlock(PC);
+    }
+
+    if(db)
+    {
+     instr = db->Instrs[0].instr;
+     opf = db->Instrs[0].opf;
+     DB_Next = &db->Instrs[1];
+     DB_PC = PC + 4;
+     DB_EndPC = PC + 4 * db->Count;
+     DB_Epoch = DecodedBlockEpoch;
+
+     if(DB_PC == DB_EndPC)
+      DB_PC = 0x1;
+    }
+    else
+    {
+     DB_PC = 0x1;
+
+     instr = ReadInstruction<CachedMode>(timestamp, PC);
 
-   if(instr & (0x3F << 26))
-    opf = 0x40 | (instr >> 26);
+     // 
+     // Instruction decode
+     //
+     opf = instr & 0x3F;
+
+     if(instr & (0x3F << 26))
+      opf = 0x40 | (instr >> 26);
+    }
+   }
 
    opf |= IPCache;
 
@@ -2450,17 +2578,29 @@ pscpu_timestamp_t PS_CPU::RunReal(pscpu_timestamp_t timestamp_in)
 pscpu_timestamp_t PS_CPU::Run(pscpu_timestamp_t timestamp_in, bool BIOSPrintMode, bool ILHMode)
 {
  if(CPUHook || ADDBT)
-  return(RunReal<true, true, false>(timestamp_in));
+  return(RunReal<true, true, false, false>(timestamp_in));
+ else if(CachedInterp)
+ {
+  if(ILHMode)
+   return(RunReal<false, false, true, true>(timestamp_in));
+  else
+  {
+   if(BIOSPrintMode)
+    return(RunReal<false, true, false, true>(timestamp_in));
+   else
+    return(RunReal<false, false, false, true>(timestamp_in));
+  }
+ }
  else
  {
   if(ILHMode)
-   return(RunReal<false, false, true>(timestamp_in));
+   return(RunReal<false, false, true, false>(timestamp_in));
   else
   {
    if(BIOSPrintMode)
-    return(RunReal<false, true, false>(timestamp_in));
+    return(RunReal<false, true, false, false>(timestamp_in));
    else
-    return(RunReal<false, false, false>(timestamp_in));
+    return(RunReal<false, false, false, false>(timestamp_in));
   }
  }
 }
@@ -85,6 +85,9 @@ class PS_CPU
 
  pscpu_timestamp_t Run(pscpu_timestamp_t timestamp_in, bool BIOSPrintMode, bool ILHMode);
 
+ // Doesn't affect emulation results, only speed; the cached interpreter isn't used when a debugger hook is set.
+ void SetCachedInterpreter(bool enabled) MDFN_COLD;
+
  void Power(void) MDFN_COLD;
 
  // which ranges 0-5, inclusive
@@ -220,14 +223,52 @@ class PS_CPU
 
  uint32 Exception(uint32 code, uint32 PC, const uint32 NP, const uint32 instr) MDFN_WARN_UNUSED_RESULT;
 
- template<bool DebugMode, bool BIOSPrintMode, bool ILHMode> NO_INLINE pscpu_timestamp_t RunReal(pscpu_timestamp_t timestamp_in);
+ template<bool DebugMode, bool BIOSPrintMode, bool ILHMode, bool CachedMode> NO_INLINE pscpu_timestamp_t RunReal(pscpu_timestamp_t timestamp_in);
 
  template<typename T> T PeekMemory(uint32 address) MDFN_COLD;
  template<typename T> void PokeMemory(uint32 address, T value) MDFN_COLD;
  template<typename T> T ReadMemory(pscpu_timestamp_t &timestamp, uint32 address, bool DS24 = false, bool LWC_timing = false);
  template<typename T> void WriteMemory(pscpu_timestamp_t &timestamp, uint32 address, uint32 value, bool DS24 = false);
 
- uint32 ReadInstruction(pscpu_timestamp_t &timestamp, uint32 address);
+ template<bool CachedMode> uint32 ReadInstruction(pscpu_timestamp_t &timestamp, uint32 address);
+
+ //
+ // Cached interpreter:
+ //
+ // Runs of instructions that hit in the instruction cache are predecoded into blocks, ending after a branch delay slot or at
+ // DecodedBlock_MaxInstrs instructions, and indexed by the instruction cache index of their first instruction.  As with the instruction
+ // cache itself, RAM writes don't affect blocks; a block is invalidated when a cache line it covers is refilled, and all blocks are invalidated
+ // (by bumping DecodedBlockEpoch, which also stops execution of the current block) when the instruction cache is written in isolated cache
+ // mode, enabled or disabled via the BIU, or loaded from a save state.  Since blocks only hold instructions that would've been cache hits
+ // anyway, instruction timing is unaffected.
+ //
+ enum { DecodedBlock_MaxInstrs = 16 };
+
+ struct DecodedInstr
+ {
+  uint32 instr;
+  uint32 opf;	// Without IPCache.
+ };
+
+ struct DecodedBlock
+ {
+  uint32 PC;	// Address of the first instruction, or 0x1 if invalid.
+  uint32 Epoch;
+  uint32 Count;
+  DecodedInstr Instrs[DecodedBlock_MaxInstrs];
+ };
+
+ DecodedBlock DecodedBlocks[1024];
+ uint32 DecodedBlockEpoch;
+ bool CachedInterp;
+
+ void InvalidateDecodedBlocks(void);
+ INLINE void InvalidateDecodedBlocksForLine(const uint32 address)
+ {
+  for(uint32 A = (address & 0xFF0) - 4 * (DecodedBlock_MaxInstrs - 1); A != (address & 0xFF0) + 0x10; A += 4)
+   DecodedBlocks[(A & 0xFFC) >> 2].PC = 0x1;
+ }
+ const DecodedBlock* BuildDecodedBlock(const uint32 PC);
 
  //
  // Mednafen debugger stuff follows:
@@ -25,6 +25,8 @@
 
 #include "psx.h"
 #include "timer.h"
+#include "gpu_mtrender.h"
+#include "gpu_upscale.h"
 
 /* FIXME: Respect horizontal timing register values in relation to hsync/hblank/hretrace/whatever signal sent to the timers */
 
@@ -76,16 +78,8 @@ namespace PS_GPU_INTERNAL
 }
 using namespace PS_GPU_INTERNAL;
 
-void GPU_Init(bool pal_clock_and_tv)
+void GPU_Init(bool pal_clock_and_tv, const unsigned renderer, const uint64 affinity, const unsigned upscale_shift, const unsigned upscale_threads)
 {
- static const int8 dither_table[4][4] =
- {
-  { -4,  0, -3,  1 },
-  {  2, -2,  3, -1 },
-  { -3,  1, -4,  0 },
-  {  3, -1,  2, -2 },
- };
-
  HardwarePALType = pal_clock_and_tv;
  //printf("%zu\n", (size_t)((uintptr_t)DitherLUT - (uintptr_t)this));
  //printf("%zu\n", (size_t)((uintptr_t)GPURAM - (uintptr_t)this));
@@ -95,7 +89,7 @@ void GPU_Init(bool pal_clock_and_tv)
   for(int x = 0; x < 4; x++)
    for(int v = 0; v < 512; v++)
    {
-    int value = v + dither_table[y][x];
+    int value = v + DitherTable[y][x];
 
     value >>= 3;
  
@@ -124,11 +118,42 @@ void GPU_Init(bool pal_clock_and_tv)
  memcpy(&Commands[0x40], Commands_40_5F, sizeof(Commands_40_5F));
  memcpy(&Commands[0x60], Commands_60_7F, sizeof(Commands_60_7F));
  memcpy(&Commands[0x80], Commands_80_FF, sizeof(Commands_80_FF));
+
+ TimingOnly = false;
+ if(renderer == GPU_RENDERER_MT)
+ {
+  TimingOnly = true;
+  PS_GPU_MTRENDER::Init(affinity);
+ }
+
+ UpscaleShift = upscale_shift;
+ if(UpscaleShift)
+  PS_GPU_UPSCALE::Init(UpscaleShift, upscale_threads);
 }
 
 void GPU_Kill(void)
 {
+ if(TimingOnly)
+ {
+  PS_GPU_MTRENDER::Kill();
+  TimingOnly = false;
+ }
+
+ if(UpscaleShift)
+ {
+  PS_GPU_UPSCALE::Kill();
+  UpscaleShift = 0;
+ }
+}
+
+void GPU_SyncRAM(void)
+{
+ PS_GPU_MTRENDER::Sync();
+}
 
+void GPU_PokeUpscaledRAM(uint32 A, uint16 V)
+{
+ PS_GPU_UPSCALE::PokeRAM(A & 0x3FF, (A >> 10) & 0x1FF, V);
 }
 
 /*
@@ -208,19 +233,14 @@ void GPU_SetGetVideoParams(MDFNGI* gi, const bool caspect, const int sls, const
   gi->fb_width = FBWidthNCA;
   gi->lcm_width = gi->nominal_width * 2;
  }
-}
-
-static INLINE void InvalidateTexCache(void)
-{
- for(auto& c : TexCache)
-  c.Tag = ~0U;
-}
-
-static void InvalidateCache(void)
-{
- CLUT_Cache_VB = ~0U;
 
- InvalidateTexCache();
+ //
+ // Upscaled output; nominal dimensions and gun coordinate scaling stay at native resolution.
+ //
+ gi->fb_width <<= UpscaleShift;
+ gi->fb_height <<= UpscaleShift;
+ gi->lcm_width <<= UpscaleShift;
+ gi->lcm_height <<= UpscaleShift;
 }
 
 static void SoftReset(void) // Control command 0x00
@@ -293,6 +313,12 @@ static void SoftReset(void) // Control command 0x00
 
 void GPU_Power(void)
 {
+ if(TimingOnly)
+  PS_GPU_MTRENDER::Sync();
+
+ if(UpscaleShift)
+  PS_GPU_UPSCALE::Sync();
+
  memset(GPURAM, 0, sizeof(GPURAM));
 
  memset(CLUT_Cache, 0, sizeof(CLUT_Cache));
@@ -389,119 +415,17 @@ void GPU_Power(void)
 
  IRQ_Assert(IRQ_VBLANK, InVBlank);
  TIMER_SetVBlank(InVBlank);
-}
-
-void GPU_ResetTS(void)
-{
- lastts = 0;
-}
-
-// Special RAM write mode(16 pixels at a time), does *not* appear to use mask drawing environment settings.
-static void Command_FBFill(const uint32 *cb)
-{
- int32 r = cb[0] & 0xFF;
- int32 g = (cb[0] >> 8) & 0xFF;
- int32 b = (cb[0] >> 16) & 0xFF;
- const uint16 fill_value = ((r >> 3) << 0) | ((g >> 3) << 5) | ((b >> 3) << 10);
-
- int32 destX = (cb[1] >>  0) & 0x3F0;
- int32 destY = (cb[1] >> 16) & 0x3FF;
-
- int32 width =  (((cb[2] >> 0) & 0x3FF) + 0xF) & ~0xF;
- int32 height = (cb[2] >> 16) & 0x1FF;
-
- //printf("[GPU] FB Fill %d:%d w=%d, h=%d\n", destX, destY, width, height);
- DrawTimeAvail -= 46;	// Approximate
-
- for(int32 y = 0; y < height; y++)
- {
-  const int32 d_y = (y + destY) & 511;
 
-  if(LineSkipTest(d_y))
-   continue;
+ if(TimingOnly)
+  PS_GPU_MTRENDER::Reset();
 
-  DrawTimeAvail -= (width >> 3) + 9;
-
-  for(int32 x = 0; x < width; x++)
-  {
-   const int32 d_x = (x + destX) & 1023;
-
-   GPURAM[d_y][d_x] = fill_value;
-  }
- }
+ if(UpscaleShift)
+  PS_GPU_UPSCALE::Reset();
 }
 
-static void Command_FBCopy(const uint32 *cb)
-{
- int32 sourceX = (cb[1] >> 0) & 0x3FF;
- int32 sourceY = (cb[1] >> 16) & 0x3FF;
- int32 destX = (cb[2] >> 0) & 0x3FF;
- int32 destY = (cb[2] >> 16) & 0x3FF;
-
- int32 width = (cb[3] >> 0) & 0x3FF;
- int32 height = (cb[3] >> 16) & 0x1FF;
-
- if(!width)
-  width = 0x400;
-
- if(!height)
-  height = 0x200;
-
- InvalidateTexCache();
- //printf("FB Copy: %d %d %d %d %d %d\n", sourceX, sourceY, destX, destY, width, height);
-
- DrawTimeAvail -= (width * height) * 2;
-
- for(int32 y = 0; y < height; y++)
- {
-  for(int32 x = 0; x < width; x += 128)
-  {
-   const int32 chunk_x_max = std::min<int32>(width - x, 128);
-   uint16 tmpbuf[128];	// TODO: Check and see if the GPU is actually (ab)using the texture cache(doesn't seem to be affecting CLUT cache...).
-
-   for(int32 chunk_x = 0; chunk_x < chunk_x_max; chunk_x++)
-   {
-    int32 s_y = (y + sourceY) & 511;
-    int32 s_x = (x + chunk_x + sourceX) & 1023;
-
-    tmpbuf[chunk_x] = GPURAM[s_y][s_x];
-   }
-
-   for(int32 chunk_x = 0; chunk_x < chunk_x_max; chunk_x++)
-   {
-    int32 d_y = (y + destY) & 511;
-    int32 d_x = (x + chunk_x + destX) & 1023;
-
-    if(!(GPURAM[d_y][d_x] & MaskEvalAND))
-     GPURAM[d_y][d_x] = tmpbuf[chunk_x] | MaskSetOR;
-   }
-  }
- }
-}
-
-static void Command_FBWrite(const uint32 *cb)
+void GPU_ResetTS(void)
 {
- assert(InCmd == PS_GPU::INCMD_NONE);
-
- FBRW_X = (cb[1] >>  0) & 0x3FF;
- FBRW_Y = (cb[1] >> 16) & 0x3FF;
-
- FBRW_W = (cb[2] >>  0) & 0x3FF;
- FBRW_H = (cb[2] >> 16) & 0x1FF;
-
- if(!FBRW_W)
-  FBRW_W = 0x400;
-
- if(!FBRW_H)
-  FBRW_H = 0x200;
-
- FBRW_CurX = FBRW_X;
- FBRW_CurY = FBRW_Y;
-
- InvalidateTexCache();
-
- if(FBRW_W != 0 && FBRW_H != 0)
-  InCmd = PS_GPU::INCMD_FBWRITE;
+ lastts = 0;
 }
 
 //
@@ -689,6 +613,22 @@ MDFN_HIDE extern const CTEntry Commands_80_FF[0x80] =
 };
 }
 
+static INLINE void ExecCommand(const uint32 cc, const CTEntry* command, const uint32* CB, const unsigned len)
+{
+ if(TimingOnly)
+ {
+  if(cc == 0x02 || (cc >= 0x20 && cc <= 0xBF))
+   PS_GPU_MTRENDER::RecordCommand(cc, CB, len);
+  else if(cc >= 0xC0 && cc <= 0xDF)
+   PS_GPU_MTRENDER::Sync();
+ }
+
+ if(UpscaleShift && (cc == 0x02 || (cc >= 0x20 && cc <= 0xBF)))
+  PS_GPU_UPSCALE::RecordCommand(cc, CB);
+
+ command->func[abr][TexMode | (MaskEvalAND ? 0x4 : 0x0)](CB);
+}
+
 static void ProcessFIFO(void)
 {
  if(!BlitterFIFO.CanRead())
@@ -711,24 +651,14 @@ static void ProcessFIFO(void)
        {
   	uint32 InData = BlitterFIFO.Read();
 
-  	for(int i = 0; i < 2; i++)
-  	{
-   	 if(!(GPURAM[FBRW_CurY & 511][FBRW_CurX & 1023] & MaskEvalAND))
-    	  GPURAM[FBRW_CurY & 511][FBRW_CurX & 1023] = InData | MaskSetOR;
+	if(TimingOnly)
+	 PS_GPU_MTRENDER::RecordFBData(InData);
 
-	 FBRW_CurX++;
-   	 if(FBRW_CurX == (FBRW_X + FBRW_W))
-	 {
-	  FBRW_CurX = FBRW_X;
-	  FBRW_CurY++;
-	  if(FBRW_CurY == (FBRW_Y + FBRW_H))
-	  {
-	   InCmd = PS_GPU::INCMD_NONE;
-	   break;	// Break out of the for() loop.
-	  }
-	 }
-	 InData >>= 16;
-  	}
+	if(UpscaleShift)
+	 PS_GPU_UPSCALE::RecordFBData(InData);
+
+	if(!FBWriteData(InData))
+	 InCmd = PS_GPU::INCMD_NONE;
   	return;
        }
        break;
@@ -750,7 +680,7 @@ static void ProcessFIFO(void)
 	  CB[i] = BlitterFIFO.Read();
 	 }
 
-	 command->func[abr][TexMode | (MaskEvalAND ? 0x4 : 0x0)](CB);
+	 ExecCommand(cc, command, CB, vl);
 	}
 	return;
        }
@@ -780,7 +710,7 @@ static void ProcessFIFO(void)
 	  CB[i] = BlitterFIFO.Read();
 	 }
 
-	 command->func[abr][TexMode | (MaskEvalAND ? 0x4 : 0x0)](CB);
+	 ExecCommand(cc, command, CB, vl);
 	}
 	return;
        }
@@ -829,7 +759,7 @@ static void ProcessFIFO(void)
   }
   else
   {
-   command->func[abr][TexMode | (MaskEvalAND ? 0x4 : 0x0)](CB);
+   ExecCommand(cc, command, CB, command->len);
   }
  }
 }
@@ -1123,6 +1053,181 @@ static NO_INLINE void ReorderRGB(bool bpp24, const uint16 *src, uint32 *dest, co
  #pragma GCC pop_options
 #endif
 
+//
+// Calculates the range of the output line to fill with pixels from VRAM, and the VRAM X position(in units of bytes
+// for 24bpp, halfwords for 15bpp) of the first pixel.
+//
+static INLINE void CalcLineHRange(const uint32 dmc, const uint32 dmw, int32* fb_x_out, int32* dx_start_out, int32* dx_end_out)
+{
+ int32 fb_x = DisplayFB_XStart * 2;
+ int32 dx_start = HorizStart, dx_end = HorizEnd;
+
+ if(dx_end < dx_start)
+  dx_end = dx_start;
+
+ dx_start = dx_start / DotClockRatios[dmc];
+ dx_end = dx_end / DotClockRatios[dmc];
+
+ dx_start -= hmc_to_visible / DotClockRatios[dmc];
+ dx_end -= hmc_to_visible / DotClockRatios[dmc];
+ dx_start += 7;
+ dx_end += 7;
+
+ if(dx_start < 0)
+ {
+  fb_x -= dx_start * ((DisplayMode & 0x10) ? 3 : 2);
+  fb_x &= 0x7FF; //0x3FF;
+  dx_start = 0;
+ }
+
+ if((uint32)dx_end > dmw)
+  dx_end = dmw;
+
+ if(InVBlank || DisplayOff)
+  dx_start = dx_end = 0;
+
+ *fb_x_out = fb_x;
+ *dx_start_out = dx_start;
+ *dx_end_out = dx_end;
+}
+
+//
+// Scanout with internal resolution upscaling; each line is output (1 << UpscaleShift) times, 15bpp pixels come from
+// the high-resolution VRAM, and interlaced modes are output progressively(the lines of both fields, every field).
+// 'vis_line' is the scanline relative to the first visible one.
+//
+static NO_INLINE void ScanoutUpscaled(const pscpu_timestamp_t sys_timestamp, const pscpu_timestamp_t line_timestamp, const uint32 dmc, const uint32 dmw, const uint32 dmpa, const unsigned vis_line)
+{
+ const unsigned us = UpscaleShift;
+ const uint32 black = surface->MakeColor(0, 0, 0);
+ const bool il = (bool)(DisplayMode & 0x20);
+ const int32 lw = dmw - dmpa * 2;
+ int32 fb_x, dx_start, dx_end;
+ int32 nca_lw = 0, nca_dest_adj = 0;
+ uint32 line24[FBWidth];
+
+ CalcLineHRange(dmc, dmw, &fb_x, &dx_start, &dx_end);
+
+ if(!CorrectAspect)
+ {
+  nca_lw = NCABaseW << (bool)(dmc & 0x2);
+  nca_dest_adj = (nca_lw - lw) >> 1;
+  assert(nca_dest_adj >= 0);
+ }
+
+ for(unsigned f = 0; f <= (unsigned)il; f++)
+ {
+  const int32 dest_line = (vis_line << il) + f;
+  uint32 fb_y = DisplayFB_CurLineYReadout;
+
+  if((DisplayMode & 0x24) == 0x24)
+   fb_y = (fb_y - (InVBlank ? 0 : field_ram_readout) + f) & 0x1FF;
+
+  if(TimingOnly)
+   PS_GPU_MTRENDER::WaitLine(fb_y);
+
+  if(DisplayMode & 0x10)
+  {
+   if(surface->format.Rshift == 0 && surface->format.Gshift == 8 && surface->format.Bshift == 16)
+    ReorderRGB<0, 8, 16>(true, GPURAM[fb_y], line24, dx_start, dx_end, fb_x);
+   else if(surface->format.Rshift == 8 && surface->format.Gshift == 16 && surface->format.Bshift == 24)
+    ReorderRGB<8, 16, 24>(true, GPURAM[fb_y], line24, dx_start, dx_end, fb_x);
+   else if(surface->format.Rshift == 16 && surface->format.Gshift == 8 && surface->format.Bshift == 0)
+    ReorderRGB<16, 8, 0>(true, GPURAM[fb_y], line24, dx_start, dx_end, fb_x);
+   else if(surface->format.Rshift == 24 && surface->format.Gshift == 16 && surface->format.Bshift == 8)
+    ReorderRGB<24, 16, 8>(true, GPURAM[fb_y], line24, dx_start, dx_end, fb_x);
+   else
+    ReorderRGB_Var(surface->format.Rshift, surface->format.Gshift, surface->format.Bshift, true, GPURAM[fb_y], line24, dx_start, dx_end, fb_x);
+  }
+  else
+   PS_GPU_UPSCALE::WaitLine(fb_y);
+
+  for(unsigned sy = 0; sy < (1U << us); sy++)
+  {
+   const int32 hi_line = (dest_line << us) + sy;
+   uint32* const dest = surface->pixels + ((drxbo - dmpa + nca_dest_adj) << us) + hi_line * surface->pitch32;
+
+   LineWidths[hi_line] = lw << us;
+
+   for(int32 x = 0; x < (dx_start << us); x++)
+    dest[x] = black;
+
+   if(DisplayMode & 0x10)
+   {
+    for(int32 x = dx_start; x < dx_end; x++)
+     for(unsigned sx = 0; sx < (1U << us); sx++)
+      dest[(x << us) + sx] = line24[x];
+   }
+   else
+   {
+    const uint16* const src = PS_GPU_UPSCALE::GetLine((fb_y << us) + sy);
+    const uint32 src_mask = (1024 << us) - 1;
+    int32 fx = fb_x;
+
+    for(int32 x = dx_start; x < dx_end; x++)
+    {
+     for(unsigned sx = 0; sx < (1U << us); sx++)
+     {
+      const uint32 srcpix = src[(((fx >> 1) << us) + sx) & src_mask];
+
+      dest[(x << us) + sx] = OutputLUT[(uint8)srcpix] | (OutputLUT + 256)[(srcpix >> 8) & 0x7F];
+     }
+     fx = (fx + 2) & 0x7FF;
+    }
+   }
+
+   for(uint32 x = dx_end << us; x < (dmw << us); x++)
+    dest[x] = black;
+  }
+ }
+
+ //
+ // The line hook(light guns) works at native resolution, on the current field's line; sample it, and write back
+ // whatever the hook changed.
+ //
+ {
+  const int32 dest_line = (vis_line << il) + (il && field);
+  uint32* const dest = surface->pixels + ((drxbo - dmpa + nca_dest_adj) << us) + (dest_line << us) * surface->pitch32;
+  uint32 hook_line[FBWidth];
+  uint32 hook_line_orig[FBWidth];
+
+  for(uint32 x = 0; x < dmw; x++)
+   hook_line[x] = hook_line_orig[x] = dest[x << us];
+
+  PSX_GPULineHook(sys_timestamp, line_timestamp, scanline == 0, hook_line, &surface->format, dmw, (hmc_to_visible - 220) / DotClockRatios[dmc], (HardwarePALType ? 53203425 : 53693182) / DotClockRatios[dmc], DotClockRatios[dmc]);
+
+  for(uint32 x = 0; x < dmw; x++)
+  {
+   if(hook_line[x] != hook_line_orig[x])
+   {
+    for(unsigned sy = 0; sy < (1U << us); sy++)
+     for(unsigned sx = 0; sx < (1U << us); sx++)
+      dest[sy * surface->pitch32 + (x << us) + sx] = hook_line[x];
+   }
+  }
+ }
+
+ if(!CorrectAspect)
+ {
+  for(unsigned f = 0; f <= (unsigned)il; f++)
+  {
+   for(unsigned sy = 0; sy < (1U << us); sy++)
+   {
+    const int32 hi_line = ((((vis_line << il) + f)) << us) + sy;
+    uint32* const dest = surface->pixels + (drxbo << us) + hi_line * surface->pitch32;
+
+    for(int32 x = 0; x < (nca_dest_adj << us); x++)
+     dest[x] = black;
+
+    for(int32 x = (nca_dest_adj + lw) << us; x < (nca_lw << us); x++)
+     dest[x] = black;
+
+    LineWidths[hi_line] = nca_lw << us;
+   }
+  }
+ }
+}
+
 MDFN_FASTCALL pscpu_timestamp_t GPU_Update(const pscpu_timestamp_t sys_timestamp)
 {
  const uint32 dmc = (DisplayMode & 0x40) ? 4 : (DisplayMode & 0x3);
@@ -1199,6 +1304,12 @@ MDFN_FASTCALL pscpu_timestamp_t GPU_Update(const pscpu_timestamp_t sys_timestamp
     scanline = (scanline + 1) % LinesPerField;
     PhaseChange = !PhaseChange;
 
+    if(TimingOnly)
+     PS_GPU_MTRENDER::Flush();
+
+    if(UpscaleShift)
+     PS_GPU_UPSCALE::Flush();
+
 #ifdef WANT_DEBUGGER
     DBG_GPUScanlineHook(scanline);
 #endif
@@ -1288,22 +1399,23 @@ MDFN_FASTCALL pscpu_timestamp_t GPU_Update(const pscpu_timestamp_t sys_timestamp
       {
        const uint32 black = surface->MakeColor(0, 0, 0);
 
-       espec->InterlaceOn = (bool)(DisplayMode & 0x20);
-       espec->InterlaceField = (bool)(DisplayMode & 0x20) && field;
+       // Upscaled output is always progressive; both fields' lines are output every field.
+       espec->InterlaceOn = !UpscaleShift && (bool)(DisplayMode & 0x20);
+       espec->InterlaceField = !UpscaleShift && (bool)(DisplayMode & 0x20) && field;
 
-       DisplayRect->x = drxbo;
+       DisplayRect->x = drxbo << UpscaleShift;
        DisplayRect->y = 0;
        DisplayRect->w = 0;
-       DisplayRect->h = VisibleLineCount << (bool)(DisplayMode & 0x20);
+       DisplayRect->h = (VisibleLineCount << (bool)(DisplayMode & 0x20)) << UpscaleShift;
 
        // Clear ~0 state.
        LineWidths[0] = 0;
 
        for(int i = 0; i < (DisplayRect->y + DisplayRect->h); i++)
        {
-	surface->pixels[i * surface->pitch32 + drxbo + 0] =
-	surface->pixels[i * surface->pitch32 + drxbo + 1] = black;
-        LineWidths[i] = 2;
+	for(int x = 0; x < (2 << UpscaleShift); x++)
+	 surface->pixels[i * surface->pitch32 + DisplayRect->x + x] = black;
+        LineWidths[i] = 2 << UpscaleShift;
        }
       }
      }
@@ -1367,40 +1479,21 @@ MDFN_FASTCALL pscpu_timestamp_t GPU_Update(const pscpu_timestamp_t sys_timestamp
     else
      DisplayFB_CurLineYReadout = (DisplayFB_YStart + DisplayFB_CurYOffset) & 0x1FF;
 
-    if((bool)(DisplayMode & 0x08) == HardwarePALType && scanline >= FirstVisibleLine && scanline < (FirstVisibleLine + VisibleLineCount) && !skip && espec)
+    const bool visible = (bool)(DisplayMode & 0x08) == HardwarePALType && scanline >= FirstVisibleLine && scanline < (FirstVisibleLine + VisibleLineCount) && !skip && espec;
+
+    if(visible && UpscaleShift)
+     ScanoutUpscaled(sys_timestamp, sys_timestamp - ((uint64)gpu_clocks * 65536) / GPUClockRatio, dmc, dmw, dmpa, scanline - FirstVisibleLine);
+    else if(visible)
     {
      const uint32 black = surface->MakeColor(0, 0, 0);
      uint32 *dest;
      int32 dest_line;
-     int32 fb_x = DisplayFB_XStart * 2;
-     int32 dx_start = HorizStart, dx_end = HorizEnd;
+     int32 fb_x, dx_start, dx_end;
 
      dest_line = ((scanline - FirstVisibleLine) << espec->InterlaceOn) + espec->InterlaceField;
      dest = surface->pixels + (drxbo - dmpa) + dest_line * surface->pitch32;
 
-     if(dx_end < dx_start)
-      dx_end = dx_start;
-
-     dx_start = dx_start / DotClockRatios[dmc];
-     dx_end = dx_end / DotClockRatios[dmc];
-
-     dx_start -= hmc_to_visible / DotClockRatios[dmc];
-     dx_end -= hmc_to_visible / DotClockRatios[dmc];
-     dx_start += 7;
-     dx_end += 7;
-
-     if(dx_start < 0)
-     {
-      fb_x -= dx_start * ((DisplayMode & 0x10) ? 3 : 2);
-      fb_x &= 0x7FF; //0x3FF;
-      dx_start = 0;
-     }
-
-     if((uint32)dx_end > dmw)
-      dx_end = dmw;
-
-     if(InVBlank || DisplayOff)
-      dx_start = dx_end = 0;
+     CalcLineHRange(dmc, dmw, &fb_x, &dx_start, &dx_end);
 
      LineWidths[dest_line] = dmw - dmpa * 2;
      //
@@ -1415,6 +1508,9 @@ MDFN_FASTCALL pscpu_timestamp_t GPU_Update(const pscpu_timestamp_t sys_timestamp
      }
 
      {
+      if(TimingOnly)
+       PS_GPU_MTRENDER::WaitLine(DisplayFB_CurLineYReadout);
+
       const uint16 *src = GPURAM[DisplayFB_CurLineYReadout];
 
       for(int32 x = 0; x < dx_start; x++)
@@ -1545,6 +1641,12 @@ void GPU_StartFrame(EmulateSpecStruct *espec_arg)
 
 void GPU_StateAction(StateMem *sm, const unsigned load, const bool data_only)
 {
+ if(TimingOnly)
+  PS_GPU_MTRENDER::Sync();
+
+ if(UpscaleShift)
+  PS_GPU_UPSCALE::Sync();
+
  uint32 TexCache_Tag[256];
  uint16 TexCache_Data[256][4];
 
@@ -1698,6 +1800,12 @@ void GPU_StateAction(StateMem *sm, const unsigned load, const bool data_only)
   OffsY = sign_x_to_s32(11, OffsY);
 
   IRQ_Assert(IRQ_GPU, IRQPending);
+
+  if(TimingOnly)
+   PS_GPU_MTRENDER::Reset();
+
+  if(UpscaleShift)
+   PS_GPU_UPSCALE::Reset();
  }
 }
 
@@ -109,6 +109,23 @@ struct PS_GPU
  uint32 abr;
  uint32 TexMode;
 
+ //
+ // Multithreaded rendering.  When TimingOnly is set, the drawing functions compute their timing(including texture
+ // cache tag and CLUT cache valid-state effects) but leave GPURAM alone; the actual pixel work is done by the
+ // render thread in gpu_mtrender.cpp.  *CacheGen are bumped on every cache invalidation so that the render thread
+ // can mirror them.
+ //
+ bool TimingOnly;
+ uint32 TexCacheGen;
+ uint32 CLUTCacheGen;
+
+ //
+ // Internal resolution upscaling(log2 of the scale factor, 0 when disabled).  GPURAM is still rendered at native
+ // resolution and stays authoritative for emulation purposes(FB reads, timing, save states); gpu_upscale.cpp
+ // redraws everything into a higher-resolution shadow copy, which is used for 15bpp scanout.
+ //
+ uint8 UpscaleShift;
+
  FastFIFO<uint32, 0x20> BlitterFIFO; // 0x10 on actual PS1 GPU, 0x20 here(see comment at top of gpu.h)
  uint32 DataReadBuffer;
  uint32 DataReadBufferEx;
@@ -212,9 +229,17 @@ struct PS_GPU
 
  MDFN_HIDE extern PS_GPU GPU;
 
- void GPU_Init(bool pal_clock_and_tv) MDFN_COLD;
+ enum
+ {
+  GPU_RENDERER_ST = 0,
+  GPU_RENDERER_MT = 1
+ };
+
+ void GPU_Init(bool pal_clock_and_tv, const unsigned renderer, const uint64 affinity, const unsigned upscale_shift, const unsigned upscale_threads) MDFN_COLD;
  void GPU_Kill(void) MDFN_COLD;
 
+ unsigned GPU_TestSpanSIMD(void) MDFN_COLD;	// Called from testsexp.cpp
+
  void GPU_SetGetVideoParams(MDFNGI* gi, const bool caspect, const int sls, const int sle, const bool show_h_overscan) MDFN_COLD;
 
  void GPU_GetGunXTranslation(float* scale, float* offs);
@@ -263,14 +288,26 @@ struct PS_GPU
   return GPU.scanline;
  } 
 
+ void GPU_SyncRAM(void);
+ void GPU_PokeUpscaledRAM(uint32 A, uint16 V);
+
  static INLINE uint16 GPU_PeekRAM(uint32 A)
  {
+  if(GPU.TimingOnly)
+   GPU_SyncRAM();
+
   return GPU.GPURAM[(A >> 10) & 0x1FF][A & 0x3FF];
  }
 
  static INLINE void GPU_PokeRAM(uint32 A, uint16 V)
  {
+  if(GPU.TimingOnly)
+   GPU_SyncRAM();
+
   GPU.GPURAM[(A >> 10) & 0x1FF][A & 0x3FF] = V;
+
+  if(GPU.UpscaleShift)
+   GPU_PokeUpscaledRAM(A, V);
  }
 }
 #endif
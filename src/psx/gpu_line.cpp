@@ -24,7 +24,11 @@
 
 namespace MDFN_IEN_PSX
 {
+#ifdef PSX_GPU_MTRENDER
+namespace PS_GPU_MTRENDER
+#else
 namespace PS_GPU_INTERNAL
+#endif
 {
 
 #include "gpu_common.inc"
@@ -146,6 +150,9 @@ static void DrawLine(line_point *points)
 
  DrawTimeAvail -= k * 2;
 
+ if(TimingOnly)
+  return;
+
  //
  //
  //
@@ -0,0 +1,581 @@
+/******************************************************************************/
+/* Mednafen Sony PS1 Emulation Module                                         */
+/******************************************************************************/
+/* gpu_mtrender.cpp:
+**  Copyright (C) 2025 Mednafen Team
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public License
+** as published by the Free Software Foundation; either version 2
+** of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software Foundation, Inc.,
+** 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+/*
+ Multithreaded GPU rendering.
+
+ The emulation thread still runs every GP0 command itself, in TimingOnly mode, so DrawTimeAvail, the texture cache tags,
+ and the CLUT cache valid state evolve exactly as with the single-threaded renderer; only the pixel work is skipped.
+ Commands that write to VRAM are queued, along with a snapshot of the drawing environment whenever it changes, and
+ the render thread runs them again, with full pixel output, against its own copy of the drawing state(GPU_MTR).
+
+ The emulation thread syncs with the render thread:
+	Before running an FB read command(GPURAM -> CPU/DMA).
+	Before reading a line of GPURAM for scanout, if a queued command may write to that line.
+	On save state save/load, power, and debugger GPURAM access.
+*/
+
+#include "psx.h"
+#include "gpu.h"
+#include "gpu_mtrender.h"
+
+#include <atomic>
+#include <mednafen/MThreading.h>
+
+namespace MDFN_IEN_PSX
+{
+namespace PS_GPU_MTRENDER
+{
+static PS_GPU GPU_MTR;
+}
+}
+
+#define PSX_GPU_MTRENDER 1
+#include "gpu_sprite.cpp"
+#include "gpu_line.cpp"
+#include "gpu_polygon.cpp"
+
+namespace MDFN_IEN_PSX
+{
+namespace PS_GPU_MTRENDER
+{
+
+struct ENV_S
+{
+ int32 ClipX0;
+ int32 ClipY0;
+ int32 ClipX1;
+ int32 ClipY1;
+
+ int32 OffsX;
+ int32 OffsY;
+
+ uint32 MaskSetOR;
+ uint32 MaskEvalAND;
+
+ uint32 dtd;
+ uint32 dfe;
+ uint32 TexDisable;
+
+ uint32 tww, twh, twx, twy;
+
+ uint32 TexPageX;
+ uint32 TexPageY;
+ uint32 SpriteFlip;
+ uint32 abr;
+ uint32 TexMode;
+
+ uint32 DisplayMode;
+ uint32 DisplayFB_YStart;
+ uint32 field_ram_readout;
+
+ uint32 TexCacheGen;
+ uint32 CLUTCacheGen;
+};
+
+enum : uint8
+{
+ ENTRY_ENV = 0,
+ ENTRY_COMMAND,
+ ENTRY_FBDATA,
+ ENTRY_EXIT
+};
+
+struct WQ_Entry
+{
+ uint8 Type;
+ uint8 CC;
+ uint8 InCmd;
+ uint8 Count;
+
+ union
+ {
+  uint32 CB[0x10];
+  ENV_S Env;
+ };
+};
+
+enum : uint32 { WQ_Size = 4096 };
+enum : uint32 { WQ_FlushThreshold = 256 };
+
+struct ITC_S
+{
+ std::array<WQ_Entry, WQ_Size> WQ;
+ //
+ // Free-running positions; entry index is (pos & (WQ_Size - 1)).
+ //
+ uint32 WritePos;
+ uint32 ReadPos;
+ uint32 PubWritePos;
+ uint8 padding0[64 - 3 * sizeof(uint32)];
+
+ std::atomic_uint_least32_t TMP_WritePos;
+ std::atomic_uint_least32_t TMP_ReadPos;
+ std::atomic_uint_least32_t WaitPos;
+ std::atomic_bool Waiting;
+ uint8 padding1[64 - 3 * sizeof(std::atomic_uint_least32_t) - sizeof(std::atomic_bool)];
+
+ MThreading::Sem* RT_WakeupSem;
+ MThreading::Sem* WakeupSem;
+ MThreading::Thread* RThread;
+};
+
+alignas(64) static ITC_S ITC;
+
+//
+// Emulation-thread-side state.
+//
+static ENV_S LastEnv;
+static bool LastEnvValid;
+static uint32 FBDataCount;	// Words in the FB data entry at WritePos that hasn't been committed yet.
+
+struct DirtyRange
+{
+ uint32 y;
+ uint32 count;
+ uint32 pos;	// Write position after the last entry that may write to these lines.
+};
+static std::array<DirtyRange, 32> DirtyRanges;
+static unsigned DirtyRangesCount;
+
+//
+// Render-thread-side state.
+//
+static ENV_S CurEnv;
+
+static INLINE bool PosReached(const uint32 cur, const uint32 target)
+{
+ return (int32)(cur - target) >= 0;
+}
+
+static void ApplyEnv(const ENV_S& env)
+{
+ if(env.TexCacheGen != CurEnv.TexCacheGen)
+  InvalidateTexCache();
+
+ if(env.CLUTCacheGen != CurEnv.CLUTCacheGen)
+  CLUT_Cache_VB = ~0U;
+
+ CurEnv = env;
+
+ ClipX0 = env.ClipX0;
+ ClipY0 = env.ClipY0;
+ ClipX1 = env.ClipX1;
+ ClipY1 = env.ClipY1;
+ OffsX = env.OffsX;
+ OffsY = env.OffsY;
+ MaskSetOR = env.MaskSetOR;
+ MaskEvalAND = env.MaskEvalAND;
+ dtd = env.dtd;
+ dfe = env.dfe;
+ TexDisable = env.TexDisable;
+ tww = env.tww;
+ twh = env.twh;
+ twx = env.twx;
+ twy = env.twy;
+ TexPageX = env.TexPageX;
+ TexPageY = env.TexPageY;
+ SpriteFlip = env.SpriteFlip;
+ abr = env.abr;
+ TexMode = env.TexMode;
+ DisplayMode = env.DisplayMode;
+ DisplayFB_YStart = env.DisplayFB_YStart;
+ field_ram_readout = env.field_ram_readout;
+
+ RecalcTexWindowStuff();
+}
+
+static MDFN_HOT int RThreadEntry(void* data)
+{
+ uint32 ReadPos = ITC.TMP_ReadPos.load(std::memory_order_acquire);
+
+ for(;;)
+ {
+  uint32 WritePos = ITC.TMP_WritePos.load(std::memory_order_acquire);
+
+  while(ReadPos == WritePos)
+  {
+   MThreading::Sem_TimedWait(ITC.RT_WakeupSem, 1);
+   WritePos = ITC.TMP_WritePos.load(std::memory_order_acquire);
+  }
+
+  while(ReadPos != WritePos)
+  {
+   const WQ_Entry& e = ITC.WQ[ReadPos & (WQ_Size - 1)];
+
+   switch(e.Type)
+   {
+    case ENTRY_ENV:
+	ApplyEnv(e.Env);
+	break;
+
+    case ENTRY_COMMAND:
+	InCmd = e.InCmd;
+	Commands[e.CC].func[abr][TexMode | (MaskEvalAND ? 0x4 : 0x0)](e.CB);
+	break;
+
+    case ENTRY_FBDATA:
+	for(unsigned i = 0; i < e.Count; i++)
+	 FBWriteData(e.CB[i]);
+	break;
+
+    case ENTRY_EXIT:
+	ITC.TMP_ReadPos.store(ReadPos + 1, std::memory_order_release);
+	return 0;
+   }
+
+   ReadPos++;
+   ITC.TMP_ReadPos.store(ReadPos, std::memory_order_release);
+
+   if(MDFN_UNLIKELY(ITC.Waiting.load(std::memory_order_relaxed)) && PosReached(ReadPos, ITC.WaitPos.load(std::memory_order_relaxed)))
+   {
+    if(ITC.Waiting.exchange(false))
+     MThreading::Sem_Post(ITC.WakeupSem);
+   }
+  }
+ }
+
+ return 0;
+}
+
+static void Publish(void)
+{
+ if(ITC.PubWritePos != ITC.WritePos)
+ {
+  ITC.PubWritePos = ITC.WritePos;
+  ITC.TMP_WritePos.store(ITC.WritePos, std::memory_order_release);
+  MThreading::Sem_Post(ITC.RT_WakeupSem);
+ }
+}
+
+static void WaitPos(const uint32 pos)
+{
+ if(PosReached(ITC.ReadPos, pos))
+  return;
+
+ Publish();
+
+ for(unsigned i = 0; i < 4096; i++)
+ {
+  ITC.ReadPos = ITC.TMP_ReadPos.load(std::memory_order_acquire);
+
+  if(PosReached(ITC.ReadPos, pos))
+   return;
+ }
+
+ ITC.WaitPos.store(pos, std::memory_order_relaxed);
+ ITC.Waiting.store(true, std::memory_order_seq_cst);
+
+ while(!PosReached((ITC.ReadPos = ITC.TMP_ReadPos.load(std::memory_order_acquire)), pos))
+  MThreading::Sem_TimedWait(ITC.WakeupSem, 1);
+
+ ITC.Waiting.store(false, std::memory_order_relaxed);
+}
+
+static INLINE WQ_Entry* AllocEntry(void)
+{
+ if(MDFN_UNLIKELY((ITC.WritePos - ITC.ReadPos) == WQ_Size))
+ {
+  ITC.ReadPos = ITC.TMP_ReadPos.load(std::memory_order_acquire);
+
+  if((ITC.WritePos - ITC.ReadPos) == WQ_Size)
+   WaitPos(ITC.WritePos - (WQ_Size / 2));
+ }
+
+ return &ITC.WQ[ITC.WritePos & (WQ_Size - 1)];
+}
+
+static INLINE void CommitEntry(void)
+{
+ ITC.WritePos++;
+
+ if(MDFN_UNLIKELY((ITC.WritePos - ITC.PubWritePos) >= WQ_FlushThreshold))
+  Publish();
+}
+
+static void MarkDirty(uint32 y, uint32 count)
+{
+ if(!count)
+  return;
+
+ y &= 511;
+ count = std::min<uint32>(count, 512);
+
+ if(DirtyRangesCount && DirtyRanges[DirtyRangesCount - 1].y == y && DirtyRanges[DirtyRangesCount - 1].count == count)
+ {
+  DirtyRanges[DirtyRangesCount - 1].pos = ITC.WritePos;
+  return;
+ }
+
+ if(DirtyRangesCount == DirtyRanges.size())
+ {
+  // Drop everything that's been completed, and if that's not enough, wait for the oldest range.
+  unsigned nc = 0;
+
+  ITC.ReadPos = ITC.TMP_ReadPos.load(std::memory_order_acquire);
+
+  for(unsigned i = 0; i < DirtyRangesCount; i++)
+  {
+   if(!PosReached(ITC.ReadPos, DirtyRanges[i].pos))
+    DirtyRanges[nc++] = DirtyRanges[i];
+  }
+
+  DirtyRangesCount = nc;
+
+  if(DirtyRangesCount == DirtyRanges.size())
+  {
+   WaitPos(DirtyRanges[0].pos);
+   memmove(&DirtyRanges[0], &DirtyRanges[1], (DirtyRangesCount - 1) * sizeof(DirtyRange));
+   DirtyRangesCount--;
+  }
+ }
+
+ DirtyRanges[DirtyRangesCount++] = { y, count, ITC.WritePos };
+}
+
+static INLINE void CommitFBData(void)
+{
+ ITC.WQ[ITC.WritePos & (WQ_Size - 1)].Count = FBDataCount;
+ FBDataCount = 0;
+ CommitEntry();
+ MarkDirty(GPU.FBRW_Y, GPU.FBRW_H);
+}
+
+static INLINE void RecordEnv(void)
+{
+ ENV_S env;
+
+ env.ClipX0 = GPU.ClipX0;
+ env.ClipY0 = GPU.ClipY0;
+ env.ClipX1 = GPU.ClipX1;
+ env.ClipY1 = GPU.ClipY1;
+ env.OffsX = GPU.OffsX;
+ env.OffsY = GPU.OffsY;
+ env.MaskSetOR = GPU.MaskSetOR;
+ env.MaskEvalAND = GPU.MaskEvalAND;
+ env.dtd = GPU.dtd;
+ env.dfe = GPU.dfe;
+ env.TexDisable = GPU.TexDisable;
+ env.tww = GPU.tww;
+ env.twh = GPU.twh;
+ env.twx = GPU.twx;
+ env.twy = GPU.twy;
+ env.TexPageX = GPU.TexPageX;
+ env.TexPageY = GPU.TexPageY;
+ env.SpriteFlip = GPU.SpriteFlip;
+ env.abr = GPU.abr;
+ env.TexMode = GPU.TexMode;
+ env.DisplayMode = GPU.DisplayMode;
+ env.DisplayFB_YStart = GPU.DisplayFB_YStart;
+ env.field_ram_readout = GPU.field_ram_readout;
+ env.TexCacheGen = GPU.TexCacheGen;
+ env.CLUTCacheGen = GPU.CLUTCacheGen;
+
+ if(MDFN_LIKELY(LastEnvValid) && !memcmp(&env, &LastEnv, sizeof(ENV_S)))
+  return;
+
+ WQ_Entry* e = AllocEntry();
+
+ e->Type = ENTRY_ENV;
+ e->Env = env;
+ CommitEntry();
+
+ LastEnv = env;
+ LastEnvValid = true;
+}
+
+MDFN_FASTCALL void RecordCommand(const uint32 cc, const uint32* cb, const unsigned len)
+{
+ if(FBDataCount)
+  CommitFBData();
+
+ RecordEnv();
+ //
+ WQ_Entry* e = AllocEntry();
+
+ e->Type = ENTRY_COMMAND;
+ e->CC = cc;
+ e->InCmd = GPU.InCmd;
+ e->Count = len;
+ memcpy(e->CB, cb, len * sizeof(uint32));
+ CommitEntry();
+ //
+ if(cc == 0x02)
+  MarkDirty(cb[1] >> 16, (cb[2] >> 16) & 0x1FF);
+ else if(cc >= 0x80 && cc <= 0x9F)
+  MarkDirty(cb[2] >> 16, ((cb[3] >> 16) & 0x1FF) ? ((cb[3] >> 16) & 0x1FF) : 0x200);
+ else if(cc >= 0x20 && cc <= 0x7F && GPU.ClipY1 >= GPU.ClipY0)
+  MarkDirty(GPU.ClipY0, GPU.ClipY1 + 1 - GPU.ClipY0);
+}
+
+MDFN_FASTCALL void RecordFBData(const uint32 V)
+{
+ if(!FBDataCount)
+ {
+  RecordEnv();
+  AllocEntry()->Type = ENTRY_FBDATA;
+ }
+
+ ITC.WQ[ITC.WritePos & (WQ_Size - 1)].CB[FBDataCount++] = V;
+
+ if(FBDataCount == 0x10)
+  CommitFBData();
+}
+
+void Flush(void)
+{
+ if(FBDataCount)
+  CommitFBData();
+
+ Publish();
+}
+
+MDFN_FASTCALL void WaitLine(const uint32 y)
+{
+ unsigned nc = 0;
+
+ if(FBDataCount)
+  Flush();
+
+ if(!DirtyRangesCount)
+  return;
+
+ ITC.ReadPos = ITC.TMP_ReadPos.load(std::memory_order_acquire);
+
+ for(unsigned i = 0; i < DirtyRangesCount; i++)
+ {
+  const DirtyRange& r = DirtyRanges[i];
+
+  if(PosReached(ITC.ReadPos, r.pos))
+   continue;
+
+  // 24bpp scanout can read the first pixel of the following line, too.
+  if(((y - r.y) & 511) < r.count || ((y + 1 - r.y) & 511) < r.count)
+   WaitPos(r.pos);
+  else
+   DirtyRanges[nc++] = r;
+ }
+
+ DirtyRangesCount = nc;
+}
+
+void Sync(void)
+{
+ Flush();
+ WaitPos(ITC.WritePos);
+ DirtyRangesCount = 0;
+
+ memcpy(GPU.CLUT_Cache, GPU_MTR.CLUT_Cache, sizeof(GPU.CLUT_Cache));
+ for(unsigned i = 0; i < 256; i++)
+  memcpy(GPU.TexCache[i].Data, GPU_MTR.TexCache[i].Data, sizeof(GPU.TexCache[i].Data));
+}
+
+void Reset(void)
+{
+ //
+ // The render thread is idle, so apply the environment directly; the queued copy of it will then be a no-op as
+ // far as the caches are concerned.
+ //
+ LastEnvValid = false;
+ RecordEnv();
+ ApplyEnv(LastEnv);
+
+ memcpy(GPU_MTR.CLUT_Cache, GPU.CLUT_Cache, sizeof(GPU.CLUT_Cache));
+ GPU_MTR.CLUT_Cache_VB = GPU.CLUT_Cache_VB;
+ memcpy(GPU_MTR.TexCache, GPU.TexCache, sizeof(GPU.TexCache));
+
+ GPU_MTR.InCmd_CC = GPU.InCmd_CC;
+ memcpy(GPU_MTR.InQuad_F3Vertices, GPU.InQuad_F3Vertices, sizeof(GPU.InQuad_F3Vertices));
+ GPU_MTR.InPLine_PrevPoint = GPU.InPLine_PrevPoint;
+
+ GPU_MTR.FBRW_X = GPU.FBRW_X;
+ GPU_MTR.FBRW_Y = GPU.FBRW_Y;
+ GPU_MTR.FBRW_W = GPU.FBRW_W;
+ GPU_MTR.FBRW_H = GPU.FBRW_H;
+ GPU_MTR.FBRW_CurX = GPU.FBRW_CurX;
+ GPU_MTR.FBRW_CurY = GPU.FBRW_CurY;
+}
+
+void Init(const uint64 affinity)
+{
+ static const CTEntry FB_Commands[3] =
+ {
+  OTHER_HELPER(3, 3, false, Command_FBFill),
+  OTHER_HELPER(4, 2, false, Command_FBCopy),
+  OTHER_HELPER(3, 2, false, Command_FBWrite),
+ };
+
+ memset(GPU_MTR.Commands, 0, sizeof(GPU_MTR.Commands));
+ GPU_MTR.Commands[0x02] = FB_Commands[0];
+ memcpy(&GPU_MTR.Commands[0x20], Commands_20_3F, sizeof(Commands_20_3F));
+ memcpy(&GPU_MTR.Commands[0x40], Commands_40_5F, sizeof(Commands_40_5F));
+ memcpy(&GPU_MTR.Commands[0x60], Commands_60_7F, sizeof(Commands_60_7F));
+ for(unsigned cc = 0x80; cc < 0xA0; cc++)
+  GPU_MTR.Commands[cc] = FB_Commands[1];
+ for(unsigned cc = 0xA0; cc < 0xC0; cc++)
+  GPU_MTR.Commands[cc] = FB_Commands[2];
+ //
+ ITC.WritePos = 0;
+ ITC.ReadPos = 0;
+ ITC.PubWritePos = 0;
+ ITC.TMP_WritePos.store(0, std::memory_order_release);
+ ITC.TMP_ReadPos.store(0, std::memory_order_release);
+ ITC.Waiting.store(false);
+
+ LastEnvValid = false;
+ FBDataCount = 0;
+ DirtyRangesCount = 0;
+ //
+ ITC.RT_WakeupSem = MThreading::Sem_Create();
+ ITC.WakeupSem = MThreading::Sem_Create();
+ //
+ ITC.RThread = MThreading::Thread_Create(RThreadEntry, NULL, "GPU Render");
+ if(affinity)
+  MThreading::Thread_SetAffinity(ITC.RThread, affinity);
+}
+
+void Kill(void)
+{
+ if(ITC.RThread)
+ {
+  Flush();
+  AllocEntry()->Type = ENTRY_EXIT;
+  CommitEntry();
+  Publish();
+  MThreading::Thread_Wait(ITC.RThread, NULL);
+  ITC.RThread = NULL;
+ }
+
+ if(ITC.RT_WakeupSem)
+ {
+  MThreading::Sem_Destroy(ITC.RT_WakeupSem);
+  ITC.RT_WakeupSem = NULL;
+ }
+
+ if(ITC.WakeupSem)
+ {
+  MThreading::Sem_Destroy(ITC.WakeupSem);
+  ITC.WakeupSem = NULL;
+ }
+}
+
+}
+}
@@ -0,0 +1,63 @@
+/******************************************************************************/
+/* Mednafen Sony PS1 Emulation Module                                         */
+/******************************************************************************/
+/* gpu_mtrender.h:
+**  Copyright (C) 2025 Mednafen Team
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public License
+** as published by the Free Software Foundation; either version 2
+** of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software Foundation, Inc.,
+** 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef __MDFN_PSX_GPU_MTRENDER_H
+#define __MDFN_PSX_GPU_MTRENDER_H
+
+namespace MDFN_IEN_PSX
+{
+namespace PS_GPU_MTRENDER
+{
+ void Init(const uint64 affinity) MDFN_COLD;
+ void Kill(void) MDFN_COLD;
+
+ //
+ // Copies the drawing-related state(caches, FB write position, quad/polyline continuation data) from GPU into
+ // the render thread's state; only call after Sync().
+ //
+ void Reset(void) MDFN_COLD;
+
+ //
+ // Waits until the render thread has finished processing everything queued, then copies its texture cache and
+ // CLUT cache contents into GPU(for save states).
+ //
+ void Sync(void);
+
+ //
+ // Commands with pixel output(FB fill, FB copy, FB write setup, polygons, lines, sprites); called before the command
+ // is run in TimingOnly mode on the emulation thread.
+ //
+ MDFN_FASTCALL void RecordCommand(const uint32 cc, const uint32* cb, const unsigned len);
+ MDFN_FASTCALL void RecordFBData(const uint32 V);
+
+ //
+ // Makes queued commands visible to the render thread.
+ //
+ void Flush(void);
+
+ //
+ // Waits until all queued commands that may write to VRAM line 'y'(or the line after it, for 24bpp scanout)
+ // have been processed.
+ //
+ MDFN_FASTCALL void WaitLine(const uint32 y);
+}
+}
+#endif
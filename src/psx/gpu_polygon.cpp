@@ -26,9 +26,20 @@
 #include "psx.h"
 #include "gpu.h"
 
+#if defined(HAVE_SSE2_INTRINSICS)
+ #include <xmmintrin.h>
+ #include <emmintrin.h>
+#elif defined(HAVE_NEON_INTRINSICS)
+ #include <arm_neon.h>
+#endif
+
 namespace MDFN_IEN_PSX
 {
+#ifdef PSX_GPU_MTRENDER
+namespace PS_GPU_MTRENDER
+#else
 namespace PS_GPU_INTERNAL
+#endif
 {
 #include "gpu_common.inc"
 
@@ -145,42 +156,16 @@ static INLINE void AddIDeltas_DY(i_group &ig, const i_deltas &idl, uint32 count
  }
 }
 
+#if defined(HAVE_SSE2_INTRINSICS) || defined(HAVE_NEON_INTRINSICS)
+ #include "gpu_span_simd.inc"
+#endif
+
+//
+// Per-pixel span drawing; also finishes off whatever DrawSpan_SIMD() leaves over.
+//
 template<bool goraud, bool textured, int BlendMode, bool TexMult, uint32 TexMode_TA, bool MaskEval_TA>
-static INLINE void DrawSpan(int y, const int32 x_start, const int32 x_bound, i_group ig, const i_deltas &idl)
+static INLINE void DrawSpan_Scalar(const int y, int32 x, int32 w, i_group ig, const i_deltas &idl)
 {
-  if(LineSkipTest(y))
-   return;
-
-  int32 x_ig_adjust = x_start;
-  int32 w = x_bound - x_start;
-  int32 x = sign_x_to_s32(11, x_start);
-
-  if(x < ClipX0)
-  {
-   int32 delta = ClipX0 - x;
-   x_ig_adjust += delta;
-   x += delta;
-   w -= delta;
-  }
-
-  if((x + w) > (ClipX1 + 1))
-   w = ClipX1 + 1 - x;
-
-  if(w <= 0)
-   return;
-
-  //printf("%d %d %d %d\n", x, w, ClipX0, ClipX1);
-
-  AddIDeltas_DX<goraud, textured>(ig, idl, x_ig_adjust);
-  AddIDeltas_DY<goraud, textured>(ig, idl, y);
-
-  if(goraud || textured)
-   DrawTimeAvail -= w * 2;
-  else if((BlendMode >= 0) || MaskEval_TA)
-   DrawTimeAvail -= w + ((w + 1) >> 1);
-  else
-   DrawTimeAvail -= w;
-
   do
   {
    const uint32 r = ig.r >> (COORD_FBS + COORD_POST_PADDING);
@@ -236,6 +221,68 @@ static INLINE void DrawSpan(int y, const int32 x_start, const int32 x_bound, i_g
   } while(MDFN_LIKELY(--w > 0));
 }
 
+template<bool goraud, bool textured, int BlendMode, bool TexMult, uint32 TexMode_TA, bool MaskEval_TA>
+static INLINE void DrawSpan(int y, const int32 x_start, const int32 x_bound, i_group ig, const i_deltas &idl)
+{
+  if(LineSkipTest(y))
+   return;
+
+  int32 x_ig_adjust = x_start;
+  int32 w = x_bound - x_start;
+  int32 x = sign_x_to_s32(11, x_start);
+
+  if(x < ClipX0)
+  {
+   int32 delta = ClipX0 - x;
+   x_ig_adjust += delta;
+   x += delta;
+   w -= delta;
+  }
+
+  if((x + w) > (ClipX1 + 1))
+   w = ClipX1 + 1 - x;
+
+  if(w <= 0)
+   return;
+
+  //printf("%d %d %d %d\n", x, w, ClipX0, ClipX1);
+
+  AddIDeltas_DX<goraud, textured>(ig, idl, x_ig_adjust);
+  AddIDeltas_DY<goraud, textured>(ig, idl, y);
+
+  if(goraud || textured)
+   DrawTimeAvail -= w * 2;
+  else if((BlendMode >= 0) || MaskEval_TA)
+   DrawTimeAvail -= w + ((w + 1) >> 1);
+  else
+   DrawTimeAvail -= w;
+
+  if(TimingOnly)
+  {
+   if(textured)
+   {
+    do
+    {
+     GetTexel<TexMode_TA, true>(ig.u >> (COORD_FBS + COORD_POST_PADDING), ig.v >> (COORD_FBS + COORD_POST_PADDING));
+     AddIDeltas_DX<false, textured>(ig, idl);
+    } while(MDFN_LIKELY(--w > 0));
+   }
+   return;
+  }
+
+#if defined(HAVE_SSE2_INTRINSICS) || defined(HAVE_NEON_INTRINSICS)
+  if(w >= 8)
+  {
+   DrawSpan_SIMD<goraud, textured, BlendMode, TexMult, TexMode_TA, MaskEval_TA>(y, x, w, ig, idl);
+
+   if(w <= 0)
+    return;
+  }
+#endif
+
+  DrawSpan_Scalar<goraud, textured, BlendMode, TexMult, TexMode_TA, MaskEval_TA>(y, x, w, ig, idl);
+}
+
 template<bool goraud, bool textured, int BlendMode, bool TexMult, uint32 TexMode_TA, bool MaskEval_TA>
 static INLINE void DrawTriangle(tri_vertex *vertices)
 {
@@ -633,5 +680,175 @@ MDFN_HIDE extern const CTEntry Commands_20_3F[0x20] =
  POLY_HELPER(0x3f)
 };
 
+#if !defined(PSX_GPU_MTRENDER) && (defined(HAVE_SSE2_INTRINSICS) || defined(HAVE_NEON_INTRINSICS))
+//
+// Differential test for DrawSpan_SIMD(); draws the same random spans through the SIMD path(plus the per-pixel tail),
+// and through the per-pixel path alone, and compares VRAM, the texture cache, and DrawTimeAvail.
+//
+struct SpanTestState
+{
+ uint16 GPURAM[512][1024];
+ decltype(PS_GPU::TexCache) TexCache;
+ int32 DrawTimeAvail;
+};
+
+static uint64 SpanTest_LCG;
+
+static uint32 SpanTest_Rand(void)
+{
+ SpanTest_LCG = (SpanTest_LCG * 6364136223846793005ULL) + 1442695040888963407ULL;
+
+ return SpanTest_LCG >> 32;
 }
+
+static uint32 SpanTest_RandDelta(void)
+{
+ return (int32)SpanTest_Rand() >> (8 + (SpanTest_Rand() & 0xF));
+}
+
+static void SpanTest_Save(SpanTestState* st)
+{
+ memcpy(st->GPURAM, GPURAM, sizeof(GPURAM));
+ memcpy(st->TexCache, TexCache, sizeof(TexCache));
+ st->DrawTimeAvail = DrawTimeAvail;
+}
+
+static void SpanTest_Load(const SpanTestState* st)
+{
+ memcpy(GPURAM, st->GPURAM, sizeof(GPURAM));
+ memcpy(TexCache, st->TexCache, sizeof(TexCache));
+ DrawTimeAvail = st->DrawTimeAvail;
+}
+
+template<bool goraud, bool textured, int BlendMode, bool TexMult, uint32 TexMode_TA, bool MaskEval_TA>
+static NO_INLINE void SpanTest_Draw(const bool simd, const uint64 seed, const unsigned count)
+{
+ SpanTest_LCG = seed;
+
+ for(unsigned i = 0; i < count; i++)
+ {
+  const int y = SpanTest_Rand() & 511;
+  int32 x = SpanTest_Rand() & 1023;
+  int32 w = 1 + (SpanTest_Rand() % std::min<int32>(1024 - x, 96));
+  i_group ig;
+  i_deltas idl;
+
+  ig.u = SpanTest_Rand();
+  ig.v = SpanTest_Rand();
+  ig.r = SpanTest_Rand();
+  ig.g = SpanTest_Rand();
+  ig.b = SpanTest_Rand();
+
+  idl.du_dx = SpanTest_RandDelta();
+  idl.dv_dx = SpanTest_RandDelta();
+  idl.dr_dx = SpanTest_RandDelta();
+  idl.dg_dx = SpanTest_RandDelta();
+  idl.db_dx = SpanTest_RandDelta();
+  idl.du_dy = idl.dv_dy = idl.dr_dy = idl.dg_dy = idl.db_dy = 0;
+
+  dtd = SpanTest_Rand() & 1;
+  MaskSetOR = (SpanTest_Rand() & 1) << 15;
+  MaskEvalAND = (SpanTest_Rand() & 1) << 15;
+
+  tww = SpanTest_Rand() & 0x1F;
+  twh = SpanTest_Rand() & 0x1F;
+  twx = SpanTest_Rand() & 0x1F;
+  twy = SpanTest_Rand() & 0x1F;
+  TexPageX = (SpanTest_Rand() & 0xF) << 6;
+  TexPageY = (SpanTest_Rand() & 1) << 8;
+  TexMode = TexMode_TA;
+  RecalcTexWindowStuff();
+
+  if(simd && w >= 8)
+  {
+   DrawSpan_SIMD<goraud, textured, BlendMode, TexMult, TexMode_TA, MaskEval_TA>(y, x, w, ig, idl);
+
+   if(w <= 0)
+    continue;
+  }
+
+  DrawSpan_Scalar<goraud, textured, BlendMode, TexMult, TexMode_TA, MaskEval_TA>(y, x, w, ig, idl);
+ }
+}
+
+template<bool goraud, bool textured, int BlendMode, bool TexMult, uint32 TexMode_TA, bool MaskEval_TA>
+static unsigned SpanTest(SpanTestState* st)
+{
+ static const unsigned count = 16384;
+ //
+ // Zero texels and CLUT entries are transparent, so make plenty of them.
+ //
+ for(auto& row : GPURAM)
+  for(auto& p : row)
+   p = (SpanTest_Rand() & 0x7) ? SpanTest_Rand() : 0;
+
+ for(auto& c : CLUT_Cache)
+  c = (SpanTest_Rand() & 0x7) ? SpanTest_Rand() : 0;
+
+ InvalidateTexCache();
+ DrawTimeAvail = 0;
+ SpanTest_Save(&st[0]);
+
+ const uint64 seed = SpanTest_LCG;
+
+ SpanTest_Draw<goraud, textured, BlendMode, TexMult, TexMode_TA, MaskEval_TA>(true, seed, count);
+ SpanTest_Save(&st[1]);
+ SpanTest_Load(&st[0]);
+ SpanTest_Draw<goraud, textured, BlendMode, TexMult, TexMode_TA, MaskEval_TA>(false, seed, count);
+
+ if(memcmp(st[1].GPURAM, GPURAM, sizeof(GPURAM)) || memcmp(st[1].TexCache, TexCache, sizeof(TexCache)) || st[1].DrawTimeAvail != DrawTimeAvail)
+ {
+  printf("DrawSpan_SIMD() mismatch: goraud=%d textured=%d BlendMode=%d TexMult=%d TexMode=%u MaskEval=%d\n", goraud, textured, BlendMode, TexMult, TexMode_TA, MaskEval_TA);
+  return 1;
+ }
+
+ return 0;
+}
+#endif
+
+}
+
+#ifndef PSX_GPU_MTRENDER
+//
+// Returns the number of drawing modes for which DrawSpan_SIMD() doesn't match the per-pixel path.  Leaves VRAM
+// and the drawing state trashed, so don't call it with a game loaded.
+//
+unsigned GPU_TestSpanSIMD(void)
+{
+ unsigned failed = 0;
+#if defined(HAVE_SSE2_INTRINSICS) || defined(HAVE_NEON_INTRINSICS)
+ using namespace PS_GPU_INTERNAL;
+ std::unique_ptr<SpanTestState[]> st(new SpanTestState[2]);
+
+ GPU_Init(false, GPU_RENDERER_ST, 0, 0, 0);
+ SpanTest_LCG = 0xDEADBEEFCAFEBABEULL;
+
+ #define SPANTEST_MASK(g, t, bm, tm, tt) SpanTest<g, t, bm, tm, tt, false>(st.get()) + SpanTest<g, t, bm, tm, tt, true>(st.get())
+ #define SPANTEST_BM(g, t, tm, tt) SPANTEST_MASK(g, t, -1, tm, tt) + SPANTEST_MASK(g, t, 0, tm, tt) + SPANTEST_MASK(g, t, 1, tm, tt) + SPANTEST_MASK(g, t, 2, tm, tt) + SPANTEST_MASK(g, t, 3, tm, tt)
+
+ failed += SPANTEST_BM(false, false, false, 0);
+ failed += SPANTEST_BM(true, false, false, 0);
+
+ failed += SPANTEST_BM(false, true, false, 0);
+ failed += SPANTEST_BM(false, true, false, 1);
+ failed += SPANTEST_BM(false, true, false, 2);
+ failed += SPANTEST_BM(false, true, true, 0);
+ failed += SPANTEST_BM(false, true, true, 1);
+ failed += SPANTEST_BM(false, true, true, 2);
+
+ failed += SPANTEST_BM(true, true, false, 0);
+ failed += SPANTEST_BM(true, true, false, 1);
+ failed += SPANTEST_BM(true, true, false, 2);
+ failed += SPANTEST_BM(true, true, true, 0);
+ failed += SPANTEST_BM(true, true, true, 1);
+ failed += SPANTEST_BM(true, true, true, 2);
+
+ #undef SPANTEST_BM
+ #undef SPANTEST_MASK
+
+ GPU_Kill();
+#endif
+ return failed;
+}
+#endif
 }
@@ -0,0 +1,1775 @@
+/******************************************************************************/
+/* Mednafen Sony PS1 Emulation Module                                         */
+/******************************************************************************/
+/* gpu_upscale.cpp:
+**  Copyright (C) 2025 Mednafen Team
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public License
+** as published by the Free Software Foundation; either version 2
+** of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software Foundation, Inc.,
+** 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+/*
+ Internal resolution upscaling.
+
+ GPURAM is rendered exactly as it would be without upscaling(by the single-threaded or multithreaded renderer), and
+ remains the only VRAM the emulated system can observe.  In addition, every command that writes to VRAM is decoded on
+ the emulation thread and queued, and a pool of tile threads redraws it into HiRAM, a copy of VRAM (1 << Shift) times
+ larger in each dimension, which 15bpp scanout then reads from instead of GPURAM.
+
+ Each tile thread owns an interleaved set of 8-line bands of VRAM, and only writes the HiRAM lines of its own bands,
+ so no two threads ever write the same pixel, and per-pixel write order is queue order.  Reads from other threads'
+ bands(textures, CLUTs) are kept safe by the emulation thread, which coarsely tracks the areas written and read by
+ queued commands, and waits for all the tile threads to go idle before queueing a command that reads an area that a
+ queued command writes, or writes an area that a queued command reads.  FB copies, and primitives that texture from
+ their own drawing area, are run on the emulation thread after such a wait.
+
+ Differences from native-resolution rendering:
+	Textures are sampled straight from HiRAM, not through the texture cache, so stale texture cache effects aren't
+	reproduced; 4bpp/8bpp texture data and CLUTs are sampled from the top-left sub-pixel of each VRAM pixel.
+
+	The dither pattern is that of native resolution.
+
+	Lines are drawn at native resolution, as (1 << Shift)-sized blocks.
+*/
+
+#include "psx.h"
+#include "gpu.h"
+#include "gpu_upscale.h"
+
+#include <atomic>
+#include <mednafen/MThreading.h>
+
+namespace MDFN_IEN_PSX
+{
+namespace PS_GPU_UPSCALE
+{
+#include "gpu_common.inc"
+
+enum : unsigned { MaxThreads = 16 };
+
+static unsigned Shift;
+static unsigned NumThreads;
+static std::unique_ptr<uint16[]> HiRAM;
+static uint8 BandOwner[64];	// Tile thread that owns each 8-line band of VRAM.
+static const uint8 AllOwner[64] = { 0 };
+
+static INLINE uint16* HiLine(const uint32 y)
+{
+ return &HiRAM[(size_t)(y & ((512 << Shift) - 1)) << (10 + Shift)];
+}
+
+struct ENV_S
+{
+ int32 ClipX0;
+ int32 ClipY0;
+ int32 ClipX1;
+ int32 ClipY1;
+
+ uint32 MaskSetOR;
+ uint32 MaskEvalAND;
+
+ uint32 dtd;
+ uint32 dfe;
+
+ uint32 TexMode;
+ uint32 TWX_AND;
+ uint32 TWX_ADD;
+ uint32 TWY_AND;
+ uint32 TWY_ADD;
+
+ uint32 DisplayMode;
+ uint32 DisplayFB_YStart;
+ uint32 field_ram_readout;
+};
+
+enum : uint8
+{
+ ENTRY_ENV = 0,
+ ENTRY_POLYGON,
+ ENTRY_SPRITE,
+ ENTRY_LINE,
+ ENTRY_FBFILL,
+ ENTRY_FBDATA,
+ ENTRY_EXIT
+};
+
+enum : uint8
+{
+ PF_GORAUD = 0x01,
+ PF_TEXTURED = 0x02,
+ PF_TEXMULT = 0x04
+};
+
+struct WQ_Entry
+{
+ uint8 Type;
+ uint8 Flags;
+ int8 BlendMode;	// -1 for opaque
+ uint8 Count;
+ uint16 CLUT;
+
+ union
+ {
+  ENV_S Env;
+  tri_vertex Tri[3];
+  line_point Line[2];
+  uint32 CB[3];
+
+  struct
+  {
+   int32 x, y;
+   int32 w, h;
+   uint32 u, v;
+   uint32 color;
+   uint32 flip;
+  } Sprite;
+
+  struct
+  {
+   uint32 X, W, EndY;
+   uint32 CurX, CurY;
+   uint32 Data[0x10];
+  } FB;
+ };
+};
+
+enum : uint32 { WQ_Size = 4096 };
+enum : uint32 { WQ_FlushThreshold = 256 };
+
+//
+// Drawing context; the tile threads each have their own, and the emulation thread uses one(owning all lines) for
+// commands that it runs itself.
+//
+struct Context
+{
+ ENV_S Env;
+ const uint8* Owner;
+ uint8 ID;
+};
+
+struct alignas(64) TileThread
+{
+ std::atomic_uint_least32_t TMP_ReadPos;
+ std::atomic_uint_least32_t WaitPos;
+ std::atomic_bool Waiting;
+ uint32 ReadPos;	// Emulation thread's copy of TMP_ReadPos.
+
+ MThreading::Sem* WakeupSem;
+ MThreading::Thread* Thread;
+
+ Context Ctx;
+};
+
+struct ITC_S
+{
+ std::array<WQ_Entry, WQ_Size> WQ;
+ //
+ // Free-running positions; entry index is (pos & (WQ_Size - 1)).
+ //
+ uint32 WritePos;
+ uint32 PubWritePos;
+ uint8 padding0[64 - 2 * sizeof(uint32)];
+
+ std::atomic_uint_least32_t TMP_WritePos;
+ uint8 padding1[64 - sizeof(std::atomic_uint_least32_t)];
+
+ MThreading::Sem* WakeupSem;
+ std::array<TileThread, MaxThreads> TT;
+};
+
+alignas(64) static ITC_S ITC;
+
+//
+// Emulation-thread-side state.
+//
+static ENV_S LastEnv;
+static bool LastEnvValid;
+static uint16 LastCLUT;		// For the second triangle of a quad.
+static uint32 FBDataCount;	// Words in the FB data entry at WritePos that hasn't been committed yet.
+static Context MainCtx;
+
+struct DirtyRange
+{
+ uint32 y;
+ uint32 count;
+ uint32 pos;	// Write position after the last entry that may write to these lines.
+};
+static std::array<DirtyRange, 32> DirtyRanges;
+static unsigned DirtyRangesCount;
+
+//
+// VRAM areas written and read by commands queued since the tile threads were last known to be idle; one bit per
+// 64-pixel-wide column block, per 8-line band.
+//
+static uint16 WrittenBands[64];
+static uint16 ReadBands[64];
+
+struct Area
+{
+ uint64 Bands;
+ uint16 Cols;
+};
+
+static INLINE bool PosReached(const uint32 cur, const uint32 target)
+{
+ return (int32)(cur - target) >= 0;
+}
+
+static INLINE bool OwnsLine(const Context& ctx, const uint32 y)
+{
+ return ctx.Owner[(y & 511) >> 3] == ctx.ID;
+}
+
+static INLINE bool SkipLine(const ENV_S& env, const uint32 y)
+{
+ // Same as LineSkipTest().
+ return (env.DisplayMode & 0x24) == 0x24 && !env.dfe && ((y & 1) == ((env.DisplayFB_YStart + env.field_ram_readout) & 1));
+}
+
+template<int BlendMode, bool textured>
+static INLINE void PlotHiPixel(const ENV_S& env, uint16* const p, const uint16 fore_pix)
+{
+ uint16 pix = fore_pix;
+
+ if(BlendMode >= 0 && (fore_pix & 0x8000))
+  pix = BlendPixel<BlendMode>(*p, fore_pix);
+
+ if(!(*p & env.MaskEvalAND))
+  *p = (textured ? pix : (pix & 0x7FFF)) | env.MaskSetOR;
+}
+
+//
+// Per-primitive state.
+//
+struct PrimState
+{
+ // Drawing area, in HiRAM coordinates, inclusive.
+ int32 ClipX0;
+ int32 ClipY0;
+ int32 ClipX1;
+ int32 ClipY1;
+
+ bool goraud;
+ bool TexMult;
+ bool dither;
+
+ uint16 CLUT[256];
+};
+
+//
+// 'hu' and 'hv' are texture coordinates with Shift extra fractional bits.
+//
+template<uint32 TexMode_TA>
+static INLINE uint16 GetHiTexel(const ENV_S& env, const PrimState& ps, const uint32 hu, const uint32 hv)
+{
+ const uint32 s = Shift;
+ const uint32 u = (hu >> s) & 0xFF;
+ const uint32 v = (hv >> s) & 0xFF;
+ const uint32 u_ext = (u & env.TWX_AND) + env.TWX_ADD;
+ const uint32 fbtex_y = ((v & env.TWY_AND) + env.TWY_ADD) & 511;
+
+ if(TexMode_TA == 2)
+  return HiLine((fbtex_y << s) | (hv & ((1U << s) - 1)))[((u_ext & 1023) << s) | (hu & ((1U << s) - 1))];
+
+ const uint16 fbw = HiLine(fbtex_y << s)[((u_ext >> (2 - TexMode_TA)) & 1023) << s];
+
+ if(TexMode_TA == 0)
+  return ps.CLUT[(fbw >> ((u_ext & 3) * 4)) & 0xF];
+ else
+  return ps.CLUT[(fbw >> ((u_ext & 1) * 8)) & 0xFF];
+}
+
+template<bool textured, uint32 TexMode_TA, int BlendMode>
+static INLINE void ShadePixel(const ENV_S& env, const PrimState& ps, uint16* const p, uint32 r, uint32 g, uint32 b, const uint32 hu, const uint32 hv, const uint32 dither_x, const uint32 dither_y)
+{
+ if(textured)
+ {
+  uint16 fbw = GetHiTexel<TexMode_TA>(env, ps, hu, hv);
+
+  if(fbw)
+  {
+   if(ps.TexMult)
+   {
+    if(ps.dither)
+     fbw = ModTexel(fbw, r, g, b, dither_x, dither_y);
+    else
+     fbw = ModTexel(fbw, r, g, b, 3, 2);
+   }
+   PlotHiPixel<BlendMode, true>(env, p, fbw);
+  }
+ }
+ else
+ {
+  uint16 pix = 0x8000;
+
+  if(ps.dither)
+  {
+   pix |= DitherLUT[dither_y][dither_x][r] << 0;
+   pix |= DitherLUT[dither_y][dither_x][g] << 5;
+   pix |= DitherLUT[dither_y][dither_x][b] << 10;
+  }
+  else
+  {
+   pix |= (r >> 3) << 0;
+   pix |= (g >> 3) << 5;
+   pix |= (b >> 3) << 10;
+  }
+
+  PlotHiPixel<BlendMode, false>(env, p, pix);
+ }
+}
+
+//
+// Polygons; same rasterization rules as gpu_polygon.cpp, but with HiRAM coordinates, and interpolants with 24
+// fractional bits computed directly(64-bit intermediates, since the coordinates are larger).
+//
+struct hi_group
+{
+ uint32 u, v;
+ uint32 r, g, b;
+};
+
+struct hi_deltas
+{
+ uint32 du_dx, dv_dx;
+ uint32 dr_dx, dg_dx, db_dx;
+
+ uint32 du_dy, dv_dy;
+ uint32 dr_dy, dg_dy, db_dy;
+};
+
+enum { HI_FBS = 24 };
+
+static INLINE int64 MakePolyXFP(uint32 x)
+{
+ return ((uint64)x << 32) + ((1ULL << 32) - (1 << 11));
+}
+
+static INLINE int64 MakePolyXFPStep(int32 dx, int32 dy)
+{
+ int64 ret;
+ int64 dx_ex = (uint64)dx << 32;
+
+ if(dx_ex < 0)
+  dx_ex -= dy - 1;
+
+ if(dx_ex > 0)
+  dx_ex += dy - 1;
+
+ ret = dx_ex / dy;
+
+ return(ret);
+}
+
+#define CALCIS(x,y) (((int64)(B.x - A.x) * (C.y - B.y)) - ((int64)(C.x - B.x) * (B.y - A.y)))
+static INLINE void CalcHiDeltas(hi_deltas& idl, const tri_vertex& A, const tri_vertex& B, const tri_vertex& C)
+{
+ const int64 denom = CALCIS(x, y);
+
+ idl.dr_dx = (uint32)(CALCIS(r, y) * (1 << HI_FBS) / denom);
+ idl.dr_dy = (uint32)(CALCIS(x, r) * (1 << HI_FBS) / denom);
+
+ idl.dg_dx = (uint32)(CALCIS(g, y) * (1 << HI_FBS) / denom);
+ idl.dg_dy = (uint32)(CALCIS(x, g) * (1 << HI_FBS) / denom);
+
+ idl.db_dx = (uint32)(CALCIS(b, y) * (1 << HI_FBS) / denom);
+ idl.db_dy = (uint32)(CALCIS(x, b) * (1 << HI_FBS) / denom);
+
+ idl.du_dx = (uint32)(CALCIS(u, y) * (1 << HI_FBS) / denom);
+ idl.du_dy = (uint32)(CALCIS(x, u) * (1 << HI_FBS) / denom);
+
+ idl.dv_dx = (uint32)(CALCIS(v, y) * (1 << HI_FBS) / denom);
+ idl.dv_dy = (uint32)(CALCIS(x, v) * (1 << HI_FBS) / denom);
+}
+#undef CALCIS
+
+static INLINE void AddHiDeltas_DX(hi_group& ig, const hi_deltas& idl, uint32 count = 1)
+{
+ ig.u += idl.du_dx * count;
+ ig.v += idl.dv_dx * count;
+ ig.r += idl.dr_dx * count;
+ ig.g += idl.dg_dx * count;
+ ig.b += idl.db_dx * count;
+}
+
+static INLINE void AddHiDeltas_DY(hi_group& ig, const hi_deltas& idl, uint32 count = 1)
+{
+ ig.u += idl.du_dy * count;
+ ig.v += idl.dv_dy * count;
+ ig.r += idl.dr_dy * count;
+ ig.g += idl.dg_dy * count;
+ ig.b += idl.db_dy * count;
+}
+
+template<bool textured, uint32 TexMode_TA, int BlendMode>
+static INLINE void DrawHiSpan(const Context& ctx, const PrimState& ps, const int32 yi, const int32 x_start, const int32 x_bound, hi_group ig, const hi_deltas& idl)
+{
+ const unsigned s = Shift;
+ const uint32 ny = (yi >> s) & 511;
+
+ if(!OwnsLine(ctx, ny) || SkipLine(ctx.Env, ny))
+  return;
+
+ int32 x_ig_adjust = x_start;
+ int32 w = x_bound - x_start;
+ int32 x = sign_x_to_s32(11 + s, x_start);
+
+ if(x < ps.ClipX0)
+ {
+  int32 delta = ps.ClipX0 - x;
+  x_ig_adjust += delta;
+  x += delta;
+  w -= delta;
+ }
+
+ if((x + w) > (ps.ClipX1 + 1))
+  w = ps.ClipX1 + 1 - x;
+
+ if(w <= 0)
+  return;
+
+ AddHiDeltas_DX(ig, idl, x_ig_adjust);
+ AddHiDeltas_DY(ig, idl, yi);
+
+ uint16* const line = HiLine(yi);
+ const uint32 dither_y = ny & 3;
+
+ do
+ {
+  ShadePixel<textured, TexMode_TA, BlendMode>(ctx.Env, ps, &line[x], ig.r >> HI_FBS, ig.g >> HI_FBS, ig.b >> HI_FBS,
+	ig.u >> (HI_FBS - s), ig.v >> (HI_FBS - s), (x >> s) & 3, dither_y);
+
+  x++;
+  AddHiDeltas_DX(ig, idl);
+ } while(MDFN_LIKELY(--w > 0));
+}
+
+template<bool textured, uint32 TexMode_TA, int BlendMode>
+static void DrawHiPolygon(const Context& ctx, const PrimState& ps, const WQ_Entry& e)
+{
+ const unsigned s = Shift;
+ tri_vertex vertices[3];
+ hi_deltas idl;
+ unsigned core_vertex;
+
+ for(unsigned i = 0; i < 3; i++)
+ {
+  vertices[i] = e.Tri[i];
+  vertices[i].x = e.Tri[i].x * (1 << s);
+  vertices[i].y = e.Tri[i].y * (1 << s);
+
+  if(!ps.goraud)
+  {
+   vertices[i].r = e.Tri[0].r;
+   vertices[i].g = e.Tri[0].g;
+   vertices[i].b = e.Tri[0].b;
+  }
+ }
+
+ //
+ // Calculate the "core" vertex based on the unsorted input vertices, and sort vertices by Y.
+ //
+ {
+  unsigned cvtemp = 0;
+
+  if(vertices[1].x <= vertices[0].x)
+  {
+   if(vertices[2].x <= vertices[1].x)
+    cvtemp = (1 << 2);
+   else
+    cvtemp = (1 << 1);
+  }
+  else if(vertices[2].x < vertices[0].x)
+   cvtemp = (1 << 2);
+  else
+   cvtemp = (1 << 0);
+
+  if(vertices[2].y < vertices[1].y)
+  {
+   std::swap(vertices[2], vertices[1]);
+   cvtemp = ((cvtemp >> 1) & 0x2) | ((cvtemp << 1) & 0x4) | (cvtemp & 0x1);
+  }
+
+  if(vertices[1].y < vertices[0].y)
+  {
+   std::swap(vertices[1], vertices[0]);
+   cvtemp = ((cvtemp >> 1) & 0x1) | ((cvtemp << 1) & 0x2) | (cvtemp & 0x4);
+  }
+
+  if(vertices[2].y < vertices[1].y)
+  {
+   std::swap(vertices[2], vertices[1]);
+   cvtemp = ((cvtemp >> 1) & 0x2) | ((cvtemp << 1) & 0x4) | (cvtemp & 0x1);
+  }
+
+  core_vertex = cvtemp >> 1;
+ }
+
+ // Degenerate and oversized triangles were already filtered out by RecordCommand().
+ CalcHiDeltas(idl, vertices[0], vertices[1], vertices[2]);
+
+ int64 base_coord;
+ int64 base_step;
+
+ int64 bound_coord_us;
+ int64 bound_coord_ls;
+
+ bool right_facing;
+ hi_group ig;
+
+ // Texture coordinates are biased by half a HiRAM pixel rather than half a VRAM pixel, for sub-texel sampling.
+ ig.u = ((uint32)vertices[core_vertex].u << HI_FBS) + (1U << (HI_FBS - 1 - s));
+ ig.v = ((uint32)vertices[core_vertex].v << HI_FBS) + (1U << (HI_FBS - 1 - s));
+ ig.r = ((uint32)vertices[core_vertex].r << HI_FBS) + (1U << (HI_FBS - 1));
+ ig.g = ((uint32)vertices[core_vertex].g << HI_FBS) + (1U << (HI_FBS - 1));
+ ig.b = ((uint32)vertices[core_vertex].b << HI_FBS) + (1U << (HI_FBS - 1));
+
+ AddHiDeltas_DX(ig, idl, -vertices[core_vertex].x);
+ AddHiDeltas_DY(ig, idl, -vertices[core_vertex].y);
+
+ base_coord = MakePolyXFP(vertices[0].x);
+ base_step = MakePolyXFPStep((vertices[2].x - vertices[0].x), (vertices[2].y - vertices[0].y));
+
+ if(vertices[1].y == vertices[0].y)
+ {
+  bound_coord_us = 0;
+  right_facing = (bool)(vertices[1].x > vertices[0].x);
+ }
+ else
+ {
+  bound_coord_us = MakePolyXFPStep((vertices[1].x - vertices[0].x), (vertices[1].y - vertices[0].y));
+  right_facing = (bool)(bound_coord_us > base_step);
+ }
+
+ if(vertices[2].y == vertices[1].y)
+  bound_coord_ls = 0;
+ else
+  bound_coord_ls = MakePolyXFPStep((vertices[2].x - vertices[1].x), (vertices[2].y - vertices[1].y));
+
+ struct
+ {
+  uint64 x_coord[2];
+  uint64 x_step[2];
+
+  int32 y_coord;
+  int32 y_bound;
+
+  bool dec_mode;
+ } tripart[2];
+
+ unsigned vo = 0;
+ unsigned vp = 0;
+
+ if(core_vertex)
+  vo = 1;
+
+ if(core_vertex == 2)
+  vp = 3;
+
+ {
+  auto* tp = &tripart[vo];
+
+  tp->y_coord = vertices[0 ^ vo].y;
+  tp->y_bound = vertices[1 ^ vo].y;
+  tp->x_coord[right_facing] = MakePolyXFP(vertices[0 ^ vo].x);
+  tp->x_step[right_facing] = bound_coord_us;
+  tp->x_coord[!right_facing] = base_coord + ((vertices[vo].y - vertices[0].y) * base_step);
+  tp->x_step[!right_facing] = base_step;
+  tp->dec_mode = vo;
+ }
+
+ {
+  auto* tp = &tripart[vo ^ 1];
+
+  tp->y_coord = vertices[1 ^ vp].y;
+  tp->y_bound = vertices[2 ^ vp].y;
+  tp->x_coord[right_facing] = MakePolyXFP(vertices[1 ^ vp].x);
+  tp->x_step[right_facing] = bound_coord_ls;
+  tp->x_coord[!right_facing] = base_coord + ((vertices[1 ^ vp].y - vertices[0].y) * base_step);
+  tp->x_step[!right_facing] = base_step;
+  tp->dec_mode = vp;
+ }
+
+ for(unsigned i = 0; i < 2; i++)
+ {
+  int32 yi = tripart[i].y_coord;
+  int32 yb = tripart[i].y_bound;
+
+  uint64 lc = tripart[i].x_coord[0];
+  uint64 ls = tripart[i].x_step[0];
+
+  uint64 rc = tripart[i].x_coord[1];
+  uint64 rs = tripart[i].x_step[1];
+
+  if(tripart[i].dec_mode)
+  {
+   while(MDFN_LIKELY(yi > yb))
+   {
+    yi--;
+    lc -= ls;
+    rc -= rs;
+    //
+    int32 y = sign_x_to_s32(11 + s, yi);
+
+    if(y < ps.ClipY0)
+     break;
+
+    if(y > ps.ClipY1)
+     continue;
+
+    DrawHiSpan<textured, TexMode_TA, BlendMode>(ctx, ps, yi, (int64)lc >> 32, (int64)rc >> 32, ig, idl);
+   }
+  }
+  else
+  {
+   while(MDFN_LIKELY(yi < yb))
+   {
+    int32 y = sign_x_to_s32(11 + s, yi);
+
+    if(y > ps.ClipY1)
+     break;
+
+    if(y >= ps.ClipY0)
+     DrawHiSpan<textured, TexMode_TA, BlendMode>(ctx, ps, yi, (int64)lc >> 32, (int64)rc >> 32, ig, idl);
+    //
+    yi++;
+    lc += ls;
+    rc += rs;
+   }
+  }
+ }
+}
+
+//
+// Sprites; each HiRAM pixel maps back to the VRAM pixel it's part of, to get the texel, and the sub-pixel position
+// selects the sub-texel(mirrored when flipped).
+//
+template<bool textured, uint32 TexMode_TA, int BlendMode>
+static void DrawHiSprite(const Context& ctx, const PrimState& ps, const WQ_Entry& e)
+{
+ const unsigned s = Shift;
+ const int32 sm = (1 << s) - 1;
+ const int32 r = e.Sprite.color & 0xFF;
+ const int32 g = (e.Sprite.color >> 8) & 0xFF;
+ const int32 b = (e.Sprite.color >> 16) & 0xFF;
+ const bool FlipX = e.Sprite.flip & 0x1000;
+ const bool FlipY = e.Sprite.flip & 0x2000;
+ const uint32 u_base = FlipX ? (e.Sprite.u | 1) : e.Sprite.u;
+ const int32 x0 = e.Sprite.x * (1 << s);
+ const int32 y0 = e.Sprite.y * (1 << s);
+ const int32 x_start = std::max<int32>(x0, ps.ClipX0);
+ const int32 x_bound = std::min<int32>((e.Sprite.x + e.Sprite.w) * (1 << s), ps.ClipX1 + 1);
+ const int32 y_start = std::max<int32>(y0, ps.ClipY0);
+ const int32 y_bound = std::min<int32>((e.Sprite.y + e.Sprite.h) * (1 << s), ps.ClipY1 + 1);
+
+ for(int32 y = y_start; y < y_bound; y++)
+ {
+  const uint32 ny = (y >> s) & 511;
+
+  if(!OwnsLine(ctx, ny) || SkipLine(ctx.Env, ny))
+   continue;
+
+  const int32 ry = y - y0;
+  const uint32 hv = (((e.Sprite.v + (FlipY ? -(ry >> s) : (ry >> s))) & 0xFF) << s) | (FlipY ? (sm - (ry & sm)) : (ry & sm));
+  uint16* const line = HiLine(y);
+
+  for(int32 x = x_start; x < x_bound; x++)
+  {
+   const int32 rx = x - x0;
+   const uint32 hu = (((u_base + (FlipX ? -(rx >> s) : (rx >> s))) & 0xFF) << s) | (FlipX ? (sm - (rx & sm)) : (rx & sm));
+
+   ShadePixel<textured, TexMode_TA, BlendMode>(ctx.Env, ps, &line[x], r, g, b, hu, hv, 0, 0);
+  }
+ }
+}
+
+//
+// Lines; rasterized as in gpu_line.cpp, at native resolution.
+//
+template<int BlendMode>
+static void DrawHiLine(const Context& ctx, const PrimState& ps, const WQ_Entry& e)
+{
+ const unsigned s = Shift;
+ const line_point* points = e.Line;
+ const int32 i_dx = abs(points[1].x - points[0].x);
+ const int32 i_dy = abs(points[1].y - points[0].y);
+ const int32 k = (i_dx > i_dy) ? i_dx : i_dy;
+ int64 x, y, dx_dk = 0, dy_dk = 0;
+ int32 r, g, b, dr_dk = 0, dg_dk = 0, db_dk = 0;
+
+ if(k)
+ {
+  dx_dk = (int64)((uint64)(points[1].x - points[0].x) << 32);
+  dy_dk = (int64)((uint64)(points[1].y - points[0].y) << 32);
+
+  dx_dk += (dx_dk < 0) ? -(k - 1) : ((dx_dk > 0) ? (k - 1) : 0);
+  dy_dk += (dy_dk < 0) ? -(k - 1) : ((dy_dk > 0) ? (k - 1) : 0);
+
+  dx_dk /= k;
+  dy_dk /= k;
+
+  if(ps.goraud)
+  {
+   dr_dk = (int32)((uint32)(points[1].r - points[0].r) << 12) / k;
+   dg_dk = (int32)((uint32)(points[1].g - points[0].g) << 12) / k;
+   db_dk = (int32)((uint32)(points[1].b - points[0].b) << 12) / k;
+  }
+ }
+
+ x = (int64)(((uint64)points[0].x << 32) | (1ULL << 31)) - 1024;
+ y = (int64)(((uint64)points[0].y << 32) | (1ULL << 31)) - ((dy_dk < 0) ? 1024 : 0);
+ r = (points[0].r << 12) | (1 << 11);
+ g = (points[0].g << 12) | (1 << 11);
+ b = (points[0].b << 12) | (1 << 11);
+
+ for(int32 i = 0; i <= k; i++)
+ {
+  const int32 px = (x >> 32) & 2047;
+  const int32 py = (y >> 32) & 2047;
+
+  if((px << s) >= ps.ClipX0 && (px << s) <= ps.ClipX1 && (py << s) >= ps.ClipY0 && (py << s) <= ps.ClipY1 && OwnsLine(ctx, py) && !SkipLine(ctx.Env, py))
+  {
+   for(int32 sy = 0; sy < (1 << s); sy++)
+   {
+    uint16* const line = HiLine((py << s) + sy);
+
+    for(int32 sx = 0; sx < (1 << s); sx++)
+     ShadePixel<false, 0, BlendMode>(ctx.Env, ps, &line[(px << s) + sx], (uint8)(r >> 12), (uint8)(g >> 12), (uint8)(b >> 12), 0, 0, px & 3, py & 3);
+   }
+  }
+
+  x += dx_dk;
+  y += dy_dk;
+
+  if(ps.goraud)
+  {
+   r += dr_dk;
+   g += dg_dk;
+   b += db_dk;
+  }
+ }
+}
+
+static void DrawHiFBFill(const Context& ctx, const WQ_Entry& e)
+{
+ const unsigned s = Shift;
+ const uint32* cb = e.CB;
+ const int32 r = cb[0] & 0xFF;
+ const int32 g = (cb[0] >> 8) & 0xFF;
+ const int32 b = (cb[0] >> 16) & 0xFF;
+ const uint16 fill_value = ((r >> 3) << 0) | ((g >> 3) << 5) | ((b >> 3) << 10);
+ const int32 destX = (cb[1] >>  0) & 0x3F0;
+ const int32 destY = (cb[1] >> 16) & 0x3FF;
+ const int32 width =  (((cb[2] >> 0) & 0x3FF) + 0xF) & ~0xF;
+ const int32 height = (cb[2] >> 16) & 0x1FF;
+
+ for(int32 y = 0; y < height; y++)
+ {
+  const int32 d_y = (y + destY) & 511;
+
+  if(!OwnsLine(ctx, d_y) || SkipLine(ctx.Env, d_y))
+   continue;
+
+  for(int32 sy = 0; sy < (1 << s); sy++)
+  {
+   uint16* const line = HiLine((d_y << s) + sy);
+
+   for(int32 x = 0; x < width; x++)
+   {
+    uint16* const p = &line[((x + destX) & 1023) << s];
+
+    for(int32 sx = 0; sx < (1 << s); sx++)
+     p[sx] = fill_value;
+   }
+  }
+ }
+}
+
+static void DrawHiFBData(const Context& ctx, const WQ_Entry& e)
+{
+ const unsigned s = Shift;
+ uint32 cur_x = e.FB.CurX;
+ uint32 cur_y = e.FB.CurY;
+
+ for(unsigned i = 0; i < e.Count; i++)
+ {
+  uint32 data = e.FB.Data[i];
+
+  for(unsigned j = 0; j < 2; j++)
+  {
+   if(cur_y == e.FB.EndY)
+    return;
+
+   if(OwnsLine(ctx, cur_y))
+   {
+    for(int32 sy = 0; sy < (1 << s); sy++)
+    {
+     uint16* const p = &HiLine(((cur_y & 511) << s) + sy)[(cur_x & 1023) << s];
+
+     for(int32 sx = 0; sx < (1 << s); sx++)
+     {
+      if(!(p[sx] & ctx.Env.MaskEvalAND))
+       p[sx] = (uint16)data | ctx.Env.MaskSetOR;
+     }
+    }
+   }
+
+   cur_x++;
+   if(cur_x == (e.FB.X + e.FB.W))
+   {
+    cur_x = e.FB.X;
+    cur_y++;
+   }
+   data >>= 16;
+  }
+ }
+}
+
+//
+// Only run on the emulation thread, with the tile threads idle.
+//
+static void DrawHiFBCopy(const ENV_S& env, const uint32* cb)
+{
+ const unsigned s = Shift;
+ const int32 sourceX = (cb[1] >> 0) & 0x3FF;
+ const int32 sourceY = (cb[1] >> 16) & 0x3FF;
+ const int32 destX = (cb[2] >> 0) & 0x3FF;
+ const int32 destY = (cb[2] >> 16) & 0x3FF;
+ int32 width = (cb[3] >> 0) & 0x3FF;
+ int32 height = (cb[3] >> 16) & 0x1FF;
+
+ if(!width)
+  width = 0x400;
+
+ if(!height)
+  height = 0x200;
+
+ // Same chunking as Command_FBCopy(), for overlapping copies.
+ std::unique_ptr<uint16[]> tmpbuf(new uint16[128 << s]);
+
+ for(int32 y = 0; y < height; y++)
+ {
+  for(int32 sy = 0; sy < (1 << s); sy++)
+  {
+   const uint16* const src_line = HiLine((((y + sourceY) & 511) << s) + sy);
+   uint16* const dest_line = HiLine((((y + destY) & 511) << s) + sy);
+
+   for(int32 x = 0; x < width; x += 128)
+   {
+    const int32 chunk_x_max = std::min<int32>(width - x, 128);
+
+    for(int32 chunk_x = 0; chunk_x < chunk_x_max; chunk_x++)
+     for(int32 sx = 0; sx < (1 << s); sx++)
+      tmpbuf[(chunk_x << s) + sx] = src_line[(((x + chunk_x + sourceX) & 1023) << s) + sx];
+
+    for(int32 chunk_x = 0; chunk_x < chunk_x_max; chunk_x++)
+    {
+     for(int32 sx = 0; sx < (1 << s); sx++)
+     {
+      uint16* const p = &dest_line[(((x + chunk_x + destX) & 1023) << s) + sx];
+
+      if(!(*p & env.MaskEvalAND))
+       *p = tmpbuf[(chunk_x << s) + sx] | env.MaskSetOR;
+     }
+    }
+   }
+  }
+ }
+}
+
+typedef void (*PrimFunc)(const Context& ctx, const PrimState& ps, const WQ_Entry& e);
+
+#define PRIM_FUNCS_BM(f, t, tm) { f<t, tm, -1>, f<t, tm, 0>, f<t, tm, 1>, f<t, tm, 2>, f<t, tm, 3> }
+
+static const PrimFunc PolygonFuncs[4][5] =
+{
+ PRIM_FUNCS_BM(DrawHiPolygon, false, 0),
+ PRIM_FUNCS_BM(DrawHiPolygon, true, 0),
+ PRIM_FUNCS_BM(DrawHiPolygon, true, 1),
+ PRIM_FUNCS_BM(DrawHiPolygon, true, 2),
+};
+
+static const PrimFunc SpriteFuncs[4][5] =
+{
+ PRIM_FUNCS_BM(DrawHiSprite, false, 0),
+ PRIM_FUNCS_BM(DrawHiSprite, true, 0),
+ PRIM_FUNCS_BM(DrawHiSprite, true, 1),
+ PRIM_FUNCS_BM(DrawHiSprite, true, 2),
+};
+
+static const PrimFunc LineFuncs[5] = { DrawHiLine<-1>, DrawHiLine<0>, DrawHiLine<1>, DrawHiLine<2>, DrawHiLine<3> };
+
+#undef PRIM_FUNCS_BM
+
+static void RunEntry(Context& ctx, const WQ_Entry& e)
+{
+ switch(e.Type)
+ {
+  case ENTRY_ENV:
+	ctx.Env = e.Env;
+	break;
+
+  case ENTRY_FBFILL:
+	DrawHiFBFill(ctx, e);
+	break;
+
+  case ENTRY_FBDATA:
+	DrawHiFBData(ctx, e);
+	break;
+
+  case ENTRY_POLYGON:
+  case ENTRY_SPRITE:
+  case ENTRY_LINE:
+	{
+	 const unsigned s = Shift;
+	 const bool textured = (e.Flags & PF_TEXTURED);
+	 const uint32 tm = std::min<uint32>(2, ctx.Env.TexMode);
+	 PrimState ps;
+
+	 ps.ClipX0 = ctx.Env.ClipX0 << s;
+	 ps.ClipY0 = ctx.Env.ClipY0 << s;
+	 ps.ClipX1 = ((ctx.Env.ClipX1 + 1) << s) - 1;
+	 ps.ClipY1 = ((ctx.Env.ClipY1 + 1) << s) - 1;
+	 ps.goraud = (e.Flags & PF_GORAUD);
+	 ps.TexMult = (e.Flags & PF_TEXMULT);
+	 ps.dither = ctx.Env.dtd && (e.Type == ENTRY_POLYGON ? (textured ? ps.TexMult : ps.goraud) : (e.Type == ENTRY_LINE));
+
+	 if(textured && tm < 2)
+	 {
+	  const uint16* const clut_line = HiLine(((e.CLUT >> 6) & 0x1FF) << s);
+	  const uint32 cxo = (e.CLUT & 0x3F) << 4;
+
+	  for(unsigned i = 0; i < (tm ? 256U : 16U); i++)
+	   ps.CLUT[i] = clut_line[((cxo + i) & 0x3FF) << s];
+	 }
+
+	 if(e.Type == ENTRY_POLYGON)
+	  PolygonFuncs[textured ? (1 + tm) : 0][e.BlendMode + 1](ctx, ps, e);
+	 else if(e.Type == ENTRY_SPRITE)
+	  SpriteFuncs[textured ? (1 + tm) : 0][e.BlendMode + 1](ctx, ps, e);
+	 else
+	  LineFuncs[e.BlendMode + 1](ctx, ps, e);
+	}
+	break;
+ }
+}
+
+static MDFN_HOT int TileThreadEntry(void* data)
+{
+ TileThread& t = *(TileThread*)data;
+ uint32 ReadPos = t.TMP_ReadPos.load(std::memory_order_acquire);
+
+ for(;;)
+ {
+  uint32 WritePos = ITC.TMP_WritePos.load(std::memory_order_acquire);
+
+  while(ReadPos == WritePos)
+  {
+   MThreading::Sem_TimedWait(t.WakeupSem, 1);
+   WritePos = ITC.TMP_WritePos.load(std::memory_order_acquire);
+  }
+
+  while(ReadPos != WritePos)
+  {
+   const WQ_Entry& e = ITC.WQ[ReadPos & (WQ_Size - 1)];
+
+   if(e.Type == ENTRY_EXIT)
+   {
+    t.TMP_ReadPos.store(ReadPos + 1, std::memory_order_release);
+    return 0;
+   }
+
+   RunEntry(t.Ctx, e);
+
+   ReadPos++;
+   t.TMP_ReadPos.store(ReadPos, std::memory_order_release);
+
+   if(MDFN_UNLIKELY(t.Waiting.load(std::memory_order_relaxed)) && PosReached(ReadPos, t.WaitPos.load(std::memory_order_relaxed)))
+   {
+    if(t.Waiting.exchange(false))
+     MThreading::Sem_Post(ITC.WakeupSem);
+   }
+  }
+ }
+
+ return 0;
+}
+
+static void Publish(void)
+{
+ if(ITC.PubWritePos != ITC.WritePos)
+ {
+  ITC.PubWritePos = ITC.WritePos;
+  ITC.TMP_WritePos.store(ITC.WritePos, std::memory_order_release);
+
+  for(unsigned i = 0; i < NumThreads; i++)
+   MThreading::Sem_Post(ITC.TT[i].WakeupSem);
+ }
+}
+
+static void WaitThread(TileThread& t, const uint32 pos)
+{
+ if(PosReached(t.ReadPos, pos))
+  return;
+
+ Publish();
+
+ for(unsigned i = 0; i < 4096; i++)
+ {
+  t.ReadPos = t.TMP_ReadPos.load(std::memory_order_acquire);
+
+  if(PosReached(t.ReadPos, pos))
+   return;
+ }
+
+ t.WaitPos.store(pos, std::memory_order_relaxed);
+ t.Waiting.store(true, std::memory_order_seq_cst);
+
+ while(!PosReached((t.ReadPos = t.TMP_ReadPos.load(std::memory_order_acquire)), pos))
+  MThreading::Sem_TimedWait(ITC.WakeupSem, 1);
+
+ t.Waiting.store(false, std::memory_order_relaxed);
+}
+
+static void WaitAll(const uint32 pos)
+{
+ for(unsigned i = 0; i < NumThreads; i++)
+  WaitThread(ITC.TT[i], pos);
+}
+
+//
+// Waits for all queued entries, and forgets about the areas they write and read.
+//
+static void WaitIdle(void)
+{
+ WaitAll(ITC.WritePos);
+
+ memset(WrittenBands, 0, sizeof(WrittenBands));
+ memset(ReadBands, 0, sizeof(ReadBands));
+}
+
+static INLINE uint32 MinReadPos(void)
+{
+ uint32 ret = ITC.TT[0].ReadPos;
+
+ for(unsigned i = 1; i < NumThreads; i++)
+ {
+  if((ITC.WritePos - ITC.TT[i].ReadPos) > (ITC.WritePos - ret))
+   ret = ITC.TT[i].ReadPos;
+ }
+
+ return ret;
+}
+
+static INLINE WQ_Entry* AllocEntry(void)
+{
+ if(MDFN_UNLIKELY((ITC.WritePos - MinReadPos()) == WQ_Size))
+ {
+  for(unsigned i = 0; i < NumThreads; i++)
+   ITC.TT[i].ReadPos = ITC.TT[i].TMP_ReadPos.load(std::memory_order_acquire);
+
+  if((ITC.WritePos - MinReadPos()) == WQ_Size)
+   WaitAll(ITC.WritePos - (WQ_Size / 2));
+ }
+
+ return &ITC.WQ[ITC.WritePos & (WQ_Size - 1)];
+}
+
+static INLINE void CommitEntry(void)
+{
+ ITC.WritePos++;
+
+ if(MDFN_UNLIKELY((ITC.WritePos - ITC.PubWritePos) >= WQ_FlushThreshold))
+  Publish();
+}
+
+static void MarkDirty(uint32 y, uint32 count)
+{
+ if(!count)
+  return;
+
+ y &= 511;
+ count = std::min<uint32>(count, 512);
+
+ if(DirtyRangesCount && DirtyRanges[DirtyRangesCount - 1].y == y && DirtyRanges[DirtyRangesCount - 1].count == count)
+ {
+  DirtyRanges[DirtyRangesCount - 1].pos = ITC.WritePos;
+  return;
+ }
+
+ if(DirtyRangesCount == DirtyRanges.size())
+ {
+  // Drop everything that's been completed by all tile threads, and if that's not enough, wait for the oldest range.
+  unsigned nc = 0;
+
+  for(unsigned i = 0; i < NumThreads; i++)
+   ITC.TT[i].ReadPos = ITC.TT[i].TMP_ReadPos.load(std::memory_order_acquire);
+
+  const uint32 min_read_pos = MinReadPos();
+
+  for(unsigned i = 0; i < DirtyRangesCount; i++)
+  {
+   if(!PosReached(min_read_pos, DirtyRanges[i].pos))
+    DirtyRanges[nc++] = DirtyRanges[i];
+  }
+
+  DirtyRangesCount = nc;
+
+  if(DirtyRangesCount == DirtyRanges.size())
+  {
+   WaitAll(DirtyRanges[0].pos);
+   memmove(&DirtyRanges[0], &DirtyRanges[1], (DirtyRangesCount - 1) * sizeof(DirtyRange));
+   DirtyRangesCount--;
+  }
+ }
+
+ DirtyRanges[DirtyRangesCount++] = { y, count, ITC.WritePos };
+}
+
+//
+// x and y are wrapped to VRAM dimensions; w and h must be >= 1.
+//
+static INLINE Area MakeArea(uint32 x, uint32 y, uint32 w, uint32 h)
+{
+ Area ret = { 0, 0 };
+
+ x &= 1023;
+ y &= 511;
+
+ if(w >= 1024)
+  ret.Cols = 0xFFFF;
+ else
+ {
+  for(uint32 cb = x >> 6, cb_end = (x + w - 1) >> 6; cb <= cb_end; cb++)
+   ret.Cols |= 1U << (cb & 0xF);
+ }
+
+ if(h >= 512)
+  ret.Bands = ~(uint64)0;
+ else
+ {
+  for(uint32 band = y >> 3, band_end = (y + h - 1) >> 3; band <= band_end; band++)
+   ret.Bands |= (uint64)1 << (band & 0x3F);
+ }
+
+ return ret;
+}
+
+static INLINE bool AreaTest(const uint16* bands, const Area& a)
+{
+ uint64 bm = a.Bands;
+
+ while(bm)
+ {
+  const unsigned band = MDFN_tzcount64_0UD(bm);
+
+  if(bands[band] & a.Cols)
+   return true;
+
+  bm &= bm - 1;
+ }
+
+ return false;
+}
+
+static INLINE void AreaMark(uint16* bands, const Area& a)
+{
+ uint64 bm = a.Bands;
+
+ while(bm)
+ {
+  bands[MDFN_tzcount64_0UD(bm)] |= a.Cols;
+  bm &= bm - 1;
+ }
+}
+
+static INLINE bool AreaOverlap(const Area& a, const Area& b)
+{
+ return (a.Bands & b.Bands) && (a.Cols & b.Cols);
+}
+
+static INLINE void CommitFBData(void)
+{
+ ITC.WQ[ITC.WritePos & (WQ_Size - 1)].Count = FBDataCount;
+ FBDataCount = 0;
+ CommitEntry();
+ MarkDirty(GPU.FBRW_Y, GPU.FBRW_H);
+}
+
+static INLINE ENV_S CaptureEnv(void)
+{
+ ENV_S env;
+
+ env.ClipX0 = GPU.ClipX0;
+ env.ClipY0 = GPU.ClipY0;
+ env.ClipX1 = GPU.ClipX1;
+ env.ClipY1 = GPU.ClipY1;
+ env.MaskSetOR = GPU.MaskSetOR;
+ env.MaskEvalAND = GPU.MaskEvalAND;
+ env.dtd = GPU.dtd;
+ env.dfe = GPU.dfe;
+ env.TexMode = GPU.TexMode;
+ env.TWX_AND = GPU.SUCV.TWX_AND;
+ env.TWX_ADD = GPU.SUCV.TWX_ADD;
+ env.TWY_AND = GPU.SUCV.TWY_AND;
+ env.TWY_ADD = GPU.SUCV.TWY_ADD;
+ env.DisplayMode = GPU.DisplayMode;
+ env.DisplayFB_YStart = GPU.DisplayFB_YStart;
+ env.field_ram_readout = GPU.field_ram_readout;
+
+ return env;
+}
+
+static INLINE void RecordEnv(void)
+{
+ const ENV_S env = CaptureEnv();
+
+ if(MDFN_LIKELY(LastEnvValid) && !memcmp(&env, &LastEnv, sizeof(ENV_S)))
+  return;
+
+ WQ_Entry* e = AllocEntry();
+
+ e->Type = ENTRY_ENV;
+ e->Env = env;
+ CommitEntry();
+
+ LastEnv = env;
+ LastEnvValid = true;
+}
+
+//
+// Queues a drawing entry(or runs it right away, when it reads from its own drawing area), after dealing with
+// hazards against queued entries.
+//
+static void SubmitEntry(const WQ_Entry& ne, const Area& write, const Area* reads, const unsigned reads_count, const int32 dirty_y, const int32 dirty_h)
+{
+ bool self_overlap = false;
+ bool wait = AreaTest(ReadBands, write);
+
+ for(unsigned i = 0; i < reads_count; i++)
+ {
+  wait |= AreaTest(WrittenBands, reads[i]);
+  self_overlap |= AreaOverlap(reads[i], write);
+ }
+
+ if(wait || self_overlap)
+  WaitIdle();
+
+ if(self_overlap)
+ {
+  MainCtx.Env = CaptureEnv();
+  RunEntry(MainCtx, ne);
+  return;
+ }
+
+ AreaMark(WrittenBands, write);
+
+ for(unsigned i = 0; i < reads_count; i++)
+  AreaMark(ReadBands, reads[i]);
+
+ RecordEnv();
+ *AllocEntry() = ne;
+ CommitEntry();
+ MarkDirty(dirty_y, dirty_h);
+}
+
+//
+// Intersects a bounding box of vertex coordinates(with drawing offset applied) with the drawing area; returns false
+// if nothing can be drawn.  Coordinates that may wrap fall back to the whole drawing area.
+//
+static bool CalcDrawArea(int32 min_x, int32 max_x, int32 min_y, int32 max_y, int32* x, int32* y, int32* w, int32* h)
+{
+ int32 x0 = GPU.ClipX0, x1 = GPU.ClipX1;
+ int32 y0 = GPU.ClipY0, y1 = GPU.ClipY1;
+
+ if(min_x >= -1024 && max_x <= 1023)
+ {
+  x0 = std::max<int32>(x0, min_x);
+  x1 = std::min<int32>(x1, max_x);
+ }
+
+ if(min_y >= -1024 && max_y <= 1023)
+ {
+  y0 = std::max<int32>(y0, min_y);
+  y1 = std::min<int32>(y1, max_y);
+ }
+
+ if(x1 < x0 || y1 < y0)
+  return false;
+
+ *x = x0;
+ *y = y0;
+ *w = x1 + 1 - x0;
+ *h = y1 + 1 - y0;
+
+ return true;
+}
+
+static unsigned CalcTexReadAreas(Area* reads, const uint16 clut)
+{
+ const uint32 tm = std::min<uint32>(2, GPU.TexMode);
+ unsigned ret = 0;
+
+ reads[ret++] = MakeArea(GPU.TexPageX, GPU.TexPageY, 64 << tm, 256);
+
+ if(tm < 2)
+  reads[ret++] = MakeArea((clut & 0x3F) << 4, (clut >> 6) & 0x1FF, tm ? 256 : 16, 1);
+
+ return ret;
+}
+
+static void RecordPolygon(const uint32 cc, const uint32* cb)
+{
+ const bool goraud = cc & 0x10;
+ const bool textured = cc & 0x4;
+ WQ_Entry ne;
+ tri_vertex* vertices = ne.Tri;
+ unsigned sv = 0;
+
+ if((cc & 0x8) && GPU.InCmd == PS_GPU::INCMD_QUAD)
+ {
+  memcpy(&vertices[0], &GPU.InQuad_F3Vertices[1], 2 * sizeof(tri_vertex));
+  sv = 2;
+ }
+
+ for(unsigned v = sv; v < 3; v++)
+ {
+  if(v == 0 || goraud)
+  {
+   const uint32 raw_color = (*cb & 0xFFFFFF);
+
+   vertices[v].r = raw_color & 0xFF;
+   vertices[v].g = (raw_color >> 8) & 0xFF;
+   vertices[v].b = (raw_color >> 16) & 0xFF;
+   cb++;
+  }
+  else
+  {
+   vertices[v].r = vertices[0].r;
+   vertices[v].g = vertices[0].g;
+   vertices[v].b = vertices[0].b;
+  }
+
+  vertices[v].x = sign_x_to_s32(11, ((int16)(*cb & 0xFFFF))) + GPU.OffsX;
+  vertices[v].y = sign_x_to_s32(11, ((int16)(*cb >> 16))) + GPU.OffsY;
+  cb++;
+
+  if(textured)
+  {
+   vertices[v].u = (*cb & 0xFF);
+   vertices[v].v = (*cb >> 8) & 0xFF;
+
+   if(v == 0)
+    LastCLUT = (*cb >> 16) & 0xFFFF;
+
+   cb++;
+  }
+  else
+  {
+   vertices[v].u = 0;
+   vertices[v].v = 0;
+  }
+ }
+
+ //
+ // Same rejection tests as DrawTriangle().
+ //
+ const int32 min_x = std::min<int32>(vertices[0].x, std::min<int32>(vertices[1].x, vertices[2].x));
+ const int32 max_x = std::max<int32>(vertices[0].x, std::max<int32>(vertices[1].x, vertices[2].x));
+ const int32 min_y = std::min<int32>(vertices[0].y, std::min<int32>(vertices[1].y, vertices[2].y));
+ const int32 max_y = std::max<int32>(vertices[0].y, std::max<int32>(vertices[1].y, vertices[2].y));
+
+ if(min_y == max_y || (max_y - min_y) >= 512 || (max_x - min_x) >= 1024)
+  return;
+
+ if(((vertices[1].x - vertices[0].x) * (vertices[2].y - vertices[1].y)) == ((vertices[2].x - vertices[1].x) * (vertices[1].y - vertices[0].y)))
+  return;
+
+ int32 x, y, w, h;
+
+ if(!CalcDrawArea(min_x, max_x, min_y, max_y, &x, &y, &w, &h))
+  return;
+
+ Area reads[2];
+ unsigned reads_count = 0;
+
+ ne.Type = ENTRY_POLYGON;
+ ne.Flags = (goraud ? PF_GORAUD : 0) | (textured ? PF_TEXTURED : 0) | ((textured && !(cc & 0x1)) ? PF_TEXMULT : 0);
+ ne.BlendMode = (cc & 0x2) ? GPU.abr : -1;
+ ne.CLUT = LastCLUT;
+
+ if(textured)
+  reads_count = CalcTexReadAreas(reads, ne.CLUT);
+
+ SubmitEntry(ne, MakeArea(x, y, w, h), reads, reads_count, y, h);
+}
+
+static void RecordSprite(const uint32 cc, const uint32* cb)
+{
+ const bool textured = cc & 0x4;
+ WQ_Entry ne;
+ int32 x, y, w, h;
+ uint32 u = 0, v = 0;
+ uint16 clut = 0;
+ const uint32 color = *cb & 0x00FFFFFF;
+
+ cb++;
+
+ x = sign_x_to_s32(11, (*cb & 0xFFFF));
+ y = sign_x_to_s32(11, (*cb >> 16));
+ cb++;
+
+ if(textured)
+ {
+  u = *cb & 0xFF;
+  v = (*cb >> 8) & 0xFF;
+  clut = (*cb >> 16) & 0xFFFF;
+  cb++;
+ }
+
+ switch((cc >> 3) & 0x3)
+ {
+  default:
+  case 0:
+	w = (*cb & 0x3FF);
+	h = (*cb >> 16) & 0x1FF;
+	break;
+
+  case 1: w = 1; h = 1; break;
+  case 2: w = 8; h = 8; break;
+  case 3: w = 16; h = 16; break;
+ }
+
+ x = sign_x_to_s32(11, x + GPU.OffsX);
+ y = sign_x_to_s32(11, y + GPU.OffsY);
+
+ int32 ax, ay, aw, ah;
+
+ if(!w || !h || !CalcDrawArea(x, x + w - 1, y, y + h - 1, &ax, &ay, &aw, &ah))
+  return;
+
+ Area reads[2];
+ unsigned reads_count = 0;
+
+ ne.Type = ENTRY_SPRITE;
+ ne.Flags = (textured ? PF_TEXTURED : 0) | ((textured && !(cc & 0x1) && color != 0x808080) ? PF_TEXMULT : 0);
+ ne.BlendMode = (cc & 0x2) ? GPU.abr : -1;
+ ne.CLUT = clut;
+ ne.Sprite.x = x;
+ ne.Sprite.y = y;
+ ne.Sprite.w = w;
+ ne.Sprite.h = h;
+ ne.Sprite.u = u;
+ ne.Sprite.v = v;
+ ne.Sprite.color = color;
+ ne.Sprite.flip = GPU.SpriteFlip & 0x3000;
+
+ if(textured)
+  reads_count = CalcTexReadAreas(reads, clut);
+
+ SubmitEntry(ne, MakeArea(ax, ay, aw, ah), reads, reads_count, ay, ah);
+}
+
+static void RecordLine(const uint32 cc, const uint32* cb)
+{
+ const bool polyline = cc & 0x08;
+ const bool goraud = cc & 0x10;
+ WQ_Entry ne;
+ line_point* points = ne.Line;
+
+ if(polyline && GPU.InCmd == PS_GPU::INCMD_PLINE)
+  points[0] = GPU.InPLine_PrevPoint;
+ else
+ {
+  points[0].r = (*cb >> 0) & 0xFF;
+  points[0].g = (*cb >> 8) & 0xFF;
+  points[0].b = (*cb >> 16) & 0xFF;
+  cb++;
+
+  points[0].x = sign_x_to_s32(11, ((*cb >> 0) & 0xFFFF)) + GPU.OffsX;
+  points[0].y = sign_x_to_s32(11, ((*cb >> 16) & 0xFFFF)) + GPU.OffsY;
+  cb++;
+ }
+
+ if(goraud)
+ {
+  points[1].r = (*cb >> 0) & 0xFF;
+  points[1].g = (*cb >> 8) & 0xFF;
+  points[1].b = (*cb >> 16) & 0xFF;
+  cb++;
+ }
+ else
+ {
+  points[1].r = points[0].r;
+  points[1].g = points[0].g;
+  points[1].b = points[0].b;
+ }
+
+ points[1].x = sign_x_to_s32(11, ((*cb >> 0) & 0xFFFF)) + GPU.OffsX;
+ points[1].y = sign_x_to_s32(11, ((*cb >> 16) & 0xFFFF)) + GPU.OffsY;
+
+ //
+ // Same rejection tests and point order as DrawLine().
+ //
+ const int32 i_dx = abs(points[1].x - points[0].x);
+ const int32 i_dy = abs(points[1].y - points[0].y);
+
+ if(i_dx >= 1024 || i_dy >= 512)
+  return;
+
+ if(points[0].x >= points[1].x && (i_dx || i_dy))
+  std::swap(points[0], points[1]);
+
+ int32 x, y, w, h;
+
+ // Line coordinates wrap at 2048, so don't narrow the drawing area with them.
+ if(!CalcDrawArea(INT32_MIN, INT32_MAX, INT32_MIN, INT32_MAX, &x, &y, &w, &h))
+  return;
+
+ ne.Type = ENTRY_LINE;
+ ne.Flags = goraud ? PF_GORAUD : 0;
+ ne.BlendMode = (cc & 0x2) ? GPU.abr : -1;
+
+ SubmitEntry(ne, MakeArea(x, y, w, h), NULL, 0, y, h);
+}
+
+MDFN_FASTCALL void RecordCommand(const uint32 cc, const uint32* cb)
+{
+ //
+ // Includes FB write setup(0xA0-0xBF), whose data then goes through RecordFBData().
+ //
+ if(FBDataCount)
+  CommitFBData();
+
+ if(cc == 0x02)
+ {
+  const uint32 x = cb[1] & 0x3F0;
+  const uint32 y = (cb[1] >> 16) & 0x3FF;
+  const uint32 w = ((cb[2] & 0x3FF) + 0xF) & ~0xF;
+  const uint32 h = (cb[2] >> 16) & 0x1FF;
+  WQ_Entry ne;
+
+  if(!w || !h)
+   return;
+
+  ne.Type = ENTRY_FBFILL;
+  memcpy(ne.CB, cb, sizeof(ne.CB));
+  SubmitEntry(ne, MakeArea(x, y, w, h), NULL, 0, y, h);
+ }
+ else if(cc >= 0x20 && cc <= 0x3F)
+  RecordPolygon(cc, cb);
+ else if(cc >= 0x40 && cc <= 0x5F)
+  RecordLine(cc, cb);
+ else if(cc >= 0x60 && cc <= 0x7F)
+  RecordSprite(cc, cb);
+ else if(cc >= 0x80 && cc <= 0x9F)
+ {
+  WaitIdle();
+  DrawHiFBCopy(CaptureEnv(), cb);
+ }
+}
+
+MDFN_FASTCALL void RecordFBData(const uint32 V)
+{
+ if(!FBDataCount)
+ {
+  //
+  // Lines the 32 pixels of a full entry can reach.
+  //
+  const uint32 rows = std::min<uint32>((GPU.FBRW_CurX - GPU.FBRW_X + 0x20 + GPU.FBRW_W - 1) / GPU.FBRW_W, GPU.FBRW_Y + GPU.FBRW_H - GPU.FBRW_CurY);
+  const Area write = MakeArea(GPU.FBRW_X, GPU.FBRW_CurY, GPU.FBRW_W, std::max<uint32>(1, rows));
+
+  if(AreaTest(ReadBands, write))
+   WaitIdle();
+
+  AreaMark(WrittenBands, write);
+
+  RecordEnv();
+
+  WQ_Entry* e = AllocEntry();
+
+  e->Type = ENTRY_FBDATA;
+  e->FB.X = GPU.FBRW_X;
+  e->FB.W = GPU.FBRW_W;
+  e->FB.EndY = GPU.FBRW_Y + GPU.FBRW_H;
+  e->FB.CurX = GPU.FBRW_CurX;
+  e->FB.CurY = GPU.FBRW_CurY;
+ }
+
+ ITC.WQ[ITC.WritePos & (WQ_Size - 1)].FB.Data[FBDataCount++] = V;
+
+ if(FBDataCount == 0x10)
+  CommitFBData();
+}
+
+void Flush(void)
+{
+ if(FBDataCount)
+  CommitFBData();
+
+ Publish();
+}
+
+MDFN_FASTCALL void WaitLine(const uint32 y)
+{
+ unsigned nc = 0;
+
+ if(FBDataCount)
+  Flush();
+
+ if(!DirtyRangesCount)
+  return;
+
+ TileThread& t = ITC.TT[BandOwner[(y & 511) >> 3]];
+
+ for(unsigned i = 0; i < NumThreads; i++)
+  ITC.TT[i].ReadPos = ITC.TT[i].TMP_ReadPos.load(std::memory_order_acquire);
+
+ const uint32 min_read_pos = MinReadPos();
+
+ for(unsigned i = 0; i < DirtyRangesCount; i++)
+ {
+  const DirtyRange& r = DirtyRanges[i];
+
+  if(PosReached(min_read_pos, r.pos))
+   continue;
+
+  if(((y - r.y) & 511) < r.count)
+   WaitThread(t, r.pos);
+
+  DirtyRanges[nc++] = r;
+ }
+
+ DirtyRangesCount = nc;
+}
+
+void Sync(void)
+{
+ Flush();
+ WaitIdle();
+ DirtyRangesCount = 0;
+}
+
+void Reset(void)
+{
+ const unsigned s = Shift;
+
+ for(uint32 y = 0; y < (512U << s); y++)
+ {
+  uint16* const line = HiLine(y);
+
+  for(uint32 x = 0; x < (1024U << s); x++)
+   line[x] = GPU.GPURAM[y >> s][x >> s];
+ }
+
+ LastEnvValid = false;
+ LastCLUT = GPU.CLUT_Cache_VB & 0x7FFF;
+}
+
+void PokeRAM(const uint32 x, const uint32 y, const uint16 V)
+{
+ const unsigned s = Shift;
+
+ Sync();
+
+ for(uint32 sy = 0; sy < (1U << s); sy++)
+  for(uint32 sx = 0; sx < (1U << s); sx++)
+   HiLine((y << s) + sy)[(x << s) + sx] = V;
+}
+
+const uint16* GetLine(const uint32 y)
+{
+ return HiLine(y);
+}
+
+void Init(const unsigned shift, const unsigned num_threads)
+{
+ Shift = shift;
+ NumThreads = std::max<unsigned>(1, std::min<unsigned>(MaxThreads, num_threads));
+
+ HiRAM.reset(new uint16[(size_t)(512 << Shift) << (10 + Shift)]);
+ memset(HiRAM.get(), 0, ((size_t)(512 << Shift) << (10 + Shift)) * sizeof(uint16));
+
+ for(unsigned band = 0; band < 64; band++)
+  BandOwner[band] = band % NumThreads;
+
+ ITC.WritePos = 0;
+ ITC.PubWritePos = 0;
+ ITC.TMP_WritePos.store(0, std::memory_order_release);
+
+ LastEnvValid = false;
+ LastCLUT = 0;
+ FBDataCount = 0;
+ DirtyRangesCount = 0;
+ memset(WrittenBands, 0, sizeof(WrittenBands));
+ memset(ReadBands, 0, sizeof(ReadBands));
+
+ MainCtx.Env = CaptureEnv();
+ MainCtx.Owner = AllOwner;
+ MainCtx.ID = 0;
+ //
+ ITC.WakeupSem = MThreading::Sem_Create();
+
+ for(unsigned i = 0; i < NumThreads; i++)
+ {
+  TileThread& t = ITC.TT[i];
+  char name[32];
+
+  t.ReadPos = 0;
+  t.TMP_ReadPos.store(0, std::memory_order_release);
+  t.Waiting.store(false);
+  t.Ctx.Env = MainCtx.Env;
+  t.Ctx.Owner = BandOwner;
+  t.Ctx.ID = i;
+  t.WakeupSem = MThreading::Sem_Create();
+
+  trio_snprintf(name, sizeof(name), "GPU Upscale %u", i);
+  t.Thread = MThreading::Thread_Create(TileThreadEntry, &t, name);
+ }
+}
+
+void Kill(void)
+{
+ if(NumThreads)
+ {
+  Flush();
+  AllocEntry()->Type = ENTRY_EXIT;
+  CommitEntry();
+  Publish();
+
+  for(unsigned i = 0; i < NumThreads; i++)
+  {
+   TileThread& t = ITC.TT[i];
+
+   MThreading::Thread_Wait(t.Thread, NULL);
+   t.Thread = NULL;
+
+   MThreading::Sem_Destroy(t.WakeupSem);
+   t.WakeupSem = NULL;
+  }
+
+  NumThreads = 0;
+ }
+
+ if(ITC.WakeupSem)
+ {
+  MThreading::Sem_Destroy(ITC.WakeupSem);
+  ITC.WakeupSem = NULL;
+ }
+
+ HiRAM.reset(nullptr);
+}
+
+}
+}
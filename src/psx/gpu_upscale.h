@@ -0,0 +1,71 @@
+/******************************************************************************/
+/* Mednafen Sony PS1 Emulation Module                                         */
+/******************************************************************************/
+/* gpu_upscale.h:
+**  Copyright (C) 2025 Mednafen Team
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public License
+** as published by the Free Software Foundation; either version 2
+** of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software Foundation, Inc.,
+** 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef __MDFN_PSX_GPU_UPSCALE_H
+#define __MDFN_PSX_GPU_UPSCALE_H
+
+namespace MDFN_IEN_PSX
+{
+namespace PS_GPU_UPSCALE
+{
+ void Init(const unsigned shift, const unsigned num_threads) MDFN_COLD;
+ void Kill(void) MDFN_COLD;
+
+ //
+ // Rebuilds the high-resolution VRAM from GPURAM(nearest-neighbor); only call after Sync().
+ //
+ void Reset(void) MDFN_COLD;
+
+ //
+ // Waits until the tile threads have finished processing everything queued.
+ //
+ void Sync(void);
+
+ //
+ // Commands with pixel output(FB fill, FB copy, FB write setup, polygons, lines, sprites); called before the command
+ // is run on the emulation thread, so that the quad/polyline continuation state in GPU is still that of the previous
+ // command.
+ //
+ MDFN_FASTCALL void RecordCommand(const uint32 cc, const uint32* cb);
+ MDFN_FASTCALL void RecordFBData(const uint32 V);
+
+ //
+ // Makes queued commands visible to the tile threads.
+ //
+ void Flush(void);
+
+ //
+ // Waits until all queued commands that may write to VRAM line 'y' have been processed.
+ //
+ MDFN_FASTCALL void WaitLine(const uint32 y);
+
+ //
+ // Debugger GPURAM write.
+ //
+ void PokeRAM(const uint32 x, const uint32 y, const uint16 V);
+
+ //
+ // Row 'y' of the high-resolution VRAM, (1024 << shift) pixels wide.
+ //
+ const uint16* GetLine(const uint32 y);
+}
+}
+#endif
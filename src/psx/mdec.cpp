@@ -65,13 +65,17 @@
 #include "mdec.h"
 #include "FastFIFO.h"
 
-#if defined(__SSE2__) || (defined(ARCH_X86) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
-#include <xmmintrin.h>
-#include <emmintrin.h>
-#endif
+#include <mednafen/FileStream.h>
+#include <mednafen/hash/md5.h>
+#include <mednafen/Time.h>
 
-#if 0 //defined(HAVE_NEON_INTRINSICS)
-#include <arm_neon.h>
+#if defined(__SSE2__) || (defined(ARCH_X86) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+ #define MDEC_SIMD_SSE2 1
+ #include <xmmintrin.h>
+ #include <emmintrin.h>
+#elif defined(HAVE_NEON_INTRINSICS)
+ #define MDEC_SIMD_NEON 1
+ #include <arm_neon.h>
 #endif
 
 #if defined(HAVE_ALTIVEC_INTRINSICS) && defined(HAVE_ALTIVEC_H)
@@ -117,6 +121,12 @@ static uint32 PixelBufferCount32;
 
 static uint16 InCounter;
 
+//
+// Debugging/benchmarking aids, see MDEC_Init() and MDEC_RunBenchmark().
+//
+static std::unique_ptr<Stream> CaptureStream;
+static bool UseRefKernels;
+
 static uint8 RAMOffsetY;
 static uint8 RAMOffsetCounter;
 static uint8 RAMOffsetWWS;
@@ -245,88 +255,9 @@ static INLINE int8 Mask9ClampS8(int32 v)
  return v;
 }
 
-////////////////////////
-//
-//
-#pragma GCC push_options
-
-#if defined(__SSE2__) || (defined(ARCH_X86) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
-//
-//
-//
-#pragma GCC target("sse2")
-template<typename T>
-static INLINE void IDCT_1D_Multi(int16 *in_coeff, T *out_coeff)
-{
- for(unsigned col = 0; col < 8; col++)
- {
-  __m128i c =  _mm_load_si128((__m128i *)&in_coeff[(col * 8)]);
-
-  for(unsigned x = 0; x < 8; x++)
-  {
-   __m128i sum;
-   __m128i m;
-   alignas(16) int32 tmp[4];
-
-   m = _mm_load_si128((__m128i *)&IDCTMatrix[(x * 8)]);
-   sum = _mm_madd_epi16(m, c);
-   sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, (3 << 0) | (2 << 2) | (1 << 4) | (0 << 6)));
-   sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, (1 << 0) | (0 << 2)));
-
-   //_mm_store_ss((float *)&tmp[0], (__m128)sum);
-   _mm_store_si128((__m128i*)tmp, sum);
-
-   if(sizeof(T) == 1)
-    out_coeff[(col * 8) + x] = Mask9ClampS8((tmp[0] + 0x4000) >> 15);
-   else
-    out_coeff[(x * 8) + col] = (tmp[0] + 0x4000) >> 15;
-  }
- }
-}
-//
-//
-//
-#elif 0 //defined(HAVE_NEON_INTRINSICS)
-//
-//
-//
-template<typename T>
-static INLINE void IDCT_1D_Multi(int16 *in_coeff, T *out_coeff)
-{
- for(unsigned col = 0; col < 8; col++)
- {
-  register int16x4_t c0 = vld1_s16(MDFN_ASSUME_ALIGNED(in_coeff + col * 8 + 0, sizeof(int16x4_t)));
-  register int16x4_t c1 = vld1_s16(MDFN_ASSUME_ALIGNED(in_coeff + col * 8 + 4, sizeof(int16x4_t)));
-  int32 buf[8];
-
-  for(unsigned x = 0; x < 8; x++)
-  {
-   register int32x4_t accum;
-   register int32x2_t sum2;
-
-   accum = vdupq_n_s32(0);
-   accum = vmlal_s16(accum, c0, vld1_s16(MDFN_ASSUME_ALIGNED(IDCTMatrix + x * 8 + 0, sizeof(int16x4_t))));
-   accum = vmlal_s16(accum, c1, vld1_s16(MDFN_ASSUME_ALIGNED(IDCTMatrix + x * 8 + 4, sizeof(int16x4_t))));
-   sum2 = vadd_s32(vget_high_s32(accum), vget_low_s32(accum));
-   sum2 = vpadd_s32(sum2, sum2);
-   vst1_lane_s32(buf + x, sum2, 0);
-  }
-
-  for(unsigned x = 0; x < 8; x++)
-  {
-   if(sizeof(T) == 1)
-    out_coeff[(col * 8) + x] = Mask9ClampS8((buf[x] + 0x4000) >> 15);
-   else
-    out_coeff[(x * 8) + col] = (buf[x] + 0x4000) >> 15;
-  }
- }
-}
-//
-//
-//
-#else
-//
 //
+// Reference(scalar) kernels; also the only kernels on targets without SIMD support, and what the SIMD kernels are
+// checked against by "psx.dbg_mdec_bench".
 //
 template<typename T>
 static INLINE void IDCT_1D_Multi(int16 *in_coeff, T *out_coeff)
@@ -349,22 +280,14 @@ static INLINE void IDCT_1D_Multi(int16 *in_coeff, T *out_coeff)
   }
  }
 }
-//
-//
-//
-#endif
 
-static NO_INLINE void IDCT(int16 *in_coeff, int8 *out_coeff)
+static NO_INLINE void IDCT_Ref(int16 *in_coeff, int8 *out_coeff)
 {
  alignas(16) int16 tmpbuf[64];
 
  IDCT_1D_Multi<int16>(in_coeff, tmpbuf);
  IDCT_1D_Multi<int8>(tmpbuf, out_coeff);
 }
-#pragma GCC pop_options
-//
-//
-///////////////////////
 
 static INLINE void YCbCr_to_RGB(const int8 y, const int8 cb, const int8 cr, int &r, int &g, int &b)
 {
@@ -400,6 +323,440 @@ static INLINE uint16 RGB_to_RGB555(uint8 r, uint8 g, uint8 b)
  return((r << 0) | (g << 5) | (b << 10));
 }
 
+static INLINE void EncodeRow24_Ref(const int8* by, const int8* cb, const int8* cr, const uint8 rgb_xor, uint8* pix_out)
+{
+ for(int x = 0; x < 8; x++)
+ {
+  int r, g, b;
+
+  YCbCr_to_RGB(by[x], cb[x >> 1], cr[x >> 1], r, g, b);
+
+  pix_out[0] = r ^ rgb_xor;
+  pix_out[1] = g ^ rgb_xor;
+  pix_out[2] = b ^ rgb_xor;
+  pix_out += 3;
+ }
+}
+
+static INLINE void EncodeRow16_Ref(const int8* by, const int8* cb, const int8* cr, const uint16 pixel_xor, uint16* pix_out)
+{
+ for(int x = 0; x < 8; x++)
+ {
+  int r, g, b;
+
+  YCbCr_to_RGB(by[x], cb[x >> 1], cr[x >> 1], r, g, b);
+
+  MDFN_en16lsb<true>(pix_out, pixel_xor ^ RGB_to_RGB555(r, g, b));
+  pix_out++;
+ }
+}
+
+////////////////////////
+//
+// SIMD kernels, bit-exact with the reference kernels above.
+//
+// IDCT: Each 1D pass computes a whole output row per input row, with the IDCT matrix
+// columns kept in registers and each input coefficient(pair) broadcast; the first pass'
+// results come out as columns, so there's one 8x8 transpose between the two passes.
+// Sums wrap at 32 bits just like the scalar code's.
+//
+// Color conversion: 8 pixels at a time in 16-bit lanes; the products that won't fit
+// in 16 bits are split up so as to give the same results:
+//	((359 * cr) + 0x80) >> 8 == cr + (((103 * cr) + 0x80) >> 8)
+//	((454 * cb) + 0x80) >> 8 == cb + (((198 * cb) + 0x80) >> 8)
+//	(g_cb + g_cr + 0x80) >> 8 == ((g_cb >> 3) + (g_cr >> 3) + 0x10) >> 5	(g_cb and g_cr are multiples of 8)
+//
+#pragma GCC push_options
+
+#if defined(MDEC_SIMD_SSE2)
+//
+//
+//
+#pragma GCC target("sse2")
+static INLINE void Transpose8x8(__m128i* r)
+{
+ const __m128i a0 = _mm_unpacklo_epi16(r[0], r[1]);
+ const __m128i a1 = _mm_unpackhi_epi16(r[0], r[1]);
+ const __m128i a2 = _mm_unpacklo_epi16(r[2], r[3]);
+ const __m128i a3 = _mm_unpackhi_epi16(r[2], r[3]);
+ const __m128i a4 = _mm_unpacklo_epi16(r[4], r[5]);
+ const __m128i a5 = _mm_unpackhi_epi16(r[4], r[5]);
+ const __m128i a6 = _mm_unpacklo_epi16(r[6], r[7]);
+ const __m128i a7 = _mm_unpackhi_epi16(r[6], r[7]);
+ const __m128i b0 = _mm_unpacklo_epi32(a0, a2);
+ const __m128i b1 = _mm_unpackhi_epi32(a0, a2);
+ const __m128i b2 = _mm_unpacklo_epi32(a1, a3);
+ const __m128i b3 = _mm_unpackhi_epi32(a1, a3);
+ const __m128i b4 = _mm_unpacklo_epi32(a4, a6);
+ const __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+ const __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+ const __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+
+ r[0] = _mm_unpacklo_epi64(b0, b4);
+ r[1] = _mm_unpackhi_epi64(b0, b4);
+ r[2] = _mm_unpacklo_epi64(b1, b5);
+ r[3] = _mm_unpackhi_epi64(b1, b5);
+ r[4] = _mm_unpacklo_epi64(b2, b6);
+ r[5] = _mm_unpackhi_epi64(b2, b6);
+ r[6] = _mm_unpacklo_epi64(b3, b7);
+ r[7] = _mm_unpackhi_epi64(b3, b7);
+}
+
+//
+// Returns the rounded and shifted sums for output elements 0-3 in *lo, and 4-7 in *hi.
+//
+static INLINE void IDCT_1D_Row(const __m128i c, const __m128i (&mp)[4][2], __m128i* lo, __m128i* hi)
+{
+ const __m128i rnd = _mm_set1_epi32(0x4000);
+ __m128i sum_lo = rnd;
+ __m128i sum_hi = rnd;
+
+ for(unsigned k = 0; k < 4; k++)
+ {
+  const __m128i cp = _mm_shuffle_epi32(c, 0x55 * k);
+
+  sum_lo = _mm_add_epi32(sum_lo, _mm_madd_epi16(cp, mp[k][0]));
+  sum_hi = _mm_add_epi32(sum_hi, _mm_madd_epi16(cp, mp[k][1]));
+ }
+
+ *lo = _mm_srai_epi32(sum_lo, 15);
+ *hi = _mm_srai_epi32(sum_hi, 15);
+}
+
+static INLINE __m128i TruncPack32(const __m128i lo, const __m128i hi)
+{
+ return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(lo, 16), 16), _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16));
+}
+
+static INLINE __m128i Mask9Pack32(const __m128i lo, const __m128i hi)
+{
+ return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(lo, 23), 23), _mm_srai_epi32(_mm_slli_epi32(hi, 23), 23));
+}
+
+static NO_INLINE void IDCT(int16 *in_coeff, int8 *out_coeff)
+{
+ __m128i mp[4][2];
+ __m128i t[8];
+
+ //
+ // mp[k][h] lane j = { IDCTMatrix[(4h + j) * 8 + 2k], IDCTMatrix[(4h + j) * 8 + 2k + 1] }
+ //
+ for(unsigned i = 0; i < 8; i++)
+  t[i] = _mm_load_si128((__m128i*)&IDCTMatrix[i * 8]);
+
+ Transpose8x8(t);
+
+ for(unsigned k = 0; k < 4; k++)
+ {
+  mp[k][0] = _mm_unpacklo_epi16(t[k * 2 + 0], t[k * 2 + 1]);
+  mp[k][1] = _mm_unpackhi_epi16(t[k * 2 + 0], t[k * 2 + 1]);
+ }
+
+ for(unsigned col = 0; col < 8; col++)
+ {
+  __m128i lo, hi;
+
+  IDCT_1D_Row(_mm_load_si128((__m128i*)&in_coeff[col * 8]), mp, &lo, &hi);
+  t[col] = TruncPack32(lo, hi);
+ }
+
+ Transpose8x8(t);
+
+ for(unsigned col = 0; col < 8; col += 2)
+ {
+  __m128i lo, hi;
+  __m128i row[2];
+
+  for(unsigned i = 0; i < 2; i++)
+  {
+   IDCT_1D_Row(t[col + i], mp, &lo, &hi);
+   row[i] = Mask9Pack32(lo, hi);
+  }
+
+  _mm_storeu_si128((__m128i*)&out_coeff[col * 8], _mm_packs_epi16(row[0], row[1]));
+ }
+}
+
+static INLINE __m128i LoadS8x8(const int8* p)
+{
+ const __m128i v = _mm_loadl_epi64((const __m128i*)p);
+
+ return _mm_srai_epi16(_mm_unpacklo_epi8(v, v), 8);
+}
+
+//
+// Loads 4 values and doubles each of them up.
+//
+static INLINE __m128i LoadS8x4x2(const int8* p)
+{
+ uint32 tmp;
+ __m128i v;
+
+ memcpy(&tmp, p, sizeof(tmp));
+ v = _mm_cvtsi32_si128(tmp);
+ v = _mm_unpacklo_epi8(v, v);
+
+ return _mm_srai_epi16(_mm_unpacklo_epi8(v, v), 8);
+}
+
+static INLINE __m128i Mask9ClampS8_U8(const __m128i v)
+{
+ const __m128i m = _mm_srai_epi16(_mm_slli_epi16(v, 7), 7);
+
+ return _mm_add_epi16(_mm_max_epi16(_mm_min_epi16(m, _mm_set1_epi16(127)), _mm_set1_epi16(-128)), _mm_set1_epi16(0x80));
+}
+
+//
+// Results are in the range of 0-255.
+//
+static INLINE void YCbCr_to_RGB_8(const int8* by, const int8* cb, const int8* cr, __m128i* r, __m128i* g, __m128i* b)
+{
+ const __m128i rnd = _mm_set1_epi16(0x80);
+ const __m128i y = LoadS8x8(by);
+ const __m128i u = LoadS8x4x2(cb);
+ const __m128i v = LoadS8x4x2(cr);
+ const __m128i rt = _mm_add_epi16(v, _mm_srai_epi16(_mm_add_epi16(_mm_mullo_epi16(v, _mm_set1_epi16(103)), rnd), 8));
+ const __m128i bt = _mm_add_epi16(u, _mm_srai_epi16(_mm_add_epi16(_mm_mullo_epi16(u, _mm_set1_epi16(198)), rnd), 8));
+ const __m128i gu = _mm_srai_epi16(_mm_and_si128(_mm_mullo_epi16(u, _mm_set1_epi16(-88)), _mm_set1_epi16(~0x1F)), 3);
+ const __m128i gv = _mm_srai_epi16(_mm_and_si128(_mm_mullo_epi16(v, _mm_set1_epi16(-183)), _mm_set1_epi16(~0x07)), 3);
+ const __m128i gt = _mm_srai_epi16(_mm_add_epi16(_mm_add_epi16(gu, gv), _mm_set1_epi16(0x10)), 5);
+
+ *r = Mask9ClampS8_U8(_mm_add_epi16(y, rt));
+ *g = Mask9ClampS8_U8(_mm_add_epi16(y, gt));
+ *b = Mask9ClampS8_U8(_mm_add_epi16(y, bt));
+}
+
+static INLINE void EncodeRow24(const int8* by, const int8* cb, const int8* cr, const uint8 rgb_xor, uint8* pix_out)
+{
+ const __m128i xv = _mm_set1_epi8(rgb_xor);
+ __m128i r, g, b;
+ alignas(16) uint8 rg[16];
+ alignas(16) uint8 bb[16];
+
+ YCbCr_to_RGB_8(by, cb, cr, &r, &g, &b);
+
+ _mm_store_si128((__m128i*)rg, _mm_xor_si128(_mm_packus_epi16(r, g), xv));
+ _mm_store_si128((__m128i*)bb, _mm_xor_si128(_mm_packus_epi16(b, b), xv));
+
+ for(unsigned x = 0; x < 8; x++)
+ {
+  pix_out[0] = rg[x];
+  pix_out[1] = rg[8 + x];
+  pix_out[2] = bb[x];
+  pix_out += 3;
+ }
+}
+
+static INLINE void EncodeRow16(const int8* by, const int8* cb, const int8* cr, const uint16 pixel_xor, uint16* pix_out)
+{
+ const __m128i four = _mm_set1_epi16(4);
+ const __m128i max = _mm_set1_epi16(0x1F);
+ __m128i r, g, b;
+ __m128i pix;
+
+ YCbCr_to_RGB_8(by, cb, cr, &r, &g, &b);
+
+ r = _mm_min_epi16(_mm_srli_epi16(_mm_add_epi16(r, four), 3), max);
+ g = _mm_min_epi16(_mm_srli_epi16(_mm_add_epi16(g, four), 3), max);
+ b = _mm_min_epi16(_mm_srli_epi16(_mm_add_epi16(b, four), 3), max);
+
+ pix = _mm_or_si128(_mm_or_si128(r, _mm_slli_epi16(g, 5)), _mm_slli_epi16(b, 10));
+ pix = _mm_xor_si128(pix, _mm_set1_epi16(pixel_xor));
+
+ _mm_storeu_si128((__m128i*)pix_out, pix);
+}
+//
+//
+//
+#elif defined(MDEC_SIMD_NEON)
+//
+//
+//
+static INLINE void Transpose8x8(int16x8_t* r)
+{
+ const int16x8x2_t t0 = vtrnq_s16(r[0], r[1]);
+ const int16x8x2_t t1 = vtrnq_s16(r[2], r[3]);
+ const int16x8x2_t t2 = vtrnq_s16(r[4], r[5]);
+ const int16x8x2_t t3 = vtrnq_s16(r[6], r[7]);
+ const int32x4x2_t u0 = vtrnq_s32(vreinterpretq_s32_s16(t0.val[0]), vreinterpretq_s32_s16(t1.val[0]));
+ const int32x4x2_t u1 = vtrnq_s32(vreinterpretq_s32_s16(t0.val[1]), vreinterpretq_s32_s16(t1.val[1]));
+ const int32x4x2_t u2 = vtrnq_s32(vreinterpretq_s32_s16(t2.val[0]), vreinterpretq_s32_s16(t3.val[0]));
+ const int32x4x2_t u3 = vtrnq_s32(vreinterpretq_s32_s16(t2.val[1]), vreinterpretq_s32_s16(t3.val[1]));
+
+ r[0] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(u0.val[0]), vget_low_s32(u2.val[0])));
+ r[1] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(u1.val[0]), vget_low_s32(u3.val[0])));
+ r[2] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(u0.val[1]), vget_low_s32(u2.val[1])));
+ r[3] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(u1.val[1]), vget_low_s32(u3.val[1])));
+ r[4] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(u0.val[0]), vget_high_s32(u2.val[0])));
+ r[5] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(u1.val[0]), vget_high_s32(u3.val[0])));
+ r[6] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(u0.val[1]), vget_high_s32(u2.val[1])));
+ r[7] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(u1.val[1]), vget_high_s32(u3.val[1])));
+}
+
+//
+// Returns the rounded and shifted sums for output elements 0-3 in *lo, and 4-7 in *hi; mt[u] holds column u of the
+// IDCT matrix.
+//
+static INLINE void IDCT_1D_Row(const int16x8_t c, const int16x8_t (&mt)[8], int32x4_t* lo, int32x4_t* hi)
+{
+ const int16x4_t c_lo = vget_low_s16(c);
+ const int16x4_t c_hi = vget_high_s16(c);
+ int32x4_t sum_lo = vdupq_n_s32(0x4000);
+ int32x4_t sum_hi = vdupq_n_s32(0x4000);
+
+ #define MDEC_IDCT_MLA(u, cv, lane)											\
+	sum_lo = vmlal_lane_s16(sum_lo, vget_low_s16(mt[u]), cv, lane);	\
+	sum_hi = vmlal_lane_s16(sum_hi, vget_high_s16(mt[u]), cv, lane);
+
+ MDEC_IDCT_MLA(0, c_lo, 0)
+ MDEC_IDCT_MLA(1, c_lo, 1)
+ MDEC_IDCT_MLA(2, c_lo, 2)
+ MDEC_IDCT_MLA(3, c_lo, 3)
+ MDEC_IDCT_MLA(4, c_hi, 0)
+ MDEC_IDCT_MLA(5, c_hi, 1)
+ MDEC_IDCT_MLA(6, c_hi, 2)
+ MDEC_IDCT_MLA(7, c_hi, 3)
+ #undef MDEC_IDCT_MLA
+
+ *lo = vshrq_n_s32(sum_lo, 15);
+ *hi = vshrq_n_s32(sum_hi, 15);
+}
+
+static NO_INLINE void IDCT(int16 *in_coeff, int8 *out_coeff)
+{
+ int16x8_t mt[8];
+ int16x8_t t[8];
+
+ for(unsigned i = 0; i < 8; i++)
+  mt[i] = vld1q_s16(MDFN_ASSUME_ALIGNED(IDCTMatrix + i * 8, sizeof(int16x8_t)));
+
+ Transpose8x8(mt);
+
+ for(unsigned col = 0; col < 8; col++)
+ {
+  int32x4_t lo, hi;
+
+  IDCT_1D_Row(vld1q_s16(MDFN_ASSUME_ALIGNED(in_coeff + col * 8, sizeof(int16x8_t))), mt, &lo, &hi);
+  t[col] = vcombine_s16(vmovn_s32(lo), vmovn_s32(hi));
+ }
+
+ Transpose8x8(t);
+
+ for(unsigned col = 0; col < 8; col++)
+ {
+  int32x4_t lo, hi;
+
+  IDCT_1D_Row(t[col], mt, &lo, &hi);
+  lo = vshrq_n_s32(vshlq_n_s32(lo, 23), 23);
+  hi = vshrq_n_s32(vshlq_n_s32(hi, 23), 23);
+
+  vst1_s8(out_coeff + col * 8, vqmovn_s16(vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi))));
+ }
+}
+
+//
+// Loads 4 values and doubles each of them up.
+//
+static INLINE int16x8_t LoadS8x4x2(const int8* p)
+{
+ uint32 tmp;
+ int8x8_t v;
+
+ memcpy(&tmp, p, sizeof(tmp));
+ v = vreinterpret_s8_u32(vdup_n_u32(tmp));
+
+ return vmovl_s8(vzip_s8(v, v).val[0]);
+}
+
+static INLINE uint8x8_t Mask9ClampS8_U8(const int16x8_t v)
+{
+ const int16x8_t m = vshrq_n_s16(vshlq_n_s16(v, 7), 7);
+
+ return veor_u8(vreinterpret_u8_s8(vqmovn_s16(m)), vdup_n_u8(0x80));
+}
+
+static INLINE void YCbCr_to_RGB_8(const int8* by, const int8* cb, const int8* cr, uint8x8_t* r, uint8x8_t* g, uint8x8_t* b)
+{
+ const int16x8_t rnd = vdupq_n_s16(0x80);
+ const int16x8_t y = vmovl_s8(vld1_s8(by));
+ const int16x8_t u = LoadS8x4x2(cb);
+ const int16x8_t v = LoadS8x4x2(cr);
+ const int16x8_t rt = vaddq_s16(v, vshrq_n_s16(vmlaq_n_s16(rnd, v, 103), 8));
+ const int16x8_t bt = vaddq_s16(u, vshrq_n_s16(vmlaq_n_s16(rnd, u, 198), 8));
+ const int16x8_t gu = vshrq_n_s16(vandq_s16(vmulq_n_s16(u, -88), vdupq_n_s16(~0x1F)), 3);
+ const int16x8_t gv = vshrq_n_s16(vandq_s16(vmulq_n_s16(v, -183), vdupq_n_s16(~0x07)), 3);
+ const int16x8_t gt = vshrq_n_s16(vaddq_s16(vaddq_s16(gu, gv), vdupq_n_s16(0x10)), 5);
+
+ *r = Mask9ClampS8_U8(vaddq_s16(y, rt));
+ *g = Mask9ClampS8_U8(vaddq_s16(y, gt));
+ *b = Mask9ClampS8_U8(vaddq_s16(y, bt));
+}
+
+static INLINE void EncodeRow24(const int8* by, const int8* cb, const int8* cr, const uint8 rgb_xor, uint8* pix_out)
+{
+ const uint8x8_t xv = vdup_n_u8(rgb_xor);
+ uint8x8x3_t rgb;
+
+ YCbCr_to_RGB_8(by, cb, cr, &rgb.val[0], &rgb.val[1], &rgb.val[2]);
+
+ for(unsigned i = 0; i < 3; i++)
+  rgb.val[i] = veor_u8(rgb.val[i], xv);
+
+ vst3_u8(pix_out, rgb);
+}
+
+static INLINE void EncodeRow16(const int8* by, const int8* cb, const int8* cr, const uint16 pixel_xor, uint16* pix_out)
+{
+ const uint16x8_t max = vdupq_n_u16(0x1F);
+ uint8x8_t r8, g8, b8;
+ uint16x8_t r, g, b;
+ uint16x8_t pix;
+
+ YCbCr_to_RGB_8(by, cb, cr, &r8, &g8, &b8);
+
+ r = vminq_u16(vshrq_n_u16(vaddw_u8(vdupq_n_u16(4), r8), 3), max);
+ g = vminq_u16(vshrq_n_u16(vaddw_u8(vdupq_n_u16(4), g8), 3), max);
+ b = vminq_u16(vshrq_n_u16(vaddw_u8(vdupq_n_u16(4), b8), 3), max);
+
+ pix = vorrq_u16(vorrq_u16(r, vshlq_n_u16(g, 5)), vshlq_n_u16(b, 10));
+ pix = veorq_u16(pix, vdupq_n_u16(pixel_xor));
+#ifdef MSB_FIRST
+ pix = vreinterpretq_u16_u8(vrev16q_u8(vreinterpretq_u8_u16(pix)));
+#endif
+ vst1q_u16(pix_out, pix);
+}
+//
+//
+//
+#else
+//
+//
+//
+static INLINE void IDCT(int16 *in_coeff, int8 *out_coeff)
+{
+ IDCT_Ref(in_coeff, out_coeff);
+}
+
+static INLINE void EncodeRow24(const int8* by, const int8* cb, const int8* cr, const uint8 rgb_xor, uint8* pix_out)
+{
+ EncodeRow24_Ref(by, cb, cr, rgb_xor, pix_out);
+}
+
+static INLINE void EncodeRow16(const int8* by, const int8* cb, const int8* cr, const uint16 pixel_xor, uint16* pix_out)
+{
+ EncodeRow16_Ref(by, cb, cr, pixel_xor, pix_out);
+}
+//
+//
+//
+#endif
+
+#pragma GCC pop_options
+//
+//
+///////////////////////
+
+template<bool ref>
 static void EncodeImage(const unsigned ybn)
 {
  //printf("ENCODE, %d\n", (Command & 0x08000000) ? 256 : 384);
@@ -456,18 +813,13 @@ static void EncodeImage(const unsigned ybn)
     const int8* by = &block_y[y][0];
     const int8* cb = &block_cb[(y >> 1) | ((ybn & 2) << 1)][(ybn & 1) << 2];
     const int8* cr = &block_cr[(y >> 1) | ((ybn & 2) << 1)][(ybn & 1) << 2];
-    
-    for(int x = 0; x < 8; x++)
-    {
-     int r, g, b;
 
-     YCbCr_to_RGB(by[x], cb[x >> 1], cr[x >> 1], r, g, b);
+    if(ref)
+     EncodeRow24_Ref(by, cb, cr, rgb_xor, pix_out);
+    else
+     EncodeRow24(by, cb, cr, rgb_xor, pix_out);
 
-     pix_out[0] = r ^ rgb_xor;
-     pix_out[1] = g ^ rgb_xor;
-     pix_out[2] = b ^ rgb_xor;
-     pix_out += 3;
-    }
+    pix_out += 8 * 3;
    }
    PixelBufferCount32 = 48;
   }
@@ -484,15 +836,12 @@ static void EncodeImage(const unsigned ybn)
     const int8* cb = &block_cb[(y >> 1) | ((ybn & 2) << 1)][(ybn & 1) << 2];
     const int8* cr = &block_cr[(y >> 1) | ((ybn & 2) << 1)][(ybn & 1) << 2];
 
-    for(int x = 0; x < 8; x++)
-    {
-     int r, g, b;
-
-     YCbCr_to_RGB(by[x], cb[x >> 1], cr[x >> 1], r, g, b);
+    if(ref)
+     EncodeRow16_Ref(by, cb, cr, pixel_xor, pix_out);
+    else
+     EncodeRow16(by, cb, cr, pixel_xor, pix_out);
 
-     MDFN_en16lsb<true>(pix_out, pixel_xor ^ RGB_to_RGB555(r, g, b));
-     pix_out++;
-    }
+    pix_out += 8;
    }
    PixelBufferCount32 = 32;
   }
@@ -501,6 +850,14 @@ static void EncodeImage(const unsigned ybn)
  }
 }
 
+static INLINE void DoIDCT(int8* out_coeff)
+{
+ if(MDFN_UNLIKELY(UseRefKernels))
+  IDCT_Ref(Coeff, out_coeff);
+ else
+  IDCT(Coeff, out_coeff);
+}
+
 static INLINE void WriteImageData(uint16 V, int32* eat_cycles)
 {
  const uint32 qmw = (bool)(DecodeWB < 2);
@@ -575,12 +932,12 @@ static INLINE void WriteImageData(uint16 V, int32* eat_cycles)
 
    switch(DecodeWB)
    {
-    case 0: IDCT(Coeff, MDAP(block_cr)); break;
-    case 1: IDCT(Coeff, MDAP(block_cb)); break;
-    case 2: IDCT(Coeff, MDAP(block_y)); break;
-    case 3: IDCT(Coeff, MDAP(block_y)); break;
-    case 4: IDCT(Coeff, MDAP(block_y)); break;
-    case 5: IDCT(Coeff, MDAP(block_y)); break;
+    case 0: DoIDCT(MDAP(block_cr)); break;
+    case 1: DoIDCT(MDAP(block_cb)); break;
+    case 2: DoIDCT(MDAP(block_y)); break;
+    case 3: DoIDCT(MDAP(block_y)); break;
+    case 4: DoIDCT(MDAP(block_y)); break;
+    case 5: DoIDCT(MDAP(block_y)); break;
    }   
 
    // Timing in the PS1 MDEC is complex due to (apparent) pipelining, but the average when decoding a large number of blocks is
@@ -589,7 +946,10 @@ static INLINE void WriteImageData(uint16 V, int32* eat_cycles)
 
    if(DecodeWB >= 2)
    {
-    EncodeImage((DecodeWB + 4) % 6);
+    if(MDFN_UNLIKELY(UseRefKernels))
+     EncodeImage<true>((DecodeWB + 4) % 6);
+    else
+     EncodeImage<false>((DecodeWB + 4) % 6);
    }
 
    DecodeWB++;
@@ -749,8 +1109,21 @@ MDFN_FASTCALL void MDEC_Run(int32 clocks)
 }
 #endif
 
+static NO_INLINE void CaptureWrite(const uint32 A, const uint32 V)
+{
+ uint8 buf[8];
+
+ MDFN_en32lsb(&buf[0], A & 4);
+ MDFN_en32lsb(&buf[4], V);
+
+ CaptureStream->write(buf, sizeof(buf));
+}
+
 MDFN_FASTCALL void MDEC_DMAWrite(uint32 V)
 {
+ if(MDFN_UNLIKELY(CaptureStream))
+  CaptureWrite(0, V);
+
  if(InFIFO.CanWrite())
  {
   InFIFO.Write(V);
@@ -808,6 +1181,9 @@ bool MDEC_DMACanRead(void)
 
 MDFN_FASTCALL void MDEC_Write(const pscpu_timestamp_t timestamp, uint32 A, uint32 V)
 {
+ if(MDFN_UNLIKELY(CaptureStream))
+  CaptureWrite(A, V);
+
  //PSX_WARNING("[MDEC] Write: 0x%08x 0x%08x, %d  --- %u %u", A, V, timestamp, InFIFO.CanRead(), OutFIFO.CanRead());
  if(A & 4)
  {
@@ -886,4 +1262,120 @@ MDFN_FASTCALL uint32 MDEC_Read(const pscpu_timestamp_t timestamp, uint32 A)
  return(ret);
 }
 
+//
+// When 'capture_path' isn't empty, every write to the MDEC registers is logged to that file as a pair of 32-bit
+// little-endian values: the register(0 or 4), and the value written.
+//
+void MDEC_Init(const std::string& capture_path)
+{
+ UseRefKernels = false;
+
+ if(capture_path != "")
+  CaptureStream.reset(new FileStream(capture_path, FileStream::MODE_WRITE));
+}
+
+void MDEC_Kill(void)
+{
+ if(CaptureStream)
+ {
+  try
+  {
+   CaptureStream->close();
+  }
+  catch(std::exception& e)
+  {
+   MDFND_OutputNotice(MDFN_NOTICE_ERROR, e.what());
+  }
+
+  CaptureStream.reset(nullptr);
+ }
+}
+
+//
+// Feeds a capture made via MDEC_Init() through the MDEC, reading out all decoded data as fast as it's made
+// available, and returns the number of 32-bit words read out.
+//
+static uint64 ReplayCapture(const uint8* data, const size_t size, md5_hasher* h)
+{
+ uint64 ret = 0;
+
+ MDEC_Power();
+
+ for(size_t i = 0; i + 8 <= size; i += 8)
+ {
+  const uint32 A = MDFN_de32lsb(&data[i + 0]);
+  const uint32 V = MDFN_de32lsb(&data[i + 4]);
+
+  MDEC_Write(0, A, V);
+
+  do
+  {
+   MDEC_Run(128);
+
+   while(OutFIFO.CanRead())
+   {
+    h->process_scalar<uint32>(OutFIFO.Read());
+    ret++;
+   }
+  } while(InFIFO.CanRead());
+ }
+
+ MDEC_Power();
+
+ return ret;
+}
+
+//
+// Decodes the MDEC register write capture in file 'path' a few times with the SIMD kernels and with the reference
+// kernels, and reports the time taken by each and whether their output matches.
+//
+void MDEC_RunBenchmark(const std::string& path)
+{
+ std::unique_ptr<uint8[]> data;
+ size_t size;
+ int64 best_us[2] = { INT64_MAX, INT64_MAX };
+ md5_digest digest[2];
+ uint64 words = 0;
+
+ {
+  FileStream fp(path, FileStream::MODE_READ);
+
+  size = fp.size();
+  data.reset(new uint8[size]);
+  fp.read(data.get(), size);
+ }
+
+ //
+ // Don't capture the benchmark itself.
+ //
+ std::unique_ptr<Stream> cs = std::move(CaptureStream);
+
+ for(unsigned pass = 0; pass < 3; pass++)
+ {
+  for(unsigned ref = 0; ref < 2; ref++)
+  {
+   md5_hasher h;
+   int64 us;
+
+   UseRefKernels = ref;
+
+   us = Time::MonoUS();
+   words = ReplayCapture(data.get(), size, &h);
+   us = std::max<int64>(1, Time::MonoUS() - us);
+
+   best_us[ref] = std::min(best_us[ref], us);
+   digest[ref] = h.digest();
+  }
+ }
+
+ UseRefKernels = false;
+ CaptureStream = std::move(cs);
+
+ MDFN_printf(_("MDEC benchmark, %llu words of output:\n"), (unsigned long long)words);
+ MDFN_AutoIndent aind(1);
+ MDFN_printf(_("SIMD kernels: %.2f ms\n"), best_us[0] / 1000.0);
+ MDFN_printf(_("Reference kernels: %.2f ms\n"), best_us[1] / 1000.0);
+ MDFN_printf(_("Output: %s\n"), (digest[0] == digest[1]) ? _("identical") : _("DIFFERENT"));
+}
+
 }
@@ -33,7 +33,10 @@ MDFN_FASTCALL void MDEC_Write(const pscpu_timestamp_t timestamp, uint32 A, uint3
 MDFN_FASTCALL uint32 MDEC_Read(const pscpu_timestamp_t timestamp, uint32 A);
 
 
+void MDEC_Init(const std::string& capture_path) MDFN_COLD;
+void MDEC_Kill(void) MDFN_COLD;
 void MDEC_Power(void) MDFN_COLD;
+void MDEC_RunBenchmark(const std::string& path) MDFN_COLD;
 
 bool MDEC_DMACanWrite(void);
 bool MDEC_DMACanRead(void);
@@ -31,6 +31,10 @@
 #include <mednafen/PSFLoader.h>
 #include <mednafen/player.h>
 #include <mednafen/hash/sha256.h>
+#include <mednafen/hash/md5.h>
+#include <mednafen/MemoryStream.h>
+#include <mednafen/Time.h>
+#include <mednafen/EventQueue.h>
 #include <mednafen/cheat_formats/psx.h>
 
 #include <zlib.h>
@@ -218,6 +222,23 @@ static const MDFNSetting_EnumList Region_List[] =
  { NULL, 0 },
 };
 
+static const MDFNSetting_EnumList GPURenderer_List[] =
+{
+ { "st", GPU_RENDERER_ST, gettext_noop("Single-threaded"), gettext_noop("GPU rendering is performed in the main emulation thread.") },
+ { "mt", GPU_RENDERER_MT, gettext_noop("Multi-threaded"), gettext_noop("GPU rendering is performed in a dedicated thread; GPU command timing is still computed in the main emulation thread, so emulation results are identical to the single-threaded renderer.") },
+
+ { NULL, 0 }
+};
+
+static const MDFNSetting_EnumList GPUUpscale_List[] =
+{
+ { "1", 0, gettext_noop("Native resolution") },
+ { "2", 1, gettext_noop("2x native resolution") },
+ { "4", 2, gettext_noop("4x native resolution") },
+
+ { NULL, 0 }
+};
+
 static const struct
 {
  const char* version;
@@ -334,103 +355,32 @@ void PSX_SetDMACycleSteal(unsigned stealage)
 
 static pscpu_timestamp_t Running;	// Set to -1 when not desiring exit, and 0 when we are.
 
-struct event_list_entry
-{
- uint32 which;
- pscpu_timestamp_t event_time;
- event_list_entry *prev;
- event_list_entry *next;
-};
-
-static event_list_entry events[PSX_EVENT__COUNT];
+//
+// Ordering of events between PSX_EVENT__SYNFIRST and PSX_EVENT__SYNLAST(exclusive), indexed relative to PSX_EVENT__SYNFIRST + 1.
+//
+enum : unsigned { EventQ_First = PSX_EVENT__SYNFIRST + 1 };
+static EventQueue<PSX_EVENT__SYNLAST - EventQ_First> EventQ;
 
 static void EventReset(void)
 {
- for(unsigned i = 0; i < PSX_EVENT__COUNT; i++)
- {
-  events[i].which = i;
-
-  if(i == PSX_EVENT__SYNFIRST)
-   events[i].event_time = (int32)0x80000000;
-  else if(i == PSX_EVENT__SYNLAST)
-   events[i].event_time = 0x7FFFFFFF;
-  else
-   events[i].event_time = PSX_EVENT_MAXTS;
-
-  events[i].prev = (i > 0) ? &events[i - 1] : NULL;
-  events[i].next = (i < (PSX_EVENT__COUNT - 1)) ? &events[i + 1] : NULL;
- }
+ EventQ.Reset(PSX_EVENT_MAXTS);
 }
 
-//static void RemoveEvent(event_list_entry *e)
-//{
-// e->prev->next = e->next;
-// e->next->prev = e->prev;
-//}
-
 static void RebaseTS(const pscpu_timestamp_t timestamp)
 {
- for(unsigned i = 0; i < PSX_EVENT__COUNT; i++)
- {
-  if(i == PSX_EVENT__SYNFIRST || i == PSX_EVENT__SYNLAST)
-   continue;
+ for(unsigned i = EventQ_First; i < PSX_EVENT__SYNLAST; i++)
+  assert(EventQ.GetTime(i - EventQ_First) > timestamp);
 
-  assert(events[i].event_time > timestamp);
-  events[i].event_time -= timestamp;
- }
+ EventQ.Rebase(timestamp, 0x7FFFFFFF);
 
- CPU->SetEventNT(events[PSX_EVENT__SYNFIRST].next->event_time);
+ CPU->SetEventNT(EventQ.TopTime());
 }
 
 void PSX_SetEventNT(const int type, const pscpu_timestamp_t next_timestamp)
 {
- event_list_entry *e = &events[type];
-
- if(next_timestamp < e->event_time)
- {
-  event_list_entry *fe = e;
-
-  do
-  {
-   fe = fe->prev;
-  }
-  while(next_timestamp < fe->event_time);
-
-  // Remove this event from the list, temporarily of course.
-  e->prev->next = e->next;
-  e->next->prev = e->prev;
-
-  // Insert into the list, just after "fe".
-  e->prev = fe;
-  e->next = fe->next;
-  fe->next->prev = e;
-  fe->next = e;
-
-  e->event_time = next_timestamp;
- }
- else if(next_timestamp > e->event_time)
- {
-  event_list_entry *fe = e;
-
-  do
-  {
-   fe = fe->next;
-  } while(next_timestamp > fe->event_time);
-
-  // Remove this event from the list, temporarily of course
-  e->prev->next = e->next;
-  e->next->prev = e->prev;
-
-  // Insert into the list, just BEFORE "fe".
-  e->prev = fe->prev;
-  e->next = fe;
-  fe->prev->next = e;
-  fe->prev = e;
-
-  e->event_time = next_timestamp;
- }
+ EventQ.Set(type - EventQ_First, next_timestamp);
 
- CPU->SetEventNT(events[PSX_EVENT__SYNFIRST].next->event_time & Running);
+ CPU->SetEventNT(EventQ.TopTime() & Running);
 }
 
 // Called from debug.cpp too.
@@ -445,50 +395,47 @@ void ForceEventUpdates(const pscpu_timestamp_t timestamp)
 
  PSX_SetEventNT(PSX_EVENT_FIO, FIO->Update(timestamp));
 
- CPU->SetEventNT(events[PSX_EVENT__SYNFIRST].next->event_time);
+ CPU->SetEventNT(EventQ.TopTime());
 }
 
 bool MDFN_FASTCALL PSX_EventHandler(const pscpu_timestamp_t timestamp)
 {
- event_list_entry *e = events[PSX_EVENT__SYNFIRST].next;
+ pscpu_timestamp_t event_time;
 
- while(timestamp >= e->event_time)	// If Running = 0, PSX_EventHandler() may be called even if there isn't an event per-se, so while() instead of do { ... } while
+ while(timestamp >= (event_time = EventQ.TopTime()))	// If Running = 0, PSX_EventHandler() may be called even if there isn't an event per-se, so while() instead of do { ... } while
  {
-  event_list_entry *prev = e->prev;
+  const unsigned which = EventQ_First + EventQ.Top();
   pscpu_timestamp_t nt;
 
-  switch(e->which)
+  switch(which)
   {
    default: abort();
 
    case PSX_EVENT_GPU:
-	nt = GPU_Update(e->event_time);
+	nt = GPU_Update(event_time);
 	break;
 
    case PSX_EVENT_CDC:
-	nt = CDC->Update(e->event_time);
+	nt = CDC->Update(event_time);
 	break;
 
    case PSX_EVENT_TIMER:
-	nt = TIMER_Update(e->event_time);
+	nt = TIMER_Update(event_time);
 	break;
 
    case PSX_EVENT_DMA:
-	nt = DMA_Update(e->event_time);
+	nt = DMA_Update(event_time);
 	break;
 
    case PSX_EVENT_FIO:
-	nt = FIO->Update(e->event_time);
+	nt = FIO->Update(event_time);
 	break;
   }
 #if PSX_EVENT_SYSTEM_CHECKS
-  assert(nt > e->event_time);
+  assert(nt > event_time);
 #endif
 
-  PSX_SetEventNT(e->which, nt);
-
-  // Order of events can change due to calling PSX_SetEventNT(), this prev business ensures we don't miss an event due to reordering.
-  e = prev->next;
+  PSX_SetEventNT(which, nt);
  }
 
  return(Running);
@@ -561,7 +508,7 @@ template<typename T, bool IsWrite, bool Access24> static INLINE void MemRW(pscpu
   return;
  }
 
- if(timestamp >= events[PSX_EVENT__SYNFIRST].next->event_time)
+ if(timestamp >= EventQ.TopTime())
   PSX_EventHandler(timestamp);
 
  if(A >= 0x1F801000 && A <= 0x1F802FFF)
@@ -579,7 +526,7 @@ template<typename T, bool IsWrite, bool Access24> static INLINE void MemRW(pscpu
     {
      //timestamp += 15;
 
-     //if(timestamp >= events[PSX_EVENT__SYNFIRST].next->event_time)
+     //if(timestamp >= EventQ.TopTime())
      // PSX_EventHandler(timestamp);
 
      SPU->Write(timestamp, A | 0, V);
@@ -589,7 +536,7 @@ template<typename T, bool IsWrite, bool Access24> static INLINE void MemRW(pscpu
     {
      timestamp += 36;
 
-     if(timestamp >= events[PSX_EVENT__SYNFIRST].next->event_time)
+     if(timestamp >= EventQ.TopTime())
       PSX_EventHandler(timestamp);
 
      V = SPU->Read(timestamp, A);
@@ -602,7 +549,7 @@ template<typename T, bool IsWrite, bool Access24> static INLINE void MemRW(pscpu
     {
      //timestamp += 8;
 
-     //if(timestamp >= events[PSX_EVENT__SYNFIRST].next->event_time)
+     //if(timestamp >= EventQ.TopTime())
      // PSX_EventHandler(timestamp);
 
      SPU->Write(timestamp, A & ~1, V);
@@ -611,7 +558,7 @@ template<typename T, bool IsWrite, bool Access24> static INLINE void MemRW(pscpu
     {
      timestamp += 16; // Just a guess, need to test.
 
-     if(timestamp >= events[PSX_EVENT__SYNFIRST].next->event_time)
+     if(timestamp >= EventQ.TopTime())
       PSX_EventHandler(timestamp);
 
      V = SPU->Read(timestamp, A & ~1);
@@ -1115,10 +1062,63 @@ void PSX_GPULineHook(const pscpu_timestamp_t timestamp, const pscpu_timestamp_t
 using namespace MDFN_IEN_PSX;
 
 
+static bool CPUCachedInterp;
+static unsigned CPUBenchFrames;
+
+static void Emulate(EmulateSpecStruct *espec);
+
+//
+// Runs "psx.dbg_cpu_bench" frames from the current state with the stock interpreter and then with the cached
+// interpreter, reports the emulated frames per second of each, and checks that both end up in the same state.
+//
+static NO_INLINE void RunCPUBenchmark(EmulateSpecStruct* espec, const unsigned frames)
+{
+ MemoryStream start(16 * 1024 * 1024);
+ int64 us[2];
+ md5_digest digest[2];
+
+ MDFNSS_SaveSM(&start, true);
+
+ for(unsigned mode = 0; mode < 2; mode++)
+ {
+  MemoryStream end(16 * 1024 * 1024);
+
+  start.rewind();
+  MDFNSS_LoadSM(&start, true);
+  CPU->SetCachedInterpreter(mode);
+
+  us[mode] = Time::MonoUS();
+  for(unsigned i = 0; i < frames; i++)
+   Emulate(espec);
+  us[mode] = std::max<int64>(1, Time::MonoUS() - us[mode]);
+
+  MDFNSS_SaveSM(&end, true);
+  digest[mode] = md5(end.map(), end.size());
+ }
+
+ start.rewind();
+ MDFNSS_LoadSM(&start, true);
+ CPU->SetCachedInterpreter(CPUCachedInterp);
+
+ MDFN_printf(_("CPU benchmark, %u frames:\n"), frames);
+ MDFN_AutoIndent aind(1);
+ MDFN_printf(_("Interpreter: %.2f frames/s\n"), frames * 1000000.0 / us[0]);
+ MDFN_printf(_("Cached interpreter: %.2f frames/s\n"), frames * 1000000.0 / us[1]);
+ MDFN_printf(_("End states: %s\n"), (digest[0] == digest[1]) ? _("identical") : _("DIFFERENT"));
+}
+
 static void Emulate(EmulateSpecStruct *espec)
 {
  pscpu_timestamp_t timestamp = 0;
 
+ if(MDFN_UNLIKELY(CPUBenchFrames))
+ {
+  const unsigned frames = CPUBenchFrames;
+
+  CPUBenchFrames = 0;
+  RunCPUBenchmark(espec, frames);
+ }
+
 #if PSX_DBGPRINT_ENABLE
  //printf("psx_dbg_puts_pfcc: %7u\n", psx_dbg_puts_pfcc);
  psx_dbg_puts_warned = false;
@@ -1141,7 +1141,7 @@ static void Emulate(EmulateSpecStruct *espec)
 
  FIO->UpdateInput();
  GPU_StartFrame(psf_loader ? NULL : espec);
- SPU->StartFrame(espec->SoundRate, MDFN_GetSettingUI("psx.spu.resamp_quality"));
+ SPU->StartFrame(espec->SoundRate, MDFN_GetSettingUI("psx.spu.resamp_quality"), espec->SoundBuf, espec->SoundBufMaxSize);
 
  Running = -1;
  timestamp = CPU->Run(timestamp, psf_loader == NULL && (psx_dbg_mask & PSX_DBG_BIOS_PRINT), psf_loader != NULL);
@@ -1683,11 +1683,19 @@ static MDFN_COLD void InitCommon(std::vector<CDInterface*> *CDInterfaces, const
  }
 
  CPU = new PS_CPU();
+ CPUCachedInterp = MDFN_GetSettingB("psx.cpu.cached_interp");
+ CPU->SetCachedInterpreter(CPUCachedInterp);
+ CPUBenchFrames = MDFN_GetSettingUI("psx.dbg_cpu_bench");
  SPU = new PS_SPU();
- GPU_Init(region == REGION_EU);
+ GPU_Init(region == REGION_EU, MDFN_GetSettingUI("psx.gpu.renderer"), MDFN_GetSettingUI("psx.affinity.gpu"), MDFN_GetSettingUI("psx.gpu.upscale"), MDFN_GetSettingUI("psx.gpu.upscale_threads"));
  CDC = new PS_CDC();
  FIO = new FrontIO();
 
+ if(MDFN_GetSettingS("psx.dbg_mdec_bench") != "")
+  MDEC_RunBenchmark(MDFN_GetSettingS("psx.dbg_mdec_bench"));
+
+ MDEC_Init(MDFN_GetSettingS("psx.dbg_mdec_capture"));
+
  MDFN_printf("\n");
  for(unsigned pp = 0; pp < 2; pp++)
  {
@@ -2127,6 +2135,8 @@ static MDFN_COLD void Cleanup(void)
 
  GPU_Kill();
 
+ MDEC_Kill();
+
  if(CPU)
  {
   delete CPU;
@@ -2395,10 +2405,23 @@ static const MDFNSetting PSXSettings[] =
 
  { "psx.h_overscan", MDFNSF_NOFLAGS, gettext_noop("Show horizontal overscan area."), NULL, MDFNST_BOOL, "1" },
 
+ { "psx.gpu.renderer", MDFNSF_NOFLAGS, gettext_noop("GPU renderer."), gettext_noop("If you have only one CPU with one physical CPU core, select the single-threaded renderer for better performance."), MDFNST_ENUM, "st", NULL, NULL, NULL, NULL, GPURenderer_List },
+ { "psx.affinity.gpu", MDFNSF_NOFLAGS, gettext_noop("GPU rendering thread CPU affinity mask."), gettext_noop("Set to 0 to disable changing affinity."), MDFNST_UINT, "0", "0x0000000000000000", "0xFFFFFFFFFFFFFFFF" },
+
+ { "psx.gpu.upscale", MDFNSF_NOFLAGS, gettext_noop("GPU internal resolution upscaling factor."), gettext_noop("Everything drawn to VRAM is additionally drawn into a higher-resolution copy of VRAM, by a pool of threads, and 15bpp display modes are output from that copy.  Emulation results are unaffected; 24bpp display modes(typically FMV) are output at native resolution, scaled up."), MDFNST_ENUM, "1", NULL, NULL, NULL, NULL, GPUUpscale_List },
+ { "psx.gpu.upscale_threads", MDFNSF_NOFLAGS, gettext_noop("Number of threads to use for upscaled rendering."), NULL, MDFNST_UINT, "4", "1", "16" },
+
+ { "psx.cpu.cached_interp", MDFNSF_NOFLAGS, gettext_noop("Use the cached CPU interpreter."), gettext_noop("Runs instructions resident in the emulated instruction cache from pre-decoded blocks.  Emulation results, including timing, are identical to the normal interpreter; only host CPU usage differs.  Not used while the debugger is active."), MDFNST_BOOL, "0" },
+
 #if PSX_DBGPRINT_ENABLE
  { "psx.dbg_mask", MDFNSF_NOFLAGS, gettext_noop("Enable debug messages."), NULL, MDFNST_MULTI_ENUM, "none", NULL, NULL, NULL, NULL,  DBGMask_List },
 #endif
 
+ { "psx.dbg_cpu_bench", MDFNSF_SUPPRESS_DOC, gettext_noop("Number of frames to run the CPU interpreter benchmark for, at the start of emulation."), NULL, MDFNST_UINT, "0", "0", "100000" },
+
+ { "psx.dbg_mdec_capture", MDFNSF_SUPPRESS_DOC | MDFNSF_CAT_PATH, gettext_noop("File to log all MDEC register writes to, for use with psx.dbg_mdec_bench."), NULL, MDFNST_STRING, "" },
+ { "psx.dbg_mdec_bench", MDFNSF_SUPPRESS_DOC | MDFNSF_CAT_PATH, gettext_noop("MDEC register write log to run the MDEC decoding benchmark on, at load time."), NULL, MDFNST_STRING, "" },
+
  { "psx.dbg_exe_cdpath", MDFNSF_SUPPRESS_DOC | MDFNSF_CAT_PATH, gettext_noop("CD image to use with .PSX/.EXE loading."), NULL, MDFNST_STRING, "" },
 
  { "psx.used_bios", MDFNSF_NOFLAGS, "The required bios", NULL, MDFNST_STRING, "" },
@@ -2473,5 +2496,6 @@ MDFN_HIDE extern const MDFNGI EmulatedPSX =
  //
 
  2,     // Number of output sound channels
+ true,  // Honors EmulateSpecStruct::skip
 
 };
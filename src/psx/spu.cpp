@@ -99,6 +99,7 @@ PS_SPU::PS_SPU()
 
  IntermediateBufferPos = 0;
  memset(IntermediateBuffer, 0, sizeof(IntermediateBuffer));
+ OutputBuffer = IntermediateBuffer;
 
  resampler = NULL;
 }
@@ -895,7 +896,7 @@ int32 PS_SPU::UpdateFromCDC(int32 clocks)
   {
    // 75%, for some (resampling) headroom.
    for(unsigned lr = 0; lr < 2; lr++)
-    IntermediateBuffer[IntermediateBufferPos][lr] = (output[lr] * 3 + 2) >> 2;
+    OutputBuffer[IntermediateBufferPos][lr] = (output[lr] * 3 + 2) >> 2;
 
    IntermediateBufferPos++;
   }
@@ -1200,7 +1201,7 @@ uint16 PS_SPU::Read(pscpu_timestamp_t timestamp, uint32 A)
 }
 
 
-void PS_SPU::StartFrame(double rate, uint32 quality)
+void PS_SPU::StartFrame(double rate, uint32 quality, int16* SoundBuf, int32 SoundBufMaxSize)
 {
  if((int)rate != last_rate || quality != last_quality)
  {
@@ -1221,6 +1222,14 @@ void PS_SPU::StartFrame(double rate, uint32 quality)
   last_quality = quality;
  }
 
+ //
+ // Nothing to resample at 44.1KHz, so write straight into the frontend's buffer if it can hold as many samples as
+ // IntermediateBuffer; there are no resampler leftovers to keep in order at this rate.
+ //
+ if(last_rate == 44100 && SoundBuf && SoundBufMaxSize >= 4096 && !IntermediateBufferPos)
+  OutputBuffer = (int16 (*)[2])SoundBuf;
+ else
+  OutputBuffer = IntermediateBuffer;
 }
 
 int32 PS_SPU::EndFrame(int16 *SoundBuf, bool reverse)
@@ -1229,8 +1238,8 @@ int32 PS_SPU::EndFrame(int16 *SoundBuf, bool reverse)
  {
   for(unsigned lr = 0; lr < 2; lr++)
   {
-   int16* p0 = &IntermediateBuffer[0][lr];
-   int16* p1 = &IntermediateBuffer[IntermediateBufferPos - 1][lr];
+   int16* p0 = &OutputBuffer[0][lr];
+   int16* p1 = &OutputBuffer[IntermediateBufferPos - 1][lr];
    unsigned count = IntermediateBufferPos >> 1;
 
    while(MDFN_LIKELY(count--))
@@ -1250,7 +1259,14 @@ int32 PS_SPU::EndFrame(int16 *SoundBuf, bool reverse)
  {
   int32 ret = IntermediateBufferPos;
 
-  memcpy(SoundBuf, IntermediateBuffer, IntermediateBufferPos * 2 * sizeof(int16));
+  if(OutputBuffer != IntermediateBuffer)
+  {
+   assert((int16*)OutputBuffer == SoundBuf);
+   OutputBuffer = IntermediateBuffer;
+  }
+  else
+   memcpy(SoundBuf, IntermediateBuffer, IntermediateBufferPos * 2 * sizeof(int16));
+
   IntermediateBufferPos = 0;
 
   return(ret);
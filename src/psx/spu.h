@@ -131,7 +131,7 @@ class PS_SPU
  void WriteDMA(uint32 V);
  uint32 ReadDMA(void);
 
- void StartFrame(double rate, uint32 quality);
+ void StartFrame(double rate, uint32 quality, int16* SoundBuf, int32 SoundBufMaxSize);
  int32 EndFrame(int16 *SoundBuf, bool reverse);
 
  int32 UpdateFromCDC(int32 clocks);
@@ -263,6 +263,10 @@ class PS_SPU
  uint32 IntermediateBufferPos;
  int16 IntermediateBuffer[4096][2];
 
+ // Where samples are written; the frontend's sound buffer, instead of IntermediateBuffer, during frames output at 44.1KHz, so
+ // EndFrame() has nothing to copy.
+ int16 (*OutputBuffer)[2];
+
  public:
  enum
  {
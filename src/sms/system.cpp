@@ -487,6 +487,7 @@ MDFN_HIDE extern const MDFNGI EmulatedSMS =
  256,	// Framebuffer height
 
  2,     // Number of output sound channels
+ true,  // Honors EmulateSpecStruct::skip
 };
 
 MDFN_HIDE extern const MDFNGI EmulatedGG =
@@ -543,5 +544,6 @@ MDFN_HIDE extern const MDFNGI EmulatedGG =
  256,	// Framebuffer height 
 
  2,     // Number of output sound channels
+ true,  // Honors EmulateSpecStruct::skip
 };
 
@@ -1402,6 +1402,7 @@ MDFN_HIDE extern const MDFNGI EmulatedSNES =
  512,	// Framebuffer height
 
  2,     // Number of output sound channels
+ true,  // Honors EmulateSpecStruct::skip
 };
 
 
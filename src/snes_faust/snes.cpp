@@ -1475,5 +1475,6 @@ MDFN_HIDE extern const MDFNGI EmulatedSNES_Faust =
  //
 
  2,     // Number of output sound channels
+ true,  // Honors EmulateSpecStruct::skip
 };
 
@@ -279,6 +279,14 @@ enum
 #else
  #warning "Compiling without AVX inline assembly."
 #endif
+
+#ifdef HAVE_INLINEASM_FMA
+ SIMD_FMA_32X,
+#endif
+
+#ifdef HAVE_INLINEASM_AVX512
+ SIMD_AVX512_64X,
+#endif
 #elif defined(HAVE_SSE_INTRINSICS)
  SIMD_SSE_16X,
 #elif defined(HAVE_ALTIVEC_INTRINSICS)
@@ -332,6 +340,16 @@ NO_INLINE int32 OwlResampler::T_Resample(OwlBuffer* in, const uint32 in_count)
 		DoMAC_AVX_32X_P16(wave, coeffs, coeff_count, I32Out);
 		break;
 #endif
+#ifdef HAVE_INLINEASM_FMA
+	  case SIMD_FMA_32X:
+		DoMAC_FMA_32X(wave, coeffs, coeff_count, I32Out);
+		break;
+#endif
+#ifdef HAVE_INLINEASM_AVX512
+	  case SIMD_AVX512_64X:
+		DoMAC_AVX512_64X(wave, coeffs, coeff_count, I32Out);
+		break;
+#endif
 
 #elif defined(HAVE_SSE_INTRINSICS)
 	case SIMD_SSE_16X:
@@ -356,7 +374,14 @@ NO_INLINE int32 OwlResampler::T_Resample(OwlBuffer* in, const uint32 in_count)
         }
 
 #if defined(ARCH_X86) && defined(HAVE_INLINEASM_AVX)
-	if(TA_SIMD_Type == SIMD_AVX_32X || TA_SIMD_Type == SIMD_AVX_32X_P16)
+	bool need_vzeroupper = (TA_SIMD_Type == SIMD_AVX_32X || TA_SIMD_Type == SIMD_AVX_32X_P16);
+#ifdef HAVE_INLINEASM_FMA
+	need_vzeroupper |= (TA_SIMD_Type == SIMD_FMA_32X);
+#endif
+#ifdef HAVE_INLINEASM_AVX512
+	need_vzeroupper |= (TA_SIMD_Type == SIMD_AVX512_64X);
+#endif
+	if(need_vzeroupper)
 	{
 	 asm volatile("vzeroupper\n\t" : : :
 	 #if defined(__AVX__)
@@ -615,6 +640,27 @@ OwlResampler::OwlResampler(double input_rate, double output_rate, double rate_er
   abort();	// The sky is falling AAAAAAAAAAAAA
  }
  #ifdef ARCH_X86
+ #ifdef HAVE_INLINEASM_AVX512
+ else if((cpuext & CPUTEST_FLAG_AVX512) && MDFN_GetSettingB("resamp_avx512"))
+ {
+  // Opt-in, as 512-bit instructions can lower the core clock on some CPUs enough to cost more than they save here.
+  SIMDTypeString = "AVX-512 (assembly)";
+
+  // AVX-512 loop does 64 MACs per iteration, and then 16 per iteration for the remainder.
+  NumCoeffs = (NumCoeffs + 0xF) &~ 0xF;
+  Resample_ = &OwlResampler::T_Resample<SIMD_AVX512_64X>;
+ }
+ #endif
+ #ifdef HAVE_INLINEASM_FMA
+ else if((cpuext & (CPUTEST_FLAG_AVX2 | CPUTEST_FLAG_FMA3)) == (CPUTEST_FLAG_AVX2 | CPUTEST_FLAG_FMA3))
+ {
+  SIMDTypeString = "FMA (assembly)";
+
+  // FMA loop does 32 MACs per iteration, and then 8 per iteration for the remainder; keep the same granularity as the SSE and AVX loops.
+  NumCoeffs = (NumCoeffs + 0xF) &~ 0xF;
+  Resample_ = &OwlResampler::T_Resample<SIMD_FMA_32X>;
+ }
+ #endif
  #ifdef HAVE_INLINEASM_AVX
  else if((cpuext & CPUTEST_FLAG_AVX) && (NumCoeffs + 0xF) >= 32)
  {
@@ -663,7 +709,11 @@ OwlResampler::OwlResampler(double input_rate, double output_rate, double rate_er
  #ifdef HAVE_NEON_INTRINSICS
  else if(1)
  {
+  #ifdef __aarch64__
+  SIMDTypeString = "NEON (FMA)";
+  #else
   SIMDTypeString = "NEON";
+  #endif
 
   // NEON loop does 16 MACs per iteration.
   NumCoeffs = (NumCoeffs + 0xF) &~ 0xF;
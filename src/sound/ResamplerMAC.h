@@ -264,6 +264,182 @@ static INLINE void DoMAC_AVX_32X_P16(const float* wave, const float *coeffs, int
 }
 #endif
 
+#ifdef HAVE_INLINEASM_FMA
+static INLINE void DoMAC_FMA_32X(const float* wave, const float *coeffs, int32 count, RESAMPLERMAC_OUTTYPE* accum_output)
+{
+ // Multiplies 32 coefficients at a time, then 8 at a time for the remainder; count must be a multiple of 8.
+ int dummy;
+ int32 tmp;
+
+/*
+	?di = wave pointer
+	?si = coeffs pointer
+	ecx = count / 32
+	eax = (count % 32) / 8
+	edx = 32-bit int output pointer
+*/
+ asm volatile(
+"vxorps %%ymm4, %%ymm4, %%ymm4\n\t"
+"vxorps %%ymm5, %%ymm5, %%ymm5\n\t"
+"vxorps %%ymm6, %%ymm6, %%ymm6\n\t"
+"vxorps %%ymm7, %%ymm7, %%ymm7\n\t"
+
+"testl %%ecx, %%ecx\n\t"
+"jz 2f\n\t"
+"1:\n\t"
+
+"vmovups   0(%%" X86_REGC "di), %%ymm0\n\t"
+"vmovups  32(%%" X86_REGC "di), %%ymm1\n\t"
+"vmovups  64(%%" X86_REGC "di), %%ymm2\n\t"
+"vmovups  96(%%" X86_REGC "di), %%ymm3\n\t"
+"vfmadd231ps   0(%%" X86_REGC "si), %%ymm0, %%ymm4\n\t"
+"vfmadd231ps  32(%%" X86_REGC "si), %%ymm1, %%ymm5\n\t"
+"vfmadd231ps  64(%%" X86_REGC "si), %%ymm2, %%ymm6\n\t"
+"vfmadd231ps  96(%%" X86_REGC "si), %%ymm3, %%ymm7\n\t"
+
+"add" X86_REGAT " $128, %%" X86_REGC "si\n\t"
+"add" X86_REGAT " $128, %%" X86_REGC "di\n\t"
+"subl $1, %%ecx\n\t"
+"jnz 1b\n\t"
+
+"2:\n\t"
+"testl %%eax, %%eax\n\t"
+"jz 4f\n\t"
+"3:\n\t"
+
+"vmovups   0(%%" X86_REGC "di), %%ymm0\n\t"
+"vfmadd231ps   0(%%" X86_REGC "si), %%ymm0, %%ymm4\n\t"
+
+"add" X86_REGAT " $32, %%" X86_REGC "si\n\t"
+"add" X86_REGAT " $32, %%" X86_REGC "di\n\t"
+"subl $1, %%eax\n\t"
+"jnz 3b\n\t"
+
+"4:\n\t"
+//
+// Add the four summation ymm regs together into one ymm register, ymm4
+//
+"vaddps  %%ymm5, %%ymm4, %%ymm4\n\t"
+"vaddps  %%ymm7, %%ymm6, %%ymm6\n\t"
+"vaddps  %%ymm6, %%ymm4, %%ymm4\n\t"
+
+//
+// Horizontal addition.
+//
+"vextractf128 $1, %%ymm4, %%xmm5\n\t"
+"vaddps  %%xmm5, %%xmm4, %%xmm4\n\t"
+"vhaddps %%xmm4, %%xmm4, %%xmm4\n\t"
+"vhaddps %%xmm4, %%xmm4, %%xmm4\n\t"
+
+#if RESAMPLERMAC_FLOATOUT
+"vmovss %%xmm4, (%%" X86_REGC "dx)\n\t"
+#else
+"vcvtss2si %%xmm4, %%ecx\n\t"
+#endif
+ : "=D" (dummy), "=S" (dummy), "=c" (tmp), "=a" (dummy)
+ : "D" (wave), "S" (coeffs), "c" (count >> 5), "a" ((count >> 3) & 0x3), "d" (accum_output)
+#ifdef __AVX__
+ : "ymm0", "ymm1", "ymm2", "ymm3", "ymm4", "ymm5", "ymm6", "ymm7", "cc", "memory"
+#elif defined(__SSE__)
+ : "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6", "xmm7", "cc", "memory"
+#else
+ : "cc", "memory"
+#endif
+);
+#if !RESAMPLERMAC_FLOATOUT
+ *accum_output = tmp;
+#endif
+}
+#endif
+
+#ifdef HAVE_INLINEASM_AVX512
+static INLINE void DoMAC_AVX512_64X(const float* wave, const float *coeffs, int32 count, RESAMPLERMAC_OUTTYPE* accum_output)
+{
+ // Multiplies 64 coefficients at a time, then 16 at a time for the remainder; count must be a multiple of 16.
+ int dummy;
+ int32 tmp;
+
+/*
+	?di = wave pointer
+	?si = coeffs pointer
+	ecx = count / 64
+	eax = (count % 64) / 16
+	edx = 32-bit int output pointer
+*/
+ asm volatile(
+"vxorps %%ymm4, %%ymm4, %%ymm4\n\t"	// VEX-encoded xor zeroes the upper half of the zmm register too.
+"vxorps %%ymm5, %%ymm5, %%ymm5\n\t"
+"vxorps %%ymm6, %%ymm6, %%ymm6\n\t"
+"vxorps %%ymm7, %%ymm7, %%ymm7\n\t"
+
+"testl %%ecx, %%ecx\n\t"
+"jz 2f\n\t"
+"1:\n\t"
+
+"vmovups    0(%%" X86_REGC "di), %%zmm0\n\t"
+"vmovups   64(%%" X86_REGC "di), %%zmm1\n\t"
+"vmovups  128(%%" X86_REGC "di), %%zmm2\n\t"
+"vmovups  192(%%" X86_REGC "di), %%zmm3\n\t"
+"vfmadd231ps    0(%%" X86_REGC "si), %%zmm0, %%zmm4\n\t"
+"vfmadd231ps   64(%%" X86_REGC "si), %%zmm1, %%zmm5\n\t"
+"vfmadd231ps  128(%%" X86_REGC "si), %%zmm2, %%zmm6\n\t"
+"vfmadd231ps  192(%%" X86_REGC "si), %%zmm3, %%zmm7\n\t"
+
+"add" X86_REGAT " $256, %%" X86_REGC "si\n\t"
+"add" X86_REGAT " $256, %%" X86_REGC "di\n\t"
+"subl $1, %%ecx\n\t"
+"jnz 1b\n\t"
+
+"2:\n\t"
+"testl %%eax, %%eax\n\t"
+"jz 4f\n\t"
+"3:\n\t"
+
+"vmovups    0(%%" X86_REGC "di), %%zmm0\n\t"
+"vfmadd231ps    0(%%" X86_REGC "si), %%zmm0, %%zmm4\n\t"
+
+"add" X86_REGAT " $64, %%" X86_REGC "si\n\t"
+"add" X86_REGAT " $64, %%" X86_REGC "di\n\t"
+"subl $1, %%eax\n\t"
+"jnz 3b\n\t"
+
+"4:\n\t"
+//
+// Add the four summation zmm regs together into one zmm register, zmm4
+//
+"vaddps  %%zmm5, %%zmm4, %%zmm4\n\t"
+"vaddps  %%zmm7, %%zmm6, %%zmm6\n\t"
+"vaddps  %%zmm6, %%zmm4, %%zmm4\n\t"
+
+//
+// Horizontal addition.
+//
+"vextractf64x4 $1, %%zmm4, %%ymm5\n\t"
+"vaddps  %%ymm5, %%ymm4, %%ymm4\n\t"
+"vextractf128 $1, %%ymm4, %%xmm5\n\t"
+"vaddps  %%xmm5, %%xmm4, %%xmm4\n\t"
+"vhaddps %%xmm4, %%xmm4, %%xmm4\n\t"
+"vhaddps %%xmm4, %%xmm4, %%xmm4\n\t"
+
+#if RESAMPLERMAC_FLOATOUT
+"vmovss %%xmm4, (%%" X86_REGC "dx)\n\t"
+#else
+"vcvtss2si %%xmm4, %%ecx\n\t"
+#endif
+ : "=D" (dummy), "=S" (dummy), "=c" (tmp), "=a" (dummy)
+ : "D" (wave), "S" (coeffs), "c" (count >> 6), "a" ((count >> 4) & 0x3), "d" (accum_output)
+#if defined(__SSE__)	// GCC accepts zmm clobbers whenever SSE is enabled, even without -mavx512f.
+ : "zmm0", "zmm1", "zmm2", "zmm3", "zmm4", "zmm5", "zmm6", "zmm7", "cc", "memory"
+#else
+ : "cc", "memory"
+#endif
+);
+#if !RESAMPLERMAC_FLOATOUT
+ *accum_output = tmp;
+#endif
+}
+#endif
+
 static INLINE void DoMAC_SSE_16X(const float* wave, const float *coeffs, int32 count, RESAMPLERMAC_OUTTYPE* accum_output)
 {
  // Multiplies 16 coefficients at a time.
@@ -530,16 +706,25 @@ static INLINE void DoMAC_NEON(const float* wave, const float *coeffs, int32 coun
 
  count >>= 4;
 
+//
+// AArch64 has no unfused vector float multiply-accumulate instruction, so vmlaq_f32() is a separate multiply and add there.
+//
+#ifdef __aarch64__
+ #define RESAMPLERMAC_NEON_MLA vfmaq_f32
+#else
+ #define RESAMPLERMAC_NEON_MLA vmlaq_f32
+#endif
  do
  {
-  acc0 = vmlaq_f32(acc0, vld1q_f32(MDFN_ASSUME_ALIGNED(coeffs     , sizeof(float32x4_t))), vld1q_f32(wave +  0));
-  acc1 = vmlaq_f32(acc1, vld1q_f32(MDFN_ASSUME_ALIGNED(coeffs +  4, sizeof(float32x4_t))), vld1q_f32(wave +  4));
-  acc2 = vmlaq_f32(acc2, vld1q_f32(MDFN_ASSUME_ALIGNED(coeffs +  8, sizeof(float32x4_t))), vld1q_f32(wave +  8));
-  acc3 = vmlaq_f32(acc3, vld1q_f32(MDFN_ASSUME_ALIGNED(coeffs + 12, sizeof(float32x4_t))), vld1q_f32(wave + 12));
+  acc0 = RESAMPLERMAC_NEON_MLA(acc0, vld1q_f32(MDFN_ASSUME_ALIGNED(coeffs     , sizeof(float32x4_t))), vld1q_f32(wave +  0));
+  acc1 = RESAMPLERMAC_NEON_MLA(acc1, vld1q_f32(MDFN_ASSUME_ALIGNED(coeffs +  4, sizeof(float32x4_t))), vld1q_f32(wave +  4));
+  acc2 = RESAMPLERMAC_NEON_MLA(acc2, vld1q_f32(MDFN_ASSUME_ALIGNED(coeffs +  8, sizeof(float32x4_t))), vld1q_f32(wave +  8));
+  acc3 = RESAMPLERMAC_NEON_MLA(acc3, vld1q_f32(MDFN_ASSUME_ALIGNED(coeffs + 12, sizeof(float32x4_t))), vld1q_f32(wave + 12));
 
   coeffs += 16;
   wave += 16;
  } while(MDFN_LIKELY(--count));
+#undef RESAMPLERMAC_NEON_MLA
  //
  //
  //
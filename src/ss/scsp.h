@@ -54,12 +54,15 @@ class SS_SCSP
  }
 
  INLINE uint64 PeekMPROG(uint32 A)	  { assert(A < 0x80); return DSP.MPROG[A]; }
- INLINE void PokeMPROG(uint32 A, uint64 V) { assert(A < 0x80); DSP.MPROG[A] = V; }
+ INLINE void PokeMPROG(uint32 A, uint64 V) { assert(A < 0x80); DSP.MPROG[A] = V; DSP.MPROG_Dirty = true; }
  INLINE uint32 PeekMEMS(uint32 A)	  { assert(A < 0x20); return DSP.MEMS[A]; }
  INLINE void PokeMEMS(uint32 A, uint32 V)  { assert(A < 0x20); DSP.MEMS[A] = V & 0x00FFFFFF; }
  INLINE uint32 PeekTEMPRel(uint32 A)	  { assert(A < 0x80); return DSP.TEMP[(DSP.MDEC_CT + A) & 0x7F]; }
  INLINE void PokeTEMPRel(uint32 A, uint32 V)  { assert(A < 0x80); DSP.TEMP[(DSP.MDEC_CT + A) & 0x7F] = V & 0x00FFFFFF; }
 
+ // For testing; when disabled, RunDSP() runs all 128 steps instead of skipping redundant NOPs.
+ INLINE void SetDSPSkipNOPs(bool enabled) { DSPSkipNOPs = enabled; DSP.MPROG_Dirty = true; }
+
  enum
  {
   GSREG_MVOL = 0,
@@ -267,6 +270,8 @@ class SS_SCSP
  uint8 RBP;
  uint8 RBL;
  void RunDSP(void);
+ void RecalcDSPSteps(void);
+ bool DSPSkipNOPs;
 
  struct DSPS
  {
@@ -297,6 +302,9 @@ class SS_SCSP
   uint32 ReadValue;
 
   bool MPROG_Dirty;
+
+  uint8 Steps[0x80];	// Indices of the MPROG steps RunDSP() executes, rebuilt from MPROG when MPROG_Dirty is set.
+  uint8 StepCount;
  } DSP;
  //
  //
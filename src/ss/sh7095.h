@@ -324,6 +324,12 @@ class SH7095 final
  uint8 Resume_exnum;
  uint8 Resume_vecnum;
 
+ //
+ // Set while the slave is being run speculatively on its own host thread(see SlaveMT_* in ss.cpp).
+ //
+ bool SpecMode;
+ bool SpecAborted;
+
  //
  //
  // Interrupt controller registers and related state
@@ -472,6 +472,7 @@ void SMPC_Reset(bool powering_up)
 {
  SlaveSH2Pending = 0;
  SlaveSH2On = false;
+ SS_SlaveSync();
  CPU[1].SetActive(SlaveSH2On);
  //
  TurnSoundCPUOff();
@@ -674,6 +675,7 @@ void SMPC_ProcessSlaveOffOn(void)
  if(SlaveSH2Pending)
  {
   SlaveSH2On = (SlaveSH2Pending > 0);
+  SS_SlaveSync();
   CPU[1].SetActive(SlaveSH2On);
   SlaveSH2Pending = 0;
   //
@@ -58,6 +58,7 @@ static MDFN_jmp_buf jbuf;
 
 static int16 IBuffer[1024][2];
 static uint32 IBufferCount;
+static int16 (*OBuffer)[2] = IBuffer;	// Where RunSCSP() writes; the frontend's sound buffer when outputting at 44.1KHz.
 static SpeexResamplerState* resampler = NULL;
 static int last_rate;
 static uint32 last_quality;
@@ -102,6 +103,7 @@ void SOUND_Init(bool stv_mapping)
 {
  memset(IBuffer, 0, sizeof(IBuffer));
  IBufferCount = 0;
+ OBuffer = IBuffer;
 
  last_rate = -1;
  last_quality = ~0U;
@@ -259,7 +261,7 @@ static NO_INLINE void RunSCSP(void)
  CDB_GetCDDA(SCSP.GetEXTSPtr());
  //
  //
- int16* const bp = IBuffer[IBufferCount];
+ int16* const bp = OBuffer[IBufferCount];
  SCSP.RunSample(bp, MIDI_Out);
  //bp[0] = rand();
  //bp[1] = rand();
@@ -316,7 +318,7 @@ sscpu_timestamp_t SOUND_Update(sscpu_timestamp_t timestamp)
  return timestamp + 128;	// FIXME
 }
 
-void SOUND_StartFrame(double rate, uint32 quality)
+void SOUND_StartFrame(double rate, uint32 quality, int16* SoundBuf, int32 SoundBufMaxSize)
 {
  if((int)rate != last_rate || quality != last_quality)
  {
@@ -336,6 +338,15 @@ void SOUND_StartFrame(double rate, uint32 quality)
   last_rate = (int)rate;
   last_quality = quality;
  }
+
+ //
+ // Nothing to resample at 44.1KHz, so write straight into the frontend's buffer if it can hold as many samples as IBuffer.
+ // SOUND_FlushOutput() switches back to IBuffer, so any samples after a mid-frame flush are copied as before.
+ //
+ if(last_rate == 44100 && SoundBuf && SoundBufMaxSize >= 1024 && !IBufferCount)
+  OBuffer = (int16 (*)[2])SoundBuf;
+ else
+  OBuffer = IBuffer;
 }
 
 int32 SOUND_FlushOutput(int16* SoundBuf, const int32 SoundBufMaxSize, const bool reverse)
@@ -344,8 +355,8 @@ int32 SOUND_FlushOutput(int16* SoundBuf, const int32 SoundBufMaxSize, const bool
  {
   for(unsigned lr = 0; lr < 2; lr++)
   {
-   int16* p0 = &IBuffer[0][lr];
-   int16* p1 = &IBuffer[IBufferCount - 1][lr];
+   int16* p0 = &OBuffer[0][lr];
+   int16* p1 = &OBuffer[IBufferCount - 1][lr];
    unsigned count = IBufferCount >> 1;
 
    while(MDFN_LIKELY(count--))
@@ -362,7 +373,14 @@ int32 SOUND_FlushOutput(int16* SoundBuf, const int32 SoundBufMaxSize, const bool
  {
   int32 ret = IBufferCount;
 
-  memcpy(SoundBuf, IBuffer, IBufferCount * 2 * sizeof(int16));
+  if(OBuffer != IBuffer)
+  {
+   assert((int16*)OBuffer == SoundBuf);
+   OBuffer = IBuffer;
+  }
+  else
+   memcpy(SoundBuf, IBuffer, IBufferCount * 2 * sizeof(int16));
+
   IBufferCount = 0;
 
   return(ret);
@@ -607,6 +625,120 @@ void SOUND_SetM68KRegister(const unsigned id, const uint32 value)
  SoundCPU.SetRegister(id, value);
 }
 
+#ifndef MDFN_SSFPLAY_COMPILE
+//
+// Differential test for the SCSP DSP's skipping of redundant NOP steps; runs two SCSPs, one with skipping disabled, under
+// the same random DSP programs, register writes(slot, DSP, and ring buffer), RAM writes, and EXTS input, and compares
+// their output samples, DSP register and work buffer reads, and RAM contents.  The SCSP main CPU interrupt is left
+// disabled, so SCU state isn't altered, but don't call this with a game loaded anyway.
+//
+static uint64 DSPTest_LCG;
+
+static uint32 DSPTest_Rand(void)
+{
+ DSPTest_LCG = (DSPTest_LCG * 6364136223846793005ULL) + 1442695040888963407ULL;
+
+ return DSPTest_LCG >> 32;
+}
+
+static uint64 DSPTest_Run(SS_SCSP* s, const uint64 seed, const unsigned count)
+{
+ uint64 hash = 0;
+
+ DSPTest_LCG = seed;
+
+ s->Reset(true);
+
+ for(uint32 A = 0; A < 0x80000; A += 2)
+ {
+  uint16 v = DSPTest_Rand();
+
+  s->RW<uint16, true>(A, v);
+ }
+ //
+ // Mostly NOPs, in runs of varying length.
+ //
+ for(unsigned step = 0; step < 128; step++)
+ {
+  const uint64 instr = ((uint64)DSPTest_Rand() << 32) | DSPTest_Rand();
+
+  s->PokeMPROG(step, (DSPTest_Rand() & 0x3) ? 0 : instr);
+ }
+
+ for(unsigned i = 0; i < count; i++)
+ {
+  const uint32 r = DSPTest_Rand();
+  uint16 v = DSPTest_Rand();
+  int16 out[2];
+
+  if(!(r & 0x7))
+  {
+   switch((r >> 3) & 0x7)
+   {
+    case 0: s->RW<uint16, true>(0x100000 + ((r >> 8) & 0x3FE), v); break;			// Slot registers
+    case 1: s->RW<uint16, true>((r >> 8) & 0x7FFFE, v); break;					// RAM
+    case 2: s->RW<uint16, true>(0x100700 + ((r >> 8) & 0xFE), v); break;			// COEF, MADRS
+    case 3: v = ((r >> 8) & 0x3) ? 0 : v; s->RW<uint16, true>(0x100800 + ((r >> 10) & 0x3FE), v); break;	// MPROG
+    case 4: s->RW<uint16, true>(0x100C00 + ((r >> 8) & 0x27E), v); break;			// TEMP, MEMS
+    case 5: s->RW<uint16, true>(0x100402, v); break;						// RBP, RBL
+    case 6: s->GetEXTSPtr()[(r >> 8) & 1] = v; break;
+    case 7: s->RW<uint16, false>(0x100C00 + ((r >> 8) & 0x2FE), v); hash = (hash * 31) + v; break;	// TEMP, MEMS, MIXS, EFREG
+   }
+  }
+
+  s->RunSample(out);
+  hash = (hash * 31) + (uint16)out[0];
+  hash = (hash * 31) + (uint16)out[1];
+ }
+
+ for(unsigned A = 0; A < 0x80; A++)
+  hash = (hash * 31) + s->PeekTEMPRel(A);
+
+ for(unsigned A = 0; A < 0x20; A++)
+  hash = (hash * 31) + s->PeekMEMS(A);
+
+ for(unsigned id = SS_SCSP::GSREG_EFREG0; id <= SS_SCSP::GSREG_EFREGF; id++)
+  hash = (hash * 31) + s->GetRegister(id, nullptr, 0);
+
+ for(uint32 A = 0; A < 0x80000; A += 2)
+ {
+  uint16 v;
+
+  s->RW<uint16, false>(A, v);
+  hash = (hash * 31) + v;
+ }
+
+ return hash;
+}
+
+//
+// Returns the number of seeds for which the results differ.
+//
+unsigned SOUND_TestDSPSkipNOPs(void)
+{
+ std::unique_ptr<SS_SCSP> s(new SS_SCSP());
+ unsigned failed = 0;
+
+ for(unsigned seed = 0; seed < 6; seed++)
+ {
+  uint64 hash[2];
+
+  s->SetDSPSkipNOPs(true);
+  hash[0] = DSPTest_Run(s.get(), seed, 44100 * 4);
+  s->SetDSPSkipNOPs(false);
+  hash[1] = DSPTest_Run(s.get(), seed, 44100 * 4);
+
+  if(hash[0] != hash[1])
+  {
+   printf("SCSP DSP NOP skipping mismatch: seed=%u\n", seed);
+   failed++;
+  }
+ }
+
+ return failed;
+}
+#endif
+
 
 }
 
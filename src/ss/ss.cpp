@@ -30,8 +30,12 @@
 #include <mednafen/hash/sha256.h>
 #include <mednafen/hash/md5.h>
 #include <mednafen/Time.h>
+#include <mednafen/MThreading.h>
+#include <mednafen/EventQueue.h>
 
 #include <bitset>
+#include <atomic>
+#include <thread>
 
 #include <trio/trio.h>
 
@@ -310,6 +314,9 @@ static INLINE void BusRW_DB_CS0(const uint32 A, uint32& DB, const bool BurstHax,
    {
     const unsigned c = ((A >> 23) & 1) ^ 1;
 
+    if(c)
+     SS_SlaveSync();
+
     CPU[c].SetFTI(true);
     CPU[c].SetFTI(false);
    }
@@ -393,6 +400,7 @@ static MDFN_COLD void CheatMemWrite(uint32 A, uint8 V)
  {
   ne16_wbo_be<uint8>(SH7095_FastMap[A >> SH7095_EXT_MAP_GRAN_BITS], A, V);
 
+  SS_SlaveSync();
   for(unsigned c = 0; c < 2; c++)
   {
    if(CPU[c].CCR & SH7095::CCR_CE)
@@ -459,6 +467,61 @@ void SS_SetPhysMemMap(uint32 Astart, uint32 Aend, uint16* ptr, uint32 length, bo
   SetFastMemMap(Astart + Abase, Aend + Abase, ptr, length, is_writeable);
 }
 
+//
+// Slave SH-2 host thread(ss.slave_thread), used only with full cache emulation and outside of debug mode.
+//
+// The slave thread runs the slave CPU ahead speculatively until it reaches an external bus access, which it leaves
+// to be performed on the main thread at the same point in master CPU execution as in serial emulation; on-chip DMA/BSC
+// register writes abort speculation.  Everything done to the slave CPU from outside of it(interrupt lines, halting,
+// DMA events, etc.) is preceded by SS_SlaveSync(), which stops the slave thread and, if the slave ran past where
+// serial emulation would have stopped it, rolls it back to a checkpoint and replays it serially.  The results are thus
+// identical to serial emulation.
+//
+static struct
+{
+ MThreading::Thread* Thread;
+ MThreading::Sem* WakeupSem;
+
+ bool Enabled;
+ bool Active;		// In RunLoop(); order points go through SlaveMT_Order().
+ bool Running;		// Speculation window launched and not yet collected.
+ bool InSerial;		// Slave is being run on the main thread.
+ bool StateExact;	// Slave state is what serial emulation would have after RunSlaveUntil(Want).
+ bool TakeCheckpoint;
+
+ sscpu_timestamp_t Want;		// Max bound serial emulation would have passed to RunSlaveUntil().
+ sscpu_timestamp_t ProgressCache;
+ sscpu_timestamp_t AbortTS;
+ sscpu_timestamp_t Limit;
+ sscpu_timestamp_t LastBound;	// Max bound speculation has passed to RunSlaveUntil() since the checkpoint.
+ uint32 Seq;
+
+ uint64 Windows;
+ uint64 SerialRuns;
+ uint64 Rollbacks;
+ uint64 Aborts;
+
+ alignas(64) std::atomic_uint_least32_t Go;
+ std::atomic_bool Spin;
+ std::atomic_bool Sleeping;	// Slave thread is, or is about to be, blocked on WakeupSem.
+ std::atomic_bool Quit;
+ alignas(64) std::atomic_uint_least32_t Done;
+ std::atomic_int_least32_t Progress;
+ std::atomic_bool StopReq;
+
+ alignas(64) uint8 Checkpoint[sizeof(SH7095)];
+} SMT;
+
+static NO_INLINE void SlaveMT_Order(const sscpu_timestamp_t t);
+
+static INLINE void SlaveMT_RunUntil(const sscpu_timestamp_t t)
+{
+ if(MDFN_LIKELY(!SMT.Active))
+  CPU[1].RunSlaveUntil(t);
+ else
+  SlaveMT_Order(t);
+}
+
 #include "sh7095.inc"
 
 //
@@ -476,6 +539,298 @@ void SS_SetPhysMemMap(uint32 Astart, uint32 Aend, uint16* ptr, uint32 length, bo
 static int Running;
 event_list_entry events[SS_EVENT__COUNT];
 static sscpu_timestamp_t next_event_ts;
+//
+// Ordering of events between SS_EVENT__SYNFIRST and SS_EVENT__SYNLAST(exclusive), indexed relative to SS_EVENT__SYNFIRST + 1;
+// events[n].event_time is kept in sync for other code to read.
+//
+enum : unsigned { EventQ_First = SS_EVENT__SYNFIRST + 1 };
+static EventQueue<SS_EVENT__SYNLAST - EventQ_First> EventQ;
+
+//
+//
+//
+enum : sscpu_timestamp_t { SlaveMT_Window = 2048 };	// Max cycles speculation may run ahead of the slave's last exact state.
+enum : sscpu_timestamp_t { SlaveMT_Chunk = 256 };	// Granularity of progress reports to the main thread.
+enum : unsigned { SlaveMT_SpinBudget = 512 };		// Idle spins before the slave thread blocks on its semaphore.
+
+static INLINE void SlaveMT_Pause(unsigned& spins)
+{
+ if(spins < 256)
+ {
+#if defined(HAVE_SSE2_INTRINSICS)
+  _mm_pause();
+#endif
+  spins++;
+ }
+ else
+  std::this_thread::yield();
+}
+
+//
+// Called by the main thread after changing Go or Quit.
+//
+static INLINE void SlaveMT_Wake(void)
+{
+ if(SMT.Sleeping.exchange(false))
+  MThreading::Sem_Post(SMT.WakeupSem);
+}
+
+//
+// Spins for a short while in case more work comes in soon, as it does while the master CPU is running, then blocks until
+// SlaveMT_Wake() is called.
+//
+static void SlaveMT_Idle(const uint32 seq)
+{
+ unsigned spins = 0;
+
+ while(spins < SlaveMT_SpinBudget && SMT.Spin.load(std::memory_order_relaxed) && SMT.Go.load(std::memory_order_acquire) == seq)
+  SlaveMT_Pause(spins);
+
+ SMT.Sleeping.store(true);
+
+ if(SMT.Go.load() == seq && !SMT.Quit.load())
+  MThreading::Sem_Wait(SMT.WakeupSem);
+ else if(!SMT.Sleeping.exchange(false))
+  MThreading::Sem_Wait(SMT.WakeupSem);	// Consume the post from a SlaveMT_Wake() that raced with the checks above.
+}
+
+static int SlaveMT_ThreadEntry(void* data)
+{
+ SH7095* const s = &CPU[1];
+ uint32 seq = 0;
+
+ while(MDFN_LIKELY(!SMT.Quit.load(std::memory_order_acquire)))
+ {
+  const uint32 go = SMT.Go.load(std::memory_order_acquire);
+
+  if(go == seq)
+  {
+   SlaveMT_Idle(seq);
+   continue;
+  }
+  seq = go;
+  //
+  //
+  const sscpu_timestamp_t limit = SMT.Limit;
+  sscpu_timestamp_t last_bound = SMT.LastBound;
+
+  if(SMT.TakeCheckpoint)
+   memcpy(SMT.Checkpoint, (void*)s, sizeof(SH7095));
+
+  s->SpecMode = true;
+  do
+  {
+   last_bound = std::min<sscpu_timestamp_t>(s->timestamp + SlaveMT_Chunk, limit);
+   s->RunSlaveUntil(last_bound);
+
+   if(s->SpecAborted)
+    break;
+
+   SMT.Progress.store(s->timestamp, std::memory_order_release);
+
+   if(s->ResumePoint)
+    break;
+  } while(s->timestamp < limit && !SMT.StopReq.load(std::memory_order_relaxed));
+  s->SpecMode = false;
+
+  SMT.LastBound = last_bound;
+  SMT.Done.store(seq, std::memory_order_release);
+ }
+
+ return 0;
+}
+
+static void SlaveMT_MarkExact(void)
+{
+ SMT.StateExact = true;
+ SMT.LastBound = INT32_MIN;
+}
+
+static void SlaveMT_Rollback(void)
+{
+ memcpy((void*)&CPU[1], SMT.Checkpoint, sizeof(SH7095));
+ CPU[1].SpecMode = false;
+ CPU[1].SpecAborted = false;
+ SlaveMT_MarkExact();
+}
+
+static void SlaveMT_Wait(void)
+{
+ unsigned spins = 0;
+
+ while(SMT.Done.load(std::memory_order_acquire) != SMT.Seq)
+  SlaveMT_Pause(spins);
+}
+
+static void SlaveMT_Collect(void)
+{
+ SMT.Running = false;
+
+ if(MDFN_UNLIKELY(CPU[1].SpecAborted))
+ {
+  //
+  // Don't speculate again until the slave gets past the problematic register write on the main thread.
+  //
+  SMT.AbortTS = CPU[1].timestamp;
+  SlaveMT_Rollback();
+  SMT.Aborts++;
+ }
+}
+
+static void SlaveMT_Serial(void)
+{
+ if(CPU[1].timestamp < SMT.Want)
+ {
+  SMT.InSerial = true;
+  CPU[1].RunSlaveUntil(SMT.Want);
+  SMT.InSerial = false;
+  SMT.SerialRuns++;
+  SlaveMT_MarkExact();
+ }
+}
+
+static void SlaveMT_Launch(void)
+{
+ SH7095* const s = &CPU[1];
+
+ if(s->ResumePoint || s->timestamp == SS_EVENT_DISABLED_TS || s->timestamp <= SMT.AbortTS)
+  return;
+
+ const sscpu_timestamp_t limit = std::min<sscpu_timestamp_t>(s->timestamp + SlaveMT_Window, next_event_ts);
+
+ if(limit <= s->timestamp)
+  return;
+
+ SMT.TakeCheckpoint = SMT.StateExact;
+ SMT.StateExact = false;
+ SMT.Limit = limit;
+ SMT.ProgressCache = s->timestamp;
+ SMT.Progress.store(s->timestamp, std::memory_order_relaxed);
+ SMT.StopReq.store(false, std::memory_order_relaxed);
+ SMT.Running = true;
+ SMT.Windows++;
+ SMT.Go.store(++SMT.Seq);
+ SlaveMT_Wake();
+}
+
+//
+// Called where serial emulation would call CPU[1].RunSlaveUntil(t), before master CPU bus accesses and after each
+// master CPU instruction; the slave's own bus accesses before 't' must have been performed upon return.
+//
+static NO_INLINE void SlaveMT_Order(const sscpu_timestamp_t t)
+{
+ if(t > SMT.Want)
+  SMT.Want = t;
+
+ if(SMT.Running)
+ {
+  if(MDFN_LIKELY(t <= SMT.ProgressCache))
+   return;
+
+  unsigned spins = 0;
+
+  for(;;)
+  {
+   SMT.ProgressCache = SMT.Progress.load(std::memory_order_acquire);
+
+   if(t <= SMT.ProgressCache)
+    return;
+
+   if(SMT.Done.load(std::memory_order_acquire) == SMT.Seq)
+    break;
+
+   SlaveMT_Pause(spins);
+  }
+  SlaveMT_Collect();
+ }
+
+ SlaveMT_Serial();
+ SlaveMT_Launch();
+}
+
+void SS_SlaveSync(void)
+{
+ if(MDFN_LIKELY(!SMT.Active) || SMT.InSerial)
+  return;
+
+ if(SMT.Running)
+ {
+  SMT.StopReq.store(true, std::memory_order_relaxed);
+  SlaveMT_Wait();
+  SlaveMT_Collect();
+ }
+
+ //
+ // If speculation may have gone past a point serial emulation would have stopped at, start over from the checkpoint.
+ //
+ if(!SMT.StateExact && CPU[1].timestamp >= SMT.Want && SMT.LastBound > SMT.Want)
+ {
+  SlaveMT_Rollback();
+  SMT.Rollbacks++;
+ }
+
+ SlaveMT_Serial();
+ SlaveMT_MarkExact();
+}
+
+static void SlaveMT_Begin(void)
+{
+ SMT.Active = true;
+ SMT.Want = INT32_MIN;
+ SMT.AbortTS = INT32_MIN;
+ SlaveMT_MarkExact();
+
+ SMT.Spin.store(true, std::memory_order_relaxed);
+}
+
+static void SlaveMT_End(void)
+{
+ SS_SlaveSync();
+ SMT.Active = false;
+ SMT.Spin.store(false, std::memory_order_relaxed);
+}
+
+static MDFN_COLD void SlaveMT_Init(const uint64 affinity)
+{
+ SMT.Active = false;
+ SMT.Running = false;
+ SMT.InSerial = false;
+ SMT.Seq = 0;
+ SMT.Windows = SMT.SerialRuns = SMT.Rollbacks = SMT.Aborts = 0;
+ SMT.Go.store(0, std::memory_order_relaxed);
+ SMT.Done.store(0, std::memory_order_relaxed);
+ SMT.Spin.store(false, std::memory_order_relaxed);
+ SMT.Sleeping.store(false, std::memory_order_relaxed);
+ SMT.Quit.store(false, std::memory_order_relaxed);
+
+ SMT.WakeupSem = MThreading::Sem_Create();
+ SMT.Thread = MThreading::Thread_Create(SlaveMT_ThreadEntry, NULL, "MDFN SS Slave SH-2");
+ if(affinity)
+  MThreading::Thread_SetAffinity(SMT.Thread, affinity);
+
+ SMT.Enabled = true;
+}
+
+static MDFN_COLD void SlaveMT_Kill(void)
+{
+ if(SMT.Thread)
+ {
+  MDFN_printf(_("Slave SH-2 thread: %llu windows, %llu serial runs, %llu rollbacks, %llu aborts.\n"), (unsigned long long)SMT.Windows, (unsigned long long)SMT.SerialRuns, (unsigned long long)SMT.Rollbacks, (unsigned long long)SMT.Aborts);
+
+  SMT.Quit.store(true, std::memory_order_release);
+  MThreading::Sem_Post(SMT.WakeupSem);
+  MThreading::Thread_Wait(SMT.Thread, NULL);
+  SMT.Thread = NULL;
+ }
+
+ if(SMT.WakeupSem)
+ {
+  MThreading::Sem_Destroy(SMT.WakeupSem);
+  SMT.WakeupSem = NULL;
+ }
+
+ SMT.Enabled = false;
+}
 
 template<unsigned c>
 static sscpu_timestamp_t SH_DMA_EventHandler(sscpu_timestamp_t et)
@@ -490,6 +845,9 @@ static sscpu_timestamp_t SH_DMA_EventHandler(sscpu_timestamp_t et)
  if(MDFN_UNLIKELY(SH7095_BusLock))
   return et + 1;
 
+ if(c)
+  SS_SlaveSync();
+
  return CPU[c].DMA_Update(et);
 }
 
@@ -507,10 +865,8 @@ static MDFN_COLD void InitEvents(void)
    events[i].event_time = 0x7FFFFFFF;
   else
    events[i].event_time = 0; //SS_EVENT_DISABLED_TS;
-
-  events[i].prev = (i > 0) ? &events[i - 1] : NULL;
-  events[i].next = (i < (SS_EVENT__COUNT - 1)) ? &events[i + 1] : NULL;
  }
+ EventQ.Reset(0);
 
  events[SS_EVENT_SH2_M_DMA].event_handler = &SH_DMA_EventHandler<0>;
  events[SS_EVENT_SH2_S_DMA].event_handler = &SH_DMA_EventHandler<1>;
@@ -548,8 +904,9 @@ static void RebaseTS(const sscpu_timestamp_t timestamp)
   if(events[i].event_time != SS_EVENT_DISABLED_TS)
    events[i].event_time -= timestamp;
  }
+ EventQ.Rebase(timestamp, SS_EVENT_DISABLED_TS);
 
- next_event_ts = events[SS_EVENT__SYNFIRST].next->event_time;
+ next_event_ts = EventQ.TopTime();
 }
 
 void SS_SetEventNT(event_list_entry* e, const sscpu_timestamp_t next_timestamp)
@@ -562,50 +919,10 @@ void SS_SetEventNT(event_list_entry* e, const sscpu_timestamp_t next_timestamp)
  }
 #endif
 
- if(next_timestamp < e->event_time)
- {
-  event_list_entry *fe = e;
-
-  do
-  {
-   fe = fe->prev;
-  } while(next_timestamp < fe->event_time);
-
-  // Remove this event from the list, temporarily of course.
-  e->prev->next = e->next;
-  e->next->prev = e->prev;
-
-  // Insert into the list, just after "fe".
-  e->prev = fe;
-  e->next = fe->next;
-  fe->next->prev = e;
-  fe->next = e;
-
-  e->event_time = next_timestamp;
- }
- else if(next_timestamp > e->event_time)
- {
-  event_list_entry *fe = e;
+ EventQ.Set(e - &events[EventQ_First], next_timestamp);
+ e->event_time = next_timestamp;
 
-  do
-  {
-   fe = fe->next;
-  } while(next_timestamp > fe->event_time);
-
-  // Remove this event from the list, temporarily of course
-  e->prev->next = e->next;
-  e->next->prev = e->prev;
-
-  // Insert into the list, just BEFORE "fe".
-  e->prev = fe->prev;
-  e->next = fe;
-  fe->prev->next = e;
-  fe->prev = e;
-
-  e->event_time = next_timestamp;
- }
-
- next_event_ts = ((Running > 0) ? events[SS_EVENT__SYNFIRST].next->event_time : 0);
+ next_event_ts = ((Running > 0) ? EventQ.TopTime() : 0);
 }
 
 // Called from debug.cpp too.
@@ -614,14 +931,15 @@ void ForceEventUpdates(const sscpu_timestamp_t timestamp)
 #ifdef MDFN_ENABLE_DEV_BUILD
  for(unsigned i = SS_EVENT__SYNFIRST + 1; i < SS_EVENT__SYNLAST; i++)
  {
-  if(events[i].event_time > events[i].next->event_time)
+  if(events[i].event_time != EventQ.GetTime(i - EventQ_First))
   {
-   printf("%u=%u, %u=%u\n", i, events[i].event_time, (unsigned)(events[i].next - events), events[i].next->event_time);
+   printf("%u=%u, %u\n", i, events[i].event_time, EventQ.GetTime(i - EventQ_First));
    abort();
   }
  }
 #endif
 
+ SS_SlaveSync();
  for(unsigned c = 0; c < 2; c++)
   CPU[c].ForceInternalEventUpdates();
 
@@ -631,14 +949,14 @@ void ForceEventUpdates(const sscpu_timestamp_t timestamp)
    SS_SetEventNT(&events[evnum], events[evnum].event_handler(timestamp));
  }
 
- next_event_ts = ((Running > 0) ? events[SS_EVENT__SYNFIRST].next->event_time : 0);
+ next_event_ts = ((Running > 0) ? EventQ.TopTime() : 0);
 }
 
 static INLINE bool EventHandler(const sscpu_timestamp_t timestamp)
 {
  event_list_entry *e;
 
- while(timestamp >= (e = events[SS_EVENT__SYNFIRST].next)->event_time)	// If Running = 0, EventHandler() may be called even if there isn't an event per-se, so while() instead of do { ... } while
+ while(timestamp >= (e = &events[EventQ_First + EventQ.Top()])->event_time)	// If Running = 0, EventHandler() may be called even if there isn't an event per-se, so while() instead of do { ... } while
  {
 #ifdef MDFN_ENABLE_DEV_BUILD
   const sscpu_timestamp_t etime = e->event_time;
@@ -702,6 +1020,12 @@ static INLINE int32 RunLoop_INLINE(EmulateSpecStruct* espec)
  for(unsigned c = 0; c < 2; c++)
   CPU[c].SetDebugMode(DebugMode);
 
+ if(EmulateICache && !DebugMode && SMT.Enabled)
+  SlaveMT_Begin();
+
+ if(!DebugMode)
+  VDP1::ThreadBegin();
+
  //printf("%d %d\n", SH7095_mem_timestamp, CPU[0].timestamp);
  do
  {
@@ -728,7 +1052,7 @@ static INLINE int32 RunLoop_INLINE(EmulateSpecStruct* espec)
      if(DebugMode)
       CPU[1].RunSlaveUntil_Debug(CPU[0].timestamp);
      else
-      CPU[1].RunSlaveUntil(CPU[0].timestamp);
+      SlaveMT_RunUntil(CPU[0].timestamp);
     }
     else
     {
@@ -750,6 +1074,12 @@ static INLINE int32 RunLoop_INLINE(EmulateSpecStruct* espec)
   } while(MDFN_LIKELY(EventHandler(eff_ts)));
  } while(MDFN_LIKELY(Running != 0));
 
+ if(!DebugMode)
+  VDP1::ThreadEnd();
+
+ if(EmulateICache && !DebugMode && SMT.Enabled)
+  SlaveMT_End();
+
  //printf(" End: %d %d -- %d\n", SH7095_mem_timestamp, CPU[0].timestamp, eff_ts);
  return eff_ts;
 }
@@ -865,7 +1195,7 @@ static void Emulate(EmulateSpecStruct* espec_arg)
  cur_clock_div = SMPC_StartFrame(espec);
  UpdateSMPCInput(0);
  VDP2::StartFrame(espec, cur_clock_div == 61);
- SOUND_StartFrame(espec->SoundRate / espec->soundmultiplier, MDFN_GetSettingUI("ss.scsp.resamp_quality"));
+ SOUND_StartFrame(espec->SoundRate / espec->soundmultiplier, MDFN_GetSettingUI("ss.scsp.resamp_quality"), espec->SoundBuf, espec->SoundBufMaxSize);
  CART_SetCPUClock(MDFNGameInfo->MasterClock / MDFN_MASTERCLOCK_FIXED(1), cur_clock_div);
  espec->SoundBufSize = 0;
  espec->MasterCycles = 0;
@@ -985,6 +1315,7 @@ static void OutputMIDI(uint8 v)
 
 static MDFN_COLD void Cleanup(void)
 {
+ SlaveMT_Kill();
  CART_Kill();
 
  DBG_Kill();
@@ -1269,6 +1600,16 @@ static void MDFN_COLD InitCommon(unsigned cpucache_emumode, unsigned horrible_ha
    horrible_hacks = ov_horrible_hacks;
  }
 
+ //
+ // The slave thread relies on the resumable slave CPU loop that's only used with full cache emulation.
+ //
+ const bool slave_thread = MDFN_GetSettingB("ss.slave_thread") && cpucache_emumode != CPUCACHE_EMUMODE_DATA_CB;
+
+ const unsigned slave_thread_forced_cpucache_emumode = (slave_thread && cpucache_emumode != CPUCACHE_EMUMODE_FULL) ? cpucache_emumode : CPUCACHE_EMUMODE__COUNT;
+
+ if(slave_thread)
+  cpucache_emumode = CPUCACHE_EMUMODE_FULL;
+
 #ifdef MDFN_ENABLE_DEV_BUILD
  ss_dbg_mask = MDFN_GetSettingMultiM("ss.dbg_mask") | SS_DBG_ERROR;
 
@@ -1300,16 +1641,24 @@ static void MDFN_COLD InitCommon(unsigned cpucache_emumode, unsigned horrible_ha
    { CPUCACHE_EMUMODE_FULL,	_("Full") },
   };
   const char* cem = _("Unknown");
+  const char* forced_cem = _("Unknown");
 
   for(auto const& ceme : CPUCacheEmuModes)
   {
    if(ceme.mode == cpucache_emumode)
-   {
     cem = ceme.name;
-    break;
-   }
+
+   if(ceme.mode == slave_thread_forced_cpucache_emumode)
+    forced_cem = ceme.name;
   }
-  MDFN_printf(_("CPU Cache Emulation Mode: %s\n"), cem);
+
+  if(slave_thread_forced_cpucache_emumode != CPUCACHE_EMUMODE__COUNT)
+   MDFN_printf(_("CPU Cache Emulation Mode: %s(instead of \"%s\", forced by the slave SH-2 thread)\n"), cem, forced_cem);
+  else
+   MDFN_printf(_("CPU Cache Emulation Mode: %s\n"), cem);
+  MDFN_printf(_("Slave SH-2 Thread: %s\n"), slave_thread ? _("Enabled") : _("Disabled"));
+  MDFN_printf(_("VDP1 Drawing Thread: %s\n"), MDFN_GetSettingB("ss.vdp1_thread") ? _("Enabled") : _("Disabled"));
+  MDFN_printf(_("VDP2 Rendering Threads: %u\n"), (unsigned)MDFN_GetSettingUI("ss.vdp2_threads"));
  }
  //
  if(horrible_hacks)
@@ -1361,6 +1710,9 @@ static void MDFN_COLD InitCommon(unsigned cpucache_emumode, unsigned horrible_ha
  SH7095_mem_timestamp = 0;
  SH7095_DB = 0;
 
+ if(slave_thread)
+  SlaveMT_Init(MDFN_GetSettingUI("ss.affinity.slave"));
+
  ss_horrible_hacks = horrible_hacks;
 
  //
@@ -1406,7 +1758,8 @@ static void MDFN_COLD InitCommon(unsigned cpucache_emumode, unsigned horrible_ha
  const char* biospath_sname;
  int sls = MDFN_GetSettingI(PAL ? "ss.slstartp" : "ss.slstart");
  int sle = MDFN_GetSettingI(PAL ? "ss.slendp" : "ss.slend");
- const uint64 vdp2_affinity = MDFN_GetSettingUI("ss.affinity.vdp2");
+ const unsigned vdp2_threads = MDFN_GetSettingUI("ss.vdp2_threads");
+ const uint64 vdp2_affinity[4] = { MDFN_GetSettingUI("ss.affinity.vdp2"), MDFN_GetSettingUI("ss.affinity.vdp2_1"), MDFN_GetSettingUI("ss.affinity.vdp2_2"), MDFN_GetSettingUI("ss.affinity.vdp2_3") };
 
  if(PAL)
  {
@@ -1514,8 +1867,8 @@ static void MDFN_COLD InitCommon(unsigned cpucache_emumode, unsigned horrible_ha
  if(cart_type == CART_STV)
   STVIO_Init(sgi);
 
- VDP1::Init();
- VDP2::Init(PAL, vdp2_affinity);
+ VDP1::Init(MDFN_GetSettingB("ss.vdp1_thread"), MDFN_GetSettingUI("ss.affinity.vdp1"));
+ VDP2::Init(PAL, vdp2_threads, vdp2_affinity);
  CDB_Init();
  SOUND_Init(cart_type == CART_STV);
 
@@ -2017,21 +2370,23 @@ struct EventsPacker
 
 INLINE void EventsPacker::Save(void)
 {
- event_list_entry* evt = events[SS_EVENT__SYNFIRST].next;
+ uint8 order[eventcopy_bound - eventcopy_first];
+
+ EventQ.GetOrder(order);
 
  for(size_t i = eventcopy_first; i < eventcopy_bound; i++)
  {
   event_times[i - eventcopy_first] = events[i].event_time;
-  event_order[i - eventcopy_first] = evt - events;
-  assert(event_order[i - eventcopy_first] >= eventcopy_first && event_order[i - eventcopy_first] < eventcopy_bound);
-  evt = evt->next;
+  event_order[i - eventcopy_first] = eventcopy_first + order[i - eventcopy_first];
  }
 }
 
 INLINE bool EventsPacker::Restore(const unsigned state_version)
 {
- bool used[SS_EVENT__COUNT] = { 0 };
- event_list_entry* evt = &events[SS_EVENT__SYNFIRST];
+ static_assert((unsigned)eventcopy_first == (unsigned)EventQ_First, "Mismatch.");
+ uint8 order[eventcopy_bound - eventcopy_first];
+ int32 times[eventcopy_bound - eventcopy_first];
+
  for(size_t i = eventcopy_first; i < eventcopy_bound; i++)
  {
   int32 et = event_times[i - eventcopy_first];
@@ -2053,53 +2408,19 @@ INLINE bool EventsPacker::Restore(const unsigned state_version)
   if(eo < eventcopy_first || eo >= eventcopy_bound)
    return false;
 
-  if(used[eo])
-   return false;
-
-  used[eo] = true;
-
   if(et < events[SS_EVENT__SYNFIRST].event_time)
    return false;
 
-  events[i].event_time = et;
-
-  evt->next = &events[eo];
-  evt->next->prev = evt;
-  evt = evt->next;
+  times[i - eventcopy_first] = et;
+  order[i - eventcopy_first] = eo - eventcopy_first;
  }
- evt->next = &events[SS_EVENT__SYNLAST];
- evt->next->prev = evt;
-
- for(size_t i = 0; i < SS_EVENT__COUNT; i++)
- {
-  if(i == SS_EVENT__SYNLAST)
-  {
-   if(events[i].next != NULL)
-    return false;
-  }
-  else
-  {
-   if(events[i].next->prev != &events[i])
-    return false;
-
-   if(events[i].next->event_time < events[i].event_time)
-    return false;
-  }
 
-  if(i == SS_EVENT__SYNFIRST)
-  {
-   if(events[i].prev != NULL)
-    return false;
-  }
-  else
-  {
-   if(events[i].prev->next != &events[i])
-    return false;
+ // Checks that the order is a permutation, and consistent with the times.
+ if(!EventQ.SetOrder(order, times))
+  return false;
 
-   if(events[i].prev->event_time > events[i].event_time)
-    return false;
-  }
- }
+ for(size_t i = eventcopy_first; i < eventcopy_bound; i++)
+  events[i].event_time = times[i - eventcopy_first];
 
  return true;
 }
@@ -2504,7 +2825,18 @@ static const MDFNSetting SSSettings[] =
  { "ss.slstartp", MDFNSF_NOFLAGS, gettext_noop("First displayed scanline in PAL mode."), NULL, MDFNST_INT, "0", "-16", "271" },
  { "ss.slendp", MDFNSF_NOFLAGS, gettext_noop("Last displayed scanline in PAL mode."), NULL, MDFNST_INT, "255", "-16", "271" },
 
- { "ss.affinity.vdp2", MDFNSF_NOFLAGS, gettext_noop("VDP2 rendering thread CPU affinity mask."), gettext_noop("Set to 0 to disable changing affinity."), MDFNST_UINT, "0", "0x0000000000000000", "0xFFFFFFFFFFFFFFFF" },
+ { "ss.affinity.vdp2", MDFNSF_NOFLAGS, gettext_noop("VDP2 rendering thread CPU affinity mask."), gettext_noop("Set to 0 to disable changing affinity.  With more than one VDP2 rendering thread, applies to the first; see ss.affinity.vdp2_1 through ss.affinity.vdp2_3 for the others."), MDFNST_UINT, "0", "0x0000000000000000", "0xFFFFFFFFFFFFFFFF" },
+ { "ss.affinity.vdp2_1", MDFNSF_NOFLAGS, gettext_noop("Second VDP2 rendering thread CPU affinity mask."), gettext_noop("Set to 0 to disable changing affinity."), MDFNST_UINT, "0", "0x0000000000000000", "0xFFFFFFFFFFFFFFFF" },
+ { "ss.affinity.vdp2_2", MDFNSF_NOFLAGS, gettext_noop("Third VDP2 rendering thread CPU affinity mask."), gettext_noop("Set to 0 to disable changing affinity."), MDFNST_UINT, "0", "0x0000000000000000", "0xFFFFFFFFFFFFFFFF" },
+ { "ss.affinity.vdp2_3", MDFNSF_NOFLAGS, gettext_noop("Fourth VDP2 rendering thread CPU affinity mask."), gettext_noop("Set to 0 to disable changing affinity."), MDFNST_UINT, "0", "0x0000000000000000", "0xFFFFFFFFFFFFFFFF" },
+ { "ss.affinity.slave", MDFNSF_NOFLAGS, gettext_noop("Slave SH-2 thread CPU affinity mask."), gettext_noop("Set to 0 to disable changing affinity."), MDFNST_UINT, "0", "0x0000000000000000", "0xFFFFFFFFFFFFFFFF" },
+ { "ss.affinity.vdp1", MDFNSF_NOFLAGS, gettext_noop("VDP1 drawing thread CPU affinity mask."), gettext_noop("Set to 0 to disable changing affinity."), MDFNST_UINT, "0", "0x0000000000000000", "0xFFFFFFFFFFFFFFFF" },
+
+ { "ss.slave_thread", MDFNSF_NOFLAGS, gettext_noop("Emulate the slave SH-2 on a separate thread."), gettext_noop("The slave CPU is run ahead speculatively on its own thread, and rolled back and rerun on the main thread when that turns out to be wrong, so results are identical to the default single-threaded emulation.  Only worthwhile for games that make heavy use of the slave CPU with code and data that stay in its cache; the number of speculation windows, serial runs, rollbacks, and aborts is printed when the game is closed.\n\nForces full CPU cache emulation, except for games that need the high-level cache bypass, where this setting has no effect."), MDFNST_BOOL, "0" },
+ { "ss.vdp1_thread", MDFNSF_NOFLAGS, gettext_noop("Run VDP1 command processing and drawing on a separate thread."), gettext_noop("Drawing is done with the same cycle budgets at the same emulated times as with the default single-threaded emulation, and the main thread waits for the drawing thread before any CPU or DMA access that could observe or affect drawing, so VDP1 register reads, framebuffer contents, and drawing progress are unchanged; the drawing end interrupt, however, may be delivered up to about 263 cycles later.  Emulation remains deterministic, but save states and movies may diverge from those made with this setting disabled.\n\nHas no effect in debug mode."), MDFNST_BOOL, "0" },
+
+ { "ss.vdp2_threads", MDFNSF_NOFLAGS, gettext_noop("Number of VDP2 rendering threads."), gettext_noop("Visible lines are divided into bands of 16 framebuffer lines, which are handed out to the rendering threads in turn.  Every thread processes every VDP2 register and memory write, so output is identical regardless of this setting.  Only worthwhile for high-resolution, interlaced, or rotation-heavy scenes on hosts with spare CPU cores; a histogram of per-line rendering times is printed when the game is closed, if this is greater than 1."), MDFNST_UINT, "1", "1", "4" },
+
 
 #ifdef MDFN_ENABLE_DEV_BUILD
  { "ss.dbg_mask", MDFNSF_SUPPRESS_DOC, gettext_noop("Debug printf mask."), NULL, MDFNST_MULTI_ENUM, "none", NULL, NULL, NULL, NULL, DBGMask_List },
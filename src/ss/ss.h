@@ -124,6 +124,7 @@ namespace MDFN_IEN_SS
  void SS_RequestMLExit(void);
  void SS_RequestEHLExit(void);
  void ForceEventUpdates(const sscpu_timestamp_t timestamp);
+ void SS_SlaveSync(void);	// Call before touching slave SH-2 state from outside of it.
 
  enum
  {
@@ -161,8 +162,6 @@ namespace MDFN_IEN_SS
  struct event_list_entry
  {
   sscpu_timestamp_t event_time;
-  event_list_entry *prev;
-  event_list_entry *next;
   ss_event_handler event_handler;
  };
 
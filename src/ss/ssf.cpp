@@ -47,7 +47,7 @@ static void Emulate(EmulateSpecStruct* espec)
 {
  SOUND_Set68KActive(true);
  SOUND_SetClockRatio(0x80000000);
- SOUND_StartFrame(espec->SoundRate / espec->soundmultiplier, MDFN_GetSettingUI("ssfplay.resamp_quality"));
+ SOUND_StartFrame(espec->SoundRate / espec->soundmultiplier, MDFN_GetSettingUI("ssfplay.resamp_quality"), espec->SoundBuf, espec->SoundBufMaxSize);
  espec->soundmultiplier = 1;
 
  const int32 target_timestamp = 588 * 512;
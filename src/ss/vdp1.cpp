@@ -41,11 +41,19 @@
 #include "ss.h"
 #include <mednafen/mednafen.h>
 #include <mednafen/FileStream.h>
+#include <mednafen/MThreading.h>
 #include "scu.h"
 #include "vdp1.h"
 #include "vdp2.h"
 #include "vdp1_common.h"
 
+#include <atomic>
+#include <thread>
+
+#if defined(HAVE_SSE2_INTRINSICS)
+ #include <xmmintrin.h>
+#endif
+
 enum : int { VDP1_UpdateTimingGran = 263 };
 enum : int { VDP1_IdleTimingGran = 1019 };
 
@@ -79,6 +87,7 @@ static int32 RetCommandAddr;
 static uint16 LOPR;
 
 static sscpu_timestamp_t lastts;
+static bool DrawEndIRQPending;
 static int32 CycleCounter;
 static int32 CommandPhase;
 static uint16 CommandData[0x10];
@@ -112,6 +121,40 @@ static struct
 
 static uint32 EraseYCounter;
 
+//
+// Drawing thread(ss.vdp1_thread), used only outside of debug mode.
+//
+// DoDrawing() for an update is handed off to the drawing thread, and the VDP1 event is provisionally rescheduled for the
+// earliest time the next update could be due.  Everything on the main thread that touches drawing state(register,
+// framebuffer, and VRAM write access, the framebuffer swap, save states, etc.) goes through Sync() first, which waits
+// for the drawing thread and reschedules the VDP1 event to when serial emulation would have.  Drawing thus gets the same
+// cycle budgets at the same times as with serial emulation, and CPU-visible VDP1 state is the same at every access; the
+// only difference is that the drawing end interrupt is raised at the sync point, up to VDP1_UpdateTimingGran cycles
+// later than it would otherwise be.
+//
+static struct
+{
+ MThreading::Thread* Thread;
+ MThreading::Sem* WakeupSem;
+
+ bool Active;		// In a frame, outside of debug mode.
+ bool Pending;		// DoDrawing() handed off and not yet waited for.
+ uint32 Seq;
+
+ uint64 Batches;
+ uint64 Waits;
+
+ alignas(64) std::atomic_uint_least32_t Go;
+ std::atomic_bool Spin;
+ std::atomic_bool Sleeping;	// Drawing thread is, or is about to be, blocked on WakeupSem.
+ std::atomic_bool Quit;
+ alignas(64) std::atomic_uint_least32_t Done;
+} DT;
+
+enum : unsigned { DT_SpinBudget = 512 };	// Idle spins before the drawing thread blocks on its semaphore.
+
+static INLINE void Sync(void);
+
 #if 1
 static uint32 InstantDrawSanityLimit; // ss_horrible_hacks
 #endif
@@ -211,9 +254,12 @@ static INLINE void VRAMUsageEnd(void) { }
 //
 //
 //
-void Init(void)
+static int DT_ThreadEntry(void* data);
+
+void Init(const bool thread, const uint64 affinity)
 {
  vbcdpending = false;
+ DrawEndIRQPending = false;
 
  for(int i = 0; i < 0x40; i++)
  {
@@ -238,15 +284,72 @@ void Init(void)
  LastRWTS = 0;
 
  VRAMUsageInit();
+ //
+ //
+ DT.Active = false;
+ DT.Pending = false;
+ DT.Seq = 0;
+ DT.Batches = DT.Waits = 0;
+ DT.Go.store(0, std::memory_order_relaxed);
+ DT.Done.store(0, std::memory_order_relaxed);
+ DT.Spin.store(false, std::memory_order_relaxed);
+ DT.Sleeping.store(false, std::memory_order_relaxed);
+ DT.Quit.store(false, std::memory_order_relaxed);
+
+ if(thread)
+ {
+  DT.WakeupSem = MThreading::Sem_Create();
+  DT.Thread = MThreading::Thread_Create(DT_ThreadEntry, NULL, "MDFN SS VDP1 Draw");
+  if(affinity)
+   MThreading::Thread_SetAffinity(DT.Thread, affinity);
+ }
 }
 
 void Kill(void)
 {
+ if(DT.Thread)
+ {
+  MDFN_printf(_("VDP1 drawing thread: %llu batches, %llu waits.\n"), (unsigned long long)DT.Batches, (unsigned long long)DT.Waits);
+
+  DT.Quit.store(true, std::memory_order_release);
+  MThreading::Sem_Post(DT.WakeupSem);
+  MThreading::Thread_Wait(DT.Thread, NULL);
+  DT.Thread = NULL;
+ }
 
+ if(DT.WakeupSem)
+ {
+  MThreading::Sem_Destroy(DT.WakeupSem);
+  DT.WakeupSem = NULL;
+ }
+}
+
+//
+// Called at the start and end of each frame's emulation loop, outside of debug mode.
+//
+void ThreadBegin(void)
+{
+ if(!DT.Thread)
+  return;
+
+ DT.Active = true;
+ DT.Spin.store(true, std::memory_order_relaxed);
+}
+
+void ThreadEnd(void)
+{
+ if(!DT.Thread)
+  return;
+
+ Sync();
+ DT.Active = false;
+ DT.Spin.store(false, std::memory_order_relaxed);
 }
 
 void Reset(bool powering_up)
 {
+ Sync();
+
  if(powering_up)
  {
   for(unsigned i = 0; i < 0x40000; i++)
@@ -794,8 +897,7 @@ static INLINE void DoDrawing(void)
 
     EDSR |= 0x2;	// TODO: Does EDSR reflect IRQ out status?
 
-    SCU_SetInt(SCU_INT_VDP1, true);
-    SCU_SetInt(SCU_INT_VDP1, false);
+    DrawEndIRQPending = true;
     goto Breakout;
    }
 
@@ -837,7 +939,116 @@ static INLINE void DoDrawing(void)
 #endif
 }
 
-sscpu_timestamp_t Update(sscpu_timestamp_t timestamp)
+static INLINE void DT_Pause(unsigned& spins)
+{
+ if(spins < 256)
+ {
+#if defined(HAVE_SSE2_INTRINSICS)
+  _mm_pause();
+#endif
+  spins++;
+ }
+ else
+  std::this_thread::yield();
+}
+
+//
+// Called by the main thread after changing Go.
+//
+static INLINE void DT_Wake(void)
+{
+ if(DT.Sleeping.exchange(false))
+  MThreading::Sem_Post(DT.WakeupSem);
+}
+
+//
+// Spins for a short while in case the next update comes in soon, as it does while drawing is in progress, then blocks until
+// DT_Wake() is called.
+//
+static void DT_Idle(const uint32 seq)
+{
+ unsigned spins = 0;
+
+ while(spins < DT_SpinBudget && DT.Spin.load(std::memory_order_relaxed) && DT.Go.load(std::memory_order_acquire) == seq)
+  DT_Pause(spins);
+
+ DT.Sleeping.store(true);
+
+ if(DT.Go.load() == seq && !DT.Quit.load())
+  MThreading::Sem_Wait(DT.WakeupSem);
+ else if(!DT.Sleeping.exchange(false))
+  MThreading::Sem_Wait(DT.WakeupSem);	// Consume the post from a DT_Wake() that raced with the checks above.
+}
+
+static int DT_ThreadEntry(void* data)
+{
+ uint32 seq = 0;
+
+ while(MDFN_LIKELY(!DT.Quit.load(std::memory_order_acquire)))
+ {
+  const uint32 go = DT.Go.load(std::memory_order_acquire);
+
+  if(go == seq)
+  {
+   DT_Idle(seq);
+   continue;
+  }
+  seq = go;
+  //
+  DoDrawing();
+  //
+  DT.Done.store(seq, std::memory_order_release);
+ }
+
+ return 0;
+}
+
+static INLINE void RaiseDrawEndIRQ(void)
+{
+ if(DrawEndIRQPending)
+ {
+  DrawEndIRQPending = false;
+
+  SCU_SetInt(SCU_INT_VDP1, true);
+  SCU_SetInt(SCU_INT_VDP1, false);
+ }
+}
+
+//
+// Returns the timestamp serial emulation would have scheduled the next update for.
+//
+static sscpu_timestamp_t DT_Finish(void)
+{
+ if(DT.Done.load(std::memory_order_acquire) != DT.Seq)
+ {
+  unsigned spins = 0;
+
+  DT.Waits++;
+
+  do
+  {
+   DT_Pause(spins);
+  } while(DT.Done.load(std::memory_order_acquire) != DT.Seq);
+ }
+ DT.Pending = false;
+
+ RaiseDrawEndIRQ();
+
+ return lastts + (DrawingActive ? std::max<int32>(VDP1_UpdateTimingGran, 0 - CycleCounter) : VDP1_IdleTimingGran);
+}
+
+static NO_INLINE void Sync_Sub(void)
+{
+ SS_SetEventNT(&events[SS_EVENT_VDP1], DT_Finish());
+}
+
+static INLINE void Sync(void)
+{
+ if(MDFN_UNLIKELY(DT.Pending))
+  Sync_Sub();
+}
+
+static INLINE sscpu_timestamp_t Update_Sub(sscpu_timestamp_t timestamp, const bool may_hand_off)
 {
  if(MDFN_UNLIKELY(timestamp < lastts))
  {
@@ -863,11 +1074,37 @@ sscpu_timestamp_t Update(sscpu_timestamp_t timestamp)
   CycleCounter = 0;
  }
  else if(DrawingActive)
+ {
+  if(may_hand_off && DT.Active)
+  {
+   DT.Pending = true;
+   DT.Batches++;
+   DT.Go.store(++DT.Seq);
+   DT_Wake();
+
+   return timestamp + VDP1_UpdateTimingGran;
+  }
+
   DoDrawing();
+  RaiseDrawEndIRQ();
+ }
 
  return timestamp + (DrawingActive ? std::max<int32>(VDP1_UpdateTimingGran, 0 - CycleCounter) : VDP1_IdleTimingGran);
 }
 
+sscpu_timestamp_t Update(sscpu_timestamp_t timestamp)
+{
+ if(MDFN_UNLIKELY(DT.Pending))
+ {
+  const sscpu_timestamp_t nt = DT_Finish();
+
+  if(nt > timestamp)
+   return nt;
+ }
+
+ return Update_Sub(timestamp, true);
+}
+
 // Draw-clear minimum x amount is 2(16-bit units) for normal and 8bpp, and 8 for rotate...actually, seems like
 // rotate being enabled forces vblank erase mode somehow.
 
@@ -902,6 +1139,7 @@ void SetHBVB(const sscpu_timestamp_t event_timestamp, const bool new_hb_status,
 
  if(MDFN_UNLIKELY(vbcdpending & hb_status & (old_hb_status ^ hb_status)))
  {
+  Sync();
   vbcdpending = false;
 
   if(vb_status) // Going into v-blank
@@ -1128,7 +1366,11 @@ void AdjustTS(const int32 delta)
 static INLINE void WriteReg(const unsigned which, const uint16 value)
 {
  SS_SetEventNT(&events[SS_EVENT_VDP2], VDP2::Update(SH7095_mem_timestamp));
- sscpu_timestamp_t nt = Update(SH7095_mem_timestamp);
+
+ if(DT.Pending)
+  DT_Finish();
+
+ sscpu_timestamp_t nt = Update_Sub(SH7095_mem_timestamp, false);
 
  SS_DBGTI(SS_DBG_VDP1_REGW, "[VDP1] Register write: 0x%02x: 0x%04x", which << 1, value);
 
@@ -1215,6 +1457,9 @@ static INLINE uint16 ReadReg(const unsigned which)
 //
 MDFN_FASTCALL void Write_CheckDrawSlowdown(uint32 A, sscpu_timestamp_t time_thing)
 {
+ if(ss_horrible_hacks & HORRIBLEHACK_VDP1RWDRAWSLOWDOWN)
+  Sync();
+
  if(DrawingActive && time_thing > LastRWTS && (ss_horrible_hacks & HORRIBLEHACK_VDP1RWDRAWSLOWDOWN))
  {
   const int32 count = (A & 0x100000) ? 22 : 25;
@@ -1228,6 +1473,9 @@ MDFN_FASTCALL void Write_CheckDrawSlowdown(uint32 A, sscpu_timestamp_t time_thin
 MDFN_FASTCALL void Read_CheckDrawSlowdown(uint32 A, sscpu_timestamp_t time_thing)
 {
  //printf("%08x\n", A);
+ if(ss_horrible_hacks & HORRIBLEHACK_VDP1RWDRAWSLOWDOWN)
+  Sync();
+
  if(!(A & 0x100000) && time_thing > LastRWTS && DrawingActive && (ss_horrible_hacks & HORRIBLEHACK_VDP1RWDRAWSLOWDOWN))
  {
   const int32 count = (A & 0x80000) ? 44 : 41;
@@ -1244,6 +1492,7 @@ MDFN_FASTCALL void Write8_DB(uint32 A, uint16 DB)
 
  if(A < 0x80000)
  {
+  Sync();
   VRAMUsageWrite(A >> 1);
   SS_DBGTI(SS_DBG_VDP1_VRAMW, "[VDP1] Write to VRAM: 0x%02x->VRAM[0x%05x]", (DB >> (((A & 1) ^ 1) << 3)) & 0xFF, A);
   ne16_wbo_be<uint8>(VRAM, A, DB >> (((A & 1) ^ 1) << 3) );
@@ -1254,6 +1503,7 @@ MDFN_FASTCALL void Write8_DB(uint32 A, uint16 DB)
  {
   uint32 FBA = A;
 
+  Sync();
   SS_DBGTI(SS_DBG_VDP1_FBW, "[VDP1] Write to FB: 0x%02x->FB[%d][0x%05x] CycleCounter=%d", (DB >> (((A & 1) ^ 1) << 3)) & 0xFF, FBDrawWhich, A & 0x3FFFF, CycleCounter);
 
   if((TVMR & (TVMR_8BPP | TVMR_ROTATE)) == (TVMR_8BPP | TVMR_ROTATE))
@@ -1273,6 +1523,7 @@ MDFN_FASTCALL void Write16_DB(uint32 A, uint16 DB)
 
  if(A < 0x80000)
  {
+  Sync();
   VRAMUsageWrite(A >> 1);
   SS_DBGTI(SS_DBG_VDP1_VRAMW, "[VDP1] Write to VRAM: 0x%04x->VRAM[0x%05x]", DB, A);
   VRAM[A >> 1] = DB;
@@ -1283,6 +1534,7 @@ MDFN_FASTCALL void Write16_DB(uint32 A, uint16 DB)
  {
   uint32 FBA = A;
 
+  Sync();
   SS_DBGTI(SS_DBG_VDP1_FBW, "[VDP1] Write to FB: 0x%04x->FB[%d][0x%05x] CycleCounter=%d", DB, FBDrawWhich, A & 0x3FFFF, CycleCounter);
 
   if((TVMR & (TVMR_8BPP | TVMR_ROTATE)) == (TVMR_8BPP | TVMR_ROTATE))
@@ -1302,6 +1554,8 @@ MDFN_FASTCALL uint16 Read16_DB(uint32 A)
  if(A < 0x080000)
   return VRAM[A >> 1];
 
+ Sync();
+
  if(A < 0x100000)
  {
   uint32 FBA = A;
@@ -1319,6 +1573,8 @@ void StateAction(StateMem* sm, const unsigned load, const bool data_only)
 {
  bool tmp_abs_dy_gt_abs_dx = false;
 
+ Sync();
+
  SFORMAT Prim_StateRegs[] =
  {
   SFVAR(PrimData.e->d_error, 0x2, sizeof(*PrimData.e), PrimData.e),
@@ -30,8 +30,10 @@ namespace MDFN_IEN_SS
 namespace VDP1
 {
 
-void Init(void) MDFN_COLD;
+void Init(const bool thread, const uint64 affinity) MDFN_COLD;
 void Kill(void) MDFN_COLD;
+void ThreadBegin(void);
+void ThreadEnd(void);
 void StateAction(StateMem* sm, const unsigned load, const bool data_only) MDFN_COLD;
 
 void Reset(bool powering_up) MDFN_COLD;
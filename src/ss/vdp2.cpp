@@ -376,6 +376,7 @@ static INLINE void IncVCounter(const sscpu_timestamp_t event_timestamp)
  {
   const bool s = (VCounter == (VTimings[PAL][VRes][VPHASE__COUNT - 1] - 1));
 
+  SS_SlaveSync();
   for(size_t i = 0; i < 2; i++)
    CPU[i].SetExtHaltDMAKludgeFromVDP2(s);
  }
@@ -884,7 +885,7 @@ void AdjustTS(const int32 delta)
 }
 
 
-void Init(const bool IsPAL, const uint64 affinity)
+void Init(const bool IsPAL, const unsigned render_threads, const uint64* render_affinity)
 {
  SurfInterlaceField = -1;
  PAL = IsPAL;
@@ -896,7 +897,7 @@ void Init(const bool IsPAL, const uint64 affinity)
 
  ExLatchIn = false;
 
- VDP2REND_Init(IsPAL, affinity);
+ VDP2REND_Init(IsPAL, render_threads, render_affinity);
 }
 
 void SetGetVideoParams(MDFNGI* gi, const bool caspect, const int sls, const int sle, const bool show_h_overscan, const bool dohblend)
@@ -939,6 +940,7 @@ void Reset(bool powering_up)
  VCounter = 0;
  Odd = true;
 
+ SS_SlaveSync();
  for(size_t i = 0; i < 2; i++)
   CPU[i].SetExtHaltDMAKludgeFromVDP2(false);
 
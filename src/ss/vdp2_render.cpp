@@ -48,157 +48,9 @@ static uint32 NextOutLine;
 static bool Clock28M;
 static unsigned VisibleLines;
 static VDP2Rend_LIB LIB[256];
-static uint16 VRAM[262144];
-static uint16 CRAM[2048];
-
-static uint8 HRes, VRes;
-static bool BorderMode;
-static uint8 InterlaceMode;
-enum { IM_NONE, IM_ILLEGAL, IM_SINGLE, IM_DOUBLE };
-
-static bool CRKTE;
-static uint8 CRAM_Mode;
-enum
-{
- CRAM_MODE_RGB555_1024	= 0,
- CRAM_MODE_RGB555_2048	= 1,
- CRAM_MODE_RGB888_1024	= 2,
- CRAM_MODE_ILLEGAL	= 3
-};
-static uint8 VRAM_Mode;
-static uint8 RDBS_Mode;
-
-static uint8 VCPRegs[4][8];
 static const uint16 DummyTileNT[8 * 8 * 4 / sizeof(uint16)] = { 0 };
 
-static uint32 UserLayerEnableMask;
-//
-//
-//
-static uint16 BGON;
-static uint16 MZCTL;
-static uint8 MosaicVCount;
-
-static uint8 SFSEL;
-static uint16 SFCODE;
-
-static uint16 CHCTLA;
-static uint16 CHCTLB;
-
-static uint16 BMPNA;
-static uint8 BMPNB;
-
-static uint16 PNCN[4];
-static uint16 PNCNR;
-
-static uint16 PLSZ;
-static uint16 MPOFN;
-static uint16 MPOFR;
-
-static uint8 MapRegs[4][4];
-static uint8 RotMapRegs[2][16];
-//
-static uint16 XScrollI[4], YScrollI[4];
-static uint8 XScrollF[2], YScrollF[2];
-
-static uint16 ZMCTL;
-static uint16 SCRCTL;
-static uint32 LineScrollAddr[2];
-static uint32 VCScrollAddr;
-static uint32 VCLast[2];
-
-static uint16 XCoordInc[2], YCoordInc[2];
-static uint32 YCoordAccum[2];
-static uint32 MosEff_YCoordAccum[2];
-
-static uint32 CurXScrollIF[2];
-static uint32 CurYScrollIF[2];
-static uint16 CurXCoordInc[2];
-static uint32 CurLSA[2];
-
-static uint16 NBG23_YCounter[2];
-static uint16 MosEff_NBG23_YCounter[2];
-//
-static uint8 RPMD;
-static uint8 KTCTL[2];
-static uint16 OVPNR[2];
-//
-static uint32 BKTA;
-static uint32 CurBackTabAddr;
-static uint16 CurBackColor;
-
-static uint32 LCTA;
-static uint32 CurLCTabAddr;
-static uint16 CurLCColor;
-
-static uint8 LineColorEn;
-
-static uint16 SFPRMD;
-static uint16 CCCTL;
-static uint16 SFCCMD;
-//
-static uint8 NBGPrioNum[4];
-static uint8 RBG0PrioNum;
-
-static uint8 NBGCCRatio[4];
-static uint8 RBG0CCRatio;
-static uint8 LineColorCCRatio;
-static uint8 BackCCRatio;
-
-//
-static struct
-{
- uint16 XStart, XEnd;
- uint32 LineWinAddr;
- bool LineWinEn;
- //
- bool YMet;
- uint16 CurXStart, CurXEnd;
- uint32 CurLineWinAddr;
-} Window[2];
-
-static uint8 WinControl[8];
-enum
-{
- WINLAYER_NBG0 = 0,
- WINLAYER_NBG1 = 1,
- WINLAYER_NBG2 = 2,
- WINLAYER_NBG3 = 3,
- WINLAYER_RBG0 = 4,
- WINLAYER_SPRITE = 5,
- WINLAYER_ROTPARAM = 6,
- WINLAYER_CC = 7,
-};
-
-static std::array<unsigned, 5> WinPieces;
-//
-static uint8 SpriteCCCond;
-static uint8 SpriteCCNum;
-static uint8 SPCTL_Low;
-
-static uint16 SDCTL;
-
-static uint8 SpritePrioNum[8];
-static uint8 SpriteCCRatio[8];
-
-static uint8 SpriteCCLUT[8];	// Temp optimization data
-static uint8 SpriteCC3Mask; 	// Temp optimization data
-
-//
-static uint8 CRAMAddrOffs_NBG[4];
-static uint8 CRAMAddrOffs_RBG0;
-static uint8 CRAMAddrOffs_Sprite;
-//
-static uint8 ColorOffsEn;
-static uint8 ColorOffsSel;
-
-//enum
-//{
-// COLOFFS_ENSEL_NBG0 = 0,
-// COLOFFS_ENSEL_NBG1 = 0,
-//};
-
-static int32 ColorOffs[2][3];	// [A,B] [R << 0, G << 8, B << 16]
+struct Renderer;
 
 template<bool IsRot>
 struct TileFetcher
@@ -231,93 +83,12 @@ struct TileFetcher
 
  bool nt_ok[4];
  bool cg_ok[4];
+ const uint16* vram;
 
  // n=0...3, NBG0...3
  // n=4, RBG0
  // n=5, RBG1
- INLINE void Start(const unsigned n, const bool bmen, const unsigned map_offset, const uint8* map_regs)
- {
-  BMOffset = map_offset << 16;
-  BMWShift = ((BMSize & 2) ? 10 : 9);
-  BMWMask = (1U << BMWShift) - 8;
-  BMHMask = (BMSize & 1) ? 0x1FF : 0xFF;
-
-  const unsigned psshift = (13 - PNDSize - (CharSize << 1));
-
-  for(unsigned i = 0; i < (IsRot ? 16 : 4); i++)
-  {
-   adj_map_regs[i] = ((map_offset << 6) + (map_regs[i] &~ PlaneSize)) << psshift;
-  }
-
-  if(IsRot)
-  {
-   if(bmen)
-   {
-    doxm = ~(BMWMask + 7);
-    doym = ~BMHMask;
-   }
-   else
-   {
-    doxm = ~((1U << ((9 + (bool)(PlaneSize & 0x1)) + (IsRot ? 2 : 1))) - 1);
-    doym = ~((1U << ((9 + (bool)(PlaneSize & 0x2)) + (IsRot ? 2 : 1))) - 1);
-   }
-
-   if(PlaneOver == 0)
-    doxm = doym = 0;
-   else if(PlaneOver == 3)
-    doxm = doym = ~511;
-  }
-
-  // Kludgeyness:
-  for(unsigned bank = 0; bank < 4; bank++)
-  {
-   const unsigned esb = bank & (2 | ((VRAM_Mode >> (bank >> 1)) & 1));
-   const uint8 rdbs = (RDBS_Mode >> (esb << 1)) & 0x3;
-
-   if(IsRot)
-   {
-    if(!(BGON & 0x20) || n == 4)
-    {
-     nt_ok[bank] = (rdbs == RDBS_NAME) && (bank < 2 || !(BGON & 0x20));
-     cg_ok[bank] = (rdbs == RDBS_CHAR) && (bank < 2 || !(BGON & 0x20));
-    }
-    else
-    {
-     nt_ok[bank] = (bank == 3);
-     cg_ok[bank] = (bank == 2);
-    }
-   }
-   else
-   {
-    nt_ok[bank] = false;
-    cg_ok[bank] = false;
-
-    if((BGON & 0x20) && (bank & 0x2))
-    {
-     //
-    }
-    else if(!(BGON & 0x10) || rdbs == RDBS_UNUSED)
-    {
-     for(unsigned ac = 0; ac < ((HRes & 0x6) ? 4 : 8); ac++)
-     {
-      if(VCPRegs[esb][ac] == (VCP_NBG0_CG + n))
-       cg_ok[bank] = true;
-
-      if(VCPRegs[esb][ac] == (VCP_NBG0_NT + n))
-       nt_ok[bank] = true;
-     }
-    }
-   }
-  }
-
-  #if 1
-  pcco = 0;
-  spr = false;
-  scc = false;
-  tile_vrb = nullptr;
-  cellx_xor = 0;
-  #endif
- }
+ INLINE void Start(const Renderer& r, const unsigned n, const bool bmen, const unsigned map_offset, const uint8* map_regs);
 
  //
  //
@@ -365,7 +136,7 @@ struct TileFetcher
    pageoffs = ((((ix >> 3) & 0x3F) >> CharSize) + ((((iy >> 3) & 0x3F) >> CharSize) << (6 - CharSize))) << (1 - PNDSize);
    nt_addr = (adj_map_regs[mapidx] + planeoffs + pageoffs) & 0x3FFFF;
 
-   pnd = &VRAM[nt_addr];
+   pnd = &vram[nt_addr];
    if(!nt_ok[nt_addr >> 16])
     pnd = DummyTileNT;
 
@@ -429,7 +200,7 @@ struct TileFetcher
    celly = (iy & 0x7) ^ (vflip ? 0x7 : 0);
    cg_addr = ((charno << 4) + ((celly * TA_bpp) >> 1)) & 0x3FFFF;
   }
-  tile_vrb = &VRAM[cg_addr];
+  tile_vrb = &vram[cg_addr];
 
   if(!cg_ok[cg_addr >> 16])
   {
@@ -460,28 +231,316 @@ struct RotVars
  TileFetcher<true> tf;
 };
 
-static struct
+//
+// Everything the render thread reads or modifies while drawing.  The drawing functions below are members so they
+// can operate on whichever instance the render thread was started with.
+//
+struct Renderer
 {
- uint64 spr[704];
- uint64 rbg0[704];
- union
+ uint16 VRAM[262144];
+ uint16 CRAM[2048];
+
+ uint8 HRes, VRes;
+ bool BorderMode;
+ uint8 InterlaceMode;
+ enum { IM_NONE, IM_ILLEGAL, IM_SINGLE, IM_DOUBLE };
+
+ bool CRKTE;
+ uint8 CRAM_Mode;
+ enum
+ {
+  CRAM_MODE_RGB555_1024	= 0,
+  CRAM_MODE_RGB555_2048	= 1,
+  CRAM_MODE_RGB888_1024	= 2,
+  CRAM_MODE_ILLEGAL	= 3
+ };
+ uint8 VRAM_Mode;
+ uint8 RDBS_Mode;
+
+ uint8 VCPRegs[4][8];
+
+ uint32 UserLayerEnableMask;
+ //
+ //
+ //
+ uint16 BGON;
+ uint16 MZCTL;
+ uint8 MosaicVCount;
+
+ uint8 SFSEL;
+ uint16 SFCODE;
+
+ uint16 CHCTLA;
+ uint16 CHCTLB;
+
+ uint16 BMPNA;
+ uint8 BMPNB;
+
+ uint16 PNCN[4];
+ uint16 PNCNR;
+
+ uint16 PLSZ;
+ uint16 MPOFN;
+ uint16 MPOFR;
+
+ uint8 MapRegs[4][4];
+ uint8 RotMapRegs[2][16];
+ //
+ uint16 XScrollI[4], YScrollI[4];
+ uint8 XScrollF[2], YScrollF[2];
+
+ uint16 ZMCTL;
+ uint16 SCRCTL;
+ uint32 LineScrollAddr[2];
+ uint32 VCScrollAddr;
+ uint32 VCLast[2];
+
+ uint16 XCoordInc[2], YCoordInc[2];
+ uint32 YCoordAccum[2];
+ uint32 MosEff_YCoordAccum[2];
+
+ uint32 CurXScrollIF[2];
+ uint32 CurYScrollIF[2];
+ uint16 CurXCoordInc[2];
+ uint32 CurLSA[2];
+
+ uint16 NBG23_YCounter[2];
+ uint16 MosEff_NBG23_YCounter[2];
+ //
+ uint8 RPMD;
+ uint8 KTCTL[2];
+ uint16 OVPNR[2];
+ //
+ uint32 BKTA;
+ uint32 CurBackTabAddr;
+ uint16 CurBackColor;
+
+ uint32 LCTA;
+ uint32 CurLCTabAddr;
+ uint16 CurLCColor;
+
+ uint8 LineColorEn;
+
+ uint16 SFPRMD;
+ uint16 CCCTL;
+ uint16 SFCCMD;
+ //
+ uint8 NBGPrioNum[4];
+ uint8 RBG0PrioNum;
+
+ uint8 NBGCCRatio[4];
+ uint8 RBG0CCRatio;
+ uint8 LineColorCCRatio;
+ uint8 BackCCRatio;
+
+ //
+ struct
+ {
+  uint16 XStart, XEnd;
+  uint32 LineWinAddr;
+  bool LineWinEn;
+  //
+  bool YMet;
+  uint16 CurXStart, CurXEnd;
+  uint32 CurLineWinAddr;
+ } Window[2];
+
+ uint8 WinControl[8];
+ enum
  {
-  uint64 nbg[4][8 + 704 + 8];
-  struct
+  WINLAYER_NBG0 = 0,
+  WINLAYER_NBG1 = 1,
+  WINLAYER_NBG2 = 2,
+  WINLAYER_NBG3 = 3,
+  WINLAYER_RBG0 = 4,
+  WINLAYER_SPRITE = 5,
+  WINLAYER_ROTPARAM = 6,
+  WINLAYER_CC = 7,
+ };
+
+ std::array<unsigned, 5> WinPieces;
+ //
+ uint8 SpriteCCCond;
+ uint8 SpriteCCNum;
+ uint8 SPCTL_Low;
+
+ uint16 SDCTL;
+
+ uint8 SpritePrioNum[8];
+ uint8 SpriteCCRatio[8];
+
+ uint8 SpriteCCLUT[8];	// Temp optimization data
+ uint8 SpriteCC3Mask; 	// Temp optimization data
+
+ //
+ uint8 CRAMAddrOffs_NBG[4];
+ uint8 CRAMAddrOffs_RBG0;
+ uint8 CRAMAddrOffs_Sprite;
+ //
+ uint8 ColorOffsEn;
+ uint8 ColorOffsSel;
+
+ //enum
+ //{
+ // COLOFFS_ENSEL_NBG0 = 0,
+ // COLOFFS_ENSEL_NBG1 = 0,
+ //};
+
+ int32 ColorOffs[2][3];	// [A,B] [R << 0, G << 8, B << 16]
+
+ struct
+ {
+  uint64 spr[704];
+  uint64 rbg0[704];
+  union
   {
-   uint8 dummy[sizeof(nbg) / 2];
-   uint16 vcscr[2][88 + 1 + 1];	// + 1 for fine x scroll != 0, + 1 for pointer shenanigans in FetchVCScroll
+   uint64 nbg[4][8 + 704 + 8];
+   struct
+   {
+    uint8 rotdummy[sizeof(nbg) / 4];
+    uint8 rotabsel[352];	// Also used as a scratch buffer in T_DrawRBG() to handle mosaic-related junk.
+    RotVars rotv[2];
+    uint32 rotcoeff[352];
+   };
   };
-  struct
+  alignas(16) uint8 lc[704];
+  //
+  // Not in the union with nbg[] above; FetchVCScroll() never stores NBG1 entries in hires modes, so they'd otherwise
+  // end up as whatever NBG2 pixel data was last rendered.
+  //
+  uint16 vcscr[2][88 + 1 + 1];	// + 1 for fine x scroll != 0, + 1 for pointer shenanigans in FetchVCScroll
+ } LB;
+
+ uint32 ColorCache[2048];
+ //
+ //
+ //
+ void CacheCRE(const unsigned cri);
+ void RecalcColorCache(void);
+ void RegsWrite(uint32 A, uint16 V);
+ template<typename T>
+ void MemW(uint32 A, const uint16 DB);
+ void Reset(bool powering_up);
+ void GetCWV(const uint8 ctrl, const bool* const xmet, bool* cwv);
+ void GetWinRotAB(void);
+ void ApplyWin(const unsigned wlayer, uint64* buf);
+ void ApplyHMosaic(const unsigned layer, uint64* buf, const unsigned w);
+ void FetchVCScroll(const unsigned w);
+ template<unsigned TA_PrioMode, unsigned TA_CCMode>
+ void MakeSFCodeLUT(const unsigned layer, int16* const sfcode_lut);
+ template<bool TA_bmen, unsigned TA_bpp, bool TA_isrgb, bool TA_igntp, unsigned TA_PrioMode, unsigned TA_CCMode, typename T>
+ uint64 MakeNBGRBGPix(T& tf, const uint32 pix_base_or, const int16* sfcode_lut, const uint32 ix, const uint32 iy);
+ template<bool TA_bmen, unsigned TA_bpp, bool TA_isrgb, bool TA_igntp, unsigned TA_PrioMode, unsigned TA_CCMode>
+ void T_DrawNBG(const unsigned n, uint64* bgbuf, const unsigned w, const uint32 pix_base_or);
+ template<bool TA_igntp, unsigned TA_PrioMode, unsigned TA_CCMode>
+ uint64 MakeNBG23Pix(uint32 dcc, uint32 pbor, const int16* sfcode_lut, uint32 colcacheoffs);
+ template<unsigned TA_bpp, bool TA_igntp, unsigned TA_PrioMode, unsigned TA_CCMode>
+ void T_DrawNBG23(const unsigned n, uint64* bgbuf, const unsigned w, const uint32 pix_base_or);
+ uint32 GetCoeffAddr(const unsigned i, uint32 offset);
+ uint32 ReadCoeff(const unsigned i, const uint32 addr);
+ template<typename T>
+ void SetupRotVars(const T* rs, const unsigned rbg_w);
+ template<bool TA_bmen, unsigned TA_bpp, bool TA_isrgb, bool TA_igntp, unsigned TA_PrioMode, unsigned TA_CCMode>
+ void T_DrawRBG(const bool rn, uint64* bgbuf, const unsigned w, const uint32 pix_base_or);
+ void RBGPP(const unsigned layer, uint64* buf, const unsigned rbg_w);
+ void MakeSpriteCCLUT(void);
+ template<bool TA_HiRes, bool TA_TPShadSel, unsigned TA_SPCTL_Low>
+ void T_DrawSpriteData(const uint16* vdp1sb, const bool vdp1_hires8, unsigned w);
+ template<bool TA_rbgdualen, unsigned TA_Special, bool TA_CCRTMD, bool TA_CCMD>
+ void T_MixIt(uint32* target, const unsigned vdp2_line, const unsigned w, const uint32 back_rgb24, const uint64* blursrc);
+ int32 ApplyHBlend(uint32* const target, int32 w);
+ void DrawLine(const uint16 out_line, const uint16 vdp2_line, const bool field, const bool render);
+ //
+ //
+ //
+ void StateAction(StateMem* sm, const unsigned load, const bool data_only, uint16 (&rr)[0x100], uint16 (&cr)[2048], uint16 (&vr)[262144]);
+};
+
+template<bool IsRot>
+INLINE void TileFetcher<IsRot>::Start(const Renderer& r, const unsigned n, const bool bmen, const unsigned map_offset, const uint8* map_regs)
+{
+ vram = r.VRAM;
+ BMOffset = map_offset << 16;
+ BMWShift = ((BMSize & 2) ? 10 : 9);
+ BMWMask = (1U << BMWShift) - 8;
+ BMHMask = (BMSize & 1) ? 0x1FF : 0xFF;
+
+ const unsigned psshift = (13 - PNDSize - (CharSize << 1));
+
+ for(unsigned i = 0; i < (IsRot ? 16 : 4); i++)
+ {
+  adj_map_regs[i] = ((map_offset << 6) + (map_regs[i] &~ PlaneSize)) << psshift;
+ }
+
+ if(IsRot)
+ {
+  if(bmen)
   {
-   uint8 rotdummy[sizeof(nbg) / 4];
-   uint8 rotabsel[352];	// Also used as a scratch buffer in T_DrawRBG() to handle mosaic-related junk.
-   RotVars rotv[2];
-   uint32 rotcoeff[352];
-  };
- };
- alignas(16) uint8 lc[704];
-} LB;
+   doxm = ~(BMWMask + 7);
+   doym = ~BMHMask;
+  }
+  else
+  {
+   doxm = ~((1U << ((9 + (bool)(PlaneSize & 0x1)) + (IsRot ? 2 : 1))) - 1);
+   doym = ~((1U << ((9 + (bool)(PlaneSize & 0x2)) + (IsRot ? 2 : 1))) - 1);
+  }
+
+  if(PlaneOver == 0)
+   doxm = doym = 0;
+  else if(PlaneOver == 3)
+   doxm = doym = ~511;
+ }
+
+ // Kludgeyness:
+ for(unsigned bank = 0; bank < 4; bank++)
+ {
+  const unsigned esb = bank & (2 | ((r.VRAM_Mode >> (bank >> 1)) & 1));
+  const uint8 rdbs = (r.RDBS_Mode >> (esb << 1)) & 0x3;
+
+  if(IsRot)
+  {
+   if(!(r.BGON & 0x20) || n == 4)
+   {
+    nt_ok[bank] = (rdbs == RDBS_NAME) && (bank < 2 || !(r.BGON & 0x20));
+    cg_ok[bank] = (rdbs == RDBS_CHAR) && (bank < 2 || !(r.BGON & 0x20));
+   }
+   else
+   {
+    nt_ok[bank] = (bank == 3);
+    cg_ok[bank] = (bank == 2);
+   }
+  }
+  else
+  {
+   nt_ok[bank] = false;
+   cg_ok[bank] = false;
+
+   if((r.BGON & 0x20) && (bank & 0x2))
+   {
+    //
+   }
+   else if(!(r.BGON & 0x10) || rdbs == RDBS_UNUSED)
+   {
+    for(unsigned ac = 0; ac < ((r.HRes & 0x6) ? 4 : 8); ac++)
+    {
+     if(r.VCPRegs[esb][ac] == (VCP_NBG0_CG + n))
+      cg_ok[bank] = true;
+
+     if(r.VCPRegs[esb][ac] == (VCP_NBG0_NT + n))
+      nt_ok[bank] = true;
+    }
+   }
+  }
+ }
+
+ #if 1
+ pcco = 0;
+ spr = false;
+ scc = false;
+ tile_vrb = nullptr;
+ cellx_xor = 0;
+ #endif
+}
 
 // ColorOffsEn, etc. ?...hmm, discrepancy with ColorCalcEn and LineColorEn...
 enum
@@ -501,8 +560,7 @@ enum
 //
 //
 //
-static uint32 ColorCache[2048];
-static void CacheCRE(const unsigned cri)
+void Renderer::CacheCRE(const unsigned cri)
 {
  if(CRAM_Mode & CRAM_MODE_RGB888_1024)
  {
@@ -520,7 +578,7 @@ static void CacheCRE(const unsigned cri)
  }
 }
 
-static void RecalcColorCache(void)
+void Renderer::RecalcColorCache(void)
 {
  if(CRAM_Mode & CRAM_MODE_RGB888_1024)
  {
@@ -539,7 +597,7 @@ static void RecalcColorCache(void)
 //
 // Register writes seem to always be 16-bit
 //
-static INLINE void RegsWrite(uint32 A, uint16 V)
+INLINE void Renderer::RegsWrite(uint32 A, uint16 V)
 {
  A &= 0x1FE;
 
@@ -937,7 +995,7 @@ static INLINE void RegsWrite(uint32 A, uint16 V)
 }
 
 template<typename T>
-static INLINE void MemW(uint32 A, const uint16 DB)
+INLINE void Renderer::MemW(uint32 A, const uint16 DB)
 {
  A &= 0x1FFFFF;
 
@@ -997,7 +1055,7 @@ static INLINE void MemW(uint32 A, const uint16 DB)
 }
 
 
-static void Reset(bool powering_up)
+void Renderer::Reset(bool powering_up)
 {
  if(powering_up)
  {
@@ -1212,7 +1270,7 @@ enum
  //SPECIAL_CCALC_SHIFT = 63
 };
 
-static INLINE void GetCWV(const uint8 ctrl, const bool* const xmet, bool* cwv)
+INLINE void Renderer::GetCWV(const uint8 ctrl, const bool* const xmet, bool* cwv)
 {
  const bool logic = (ctrl >> 7) & 1;	// 0 = OR, 1 = AND
  const bool w_enable[2] = { (bool)(ctrl & 0x02), (bool)(ctrl & 0x08) };
@@ -1237,7 +1295,7 @@ static INLINE void GetCWV(const uint8 ctrl, const bool* const xmet, bool* cwv)
  }
 }
 
-static void GetWinRotAB(void)
+INLINE void Renderer::GetWinRotAB(void)
 {
  unsigned x = 0;
 
@@ -1267,7 +1325,7 @@ static void GetWinRotAB(void)
  }
 }
 
-static void ApplyWin(const unsigned wlayer, uint64* buf)
+void Renderer::ApplyWin(const unsigned wlayer, uint64* buf)
 {
  unsigned x = 0;
 
@@ -1332,7 +1390,7 @@ static void ApplyWin(const unsigned wlayer, uint64* buf)
  #pragma GCC push_options
  #pragma GCC optimize("no-unroll-loops,no-peel-loops,no-crossjumping")
 #endif
-static NO_INLINE void ApplyHMosaic(const unsigned layer, uint64* buf, const unsigned w)
+NO_INLINE void Renderer::ApplyHMosaic(const unsigned layer, uint64* buf, const unsigned w)
 {
  if(!(MZCTL & (1U << layer)))
   return;
@@ -1380,7 +1438,7 @@ static NO_INLINE void ApplyHMosaic(const unsigned layer, uint64* buf, const unsi
 //	[Entry 44] [Entry 44] [Entry 0] [Entry 1]
 //
 
-static void FetchVCScroll(const unsigned w)
+INLINE void Renderer::FetchVCScroll(const unsigned w)
 {
  const bool vcon[2] = { (bool)(SCRCTL & BGON & !(MZCTL & 0x1)), (bool)((SCRCTL >> 8) & (BGON >> 1) & !(MZCTL & 0x2) & 0x1) };
  const unsigned max_cyc = (HRes & 0x6) ? 4 : 8;
@@ -1463,7 +1521,7 @@ static void FetchVCScroll(const unsigned w)
 }
 
 template<unsigned TA_PrioMode, unsigned TA_CCMode>
-static INLINE void MakeSFCodeLUT(const unsigned layer, int16* const sfcode_lut)
+INLINE void Renderer::MakeSFCodeLUT(const unsigned layer, int16* const sfcode_lut)
 {
  const uint8 code = SFCODE >> (((SFSEL >> layer) & 1) << 3);
 
@@ -1490,7 +1548,7 @@ static INLINE uint32 rgb15_to_rgb24(uint16 src)
 }
 
 template<bool TA_bmen, unsigned TA_bpp, bool TA_isrgb, bool TA_igntp, unsigned TA_PrioMode, unsigned TA_CCMode, typename T>
-static INLINE uint64 MakeNBGRBGPix(T& tf, const uint32 pix_base_or, const int16* sfcode_lut, const uint32 ix, const uint32 iy)
+INLINE uint64 Renderer::MakeNBGRBGPix(T& tf, const uint32 pix_base_or, const int16* sfcode_lut, const uint32 ix, const uint32 iy)
 {
  uint32 cellx = (ix ^ tf.cellx_xor);
  const uint16* vrb = &tf.tile_vrb[((cellx * TA_bpp) >> 4)];
@@ -1557,7 +1615,7 @@ static INLINE uint64 MakeNBGRBGPix(T& tf, const uint32 pix_base_or, const int16*
 }
 
 template<bool TA_bmen, unsigned TA_bpp, bool TA_isrgb, bool TA_igntp, unsigned TA_PrioMode, unsigned TA_CCMode>
-static void T_DrawNBG(const unsigned n, uint64* bgbuf, const unsigned w, const uint32 pix_base_or)
+void Renderer::T_DrawNBG(const unsigned n, uint64* bgbuf, const unsigned w, const uint32 pix_base_or)
 {
  assert(n < 2);
  //
@@ -1583,7 +1641,7 @@ static void T_DrawNBG(const unsigned n, uint64* bgbuf, const unsigned w, const u
  tf.AuxMode = (PNCN[n] >> 14) & 1;
  tf.Supp = (PNCN[n] & 0x3FF); // Supplement bits when PNDSize == 1
  //
- tf.Start(n, TA_bmen, (MPOFN >> (n << 2)) & 0x7, MapRegs[n]);
+ tf.Start(*this, n, TA_bmen, (MPOFN >> (n << 2)) & 0x7, MapRegs[n]);
 
  MakeSFCodeLUT<TA_PrioMode, TA_CCMode>(n, sfcode_lut);
 
@@ -1641,26 +1699,26 @@ static void T_DrawNBG(const unsigned n, uint64* bgbuf, const unsigned w, const u
  }
 }
 
-static void (*DrawNBG[2 /*bitmap enable*/][5/*col mode*/][2/*igntp*/][3/*priomode*/][4/*ccmode*/])(const unsigned n, uint64* bgbuf, const unsigned w, const uint32 pix_base_or) =
+static void (Renderer::*DrawNBG[2 /*bitmap enable*/][5/*col mode*/][2/*igntp*/][3/*priomode*/][4/*ccmode*/])(const unsigned n, uint64* bgbuf, const unsigned w, const uint32 pix_base_or) =
 {
  {
-  {  {  { T_DrawNBG<0, 4, 0, 0, 0, 0>, T_DrawNBG<0, 4, 0, 0, 0, 1>, T_DrawNBG<0, 4, 0, 0, 0, 2>, T_DrawNBG<0, 4, 0, 0, 0, 3>,  },  { T_DrawNBG<0, 4, 0, 0, 1, 0>, T_DrawNBG<0, 4, 0, 0, 1, 1>, T_DrawNBG<0, 4, 0, 0, 1, 2>, T_DrawNBG<0, 4, 0, 0, 1, 3>,  },  { T_DrawNBG<0, 4, 0, 0, 2, 0>, T_DrawNBG<0, 4, 0, 0, 2, 1>, T_DrawNBG<0, 4, 0, 0, 2, 2>, T_DrawNBG<0, 4, 0, 0, 2, 3>,  },  },  {  { T_DrawNBG<0, 4, 0, 1, 0, 0>, T_DrawNBG<0, 4, 0, 1, 0, 1>, T_DrawNBG<0, 4, 0, 1, 0, 2>, T_DrawNBG<0, 4, 0, 1, 0, 3>,  },  { T_DrawNBG<0, 4, 0, 1, 1, 0>, T_DrawNBG<0, 4, 0, 1, 1, 1>, T_DrawNBG<0, 4, 0, 1, 1, 2>, T_DrawNBG<0, 4, 0, 1, 1, 3>,  },  { T_DrawNBG<0, 4, 0, 1, 2, 0>, T_DrawNBG<0, 4, 0, 1, 2, 1>, T_DrawNBG<0, 4, 0, 1, 2, 2>, T_DrawNBG<0, 4, 0, 1, 2, 3>,  },  },  },
-  {  {  { T_DrawNBG<0, 8, 0, 0, 0, 0>, T_DrawNBG<0, 8, 0, 0, 0, 1>, T_DrawNBG<0, 8, 0, 0, 0, 2>, T_DrawNBG<0, 8, 0, 0, 0, 3>,  },  { T_DrawNBG<0, 8, 0, 0, 1, 0>, T_DrawNBG<0, 8, 0, 0, 1, 1>, T_DrawNBG<0, 8, 0, 0, 1, 2>, T_DrawNBG<0, 8, 0, 0, 1, 3>,  },  { T_DrawNBG<0, 8, 0, 0, 2, 0>, T_DrawNBG<0, 8, 0, 0, 2, 1>, T_DrawNBG<0, 8, 0, 0, 2, 2>, T_DrawNBG<0, 8, 0, 0, 2, 3>,  },  },  {  { T_DrawNBG<0, 8, 0, 1, 0, 0>, T_DrawNBG<0, 8, 0, 1, 0, 1>, T_DrawNBG<0, 8, 0, 1, 0, 2>, T_DrawNBG<0, 8, 0, 1, 0, 3>,  },  { T_DrawNBG<0, 8, 0, 1, 1, 0>, T_DrawNBG<0, 8, 0, 1, 1, 1>, T_DrawNBG<0, 8, 0, 1, 1, 2>, T_DrawNBG<0, 8, 0, 1, 1, 3>,  },  { T_DrawNBG<0, 8, 0, 1, 2, 0>, T_DrawNBG<0, 8, 0, 1, 2, 1>, T_DrawNBG<0, 8, 0, 1, 2, 2>, T_DrawNBG<0, 8, 0, 1, 2, 3>,  },  },  },
-  {  {  { T_DrawNBG<0, 16, 0, 0, 0, 0>, T_DrawNBG<0, 16, 0, 0, 0, 1>, T_DrawNBG<0, 16, 0, 0, 0, 2>, T_DrawNBG<0, 16, 0, 0, 0, 3>,  },  { T_DrawNBG<0, 16, 0, 0, 1, 0>, T_DrawNBG<0, 16, 0, 0, 1, 1>, T_DrawNBG<0, 16, 0, 0, 1, 2>, T_DrawNBG<0, 16, 0, 0, 1, 3>,  },  { T_DrawNBG<0, 16, 0, 0, 2, 0>, T_DrawNBG<0, 16, 0, 0, 2, 1>, T_DrawNBG<0, 16, 0, 0, 2, 2>, T_DrawNBG<0, 16, 0, 0, 2, 3>,  },  },  {  { T_DrawNBG<0, 16, 0, 1, 0, 0>, T_DrawNBG<0, 16, 0, 1, 0, 1>, T_DrawNBG<0, 16, 0, 1, 0, 2>, T_DrawNBG<0, 16, 0, 1, 0, 3>,  },  { T_DrawNBG<0, 16, 0, 1, 1, 0>, T_DrawNBG<0, 16, 0, 1, 1, 1>, T_DrawNBG<0, 16, 0, 1, 1, 2>, T_DrawNBG<0, 16, 0, 1, 1, 3>,  },  { T_DrawNBG<0, 16, 0, 1, 2, 0>, T_DrawNBG<0, 16, 0, 1, 2, 1>, T_DrawNBG<0, 16, 0, 1, 2, 2>, T_DrawNBG<0, 16, 0, 1, 2, 3>,  },  },  },
-  {  {  { T_DrawNBG<0, 16, 1, 0, 0, 0>, T_DrawNBG<0, 16, 1, 0, 0, 1>, T_DrawNBG<0, 16, 1, 0, 0, 2>, T_DrawNBG<0, 16, 1, 0, 0, 3>,  },  { T_DrawNBG<0, 16, 1, 0, 1, 0>, T_DrawNBG<0, 16, 1, 0, 1, 1>, T_DrawNBG<0, 16, 1, 0, 1, 2>, T_DrawNBG<0, 16, 1, 0, 1, 3>,  },  { T_DrawNBG<0, 16, 1, 0, 2, 0>, T_DrawNBG<0, 16, 1, 0, 2, 1>, T_DrawNBG<0, 16, 1, 0, 2, 2>, T_DrawNBG<0, 16, 1, 0, 2, 3>,  },  },  {  { T_DrawNBG<0, 16, 1, 1, 0, 0>, T_DrawNBG<0, 16, 1, 1, 0, 1>, T_DrawNBG<0, 16, 1, 1, 0, 2>, T_DrawNBG<0, 16, 1, 1, 0, 3>,  },  { T_DrawNBG<0, 16, 1, 1, 1, 0>, T_DrawNBG<0, 16, 1, 1, 1, 1>, T_DrawNBG<0, 16, 1, 1, 1, 2>, T_DrawNBG<0, 16, 1, 1, 1, 3>,  },  { T_DrawNBG<0, 16, 1, 1, 2, 0>, T_DrawNBG<0, 16, 1, 1, 2, 1>, T_DrawNBG<0, 16, 1, 1, 2, 2>, T_DrawNBG<0, 16, 1, 1, 2, 3>,  },  },  },
-  {  {  { T_DrawNBG<0, 32, 1, 0, 0, 0>, T_DrawNBG<0, 32, 1, 0, 0, 1>, T_DrawNBG<0, 32, 1, 0, 0, 2>, T_DrawNBG<0, 32, 1, 0, 0, 3>,  },  { T_DrawNBG<0, 32, 1, 0, 1, 0>, T_DrawNBG<0, 32, 1, 0, 1, 1>, T_DrawNBG<0, 32, 1, 0, 1, 2>, T_DrawNBG<0, 32, 1, 0, 1, 3>,  },  { T_DrawNBG<0, 32, 1, 0, 2, 0>, T_DrawNBG<0, 32, 1, 0, 2, 1>, T_DrawNBG<0, 32, 1, 0, 2, 2>, T_DrawNBG<0, 32, 1, 0, 2, 3>,  },  },  {  { T_DrawNBG<0, 32, 1, 1, 0, 0>, T_DrawNBG<0, 32, 1, 1, 0, 1>, T_DrawNBG<0, 32, 1, 1, 0, 2>, T_DrawNBG<0, 32, 1, 1, 0, 3>,  },  { T_DrawNBG<0, 32, 1, 1, 1, 0>, T_DrawNBG<0, 32, 1, 1, 1, 1>, T_DrawNBG<0, 32, 1, 1, 1, 2>, T_DrawNBG<0, 32, 1, 1, 1, 3>,  },  { T_DrawNBG<0, 32, 1, 1, 2, 0>, T_DrawNBG<0, 32, 1, 1, 2, 1>, T_DrawNBG<0, 32, 1, 1, 2, 2>, T_DrawNBG<0, 32, 1, 1, 2, 3>,  },  },  },
+  {  {  { &Renderer::T_DrawNBG<0, 4, 0, 0, 0, 0>, &Renderer::T_DrawNBG<0, 4, 0, 0, 0, 1>, &Renderer::T_DrawNBG<0, 4, 0, 0, 0, 2>, &Renderer::T_DrawNBG<0, 4, 0, 0, 0, 3>,  },  { &Renderer::T_DrawNBG<0, 4, 0, 0, 1, 0>, &Renderer::T_DrawNBG<0, 4, 0, 0, 1, 1>, &Renderer::T_DrawNBG<0, 4, 0, 0, 1, 2>, &Renderer::T_DrawNBG<0, 4, 0, 0, 1, 3>,  },  { &Renderer::T_DrawNBG<0, 4, 0, 0, 2, 0>, &Renderer::T_DrawNBG<0, 4, 0, 0, 2, 1>, &Renderer::T_DrawNBG<0, 4, 0, 0, 2, 2>, &Renderer::T_DrawNBG<0, 4, 0, 0, 2, 3>,  },  },  {  { &Renderer::T_DrawNBG<0, 4, 0, 1, 0, 0>, &Renderer::T_DrawNBG<0, 4, 0, 1, 0, 1>, &Renderer::T_DrawNBG<0, 4, 0, 1, 0, 2>, &Renderer::T_DrawNBG<0, 4, 0, 1, 0, 3>,  },  { &Renderer::T_DrawNBG<0, 4, 0, 1, 1, 0>, &Renderer::T_DrawNBG<0, 4, 0, 1, 1, 1>, &Renderer::T_DrawNBG<0, 4, 0, 1, 1, 2>, &Renderer::T_DrawNBG<0, 4, 0, 1, 1, 3>,  },  { &Renderer::T_DrawNBG<0, 4, 0, 1, 2, 0>, &Renderer::T_DrawNBG<0, 4, 0, 1, 2, 1>, &Renderer::T_DrawNBG<0, 4, 0, 1, 2, 2>, &Renderer::T_DrawNBG<0, 4, 0, 1, 2, 3>,  },  },  },
+  {  {  { &Renderer::T_DrawNBG<0, 8, 0, 0, 0, 0>, &Renderer::T_DrawNBG<0, 8, 0, 0, 0, 1>, &Renderer::T_DrawNBG<0, 8, 0, 0, 0, 2>, &Renderer::T_DrawNBG<0, 8, 0, 0, 0, 3>,  },  { &Renderer::T_DrawNBG<0, 8, 0, 0, 1, 0>, &Renderer::T_DrawNBG<0, 8, 0, 0, 1, 1>, &Renderer::T_DrawNBG<0, 8, 0, 0, 1, 2>, &Renderer::T_DrawNBG<0, 8, 0, 0, 1, 3>,  },  { &Renderer::T_DrawNBG<0, 8, 0, 0, 2, 0>, &Renderer::T_DrawNBG<0, 8, 0, 0, 2, 1>, &Renderer::T_DrawNBG<0, 8, 0, 0, 2, 2>, &Renderer::T_DrawNBG<0, 8, 0, 0, 2, 3>,  },  },  {  { &Renderer::T_DrawNBG<0, 8, 0, 1, 0, 0>, &Renderer::T_DrawNBG<0, 8, 0, 1, 0, 1>, &Renderer::T_DrawNBG<0, 8, 0, 1, 0, 2>, &Renderer::T_DrawNBG<0, 8, 0, 1, 0, 3>,  },  { &Renderer::T_DrawNBG<0, 8, 0, 1, 1, 0>, &Renderer::T_DrawNBG<0, 8, 0, 1, 1, 1>, &Renderer::T_DrawNBG<0, 8, 0, 1, 1, 2>, &Renderer::T_DrawNBG<0, 8, 0, 1, 1, 3>,  },  { &Renderer::T_DrawNBG<0, 8, 0, 1, 2, 0>, &Renderer::T_DrawNBG<0, 8, 0, 1, 2, 1>, &Renderer::T_DrawNBG<0, 8, 0, 1, 2, 2>, &Renderer::T_DrawNBG<0, 8, 0, 1, 2, 3>,  },  },  },
+  {  {  { &Renderer::T_DrawNBG<0, 16, 0, 0, 0, 0>, &Renderer::T_DrawNBG<0, 16, 0, 0, 0, 1>, &Renderer::T_DrawNBG<0, 16, 0, 0, 0, 2>, &Renderer::T_DrawNBG<0, 16, 0, 0, 0, 3>,  },  { &Renderer::T_DrawNBG<0, 16, 0, 0, 1, 0>, &Renderer::T_DrawNBG<0, 16, 0, 0, 1, 1>, &Renderer::T_DrawNBG<0, 16, 0, 0, 1, 2>, &Renderer::T_DrawNBG<0, 16, 0, 0, 1, 3>,  },  { &Renderer::T_DrawNBG<0, 16, 0, 0, 2, 0>, &Renderer::T_DrawNBG<0, 16, 0, 0, 2, 1>, &Renderer::T_DrawNBG<0, 16, 0, 0, 2, 2>, &Renderer::T_DrawNBG<0, 16, 0, 0, 2, 3>,  },  },  {  { &Renderer::T_DrawNBG<0, 16, 0, 1, 0, 0>, &Renderer::T_DrawNBG<0, 16, 0, 1, 0, 1>, &Renderer::T_DrawNBG<0, 16, 0, 1, 0, 2>, &Renderer::T_DrawNBG<0, 16, 0, 1, 0, 3>,  },  { &Renderer::T_DrawNBG<0, 16, 0, 1, 1, 0>, &Renderer::T_DrawNBG<0, 16, 0, 1, 1, 1>, &Renderer::T_DrawNBG<0, 16, 0, 1, 1, 2>, &Renderer::T_DrawNBG<0, 16, 0, 1, 1, 3>,  },  { &Renderer::T_DrawNBG<0, 16, 0, 1, 2, 0>, &Renderer::T_DrawNBG<0, 16, 0, 1, 2, 1>, &Renderer::T_DrawNBG<0, 16, 0, 1, 2, 2>, &Renderer::T_DrawNBG<0, 16, 0, 1, 2, 3>,  },  },  },
+  {  {  { &Renderer::T_DrawNBG<0, 16, 1, 0, 0, 0>, &Renderer::T_DrawNBG<0, 16, 1, 0, 0, 1>, &Renderer::T_DrawNBG<0, 16, 1, 0, 0, 2>, &Renderer::T_DrawNBG<0, 16, 1, 0, 0, 3>,  },  { &Renderer::T_DrawNBG<0, 16, 1, 0, 1, 0>, &Renderer::T_DrawNBG<0, 16, 1, 0, 1, 1>, &Renderer::T_DrawNBG<0, 16, 1, 0, 1, 2>, &Renderer::T_DrawNBG<0, 16, 1, 0, 1, 3>,  },  { &Renderer::T_DrawNBG<0, 16, 1, 0, 2, 0>, &Renderer::T_DrawNBG<0, 16, 1, 0, 2, 1>, &Renderer::T_DrawNBG<0, 16, 1, 0, 2, 2>, &Renderer::T_DrawNBG<0, 16, 1, 0, 2, 3>,  },  },  {  { &Renderer::T_DrawNBG<0, 16, 1, 1, 0, 0>, &Renderer::T_DrawNBG<0, 16, 1, 1, 0, 1>, &Renderer::T_DrawNBG<0, 16, 1, 1, 0, 2>, &Renderer::T_DrawNBG<0, 16, 1, 1, 0, 3>,  },  { &Renderer::T_DrawNBG<0, 16, 1, 1, 1, 0>, &Renderer::T_DrawNBG<0, 16, 1, 1, 1, 1>, &Renderer::T_DrawNBG<0, 16, 1, 1, 1, 2>, &Renderer::T_DrawNBG<0, 16, 1, 1, 1, 3>,  },  { &Renderer::T_DrawNBG<0, 16, 1, 1, 2, 0>, &Renderer::T_DrawNBG<0, 16, 1, 1, 2, 1>, &Renderer::T_DrawNBG<0, 16, 1, 1, 2, 2>, &Renderer::T_DrawNBG<0, 16, 1, 1, 2, 3>,  },  },  },
+  {  {  { &Renderer::T_DrawNBG<0, 32, 1, 0, 0, 0>, &Renderer::T_DrawNBG<0, 32, 1, 0, 0, 1>, &Renderer::T_DrawNBG<0, 32, 1, 0, 0, 2>, &Renderer::T_DrawNBG<0, 32, 1, 0, 0, 3>,  },  { &Renderer::T_DrawNBG<0, 32, 1, 0, 1, 0>, &Renderer::T_DrawNBG<0, 32, 1, 0, 1, 1>, &Renderer::T_DrawNBG<0, 32, 1, 0, 1, 2>, &Renderer::T_DrawNBG<0, 32, 1, 0, 1, 3>,  },  { &Renderer::T_DrawNBG<0, 32, 1, 0, 2, 0>, &Renderer::T_DrawNBG<0, 32, 1, 0, 2, 1>, &Renderer::T_DrawNBG<0, 32, 1, 0, 2, 2>, &Renderer::T_DrawNBG<0, 32, 1, 0, 2, 3>,  },  },  {  { &Renderer::T_DrawNBG<0, 32, 1, 1, 0, 0>, &Renderer::T_DrawNBG<0, 32, 1, 1, 0, 1>, &Renderer::T_DrawNBG<0, 32, 1, 1, 0, 2>, &Renderer::T_DrawNBG<0, 32, 1, 1, 0, 3>,  },  { &Renderer::T_DrawNBG<0, 32, 1, 1, 1, 0>, &Renderer::T_DrawNBG<0, 32, 1, 1, 1, 1>, &Renderer::T_DrawNBG<0, 32, 1, 1, 1, 2>, &Renderer::T_DrawNBG<0, 32, 1, 1, 1, 3>,  },  { &Renderer::T_DrawNBG<0, 32, 1, 1, 2, 0>, &Renderer::T_DrawNBG<0, 32, 1, 1, 2, 1>, &Renderer::T_DrawNBG<0, 32, 1, 1, 2, 2>, &Renderer::T_DrawNBG<0, 32, 1, 1, 2, 3>,  },  },  },
  },
  {
-  {  {  { T_DrawNBG<1, 4, 0, 0, 0, 0>, T_DrawNBG<1, 4, 0, 0, 0, 1>, T_DrawNBG<1, 4, 0, 0, 0, 2>, T_DrawNBG<1, 4, 0, 0, 0, 3>,  },  { T_DrawNBG<1, 4, 0, 0, 1, 0>, T_DrawNBG<1, 4, 0, 0, 1, 1>, T_DrawNBG<1, 4, 0, 0, 1, 2>, T_DrawNBG<1, 4, 0, 0, 1, 3>,  },  { T_DrawNBG<1, 4, 0, 0, 2, 0>, T_DrawNBG<1, 4, 0, 0, 2, 1>, T_DrawNBG<1, 4, 0, 0, 2, 2>, T_DrawNBG<1, 4, 0, 0, 2, 3>,  },  },  {  { T_DrawNBG<1, 4, 0, 1, 0, 0>, T_DrawNBG<1, 4, 0, 1, 0, 1>, T_DrawNBG<1, 4, 0, 1, 0, 2>, T_DrawNBG<1, 4, 0, 1, 0, 3>,  },  { T_DrawNBG<1, 4, 0, 1, 1, 0>, T_DrawNBG<1, 4, 0, 1, 1, 1>, T_DrawNBG<1, 4, 0, 1, 1, 2>, T_DrawNBG<1, 4, 0, 1, 1, 3>,  },  { T_DrawNBG<1, 4, 0, 1, 2, 0>, T_DrawNBG<1, 4, 0, 1, 2, 1>, T_DrawNBG<1, 4, 0, 1, 2, 2>, T_DrawNBG<1, 4, 0, 1, 2, 3>,  },  },  },
-  {  {  { T_DrawNBG<1, 8, 0, 0, 0, 0>, T_DrawNBG<1, 8, 0, 0, 0, 1>, T_DrawNBG<1, 8, 0, 0, 0, 2>, T_DrawNBG<1, 8, 0, 0, 0, 3>,  },  { T_DrawNBG<1, 8, 0, 0, 1, 0>, T_DrawNBG<1, 8, 0, 0, 1, 1>, T_DrawNBG<1, 8, 0, 0, 1, 2>, T_DrawNBG<1, 8, 0, 0, 1, 3>,  },  { T_DrawNBG<1, 8, 0, 0, 2, 0>, T_DrawNBG<1, 8, 0, 0, 2, 1>, T_DrawNBG<1, 8, 0, 0, 2, 2>, T_DrawNBG<1, 8, 0, 0, 2, 3>,  },  },  {  { T_DrawNBG<1, 8, 0, 1, 0, 0>, T_DrawNBG<1, 8, 0, 1, 0, 1>, T_DrawNBG<1, 8, 0, 1, 0, 2>, T_DrawNBG<1, 8, 0, 1, 0, 3>,  },  { T_DrawNBG<1, 8, 0, 1, 1, 0>, T_DrawNBG<1, 8, 0, 1, 1, 1>, T_DrawNBG<1, 8, 0, 1, 1, 2>, T_DrawNBG<1, 8, 0, 1, 1, 3>,  },  { T_DrawNBG<1, 8, 0, 1, 2, 0>, T_DrawNBG<1, 8, 0, 1, 2, 1>, T_DrawNBG<1, 8, 0, 1, 2, 2>, T_DrawNBG<1, 8, 0, 1, 2, 3>,  },  },  },
-  {  {  { T_DrawNBG<1, 16, 0, 0, 0, 0>, T_DrawNBG<1, 16, 0, 0, 0, 1>, T_DrawNBG<1, 16, 0, 0, 0, 2>, T_DrawNBG<1, 16, 0, 0, 0, 3>,  },  { T_DrawNBG<1, 16, 0, 0, 1, 0>, T_DrawNBG<1, 16, 0, 0, 1, 1>, T_DrawNBG<1, 16, 0, 0, 1, 2>, T_DrawNBG<1, 16, 0, 0, 1, 3>,  },  { T_DrawNBG<1, 16, 0, 0, 2, 0>, T_DrawNBG<1, 16, 0, 0, 2, 1>, T_DrawNBG<1, 16, 0, 0, 2, 2>, T_DrawNBG<1, 16, 0, 0, 2, 3>,  },  },  {  { T_DrawNBG<1, 16, 0, 1, 0, 0>, T_DrawNBG<1, 16, 0, 1, 0, 1>, T_DrawNBG<1, 16, 0, 1, 0, 2>, T_DrawNBG<1, 16, 0, 1, 0, 3>,  },  { T_DrawNBG<1, 16, 0, 1, 1, 0>, T_DrawNBG<1, 16, 0, 1, 1, 1>, T_DrawNBG<1, 16, 0, 1, 1, 2>, T_DrawNBG<1, 16, 0, 1, 1, 3>,  },  { T_DrawNBG<1, 16, 0, 1, 2, 0>, T_DrawNBG<1, 16, 0, 1, 2, 1>, T_DrawNBG<1, 16, 0, 1, 2, 2>, T_DrawNBG<1, 16, 0, 1, 2, 3>,  },  },  },
-  {  {  { T_DrawNBG<1, 16, 1, 0, 0, 0>, T_DrawNBG<1, 16, 1, 0, 0, 1>, T_DrawNBG<1, 16, 1, 0, 0, 2>, T_DrawNBG<1, 16, 1, 0, 0, 3>,  },  { T_DrawNBG<1, 16, 1, 0, 1, 0>, T_DrawNBG<1, 16, 1, 0, 1, 1>, T_DrawNBG<1, 16, 1, 0, 1, 2>, T_DrawNBG<1, 16, 1, 0, 1, 3>,  },  { T_DrawNBG<1, 16, 1, 0, 2, 0>, T_DrawNBG<1, 16, 1, 0, 2, 1>, T_DrawNBG<1, 16, 1, 0, 2, 2>, T_DrawNBG<1, 16, 1, 0, 2, 3>,  },  },  {  { T_DrawNBG<1, 16, 1, 1, 0, 0>, T_DrawNBG<1, 16, 1, 1, 0, 1>, T_DrawNBG<1, 16, 1, 1, 0, 2>, T_DrawNBG<1, 16, 1, 1, 0, 3>,  },  { T_DrawNBG<1, 16, 1, 1, 1, 0>, T_DrawNBG<1, 16, 1, 1, 1, 1>, T_DrawNBG<1, 16, 1, 1, 1, 2>, T_DrawNBG<1, 16, 1, 1, 1, 3>,  },  { T_DrawNBG<1, 16, 1, 1, 2, 0>, T_DrawNBG<1, 16, 1, 1, 2, 1>, T_DrawNBG<1, 16, 1, 1, 2, 2>, T_DrawNBG<1, 16, 1, 1, 2, 3>,  },  },  },
-  {  {  { T_DrawNBG<1, 32, 1, 0, 0, 0>, T_DrawNBG<1, 32, 1, 0, 0, 1>, T_DrawNBG<1, 32, 1, 0, 0, 2>, T_DrawNBG<1, 32, 1, 0, 0, 3>,  },  { T_DrawNBG<1, 32, 1, 0, 1, 0>, T_DrawNBG<1, 32, 1, 0, 1, 1>, T_DrawNBG<1, 32, 1, 0, 1, 2>, T_DrawNBG<1, 32, 1, 0, 1, 3>,  },  { T_DrawNBG<1, 32, 1, 0, 2, 0>, T_DrawNBG<1, 32, 1, 0, 2, 1>, T_DrawNBG<1, 32, 1, 0, 2, 2>, T_DrawNBG<1, 32, 1, 0, 2, 3>,  },  },  {  { T_DrawNBG<1, 32, 1, 1, 0, 0>, T_DrawNBG<1, 32, 1, 1, 0, 1>, T_DrawNBG<1, 32, 1, 1, 0, 2>, T_DrawNBG<1, 32, 1, 1, 0, 3>,  },  { T_DrawNBG<1, 32, 1, 1, 1, 0>, T_DrawNBG<1, 32, 1, 1, 1, 1>, T_DrawNBG<1, 32, 1, 1, 1, 2>, T_DrawNBG<1, 32, 1, 1, 1, 3>,  },  { T_DrawNBG<1, 32, 1, 1, 2, 0>, T_DrawNBG<1, 32, 1, 1, 2, 1>, T_DrawNBG<1, 32, 1, 1, 2, 2>, T_DrawNBG<1, 32, 1, 1, 2, 3>,  },  },  },
+  {  {  { &Renderer::T_DrawNBG<1, 4, 0, 0, 0, 0>, &Renderer::T_DrawNBG<1, 4, 0, 0, 0, 1>, &Renderer::T_DrawNBG<1, 4, 0, 0, 0, 2>, &Renderer::T_DrawNBG<1, 4, 0, 0, 0, 3>,  },  { &Renderer::T_DrawNBG<1, 4, 0, 0, 1, 0>, &Renderer::T_DrawNBG<1, 4, 0, 0, 1, 1>, &Renderer::T_DrawNBG<1, 4, 0, 0, 1, 2>, &Renderer::T_DrawNBG<1, 4, 0, 0, 1, 3>,  },  { &Renderer::T_DrawNBG<1, 4, 0, 0, 2, 0>, &Renderer::T_DrawNBG<1, 4, 0, 0, 2, 1>, &Renderer::T_DrawNBG<1, 4, 0, 0, 2, 2>, &Renderer::T_DrawNBG<1, 4, 0, 0, 2, 3>,  },  },  {  { &Renderer::T_DrawNBG<1, 4, 0, 1, 0, 0>, &Renderer::T_DrawNBG<1, 4, 0, 1, 0, 1>, &Renderer::T_DrawNBG<1, 4, 0, 1, 0, 2>, &Renderer::T_DrawNBG<1, 4, 0, 1, 0, 3>,  },  { &Renderer::T_DrawNBG<1, 4, 0, 1, 1, 0>, &Renderer::T_DrawNBG<1, 4, 0, 1, 1, 1>, &Renderer::T_DrawNBG<1, 4, 0, 1, 1, 2>, &Renderer::T_DrawNBG<1, 4, 0, 1, 1, 3>,  },  { &Renderer::T_DrawNBG<1, 4, 0, 1, 2, 0>, &Renderer::T_DrawNBG<1, 4, 0, 1, 2, 1>, &Renderer::T_DrawNBG<1, 4, 0, 1, 2, 2>, &Renderer::T_DrawNBG<1, 4, 0, 1, 2, 3>,  },  },  },
+  {  {  { &Renderer::T_DrawNBG<1, 8, 0, 0, 0, 0>, &Renderer::T_DrawNBG<1, 8, 0, 0, 0, 1>, &Renderer::T_DrawNBG<1, 8, 0, 0, 0, 2>, &Renderer::T_DrawNBG<1, 8, 0, 0, 0, 3>,  },  { &Renderer::T_DrawNBG<1, 8, 0, 0, 1, 0>, &Renderer::T_DrawNBG<1, 8, 0, 0, 1, 1>, &Renderer::T_DrawNBG<1, 8, 0, 0, 1, 2>, &Renderer::T_DrawNBG<1, 8, 0, 0, 1, 3>,  },  { &Renderer::T_DrawNBG<1, 8, 0, 0, 2, 0>, &Renderer::T_DrawNBG<1, 8, 0, 0, 2, 1>, &Renderer::T_DrawNBG<1, 8, 0, 0, 2, 2>, &Renderer::T_DrawNBG<1, 8, 0, 0, 2, 3>,  },  },  {  { &Renderer::T_DrawNBG<1, 8, 0, 1, 0, 0>, &Renderer::T_DrawNBG<1, 8, 0, 1, 0, 1>, &Renderer::T_DrawNBG<1, 8, 0, 1, 0, 2>, &Renderer::T_DrawNBG<1, 8, 0, 1, 0, 3>,  },  { &Renderer::T_DrawNBG<1, 8, 0, 1, 1, 0>, &Renderer::T_DrawNBG<1, 8, 0, 1, 1, 1>, &Renderer::T_DrawNBG<1, 8, 0, 1, 1, 2>, &Renderer::T_DrawNBG<1, 8, 0, 1, 1, 3>,  },  { &Renderer::T_DrawNBG<1, 8, 0, 1, 2, 0>, &Renderer::T_DrawNBG<1, 8, 0, 1, 2, 1>, &Renderer::T_DrawNBG<1, 8, 0, 1, 2, 2>, &Renderer::T_DrawNBG<1, 8, 0, 1, 2, 3>,  },  },  },
+  {  {  { &Renderer::T_DrawNBG<1, 16, 0, 0, 0, 0>, &Renderer::T_DrawNBG<1, 16, 0, 0, 0, 1>, &Renderer::T_DrawNBG<1, 16, 0, 0, 0, 2>, &Renderer::T_DrawNBG<1, 16, 0, 0, 0, 3>,  },  { &Renderer::T_DrawNBG<1, 16, 0, 0, 1, 0>, &Renderer::T_DrawNBG<1, 16, 0, 0, 1, 1>, &Renderer::T_DrawNBG<1, 16, 0, 0, 1, 2>, &Renderer::T_DrawNBG<1, 16, 0, 0, 1, 3>,  },  { &Renderer::T_DrawNBG<1, 16, 0, 0, 2, 0>, &Renderer::T_DrawNBG<1, 16, 0, 0, 2, 1>, &Renderer::T_DrawNBG<1, 16, 0, 0, 2, 2>, &Renderer::T_DrawNBG<1, 16, 0, 0, 2, 3>,  },  },  {  { &Renderer::T_DrawNBG<1, 16, 0, 1, 0, 0>, &Renderer::T_DrawNBG<1, 16, 0, 1, 0, 1>, &Renderer::T_DrawNBG<1, 16, 0, 1, 0, 2>, &Renderer::T_DrawNBG<1, 16, 0, 1, 0, 3>,  },  { &Renderer::T_DrawNBG<1, 16, 0, 1, 1, 0>, &Renderer::T_DrawNBG<1, 16, 0, 1, 1, 1>, &Renderer::T_DrawNBG<1, 16, 0, 1, 1, 2>, &Renderer::T_DrawNBG<1, 16, 0, 1, 1, 3>,  },  { &Renderer::T_DrawNBG<1, 16, 0, 1, 2, 0>, &Renderer::T_DrawNBG<1, 16, 0, 1, 2, 1>, &Renderer::T_DrawNBG<1, 16, 0, 1, 2, 2>, &Renderer::T_DrawNBG<1, 16, 0, 1, 2, 3>,  },  },  },
+  {  {  { &Renderer::T_DrawNBG<1, 16, 1, 0, 0, 0>, &Renderer::T_DrawNBG<1, 16, 1, 0, 0, 1>, &Renderer::T_DrawNBG<1, 16, 1, 0, 0, 2>, &Renderer::T_DrawNBG<1, 16, 1, 0, 0, 3>,  },  { &Renderer::T_DrawNBG<1, 16, 1, 0, 1, 0>, &Renderer::T_DrawNBG<1, 16, 1, 0, 1, 1>, &Renderer::T_DrawNBG<1, 16, 1, 0, 1, 2>, &Renderer::T_DrawNBG<1, 16, 1, 0, 1, 3>,  },  { &Renderer::T_DrawNBG<1, 16, 1, 0, 2, 0>, &Renderer::T_DrawNBG<1, 16, 1, 0, 2, 1>, &Renderer::T_DrawNBG<1, 16, 1, 0, 2, 2>, &Renderer::T_DrawNBG<1, 16, 1, 0, 2, 3>,  },  },  {  { &Renderer::T_DrawNBG<1, 16, 1, 1, 0, 0>, &Renderer::T_DrawNBG<1, 16, 1, 1, 0, 1>, &Renderer::T_DrawNBG<1, 16, 1, 1, 0, 2>, &Renderer::T_DrawNBG<1, 16, 1, 1, 0, 3>,  },  { &Renderer::T_DrawNBG<1, 16, 1, 1, 1, 0>, &Renderer::T_DrawNBG<1, 16, 1, 1, 1, 1>, &Renderer::T_DrawNBG<1, 16, 1, 1, 1, 2>, &Renderer::T_DrawNBG<1, 16, 1, 1, 1, 3>,  },  { &Renderer::T_DrawNBG<1, 16, 1, 1, 2, 0>, &Renderer::T_DrawNBG<1, 16, 1, 1, 2, 1>, &Renderer::T_DrawNBG<1, 16, 1, 1, 2, 2>, &Renderer::T_DrawNBG<1, 16, 1, 1, 2, 3>,  },  },  },
+  {  {  { &Renderer::T_DrawNBG<1, 32, 1, 0, 0, 0>, &Renderer::T_DrawNBG<1, 32, 1, 0, 0, 1>, &Renderer::T_DrawNBG<1, 32, 1, 0, 0, 2>, &Renderer::T_DrawNBG<1, 32, 1, 0, 0, 3>,  },  { &Renderer::T_DrawNBG<1, 32, 1, 0, 1, 0>, &Renderer::T_DrawNBG<1, 32, 1, 0, 1, 1>, &Renderer::T_DrawNBG<1, 32, 1, 0, 1, 2>, &Renderer::T_DrawNBG<1, 32, 1, 0, 1, 3>,  },  { &Renderer::T_DrawNBG<1, 32, 1, 0, 2, 0>, &Renderer::T_DrawNBG<1, 32, 1, 0, 2, 1>, &Renderer::T_DrawNBG<1, 32, 1, 0, 2, 2>, &Renderer::T_DrawNBG<1, 32, 1, 0, 2, 3>,  },  },  {  { &Renderer::T_DrawNBG<1, 32, 1, 1, 0, 0>, &Renderer::T_DrawNBG<1, 32, 1, 1, 0, 1>, &Renderer::T_DrawNBG<1, 32, 1, 1, 0, 2>, &Renderer::T_DrawNBG<1, 32, 1, 1, 0, 3>,  },  { &Renderer::T_DrawNBG<1, 32, 1, 1, 1, 0>, &Renderer::T_DrawNBG<1, 32, 1, 1, 1, 1>, &Renderer::T_DrawNBG<1, 32, 1, 1, 1, 2>, &Renderer::T_DrawNBG<1, 32, 1, 1, 1, 3>,  },  { &Renderer::T_DrawNBG<1, 32, 1, 1, 2, 0>, &Renderer::T_DrawNBG<1, 32, 1, 1, 2, 1>, &Renderer::T_DrawNBG<1, 32, 1, 1, 2, 2>, &Renderer::T_DrawNBG<1, 32, 1, 1, 2, 3>,  },  },  },
  }
 };
 
 template<bool TA_igntp, unsigned TA_PrioMode, unsigned TA_CCMode>
-static INLINE uint64 MakeNBG23Pix(uint32 dcc, uint32 pbor, const int16* sfcode_lut, uint32 colcacheoffs)
+INLINE uint64 Renderer::MakeNBG23Pix(uint32 dcc, uint32 pbor, const int16* sfcode_lut, uint32 colcacheoffs)
 {
  uint32 rgb24;
 
@@ -1682,7 +1740,7 @@ static INLINE uint64 MakeNBG23Pix(uint32 dcc, uint32 pbor, const int16* sfcode_l
 // CCMode will be forced to 0 in the effective instantiation if corresponding NBG CCE bit in CCCTL is 0.
 //
 template<unsigned TA_bpp, bool TA_igntp, unsigned TA_PrioMode, unsigned TA_CCMode>
-static void T_DrawNBG23(const unsigned n, uint64* bgbuf, const unsigned w, const uint32 pix_base_or)
+void Renderer::T_DrawNBG23(const unsigned n, uint64* bgbuf, const unsigned w, const uint32 pix_base_or)
 {
  assert(n >= 2);
  TileFetcher<false> tf;
@@ -1700,7 +1758,7 @@ static void T_DrawNBG23(const unsigned n, uint64* bgbuf, const unsigned w, const
  tf.AuxMode = (PNCN[n] >> 14) & 1;
  tf.Supp = (PNCN[n] & 0x3FF); // Supplement bits when PNDSize == 1
  //
- tf.Start(n, false, (MPOFN >> (n << 2)) & 0x7, MapRegs[n]);
+ tf.Start(*this, n, false, (MPOFN >> (n << 2)) & 0x7, MapRegs[n]);
 
  MakeSFCodeLUT<TA_PrioMode, TA_CCMode>(n, sfcode_lut);
 
@@ -1744,7 +1802,7 @@ static void T_DrawNBG23(const unsigned n, uint64* bgbuf, const unsigned w, const
    pbor |= (tf.spr << PIX_PRIO_SHIFT);
   //
   //
-  auto* const mbp = MakeNBG23Pix<TA_igntp, TA_PrioMode, TA_CCMode>;
+  auto const mbp = [this](uint32 dcc, uint32 pb, const int16* lut, uint32 cco) { return MakeNBG23Pix<TA_igntp, TA_PrioMode, TA_CCMode>(dcc, pb, lut, cco); };
 
   if(TA_bpp == 8)
   {
@@ -1805,19 +1863,19 @@ static void T_DrawNBG23(const unsigned n, uint64* bgbuf, const unsigned w, const
  }
 }
 
-static void (*DrawNBG23[2/*col mode*/][2/*igntp*/][3/*priomode*/][4/*ccmode*/])(const unsigned n, uint64* bgbuf, const unsigned w, const uint32 pix_base_or) =
+static void (Renderer::*DrawNBG23[2/*col mode*/][2/*igntp*/][3/*priomode*/][4/*ccmode*/])(const unsigned n, uint64* bgbuf, const unsigned w, const uint32 pix_base_or) =
 {
  {
-  {    { T_DrawNBG23<4, 0, 0, 0>, T_DrawNBG23<4, 0, 0, 1>, T_DrawNBG23<4, 0, 0, 2>, T_DrawNBG23<4, 0, 0, 3>, },    { T_DrawNBG23<4, 0, 1, 0>, T_DrawNBG23<4, 0, 1, 1>, T_DrawNBG23<4, 0, 1, 2>, T_DrawNBG23<4, 0, 1, 3>, },    { T_DrawNBG23<4, 0, 2, 0>, T_DrawNBG23<4, 0, 2, 1>, T_DrawNBG23<4, 0, 2, 2>, T_DrawNBG23<4, 0, 2, 3>, }, },
-  {    { T_DrawNBG23<4, 1, 0, 0>, T_DrawNBG23<4, 1, 0, 1>, T_DrawNBG23<4, 1, 0, 2>, T_DrawNBG23<4, 1, 0, 3>, },    { T_DrawNBG23<4, 1, 1, 0>, T_DrawNBG23<4, 1, 1, 1>, T_DrawNBG23<4, 1, 1, 2>, T_DrawNBG23<4, 1, 1, 3>, },    { T_DrawNBG23<4, 1, 2, 0>, T_DrawNBG23<4, 1, 2, 1>, T_DrawNBG23<4, 1, 2, 2>, T_DrawNBG23<4, 1, 2, 3>, }, },
+  {    { &Renderer::T_DrawNBG23<4, 0, 0, 0>, &Renderer::T_DrawNBG23<4, 0, 0, 1>, &Renderer::T_DrawNBG23<4, 0, 0, 2>, &Renderer::T_DrawNBG23<4, 0, 0, 3>, },    { &Renderer::T_DrawNBG23<4, 0, 1, 0>, &Renderer::T_DrawNBG23<4, 0, 1, 1>, &Renderer::T_DrawNBG23<4, 0, 1, 2>, &Renderer::T_DrawNBG23<4, 0, 1, 3>, },    { &Renderer::T_DrawNBG23<4, 0, 2, 0>, &Renderer::T_DrawNBG23<4, 0, 2, 1>, &Renderer::T_DrawNBG23<4, 0, 2, 2>, &Renderer::T_DrawNBG23<4, 0, 2, 3>, }, },
+  {    { &Renderer::T_DrawNBG23<4, 1, 0, 0>, &Renderer::T_DrawNBG23<4, 1, 0, 1>, &Renderer::T_DrawNBG23<4, 1, 0, 2>, &Renderer::T_DrawNBG23<4, 1, 0, 3>, },    { &Renderer::T_DrawNBG23<4, 1, 1, 0>, &Renderer::T_DrawNBG23<4, 1, 1, 1>, &Renderer::T_DrawNBG23<4, 1, 1, 2>, &Renderer::T_DrawNBG23<4, 1, 1, 3>, },    { &Renderer::T_DrawNBG23<4, 1, 2, 0>, &Renderer::T_DrawNBG23<4, 1, 2, 1>, &Renderer::T_DrawNBG23<4, 1, 2, 2>, &Renderer::T_DrawNBG23<4, 1, 2, 3>, }, },
  },
  {
-  {    { T_DrawNBG23<8, 0, 0, 0>, T_DrawNBG23<8, 0, 0, 1>, T_DrawNBG23<8, 0, 0, 2>, T_DrawNBG23<8, 0, 0, 3>, },    { T_DrawNBG23<8, 0, 1, 0>, T_DrawNBG23<8, 0, 1, 1>, T_DrawNBG23<8, 0, 1, 2>, T_DrawNBG23<8, 0, 1, 3>, },    { T_DrawNBG23<8, 0, 2, 0>, T_DrawNBG23<8, 0, 2, 1>, T_DrawNBG23<8, 0, 2, 2>, T_DrawNBG23<8, 0, 2, 3>, }, },
-  {    { T_DrawNBG23<8, 1, 0, 0>, T_DrawNBG23<8, 1, 0, 1>, T_DrawNBG23<8, 1, 0, 2>, T_DrawNBG23<8, 1, 0, 3>, },    { T_DrawNBG23<8, 1, 1, 0>, T_DrawNBG23<8, 1, 1, 1>, T_DrawNBG23<8, 1, 1, 2>, T_DrawNBG23<8, 1, 1, 3>, },    { T_DrawNBG23<8, 1, 2, 0>, T_DrawNBG23<8, 1, 2, 1>, T_DrawNBG23<8, 1, 2, 2>, T_DrawNBG23<8, 1, 2, 3>, }, },
+  {    { &Renderer::T_DrawNBG23<8, 0, 0, 0>, &Renderer::T_DrawNBG23<8, 0, 0, 1>, &Renderer::T_DrawNBG23<8, 0, 0, 2>, &Renderer::T_DrawNBG23<8, 0, 0, 3>, },    { &Renderer::T_DrawNBG23<8, 0, 1, 0>, &Renderer::T_DrawNBG23<8, 0, 1, 1>, &Renderer::T_DrawNBG23<8, 0, 1, 2>, &Renderer::T_DrawNBG23<8, 0, 1, 3>, },    { &Renderer::T_DrawNBG23<8, 0, 2, 0>, &Renderer::T_DrawNBG23<8, 0, 2, 1>, &Renderer::T_DrawNBG23<8, 0, 2, 2>, &Renderer::T_DrawNBG23<8, 0, 2, 3>, }, },
+  {    { &Renderer::T_DrawNBG23<8, 1, 0, 0>, &Renderer::T_DrawNBG23<8, 1, 0, 1>, &Renderer::T_DrawNBG23<8, 1, 0, 2>, &Renderer::T_DrawNBG23<8, 1, 0, 3>, },    { &Renderer::T_DrawNBG23<8, 1, 1, 0>, &Renderer::T_DrawNBG23<8, 1, 1, 1>, &Renderer::T_DrawNBG23<8, 1, 1, 2>, &Renderer::T_DrawNBG23<8, 1, 1, 3>, },    { &Renderer::T_DrawNBG23<8, 1, 2, 0>, &Renderer::T_DrawNBG23<8, 1, 2, 1>, &Renderer::T_DrawNBG23<8, 1, 2, 2>, &Renderer::T_DrawNBG23<8, 1, 2, 3>, }, },
  },
 };
 
-static INLINE uint32 GetCoeffAddr(const unsigned i, uint32 offset)
+INLINE uint32 Renderer::GetCoeffAddr(const unsigned i, uint32 offset)
 {
  const uint32 src_mask = (CRKTE ? 0x3FF : 0x3FFFF);
 
@@ -1828,7 +1886,7 @@ static INLINE uint32 GetCoeffAddr(const unsigned i, uint32 offset)
  return offset;
 }
 
-static INLINE uint32 ReadCoeff(const unsigned i, const uint32 addr)
+INLINE uint32 Renderer::ReadCoeff(const unsigned i, const uint32 addr)
 {
  const uint16* src = (CRKTE ? &CRAM[0x400] : VRAM);
  uint32 coeff;
@@ -1857,14 +1915,15 @@ static INLINE uint32 ReadCoeff(const unsigned i, const uint32 addr)
 // RBG1 requires RPMD == 0, or else bad things happen?
 
 template<typename T>
-static void SetupRotVars(const T* rs, const unsigned rbg_w)
+INLINE void Renderer::SetupRotVars(const T* rs, const unsigned rbg_w)
 {
  const uint8 EffRPMD = ((BGON & 0x20) ? 0 : RPMD);
 
  if(EffRPMD < 2)
  {
+  // "& 1" so that RPMD == 2 or 3 with RBG1 enabled doesn't index past the end of LB.rotv[].
   for(unsigned x = 0; MDFN_LIKELY(x < rbg_w); x++)
-   LB.rotabsel[x] = RPMD;
+   LB.rotabsel[x] = RPMD & 1;
  }
  else if(EffRPMD == 3)
   GetWinRotAB();
@@ -1916,7 +1975,7 @@ static void SetupRotVars(const T* rs, const unsigned rbg_w)
   LB.rotv[i].tf.PlaneSize = (PLSZ >> ( 8 + (i << 2))) & 0x3;
   LB.rotv[i].tf.PlaneOver = (PLSZ >> (10 + (i << 2))) & 0x3;
   LB.rotv[i].tf.PlaneOverChar = OVPNR[i];
-  LB.rotv[i].tf.Start(4 + i, !i && ((CHCTLB >> 9) & 1), (MPOFR >> (i << 2)) & 0x7, RotMapRegs[i]);
+  LB.rotv[i].tf.Start(*this, 4 + i, !i && ((CHCTLB >> 9) & 1), (MPOFR >> (i << 2)) & 0x7, RotMapRegs[i]);
  }
 
  //
@@ -2008,7 +2067,7 @@ static void SetupRotVars(const T* rs, const unsigned rbg_w)
 
 // const bool TA_bmen = ((rn == 1) ? false : ((CHCTLB >> 9) & 1));
 template<bool TA_bmen, unsigned TA_bpp, bool TA_isrgb, bool TA_igntp, unsigned TA_PrioMode, unsigned TA_CCMode>
-static void T_DrawRBG(const bool rn, uint64* bgbuf, const unsigned w, const uint32 pix_base_or)
+void Renderer::T_DrawRBG(const bool rn, uint64* bgbuf, const unsigned w, const uint32 pix_base_or)
 {
  // Full color format selection for both RBG0 and RBG1
  // Bitmap only allowed for RBG0
@@ -2062,21 +2121,21 @@ static void T_DrawRBG(const bool rn, uint64* bgbuf, const unsigned w, const uint
 }
 
 //template<unsigned TA_bpp, bool TA_isrgb, bool TA_igntp, unsigned TA_PrioMode, unsigned TA_CCMode>
-static void (*DrawRBG[2 /*bitmap enable*/][5/*col mode*/][2/*igntp*/][3/*priomode*/][4/*ccmode*/])(const bool rn, uint64* bgbuf, const unsigned w, const uint32 pix_base_or) =
+static void (Renderer::*DrawRBG[2 /*bitmap enable*/][5/*col mode*/][2/*igntp*/][3/*priomode*/][4/*ccmode*/])(const bool rn, uint64* bgbuf, const unsigned w, const uint32 pix_base_or) =
 {
  {
-  {  {  { T_DrawRBG<0, 4, 0, 0, 0, 0>, T_DrawRBG<0, 4, 0, 0, 0, 1>, T_DrawRBG<0, 4, 0, 0, 0, 2>, T_DrawRBG<0, 4, 0, 0, 0, 3>,  },  { T_DrawRBG<0, 4, 0, 0, 1, 0>, T_DrawRBG<0, 4, 0, 0, 1, 1>, T_DrawRBG<0, 4, 0, 0, 1, 2>, T_DrawRBG<0, 4, 0, 0, 1, 3>,  },  { T_DrawRBG<0, 4, 0, 0, 2, 0>, T_DrawRBG<0, 4, 0, 0, 2, 1>, T_DrawRBG<0, 4, 0, 0, 2, 2>, T_DrawRBG<0, 4, 0, 0, 2, 3>,  },  },  {  { T_DrawRBG<0, 4, 0, 1, 0, 0>, T_DrawRBG<0, 4, 0, 1, 0, 1>, T_DrawRBG<0, 4, 0, 1, 0, 2>, T_DrawRBG<0, 4, 0, 1, 0, 3>,  },  { T_DrawRBG<0, 4, 0, 1, 1, 0>, T_DrawRBG<0, 4, 0, 1, 1, 1>, T_DrawRBG<0, 4, 0, 1, 1, 2>, T_DrawRBG<0, 4, 0, 1, 1, 3>,  },  { T_DrawRBG<0, 4, 0, 1, 2, 0>, T_DrawRBG<0, 4, 0, 1, 2, 1>, T_DrawRBG<0, 4, 0, 1, 2, 2>, T_DrawRBG<0, 4, 0, 1, 2, 3>,  },  },  },
-  {  {  { T_DrawRBG<0, 8, 0, 0, 0, 0>, T_DrawRBG<0, 8, 0, 0, 0, 1>, T_DrawRBG<0, 8, 0, 0, 0, 2>, T_DrawRBG<0, 8, 0, 0, 0, 3>,  },  { T_DrawRBG<0, 8, 0, 0, 1, 0>, T_DrawRBG<0, 8, 0, 0, 1, 1>, T_DrawRBG<0, 8, 0, 0, 1, 2>, T_DrawRBG<0, 8, 0, 0, 1, 3>,  },  { T_DrawRBG<0, 8, 0, 0, 2, 0>, T_DrawRBG<0, 8, 0, 0, 2, 1>, T_DrawRBG<0, 8, 0, 0, 2, 2>, T_DrawRBG<0, 8, 0, 0, 2, 3>,  },  },  {  { T_DrawRBG<0, 8, 0, 1, 0, 0>, T_DrawRBG<0, 8, 0, 1, 0, 1>, T_DrawRBG<0, 8, 0, 1, 0, 2>, T_DrawRBG<0, 8, 0, 1, 0, 3>,  },  { T_DrawRBG<0, 8, 0, 1, 1, 0>, T_DrawRBG<0, 8, 0, 1, 1, 1>, T_DrawRBG<0, 8, 0, 1, 1, 2>, T_DrawRBG<0, 8, 0, 1, 1, 3>,  },  { T_DrawRBG<0, 8, 0, 1, 2, 0>, T_DrawRBG<0, 8, 0, 1, 2, 1>, T_DrawRBG<0, 8, 0, 1, 2, 2>, T_DrawRBG<0, 8, 0, 1, 2, 3>,  },  },  },
-  {  {  { T_DrawRBG<0, 16, 0, 0, 0, 0>, T_DrawRBG<0, 16, 0, 0, 0, 1>, T_DrawRBG<0, 16, 0, 0, 0, 2>, T_DrawRBG<0, 16, 0, 0, 0, 3>,  },  { T_DrawRBG<0, 16, 0, 0, 1, 0>, T_DrawRBG<0, 16, 0, 0, 1, 1>, T_DrawRBG<0, 16, 0, 0, 1, 2>, T_DrawRBG<0, 16, 0, 0, 1, 3>,  },  { T_DrawRBG<0, 16, 0, 0, 2, 0>, T_DrawRBG<0, 16, 0, 0, 2, 1>, T_DrawRBG<0, 16, 0, 0, 2, 2>, T_DrawRBG<0, 16, 0, 0, 2, 3>,  },  },  {  { T_DrawRBG<0, 16, 0, 1, 0, 0>, T_DrawRBG<0, 16, 0, 1, 0, 1>, T_DrawRBG<0, 16, 0, 1, 0, 2>, T_DrawRBG<0, 16, 0, 1, 0, 3>,  },  { T_DrawRBG<0, 16, 0, 1, 1, 0>, T_DrawRBG<0, 16, 0, 1, 1, 1>, T_DrawRBG<0, 16, 0, 1, 1, 2>, T_DrawRBG<0, 16, 0, 1, 1, 3>,  },  { T_DrawRBG<0, 16, 0, 1, 2, 0>, T_DrawRBG<0, 16, 0, 1, 2, 1>, T_DrawRBG<0, 16, 0, 1, 2, 2>, T_DrawRBG<0, 16, 0, 1, 2, 3>,  },  },  },
-  {  {  { T_DrawRBG<0, 16, 1, 0, 0, 0>, T_DrawRBG<0, 16, 1, 0, 0, 1>, T_DrawRBG<0, 16, 1, 0, 0, 2>, T_DrawRBG<0, 16, 1, 0, 0, 3>,  },  { T_DrawRBG<0, 16, 1, 0, 1, 0>, T_DrawRBG<0, 16, 1, 0, 1, 1>, T_DrawRBG<0, 16, 1, 0, 1, 2>, T_DrawRBG<0, 16, 1, 0, 1, 3>,  },  { T_DrawRBG<0, 16, 1, 0, 2, 0>, T_DrawRBG<0, 16, 1, 0, 2, 1>, T_DrawRBG<0, 16, 1, 0, 2, 2>, T_DrawRBG<0, 16, 1, 0, 2, 3>,  },  },  {  { T_DrawRBG<0, 16, 1, 1, 0, 0>, T_DrawRBG<0, 16, 1, 1, 0, 1>, T_DrawRBG<0, 16, 1, 1, 0, 2>, T_DrawRBG<0, 16, 1, 1, 0, 3>,  },  { T_DrawRBG<0, 16, 1, 1, 1, 0>, T_DrawRBG<0, 16, 1, 1, 1, 1>, T_DrawRBG<0, 16, 1, 1, 1, 2>, T_DrawRBG<0, 16, 1, 1, 1, 3>,  },  { T_DrawRBG<0, 16, 1, 1, 2, 0>, T_DrawRBG<0, 16, 1, 1, 2, 1>, T_DrawRBG<0, 16, 1, 1, 2, 2>, T_DrawRBG<0, 16, 1, 1, 2, 3>,  },  },  },
-  {  {  { T_DrawRBG<0, 32, 1, 0, 0, 0>, T_DrawRBG<0, 32, 1, 0, 0, 1>, T_DrawRBG<0, 32, 1, 0, 0, 2>, T_DrawRBG<0, 32, 1, 0, 0, 3>,  },  { T_DrawRBG<0, 32, 1, 0, 1, 0>, T_DrawRBG<0, 32, 1, 0, 1, 1>, T_DrawRBG<0, 32, 1, 0, 1, 2>, T_DrawRBG<0, 32, 1, 0, 1, 3>,  },  { T_DrawRBG<0, 32, 1, 0, 2, 0>, T_DrawRBG<0, 32, 1, 0, 2, 1>, T_DrawRBG<0, 32, 1, 0, 2, 2>, T_DrawRBG<0, 32, 1, 0, 2, 3>,  },  },  {  { T_DrawRBG<0, 32, 1, 1, 0, 0>, T_DrawRBG<0, 32, 1, 1, 0, 1>, T_DrawRBG<0, 32, 1, 1, 0, 2>, T_DrawRBG<0, 32, 1, 1, 0, 3>,  },  { T_DrawRBG<0, 32, 1, 1, 1, 0>, T_DrawRBG<0, 32, 1, 1, 1, 1>, T_DrawRBG<0, 32, 1, 1, 1, 2>, T_DrawRBG<0, 32, 1, 1, 1, 3>,  },  { T_DrawRBG<0, 32, 1, 1, 2, 0>, T_DrawRBG<0, 32, 1, 1, 2, 1>, T_DrawRBG<0, 32, 1, 1, 2, 2>, T_DrawRBG<0, 32, 1, 1, 2, 3>,  },  },  },
+  {  {  { &Renderer::T_DrawRBG<0, 4, 0, 0, 0, 0>, &Renderer::T_DrawRBG<0, 4, 0, 0, 0, 1>, &Renderer::T_DrawRBG<0, 4, 0, 0, 0, 2>, &Renderer::T_DrawRBG<0, 4, 0, 0, 0, 3>,  },  { &Renderer::T_DrawRBG<0, 4, 0, 0, 1, 0>, &Renderer::T_DrawRBG<0, 4, 0, 0, 1, 1>, &Renderer::T_DrawRBG<0, 4, 0, 0, 1, 2>, &Renderer::T_DrawRBG<0, 4, 0, 0, 1, 3>,  },  { &Renderer::T_DrawRBG<0, 4, 0, 0, 2, 0>, &Renderer::T_DrawRBG<0, 4, 0, 0, 2, 1>, &Renderer::T_DrawRBG<0, 4, 0, 0, 2, 2>, &Renderer::T_DrawRBG<0, 4, 0, 0, 2, 3>,  },  },  {  { &Renderer::T_DrawRBG<0, 4, 0, 1, 0, 0>, &Renderer::T_DrawRBG<0, 4, 0, 1, 0, 1>, &Renderer::T_DrawRBG<0, 4, 0, 1, 0, 2>, &Renderer::T_DrawRBG<0, 4, 0, 1, 0, 3>,  },  { &Renderer::T_DrawRBG<0, 4, 0, 1, 1, 0>, &Renderer::T_DrawRBG<0, 4, 0, 1, 1, 1>, &Renderer::T_DrawRBG<0, 4, 0, 1, 1, 2>, &Renderer::T_DrawRBG<0, 4, 0, 1, 1, 3>,  },  { &Renderer::T_DrawRBG<0, 4, 0, 1, 2, 0>, &Renderer::T_DrawRBG<0, 4, 0, 1, 2, 1>, &Renderer::T_DrawRBG<0, 4, 0, 1, 2, 2>, &Renderer::T_DrawRBG<0, 4, 0, 1, 2, 3>,  },  },  },
+  {  {  { &Renderer::T_DrawRBG<0, 8, 0, 0, 0, 0>, &Renderer::T_DrawRBG<0, 8, 0, 0, 0, 1>, &Renderer::T_DrawRBG<0, 8, 0, 0, 0, 2>, &Renderer::T_DrawRBG<0, 8, 0, 0, 0, 3>,  },  { &Renderer::T_DrawRBG<0, 8, 0, 0, 1, 0>, &Renderer::T_DrawRBG<0, 8, 0, 0, 1, 1>, &Renderer::T_DrawRBG<0, 8, 0, 0, 1, 2>, &Renderer::T_DrawRBG<0, 8, 0, 0, 1, 3>,  },  { &Renderer::T_DrawRBG<0, 8, 0, 0, 2, 0>, &Renderer::T_DrawRBG<0, 8, 0, 0, 2, 1>, &Renderer::T_DrawRBG<0, 8, 0, 0, 2, 2>, &Renderer::T_DrawRBG<0, 8, 0, 0, 2, 3>,  },  },  {  { &Renderer::T_DrawRBG<0, 8, 0, 1, 0, 0>, &Renderer::T_DrawRBG<0, 8, 0, 1, 0, 1>, &Renderer::T_DrawRBG<0, 8, 0, 1, 0, 2>, &Renderer::T_DrawRBG<0, 8, 0, 1, 0, 3>,  },  { &Renderer::T_DrawRBG<0, 8, 0, 1, 1, 0>, &Renderer::T_DrawRBG<0, 8, 0, 1, 1, 1>, &Renderer::T_DrawRBG<0, 8, 0, 1, 1, 2>, &Renderer::T_DrawRBG<0, 8, 0, 1, 1, 3>,  },  { &Renderer::T_DrawRBG<0, 8, 0, 1, 2, 0>, &Renderer::T_DrawRBG<0, 8, 0, 1, 2, 1>, &Renderer::T_DrawRBG<0, 8, 0, 1, 2, 2>, &Renderer::T_DrawRBG<0, 8, 0, 1, 2, 3>,  },  },  },
+  {  {  { &Renderer::T_DrawRBG<0, 16, 0, 0, 0, 0>, &Renderer::T_DrawRBG<0, 16, 0, 0, 0, 1>, &Renderer::T_DrawRBG<0, 16, 0, 0, 0, 2>, &Renderer::T_DrawRBG<0, 16, 0, 0, 0, 3>,  },  { &Renderer::T_DrawRBG<0, 16, 0, 0, 1, 0>, &Renderer::T_DrawRBG<0, 16, 0, 0, 1, 1>, &Renderer::T_DrawRBG<0, 16, 0, 0, 1, 2>, &Renderer::T_DrawRBG<0, 16, 0, 0, 1, 3>,  },  { &Renderer::T_DrawRBG<0, 16, 0, 0, 2, 0>, &Renderer::T_DrawRBG<0, 16, 0, 0, 2, 1>, &Renderer::T_DrawRBG<0, 16, 0, 0, 2, 2>, &Renderer::T_DrawRBG<0, 16, 0, 0, 2, 3>,  },  },  {  { &Renderer::T_DrawRBG<0, 16, 0, 1, 0, 0>, &Renderer::T_DrawRBG<0, 16, 0, 1, 0, 1>, &Renderer::T_DrawRBG<0, 16, 0, 1, 0, 2>, &Renderer::T_DrawRBG<0, 16, 0, 1, 0, 3>,  },  { &Renderer::T_DrawRBG<0, 16, 0, 1, 1, 0>, &Renderer::T_DrawRBG<0, 16, 0, 1, 1, 1>, &Renderer::T_DrawRBG<0, 16, 0, 1, 1, 2>, &Renderer::T_DrawRBG<0, 16, 0, 1, 1, 3>,  },  { &Renderer::T_DrawRBG<0, 16, 0, 1, 2, 0>, &Renderer::T_DrawRBG<0, 16, 0, 1, 2, 1>, &Renderer::T_DrawRBG<0, 16, 0, 1, 2, 2>, &Renderer::T_DrawRBG<0, 16, 0, 1, 2, 3>,  },  },  },
+  {  {  { &Renderer::T_DrawRBG<0, 16, 1, 0, 0, 0>, &Renderer::T_DrawRBG<0, 16, 1, 0, 0, 1>, &Renderer::T_DrawRBG<0, 16, 1, 0, 0, 2>, &Renderer::T_DrawRBG<0, 16, 1, 0, 0, 3>,  },  { &Renderer::T_DrawRBG<0, 16, 1, 0, 1, 0>, &Renderer::T_DrawRBG<0, 16, 1, 0, 1, 1>, &Renderer::T_DrawRBG<0, 16, 1, 0, 1, 2>, &Renderer::T_DrawRBG<0, 16, 1, 0, 1, 3>,  },  { &Renderer::T_DrawRBG<0, 16, 1, 0, 2, 0>, &Renderer::T_DrawRBG<0, 16, 1, 0, 2, 1>, &Renderer::T_DrawRBG<0, 16, 1, 0, 2, 2>, &Renderer::T_DrawRBG<0, 16, 1, 0, 2, 3>,  },  },  {  { &Renderer::T_DrawRBG<0, 16, 1, 1, 0, 0>, &Renderer::T_DrawRBG<0, 16, 1, 1, 0, 1>, &Renderer::T_DrawRBG<0, 16, 1, 1, 0, 2>, &Renderer::T_DrawRBG<0, 16, 1, 1, 0, 3>,  },  { &Renderer::T_DrawRBG<0, 16, 1, 1, 1, 0>, &Renderer::T_DrawRBG<0, 16, 1, 1, 1, 1>, &Renderer::T_DrawRBG<0, 16, 1, 1, 1, 2>, &Renderer::T_DrawRBG<0, 16, 1, 1, 1, 3>,  },  { &Renderer::T_DrawRBG<0, 16, 1, 1, 2, 0>, &Renderer::T_DrawRBG<0, 16, 1, 1, 2, 1>, &Renderer::T_DrawRBG<0, 16, 1, 1, 2, 2>, &Renderer::T_DrawRBG<0, 16, 1, 1, 2, 3>,  },  },  },
+  {  {  { &Renderer::T_DrawRBG<0, 32, 1, 0, 0, 0>, &Renderer::T_DrawRBG<0, 32, 1, 0, 0, 1>, &Renderer::T_DrawRBG<0, 32, 1, 0, 0, 2>, &Renderer::T_DrawRBG<0, 32, 1, 0, 0, 3>,  },  { &Renderer::T_DrawRBG<0, 32, 1, 0, 1, 0>, &Renderer::T_DrawRBG<0, 32, 1, 0, 1, 1>, &Renderer::T_DrawRBG<0, 32, 1, 0, 1, 2>, &Renderer::T_DrawRBG<0, 32, 1, 0, 1, 3>,  },  { &Renderer::T_DrawRBG<0, 32, 1, 0, 2, 0>, &Renderer::T_DrawRBG<0, 32, 1, 0, 2, 1>, &Renderer::T_DrawRBG<0, 32, 1, 0, 2, 2>, &Renderer::T_DrawRBG<0, 32, 1, 0, 2, 3>,  },  },  {  { &Renderer::T_DrawRBG<0, 32, 1, 1, 0, 0>, &Renderer::T_DrawRBG<0, 32, 1, 1, 0, 1>, &Renderer::T_DrawRBG<0, 32, 1, 1, 0, 2>, &Renderer::T_DrawRBG<0, 32, 1, 1, 0, 3>,  },  { &Renderer::T_DrawRBG<0, 32, 1, 1, 1, 0>, &Renderer::T_DrawRBG<0, 32, 1, 1, 1, 1>, &Renderer::T_DrawRBG<0, 32, 1, 1, 1, 2>, &Renderer::T_DrawRBG<0, 32, 1, 1, 1, 3>,  },  { &Renderer::T_DrawRBG<0, 32, 1, 1, 2, 0>, &Renderer::T_DrawRBG<0, 32, 1, 1, 2, 1>, &Renderer::T_DrawRBG<0, 32, 1, 1, 2, 2>, &Renderer::T_DrawRBG<0, 32, 1, 1, 2, 3>,  },  },  },
  },
  {
-  {  {  { T_DrawRBG<1, 4, 0, 0, 0, 0>, T_DrawRBG<1, 4, 0, 0, 0, 1>, T_DrawRBG<1, 4, 0, 0, 0, 2>, T_DrawRBG<1, 4, 0, 0, 0, 3>,  },  { T_DrawRBG<1, 4, 0, 0, 1, 0>, T_DrawRBG<1, 4, 0, 0, 1, 1>, T_DrawRBG<1, 4, 0, 0, 1, 2>, T_DrawRBG<1, 4, 0, 0, 1, 3>,  },  { T_DrawRBG<1, 4, 0, 0, 2, 0>, T_DrawRBG<1, 4, 0, 0, 2, 1>, T_DrawRBG<1, 4, 0, 0, 2, 2>, T_DrawRBG<1, 4, 0, 0, 2, 3>,  },  },  {  { T_DrawRBG<1, 4, 0, 1, 0, 0>, T_DrawRBG<1, 4, 0, 1, 0, 1>, T_DrawRBG<1, 4, 0, 1, 0, 2>, T_DrawRBG<1, 4, 0, 1, 0, 3>,  },  { T_DrawRBG<1, 4, 0, 1, 1, 0>, T_DrawRBG<1, 4, 0, 1, 1, 1>, T_DrawRBG<1, 4, 0, 1, 1, 2>, T_DrawRBG<1, 4, 0, 1, 1, 3>,  },  { T_DrawRBG<1, 4, 0, 1, 2, 0>, T_DrawRBG<1, 4, 0, 1, 2, 1>, T_DrawRBG<1, 4, 0, 1, 2, 2>, T_DrawRBG<1, 4, 0, 1, 2, 3>,  },  },  },
-  {  {  { T_DrawRBG<1, 8, 0, 0, 0, 0>, T_DrawRBG<1, 8, 0, 0, 0, 1>, T_DrawRBG<1, 8, 0, 0, 0, 2>, T_DrawRBG<1, 8, 0, 0, 0, 3>,  },  { T_DrawRBG<1, 8, 0, 0, 1, 0>, T_DrawRBG<1, 8, 0, 0, 1, 1>, T_DrawRBG<1, 8, 0, 0, 1, 2>, T_DrawRBG<1, 8, 0, 0, 1, 3>,  },  { T_DrawRBG<1, 8, 0, 0, 2, 0>, T_DrawRBG<1, 8, 0, 0, 2, 1>, T_DrawRBG<1, 8, 0, 0, 2, 2>, T_DrawRBG<1, 8, 0, 0, 2, 3>,  },  },  {  { T_DrawRBG<1, 8, 0, 1, 0, 0>, T_DrawRBG<1, 8, 0, 1, 0, 1>, T_DrawRBG<1, 8, 0, 1, 0, 2>, T_DrawRBG<1, 8, 0, 1, 0, 3>,  },  { T_DrawRBG<1, 8, 0, 1, 1, 0>, T_DrawRBG<1, 8, 0, 1, 1, 1>, T_DrawRBG<1, 8, 0, 1, 1, 2>, T_DrawRBG<1, 8, 0, 1, 1, 3>,  },  { T_DrawRBG<1, 8, 0, 1, 2, 0>, T_DrawRBG<1, 8, 0, 1, 2, 1>, T_DrawRBG<1, 8, 0, 1, 2, 2>, T_DrawRBG<1, 8, 0, 1, 2, 3>,  },  },  },
-  {  {  { T_DrawRBG<1, 16, 0, 0, 0, 0>, T_DrawRBG<1, 16, 0, 0, 0, 1>, T_DrawRBG<1, 16, 0, 0, 0, 2>, T_DrawRBG<1, 16, 0, 0, 0, 3>,  },  { T_DrawRBG<1, 16, 0, 0, 1, 0>, T_DrawRBG<1, 16, 0, 0, 1, 1>, T_DrawRBG<1, 16, 0, 0, 1, 2>, T_DrawRBG<1, 16, 0, 0, 1, 3>,  },  { T_DrawRBG<1, 16, 0, 0, 2, 0>, T_DrawRBG<1, 16, 0, 0, 2, 1>, T_DrawRBG<1, 16, 0, 0, 2, 2>, T_DrawRBG<1, 16, 0, 0, 2, 3>,  },  },  {  { T_DrawRBG<1, 16, 0, 1, 0, 0>, T_DrawRBG<1, 16, 0, 1, 0, 1>, T_DrawRBG<1, 16, 0, 1, 0, 2>, T_DrawRBG<1, 16, 0, 1, 0, 3>,  },  { T_DrawRBG<1, 16, 0, 1, 1, 0>, T_DrawRBG<1, 16, 0, 1, 1, 1>, T_DrawRBG<1, 16, 0, 1, 1, 2>, T_DrawRBG<1, 16, 0, 1, 1, 3>,  },  { T_DrawRBG<1, 16, 0, 1, 2, 0>, T_DrawRBG<1, 16, 0, 1, 2, 1>, T_DrawRBG<1, 16, 0, 1, 2, 2>, T_DrawRBG<1, 16, 0, 1, 2, 3>,  },  },  },
-  {  {  { T_DrawRBG<1, 16, 1, 0, 0, 0>, T_DrawRBG<1, 16, 1, 0, 0, 1>, T_DrawRBG<1, 16, 1, 0, 0, 2>, T_DrawRBG<1, 16, 1, 0, 0, 3>,  },  { T_DrawRBG<1, 16, 1, 0, 1, 0>, T_DrawRBG<1, 16, 1, 0, 1, 1>, T_DrawRBG<1, 16, 1, 0, 1, 2>, T_DrawRBG<1, 16, 1, 0, 1, 3>,  },  { T_DrawRBG<1, 16, 1, 0, 2, 0>, T_DrawRBG<1, 16, 1, 0, 2, 1>, T_DrawRBG<1, 16, 1, 0, 2, 2>, T_DrawRBG<1, 16, 1, 0, 2, 3>,  },  },  {  { T_DrawRBG<1, 16, 1, 1, 0, 0>, T_DrawRBG<1, 16, 1, 1, 0, 1>, T_DrawRBG<1, 16, 1, 1, 0, 2>, T_DrawRBG<1, 16, 1, 1, 0, 3>,  },  { T_DrawRBG<1, 16, 1, 1, 1, 0>, T_DrawRBG<1, 16, 1, 1, 1, 1>, T_DrawRBG<1, 16, 1, 1, 1, 2>, T_DrawRBG<1, 16, 1, 1, 1, 3>,  },  { T_DrawRBG<1, 16, 1, 1, 2, 0>, T_DrawRBG<1, 16, 1, 1, 2, 1>, T_DrawRBG<1, 16, 1, 1, 2, 2>, T_DrawRBG<1, 16, 1, 1, 2, 3>,  },  },  },
-  {  {  { T_DrawRBG<1, 32, 1, 0, 0, 0>, T_DrawRBG<1, 32, 1, 0, 0, 1>, T_DrawRBG<1, 32, 1, 0, 0, 2>, T_DrawRBG<1, 32, 1, 0, 0, 3>,  },  { T_DrawRBG<1, 32, 1, 0, 1, 0>, T_DrawRBG<1, 32, 1, 0, 1, 1>, T_DrawRBG<1, 32, 1, 0, 1, 2>, T_DrawRBG<1, 32, 1, 0, 1, 3>,  },  { T_DrawRBG<1, 32, 1, 0, 2, 0>, T_DrawRBG<1, 32, 1, 0, 2, 1>, T_DrawRBG<1, 32, 1, 0, 2, 2>, T_DrawRBG<1, 32, 1, 0, 2, 3>,  },  },  {  { T_DrawRBG<1, 32, 1, 1, 0, 0>, T_DrawRBG<1, 32, 1, 1, 0, 1>, T_DrawRBG<1, 32, 1, 1, 0, 2>, T_DrawRBG<1, 32, 1, 1, 0, 3>,  },  { T_DrawRBG<1, 32, 1, 1, 1, 0>, T_DrawRBG<1, 32, 1, 1, 1, 1>, T_DrawRBG<1, 32, 1, 1, 1, 2>, T_DrawRBG<1, 32, 1, 1, 1, 3>,  },  { T_DrawRBG<1, 32, 1, 1, 2, 0>, T_DrawRBG<1, 32, 1, 1, 2, 1>, T_DrawRBG<1, 32, 1, 1, 2, 2>, T_DrawRBG<1, 32, 1, 1, 2, 3>,  },  },  },
+  {  {  { &Renderer::T_DrawRBG<1, 4, 0, 0, 0, 0>, &Renderer::T_DrawRBG<1, 4, 0, 0, 0, 1>, &Renderer::T_DrawRBG<1, 4, 0, 0, 0, 2>, &Renderer::T_DrawRBG<1, 4, 0, 0, 0, 3>,  },  { &Renderer::T_DrawRBG<1, 4, 0, 0, 1, 0>, &Renderer::T_DrawRBG<1, 4, 0, 0, 1, 1>, &Renderer::T_DrawRBG<1, 4, 0, 0, 1, 2>, &Renderer::T_DrawRBG<1, 4, 0, 0, 1, 3>,  },  { &Renderer::T_DrawRBG<1, 4, 0, 0, 2, 0>, &Renderer::T_DrawRBG<1, 4, 0, 0, 2, 1>, &Renderer::T_DrawRBG<1, 4, 0, 0, 2, 2>, &Renderer::T_DrawRBG<1, 4, 0, 0, 2, 3>,  },  },  {  { &Renderer::T_DrawRBG<1, 4, 0, 1, 0, 0>, &Renderer::T_DrawRBG<1, 4, 0, 1, 0, 1>, &Renderer::T_DrawRBG<1, 4, 0, 1, 0, 2>, &Renderer::T_DrawRBG<1, 4, 0, 1, 0, 3>,  },  { &Renderer::T_DrawRBG<1, 4, 0, 1, 1, 0>, &Renderer::T_DrawRBG<1, 4, 0, 1, 1, 1>, &Renderer::T_DrawRBG<1, 4, 0, 1, 1, 2>, &Renderer::T_DrawRBG<1, 4, 0, 1, 1, 3>,  },  { &Renderer::T_DrawRBG<1, 4, 0, 1, 2, 0>, &Renderer::T_DrawRBG<1, 4, 0, 1, 2, 1>, &Renderer::T_DrawRBG<1, 4, 0, 1, 2, 2>, &Renderer::T_DrawRBG<1, 4, 0, 1, 2, 3>,  },  },  },
+  {  {  { &Renderer::T_DrawRBG<1, 8, 0, 0, 0, 0>, &Renderer::T_DrawRBG<1, 8, 0, 0, 0, 1>, &Renderer::T_DrawRBG<1, 8, 0, 0, 0, 2>, &Renderer::T_DrawRBG<1, 8, 0, 0, 0, 3>,  },  { &Renderer::T_DrawRBG<1, 8, 0, 0, 1, 0>, &Renderer::T_DrawRBG<1, 8, 0, 0, 1, 1>, &Renderer::T_DrawRBG<1, 8, 0, 0, 1, 2>, &Renderer::T_DrawRBG<1, 8, 0, 0, 1, 3>,  },  { &Renderer::T_DrawRBG<1, 8, 0, 0, 2, 0>, &Renderer::T_DrawRBG<1, 8, 0, 0, 2, 1>, &Renderer::T_DrawRBG<1, 8, 0, 0, 2, 2>, &Renderer::T_DrawRBG<1, 8, 0, 0, 2, 3>,  },  },  {  { &Renderer::T_DrawRBG<1, 8, 0, 1, 0, 0>, &Renderer::T_DrawRBG<1, 8, 0, 1, 0, 1>, &Renderer::T_DrawRBG<1, 8, 0, 1, 0, 2>, &Renderer::T_DrawRBG<1, 8, 0, 1, 0, 3>,  },  { &Renderer::T_DrawRBG<1, 8, 0, 1, 1, 0>, &Renderer::T_DrawRBG<1, 8, 0, 1, 1, 1>, &Renderer::T_DrawRBG<1, 8, 0, 1, 1, 2>, &Renderer::T_DrawRBG<1, 8, 0, 1, 1, 3>,  },  { &Renderer::T_DrawRBG<1, 8, 0, 1, 2, 0>, &Renderer::T_DrawRBG<1, 8, 0, 1, 2, 1>, &Renderer::T_DrawRBG<1, 8, 0, 1, 2, 2>, &Renderer::T_DrawRBG<1, 8, 0, 1, 2, 3>,  },  },  },
+  {  {  { &Renderer::T_DrawRBG<1, 16, 0, 0, 0, 0>, &Renderer::T_DrawRBG<1, 16, 0, 0, 0, 1>, &Renderer::T_DrawRBG<1, 16, 0, 0, 0, 2>, &Renderer::T_DrawRBG<1, 16, 0, 0, 0, 3>,  },  { &Renderer::T_DrawRBG<1, 16, 0, 0, 1, 0>, &Renderer::T_DrawRBG<1, 16, 0, 0, 1, 1>, &Renderer::T_DrawRBG<1, 16, 0, 0, 1, 2>, &Renderer::T_DrawRBG<1, 16, 0, 0, 1, 3>,  },  { &Renderer::T_DrawRBG<1, 16, 0, 0, 2, 0>, &Renderer::T_DrawRBG<1, 16, 0, 0, 2, 1>, &Renderer::T_DrawRBG<1, 16, 0, 0, 2, 2>, &Renderer::T_DrawRBG<1, 16, 0, 0, 2, 3>,  },  },  {  { &Renderer::T_DrawRBG<1, 16, 0, 1, 0, 0>, &Renderer::T_DrawRBG<1, 16, 0, 1, 0, 1>, &Renderer::T_DrawRBG<1, 16, 0, 1, 0, 2>, &Renderer::T_DrawRBG<1, 16, 0, 1, 0, 3>,  },  { &Renderer::T_DrawRBG<1, 16, 0, 1, 1, 0>, &Renderer::T_DrawRBG<1, 16, 0, 1, 1, 1>, &Renderer::T_DrawRBG<1, 16, 0, 1, 1, 2>, &Renderer::T_DrawRBG<1, 16, 0, 1, 1, 3>,  },  { &Renderer::T_DrawRBG<1, 16, 0, 1, 2, 0>, &Renderer::T_DrawRBG<1, 16, 0, 1, 2, 1>, &Renderer::T_DrawRBG<1, 16, 0, 1, 2, 2>, &Renderer::T_DrawRBG<1, 16, 0, 1, 2, 3>,  },  },  },
+  {  {  { &Renderer::T_DrawRBG<1, 16, 1, 0, 0, 0>, &Renderer::T_DrawRBG<1, 16, 1, 0, 0, 1>, &Renderer::T_DrawRBG<1, 16, 1, 0, 0, 2>, &Renderer::T_DrawRBG<1, 16, 1, 0, 0, 3>,  },  { &Renderer::T_DrawRBG<1, 16, 1, 0, 1, 0>, &Renderer::T_DrawRBG<1, 16, 1, 0, 1, 1>, &Renderer::T_DrawRBG<1, 16, 1, 0, 1, 2>, &Renderer::T_DrawRBG<1, 16, 1, 0, 1, 3>,  },  { &Renderer::T_DrawRBG<1, 16, 1, 0, 2, 0>, &Renderer::T_DrawRBG<1, 16, 1, 0, 2, 1>, &Renderer::T_DrawRBG<1, 16, 1, 0, 2, 2>, &Renderer::T_DrawRBG<1, 16, 1, 0, 2, 3>,  },  },  {  { &Renderer::T_DrawRBG<1, 16, 1, 1, 0, 0>, &Renderer::T_DrawRBG<1, 16, 1, 1, 0, 1>, &Renderer::T_DrawRBG<1, 16, 1, 1, 0, 2>, &Renderer::T_DrawRBG<1, 16, 1, 1, 0, 3>,  },  { &Renderer::T_DrawRBG<1, 16, 1, 1, 1, 0>, &Renderer::T_DrawRBG<1, 16, 1, 1, 1, 1>, &Renderer::T_DrawRBG<1, 16, 1, 1, 1, 2>, &Renderer::T_DrawRBG<1, 16, 1, 1, 1, 3>,  },  { &Renderer::T_DrawRBG<1, 16, 1, 1, 2, 0>, &Renderer::T_DrawRBG<1, 16, 1, 1, 2, 1>, &Renderer::T_DrawRBG<1, 16, 1, 1, 2, 2>, &Renderer::T_DrawRBG<1, 16, 1, 1, 2, 3>,  },  },  },
+  {  {  { &Renderer::T_DrawRBG<1, 32, 1, 0, 0, 0>, &Renderer::T_DrawRBG<1, 32, 1, 0, 0, 1>, &Renderer::T_DrawRBG<1, 32, 1, 0, 0, 2>, &Renderer::T_DrawRBG<1, 32, 1, 0, 0, 3>,  },  { &Renderer::T_DrawRBG<1, 32, 1, 0, 1, 0>, &Renderer::T_DrawRBG<1, 32, 1, 0, 1, 1>, &Renderer::T_DrawRBG<1, 32, 1, 0, 1, 2>, &Renderer::T_DrawRBG<1, 32, 1, 0, 1, 3>,  },  { &Renderer::T_DrawRBG<1, 32, 1, 0, 2, 0>, &Renderer::T_DrawRBG<1, 32, 1, 0, 2, 1>, &Renderer::T_DrawRBG<1, 32, 1, 0, 2, 2>, &Renderer::T_DrawRBG<1, 32, 1, 0, 2, 3>,  },  },  {  { &Renderer::T_DrawRBG<1, 32, 1, 1, 0, 0>, &Renderer::T_DrawRBG<1, 32, 1, 1, 0, 1>, &Renderer::T_DrawRBG<1, 32, 1, 1, 0, 2>, &Renderer::T_DrawRBG<1, 32, 1, 1, 0, 3>,  },  { &Renderer::T_DrawRBG<1, 32, 1, 1, 1, 0>, &Renderer::T_DrawRBG<1, 32, 1, 1, 1, 1>, &Renderer::T_DrawRBG<1, 32, 1, 1, 1, 2>, &Renderer::T_DrawRBG<1, 32, 1, 1, 1, 3>,  },  { &Renderer::T_DrawRBG<1, 32, 1, 1, 2, 0>, &Renderer::T_DrawRBG<1, 32, 1, 1, 2, 1>, &Renderer::T_DrawRBG<1, 32, 1, 1, 2, 2>, &Renderer::T_DrawRBG<1, 32, 1, 1, 2, 3>,  },  },  },
  }
 };
 
@@ -2092,7 +2151,7 @@ static INLINE void Doubleize(T* ptr, const int orig_len)
  }
 }
 
-static void RBGPP(const unsigned layer, uint64* buf, const unsigned rbg_w)
+void Renderer::RBGPP(const unsigned layer, uint64* buf, const unsigned rbg_w)
 {
  ApplyHMosaic(layer, buf, rbg_w);
 
@@ -2113,7 +2172,7 @@ static void RBGPP(const unsigned layer, uint64* buf, const unsigned rbg_w)
 }
 
 // Call before DrawSpriteData()
-static INLINE void MakeSpriteCCLUT(void)
+INLINE void Renderer::MakeSpriteCCLUT(void)
 {
  const bool cce = ((CCCTL >> 6) & 1);
 
@@ -2136,7 +2195,7 @@ static INLINE void MakeSpriteCCLUT(void)
 }
 
 template<bool TA_HiRes, bool TA_TPShadSel, unsigned TA_SPCTL_Low>
-static void T_DrawSpriteData(const uint16* vdp1sb, const bool vdp1_hires8, unsigned w)
+void Renderer::T_DrawSpriteData(const uint16* vdp1sb, const bool vdp1_hires8, unsigned w)
 {
  const unsigned SpriteType = (TA_SPCTL_Low & 0xF);
  const bool SpriteWinEn = (TA_SPCTL_Low & 0x10);
@@ -2351,15 +2410,15 @@ static void T_DrawSpriteData(const uint16* vdp1sb, const bool vdp1_hires8, unsig
  }
 }
 
-static void (*DrawSpriteData[2][2][0x40])(const uint16* vdp1sb, const bool vdp1_hires8, unsigned w) =
+static void (Renderer::*DrawSpriteData[2][2][0x40])(const uint16* vdp1sb, const bool vdp1_hires8, unsigned w) =
 {
  {
-  { T_DrawSpriteData<0, 0, 0x00>, T_DrawSpriteData<0, 0, 0x01>, T_DrawSpriteData<0, 0, 0x02>, T_DrawSpriteData<0, 0, 0x03>, T_DrawSpriteData<0, 0, 0x04>, T_DrawSpriteData<0, 0, 0x05>, T_DrawSpriteData<0, 0, 0x06>, T_DrawSpriteData<0, 0, 0x07>, T_DrawSpriteData<0, 0, 0x08>, T_DrawSpriteData<0, 0, 0x09>, T_DrawSpriteData<0, 0, 0x0a>, T_DrawSpriteData<0, 0, 0x0b>, T_DrawSpriteData<0, 0, 0x0c>, T_DrawSpriteData<0, 0, 0x0d>, T_DrawSpriteData<0, 0, 0x0e>, T_DrawSpriteData<0, 0, 0x0f>, T_DrawSpriteData<0, 0, 0x10>, T_DrawSpriteData<0, 0, 0x11>, T_DrawSpriteData<0, 0, 0x12>, T_DrawSpriteData<0, 0, 0x13>, T_DrawSpriteData<0, 0, 0x14>, T_DrawSpriteData<0, 0, 0x15>, T_DrawSpriteData<0, 0, 0x16>, T_DrawSpriteData<0, 0, 0x17>, T_DrawSpriteData<0, 0, 0x18>, T_DrawSpriteData<0, 0, 0x19>, T_DrawSpriteData<0, 0, 0x1a>, T_DrawSpriteData<0, 0, 0x1b>, T_DrawSpriteData<0, 0, 0x1c>, T_DrawSpriteData<0, 0, 0x1d>, T_DrawSpriteData<0, 0, 0x1e>, T_DrawSpriteData<0, 0, 0x1f>, T_DrawSpriteData<0, 0, 0x20>, T_DrawSpriteData<0, 0, 0x21>, T_DrawSpriteData<0, 0, 0x22>, T_DrawSpriteData<0, 0, 0x23>, T_DrawSpriteData<0, 0, 0x24>, T_DrawSpriteData<0, 0, 0x25>, T_DrawSpriteData<0, 0, 0x26>, T_DrawSpriteData<0, 0, 0x27>, T_DrawSpriteData<0, 0, 0x28>, T_DrawSpriteData<0, 0, 0x29>, T_DrawSpriteData<0, 0, 0x2a>, T_DrawSpriteData<0, 0, 0x2b>, T_DrawSpriteData<0, 0, 0x2c>, T_DrawSpriteData<0, 0, 0x2d>, T_DrawSpriteData<0, 0, 0x2e>, T_DrawSpriteData<0, 0, 0x2f>, T_DrawSpriteData<0, 0, 0x30>, T_DrawSpriteData<0, 0, 0x31>, T_DrawSpriteData<0, 0, 0x32>, T_DrawSpriteData<0, 0, 0x33>, T_DrawSpriteData<0, 0, 0x34>, T_DrawSpriteData<0, 0, 0x35>, T_DrawSpriteData<0, 0, 0x36>, T_DrawSpriteData<0, 0, 0x37>, T_DrawSpriteData<0, 0, 0x38>, T_DrawSpriteData<0, 0, 0x39>, T_DrawSpriteData<0, 0, 0x3a>, T_DrawSpriteData<0, 0, 0x3b>, T_DrawSpriteData<0, 0, 0x3c>, T_DrawSpriteData<0, 0, 0x3d>, T_DrawSpriteData<0, 0, 0x3e>, T_DrawSpriteData<0, 0, 0x3f> },
-  { T_DrawSpriteData<0, 1, 0x00>, T_DrawSpriteData<0, 1, 0x01>, T_DrawSpriteData<0, 1, 0x02>, T_DrawSpriteData<0, 1, 0x03>, T_DrawSpriteData<0, 1, 0x04>, T_DrawSpriteData<0, 1, 0x05>, T_DrawSpriteData<0, 1, 0x06>, T_DrawSpriteData<0, 1, 0x07>, T_DrawSpriteData<0, 1, 0x08>, T_DrawSpriteData<0, 1, 0x09>, T_DrawSpriteData<0, 1, 0x0a>, T_DrawSpriteData<0, 1, 0x0b>, T_DrawSpriteData<0, 1, 0x0c>, T_DrawSpriteData<0, 1, 0x0d>, T_DrawSpriteData<0, 1, 0x0e>, T_DrawSpriteData<0, 1, 0x0f>, T_DrawSpriteData<0, 1, 0x10>, T_DrawSpriteData<0, 1, 0x11>, T_DrawSpriteData<0, 1, 0x12>, T_DrawSpriteData<0, 1, 0x13>, T_DrawSpriteData<0, 1, 0x14>, T_DrawSpriteData<0, 1, 0x15>, T_DrawSpriteData<0, 1, 0x16>, T_DrawSpriteData<0, 1, 0x17>, T_DrawSpriteData<0, 1, 0x18>, T_DrawSpriteData<0, 1, 0x19>, T_DrawSpriteData<0, 1, 0x1a>, T_DrawSpriteData<0, 1, 0x1b>, T_DrawSpriteData<0, 1, 0x1c>, T_DrawSpriteData<0, 1, 0x1d>, T_DrawSpriteData<0, 1, 0x1e>, T_DrawSpriteData<0, 1, 0x1f>, T_DrawSpriteData<0, 1, 0x20>, T_DrawSpriteData<0, 1, 0x21>, T_DrawSpriteData<0, 1, 0x22>, T_DrawSpriteData<0, 1, 0x23>, T_DrawSpriteData<0, 1, 0x24>, T_DrawSpriteData<0, 1, 0x25>, T_DrawSpriteData<0, 1, 0x26>, T_DrawSpriteData<0, 1, 0x27>, T_DrawSpriteData<0, 1, 0x28>, T_DrawSpriteData<0, 1, 0x29>, T_DrawSpriteData<0, 1, 0x2a>, T_DrawSpriteData<0, 1, 0x2b>, T_DrawSpriteData<0, 1, 0x2c>, T_DrawSpriteData<0, 1, 0x2d>, T_DrawSpriteData<0, 1, 0x2e>, T_DrawSpriteData<0, 1, 0x2f>, T_DrawSpriteData<0, 1, 0x30>, T_DrawSpriteData<0, 1, 0x31>, T_DrawSpriteData<0, 1, 0x32>, T_DrawSpriteData<0, 1, 0x33>, T_DrawSpriteData<0, 1, 0x34>, T_DrawSpriteData<0, 1, 0x35>, T_DrawSpriteData<0, 1, 0x36>, T_DrawSpriteData<0, 1, 0x37>, T_DrawSpriteData<0, 1, 0x38>, T_DrawSpriteData<0, 1, 0x39>, T_DrawSpriteData<0, 1, 0x3a>, T_DrawSpriteData<0, 1, 0x3b>, T_DrawSpriteData<0, 1, 0x3c>, T_DrawSpriteData<0, 1, 0x3d>, T_DrawSpriteData<0, 1, 0x3e>, T_DrawSpriteData<0, 1, 0x3f> },
+  { &Renderer::T_DrawSpriteData<0, 0, 0x00>, &Renderer::T_DrawSpriteData<0, 0, 0x01>, &Renderer::T_DrawSpriteData<0, 0, 0x02>, &Renderer::T_DrawSpriteData<0, 0, 0x03>, &Renderer::T_DrawSpriteData<0, 0, 0x04>, &Renderer::T_DrawSpriteData<0, 0, 0x05>, &Renderer::T_DrawSpriteData<0, 0, 0x06>, &Renderer::T_DrawSpriteData<0, 0, 0x07>, &Renderer::T_DrawSpriteData<0, 0, 0x08>, &Renderer::T_DrawSpriteData<0, 0, 0x09>, &Renderer::T_DrawSpriteData<0, 0, 0x0a>, &Renderer::T_DrawSpriteData<0, 0, 0x0b>, &Renderer::T_DrawSpriteData<0, 0, 0x0c>, &Renderer::T_DrawSpriteData<0, 0, 0x0d>, &Renderer::T_DrawSpriteData<0, 0, 0x0e>, &Renderer::T_DrawSpriteData<0, 0, 0x0f>, &Renderer::T_DrawSpriteData<0, 0, 0x10>, &Renderer::T_DrawSpriteData<0, 0, 0x11>, &Renderer::T_DrawSpriteData<0, 0, 0x12>, &Renderer::T_DrawSpriteData<0, 0, 0x13>, &Renderer::T_DrawSpriteData<0, 0, 0x14>, &Renderer::T_DrawSpriteData<0, 0, 0x15>, &Renderer::T_DrawSpriteData<0, 0, 0x16>, &Renderer::T_DrawSpriteData<0, 0, 0x17>, &Renderer::T_DrawSpriteData<0, 0, 0x18>, &Renderer::T_DrawSpriteData<0, 0, 0x19>, &Renderer::T_DrawSpriteData<0, 0, 0x1a>, &Renderer::T_DrawSpriteData<0, 0, 0x1b>, &Renderer::T_DrawSpriteData<0, 0, 0x1c>, &Renderer::T_DrawSpriteData<0, 0, 0x1d>, &Renderer::T_DrawSpriteData<0, 0, 0x1e>, &Renderer::T_DrawSpriteData<0, 0, 0x1f>, &Renderer::T_DrawSpriteData<0, 0, 0x20>, &Renderer::T_DrawSpriteData<0, 0, 0x21>, &Renderer::T_DrawSpriteData<0, 0, 0x22>, &Renderer::T_DrawSpriteData<0, 0, 0x23>, &Renderer::T_DrawSpriteData<0, 0, 0x24>, &Renderer::T_DrawSpriteData<0, 0, 0x25>, &Renderer::T_DrawSpriteData<0, 0, 0x26>, &Renderer::T_DrawSpriteData<0, 0, 0x27>, &Renderer::T_DrawSpriteData<0, 0, 0x28>, &Renderer::T_DrawSpriteData<0, 0, 0x29>, &Renderer::T_DrawSpriteData<0, 0, 0x2a>, &Renderer::T_DrawSpriteData<0, 0, 0x2b>, &Renderer::T_DrawSpriteData<0, 0, 0x2c>, &Renderer::T_DrawSpriteData<0, 0, 0x2d>, &Renderer::T_DrawSpriteData<0, 0, 0x2e>, &Renderer::T_DrawSpriteData<0, 0, 0x2f>, &Renderer::T_DrawSpriteData<0, 0, 0x30>, &Renderer::T_DrawSpriteData<0, 0, 0x31>, &Renderer::T_DrawSpriteData<0, 0, 0x32>, &Renderer::T_DrawSpriteData<0, 0, 0x33>, &Renderer::T_DrawSpriteData<0, 0, 0x34>, &Renderer::T_DrawSpriteData<0, 0, 0x35>, &Renderer::T_DrawSpriteData<0, 0, 0x36>, &Renderer::T_DrawSpriteData<0, 0, 0x37>, &Renderer::T_DrawSpriteData<0, 0, 0x38>, &Renderer::T_DrawSpriteData<0, 0, 0x39>, &Renderer::T_DrawSpriteData<0, 0, 0x3a>, &Renderer::T_DrawSpriteData<0, 0, 0x3b>, &Renderer::T_DrawSpriteData<0, 0, 0x3c>, &Renderer::T_DrawSpriteData<0, 0, 0x3d>, &Renderer::T_DrawSpriteData<0, 0, 0x3e>, &Renderer::T_DrawSpriteData<0, 0, 0x3f> },
+  { &Renderer::T_DrawSpriteData<0, 1, 0x00>, &Renderer::T_DrawSpriteData<0, 1, 0x01>, &Renderer::T_DrawSpriteData<0, 1, 0x02>, &Renderer::T_DrawSpriteData<0, 1, 0x03>, &Renderer::T_DrawSpriteData<0, 1, 0x04>, &Renderer::T_DrawSpriteData<0, 1, 0x05>, &Renderer::T_DrawSpriteData<0, 1, 0x06>, &Renderer::T_DrawSpriteData<0, 1, 0x07>, &Renderer::T_DrawSpriteData<0, 1, 0x08>, &Renderer::T_DrawSpriteData<0, 1, 0x09>, &Renderer::T_DrawSpriteData<0, 1, 0x0a>, &Renderer::T_DrawSpriteData<0, 1, 0x0b>, &Renderer::T_DrawSpriteData<0, 1, 0x0c>, &Renderer::T_DrawSpriteData<0, 1, 0x0d>, &Renderer::T_DrawSpriteData<0, 1, 0x0e>, &Renderer::T_DrawSpriteData<0, 1, 0x0f>, &Renderer::T_DrawSpriteData<0, 1, 0x10>, &Renderer::T_DrawSpriteData<0, 1, 0x11>, &Renderer::T_DrawSpriteData<0, 1, 0x12>, &Renderer::T_DrawSpriteData<0, 1, 0x13>, &Renderer::T_DrawSpriteData<0, 1, 0x14>, &Renderer::T_DrawSpriteData<0, 1, 0x15>, &Renderer::T_DrawSpriteData<0, 1, 0x16>, &Renderer::T_DrawSpriteData<0, 1, 0x17>, &Renderer::T_DrawSpriteData<0, 1, 0x18>, &Renderer::T_DrawSpriteData<0, 1, 0x19>, &Renderer::T_DrawSpriteData<0, 1, 0x1a>, &Renderer::T_DrawSpriteData<0, 1, 0x1b>, &Renderer::T_DrawSpriteData<0, 1, 0x1c>, &Renderer::T_DrawSpriteData<0, 1, 0x1d>, &Renderer::T_DrawSpriteData<0, 1, 0x1e>, &Renderer::T_DrawSpriteData<0, 1, 0x1f>, &Renderer::T_DrawSpriteData<0, 1, 0x20>, &Renderer::T_DrawSpriteData<0, 1, 0x21>, &Renderer::T_DrawSpriteData<0, 1, 0x22>, &Renderer::T_DrawSpriteData<0, 1, 0x23>, &Renderer::T_DrawSpriteData<0, 1, 0x24>, &Renderer::T_DrawSpriteData<0, 1, 0x25>, &Renderer::T_DrawSpriteData<0, 1, 0x26>, &Renderer::T_DrawSpriteData<0, 1, 0x27>, &Renderer::T_DrawSpriteData<0, 1, 0x28>, &Renderer::T_DrawSpriteData<0, 1, 0x29>, &Renderer::T_DrawSpriteData<0, 1, 0x2a>, &Renderer::T_DrawSpriteData<0, 1, 0x2b>, &Renderer::T_DrawSpriteData<0, 1, 0x2c>, &Renderer::T_DrawSpriteData<0, 1, 0x2d>, &Renderer::T_DrawSpriteData<0, 1, 0x2e>, &Renderer::T_DrawSpriteData<0, 1, 0x2f>, &Renderer::T_DrawSpriteData<0, 1, 0x30>, &Renderer::T_DrawSpriteData<0, 1, 0x31>, &Renderer::T_DrawSpriteData<0, 1, 0x32>, &Renderer::T_DrawSpriteData<0, 1, 0x33>, &Renderer::T_DrawSpriteData<0, 1, 0x34>, &Renderer::T_DrawSpriteData<0, 1, 0x35>, &Renderer::T_DrawSpriteData<0, 1, 0x36>, &Renderer::T_DrawSpriteData<0, 1, 0x37>, &Renderer::T_DrawSpriteData<0, 1, 0x38>, &Renderer::T_DrawSpriteData<0, 1, 0x39>, &Renderer::T_DrawSpriteData<0, 1, 0x3a>, &Renderer::T_DrawSpriteData<0, 1, 0x3b>, &Renderer::T_DrawSpriteData<0, 1, 0x3c>, &Renderer::T_DrawSpriteData<0, 1, 0x3d>, &Renderer::T_DrawSpriteData<0, 1, 0x3e>, &Renderer::T_DrawSpriteData<0, 1, 0x3f> },
  },
  {
-  { T_DrawSpriteData<1, 0, 0x00>, T_DrawSpriteData<1, 0, 0x01>, T_DrawSpriteData<1, 0, 0x02>, T_DrawSpriteData<1, 0, 0x03>, T_DrawSpriteData<1, 0, 0x04>, T_DrawSpriteData<1, 0, 0x05>, T_DrawSpriteData<1, 0, 0x06>, T_DrawSpriteData<1, 0, 0x07>, T_DrawSpriteData<1, 0, 0x08>, T_DrawSpriteData<1, 0, 0x09>, T_DrawSpriteData<1, 0, 0x0a>, T_DrawSpriteData<1, 0, 0x0b>, T_DrawSpriteData<1, 0, 0x0c>, T_DrawSpriteData<1, 0, 0x0d>, T_DrawSpriteData<1, 0, 0x0e>, T_DrawSpriteData<1, 0, 0x0f>, T_DrawSpriteData<1, 0, 0x10>, T_DrawSpriteData<1, 0, 0x11>, T_DrawSpriteData<1, 0, 0x12>, T_DrawSpriteData<1, 0, 0x13>, T_DrawSpriteData<1, 0, 0x14>, T_DrawSpriteData<1, 0, 0x15>, T_DrawSpriteData<1, 0, 0x16>, T_DrawSpriteData<1, 0, 0x17>, T_DrawSpriteData<1, 0, 0x18>, T_DrawSpriteData<1, 0, 0x19>, T_DrawSpriteData<1, 0, 0x1a>, T_DrawSpriteData<1, 0, 0x1b>, T_DrawSpriteData<1, 0, 0x1c>, T_DrawSpriteData<1, 0, 0x1d>, T_DrawSpriteData<1, 0, 0x1e>, T_DrawSpriteData<1, 0, 0x1f>, T_DrawSpriteData<1, 0, 0x20>, T_DrawSpriteData<1, 0, 0x21>, T_DrawSpriteData<1, 0, 0x22>, T_DrawSpriteData<1, 0, 0x23>, T_DrawSpriteData<1, 0, 0x24>, T_DrawSpriteData<1, 0, 0x25>, T_DrawSpriteData<1, 0, 0x26>, T_DrawSpriteData<1, 0, 0x27>, T_DrawSpriteData<1, 0, 0x28>, T_DrawSpriteData<1, 0, 0x29>, T_DrawSpriteData<1, 0, 0x2a>, T_DrawSpriteData<1, 0, 0x2b>, T_DrawSpriteData<1, 0, 0x2c>, T_DrawSpriteData<1, 0, 0x2d>, T_DrawSpriteData<1, 0, 0x2e>, T_DrawSpriteData<1, 0, 0x2f>, T_DrawSpriteData<1, 0, 0x30>, T_DrawSpriteData<1, 0, 0x31>, T_DrawSpriteData<1, 0, 0x32>, T_DrawSpriteData<1, 0, 0x33>, T_DrawSpriteData<1, 0, 0x34>, T_DrawSpriteData<1, 0, 0x35>, T_DrawSpriteData<1, 0, 0x36>, T_DrawSpriteData<1, 0, 0x37>, T_DrawSpriteData<1, 0, 0x38>, T_DrawSpriteData<1, 0, 0x39>, T_DrawSpriteData<1, 0, 0x3a>, T_DrawSpriteData<1, 0, 0x3b>, T_DrawSpriteData<1, 0, 0x3c>, T_DrawSpriteData<1, 0, 0x3d>, T_DrawSpriteData<1, 0, 0x3e>, T_DrawSpriteData<1, 0, 0x3f> },
-  { T_DrawSpriteData<1, 1, 0x00>, T_DrawSpriteData<1, 1, 0x01>, T_DrawSpriteData<1, 1, 0x02>, T_DrawSpriteData<1, 1, 0x03>, T_DrawSpriteData<1, 1, 0x04>, T_DrawSpriteData<1, 1, 0x05>, T_DrawSpriteData<1, 1, 0x06>, T_DrawSpriteData<1, 1, 0x07>, T_DrawSpriteData<1, 1, 0x08>, T_DrawSpriteData<1, 1, 0x09>, T_DrawSpriteData<1, 1, 0x0a>, T_DrawSpriteData<1, 1, 0x0b>, T_DrawSpriteData<1, 1, 0x0c>, T_DrawSpriteData<1, 1, 0x0d>, T_DrawSpriteData<1, 1, 0x0e>, T_DrawSpriteData<1, 1, 0x0f>, T_DrawSpriteData<1, 1, 0x10>, T_DrawSpriteData<1, 1, 0x11>, T_DrawSpriteData<1, 1, 0x12>, T_DrawSpriteData<1, 1, 0x13>, T_DrawSpriteData<1, 1, 0x14>, T_DrawSpriteData<1, 1, 0x15>, T_DrawSpriteData<1, 1, 0x16>, T_DrawSpriteData<1, 1, 0x17>, T_DrawSpriteData<1, 1, 0x18>, T_DrawSpriteData<1, 1, 0x19>, T_DrawSpriteData<1, 1, 0x1a>, T_DrawSpriteData<1, 1, 0x1b>, T_DrawSpriteData<1, 1, 0x1c>, T_DrawSpriteData<1, 1, 0x1d>, T_DrawSpriteData<1, 1, 0x1e>, T_DrawSpriteData<1, 1, 0x1f>, T_DrawSpriteData<1, 1, 0x20>, T_DrawSpriteData<1, 1, 0x21>, T_DrawSpriteData<1, 1, 0x22>, T_DrawSpriteData<1, 1, 0x23>, T_DrawSpriteData<1, 1, 0x24>, T_DrawSpriteData<1, 1, 0x25>, T_DrawSpriteData<1, 1, 0x26>, T_DrawSpriteData<1, 1, 0x27>, T_DrawSpriteData<1, 1, 0x28>, T_DrawSpriteData<1, 1, 0x29>, T_DrawSpriteData<1, 1, 0x2a>, T_DrawSpriteData<1, 1, 0x2b>, T_DrawSpriteData<1, 1, 0x2c>, T_DrawSpriteData<1, 1, 0x2d>, T_DrawSpriteData<1, 1, 0x2e>, T_DrawSpriteData<1, 1, 0x2f>, T_DrawSpriteData<1, 1, 0x30>, T_DrawSpriteData<1, 1, 0x31>, T_DrawSpriteData<1, 1, 0x32>, T_DrawSpriteData<1, 1, 0x33>, T_DrawSpriteData<1, 1, 0x34>, T_DrawSpriteData<1, 1, 0x35>, T_DrawSpriteData<1, 1, 0x36>, T_DrawSpriteData<1, 1, 0x37>, T_DrawSpriteData<1, 1, 0x38>, T_DrawSpriteData<1, 1, 0x39>, T_DrawSpriteData<1, 1, 0x3a>, T_DrawSpriteData<1, 1, 0x3b>, T_DrawSpriteData<1, 1, 0x3c>, T_DrawSpriteData<1, 1, 0x3d>, T_DrawSpriteData<1, 1, 0x3e>, T_DrawSpriteData<1, 1, 0x3f> },
+  { &Renderer::T_DrawSpriteData<1, 0, 0x00>, &Renderer::T_DrawSpriteData<1, 0, 0x01>, &Renderer::T_DrawSpriteData<1, 0, 0x02>, &Renderer::T_DrawSpriteData<1, 0, 0x03>, &Renderer::T_DrawSpriteData<1, 0, 0x04>, &Renderer::T_DrawSpriteData<1, 0, 0x05>, &Renderer::T_DrawSpriteData<1, 0, 0x06>, &Renderer::T_DrawSpriteData<1, 0, 0x07>, &Renderer::T_DrawSpriteData<1, 0, 0x08>, &Renderer::T_DrawSpriteData<1, 0, 0x09>, &Renderer::T_DrawSpriteData<1, 0, 0x0a>, &Renderer::T_DrawSpriteData<1, 0, 0x0b>, &Renderer::T_DrawSpriteData<1, 0, 0x0c>, &Renderer::T_DrawSpriteData<1, 0, 0x0d>, &Renderer::T_DrawSpriteData<1, 0, 0x0e>, &Renderer::T_DrawSpriteData<1, 0, 0x0f>, &Renderer::T_DrawSpriteData<1, 0, 0x10>, &Renderer::T_DrawSpriteData<1, 0, 0x11>, &Renderer::T_DrawSpriteData<1, 0, 0x12>, &Renderer::T_DrawSpriteData<1, 0, 0x13>, &Renderer::T_DrawSpriteData<1, 0, 0x14>, &Renderer::T_DrawSpriteData<1, 0, 0x15>, &Renderer::T_DrawSpriteData<1, 0, 0x16>, &Renderer::T_DrawSpriteData<1, 0, 0x17>, &Renderer::T_DrawSpriteData<1, 0, 0x18>, &Renderer::T_DrawSpriteData<1, 0, 0x19>, &Renderer::T_DrawSpriteData<1, 0, 0x1a>, &Renderer::T_DrawSpriteData<1, 0, 0x1b>, &Renderer::T_DrawSpriteData<1, 0, 0x1c>, &Renderer::T_DrawSpriteData<1, 0, 0x1d>, &Renderer::T_DrawSpriteData<1, 0, 0x1e>, &Renderer::T_DrawSpriteData<1, 0, 0x1f>, &Renderer::T_DrawSpriteData<1, 0, 0x20>, &Renderer::T_DrawSpriteData<1, 0, 0x21>, &Renderer::T_DrawSpriteData<1, 0, 0x22>, &Renderer::T_DrawSpriteData<1, 0, 0x23>, &Renderer::T_DrawSpriteData<1, 0, 0x24>, &Renderer::T_DrawSpriteData<1, 0, 0x25>, &Renderer::T_DrawSpriteData<1, 0, 0x26>, &Renderer::T_DrawSpriteData<1, 0, 0x27>, &Renderer::T_DrawSpriteData<1, 0, 0x28>, &Renderer::T_DrawSpriteData<1, 0, 0x29>, &Renderer::T_DrawSpriteData<1, 0, 0x2a>, &Renderer::T_DrawSpriteData<1, 0, 0x2b>, &Renderer::T_DrawSpriteData<1, 0, 0x2c>, &Renderer::T_DrawSpriteData<1, 0, 0x2d>, &Renderer::T_DrawSpriteData<1, 0, 0x2e>, &Renderer::T_DrawSpriteData<1, 0, 0x2f>, &Renderer::T_DrawSpriteData<1, 0, 0x30>, &Renderer::T_DrawSpriteData<1, 0, 0x31>, &Renderer::T_DrawSpriteData<1, 0, 0x32>, &Renderer::T_DrawSpriteData<1, 0, 0x33>, &Renderer::T_DrawSpriteData<1, 0, 0x34>, &Renderer::T_DrawSpriteData<1, 0, 0x35>, &Renderer::T_DrawSpriteData<1, 0, 0x36>, &Renderer::T_DrawSpriteData<1, 0, 0x37>, &Renderer::T_DrawSpriteData<1, 0, 0x38>, &Renderer::T_DrawSpriteData<1, 0, 0x39>, &Renderer::T_DrawSpriteData<1, 0, 0x3a>, &Renderer::T_DrawSpriteData<1, 0, 0x3b>, &Renderer::T_DrawSpriteData<1, 0, 0x3c>, &Renderer::T_DrawSpriteData<1, 0, 0x3d>, &Renderer::T_DrawSpriteData<1, 0, 0x3e>, &Renderer::T_DrawSpriteData<1, 0, 0x3f> },
+  { &Renderer::T_DrawSpriteData<1, 1, 0x00>, &Renderer::T_DrawSpriteData<1, 1, 0x01>, &Renderer::T_DrawSpriteData<1, 1, 0x02>, &Renderer::T_DrawSpriteData<1, 1, 0x03>, &Renderer::T_DrawSpriteData<1, 1, 0x04>, &Renderer::T_DrawSpriteData<1, 1, 0x05>, &Renderer::T_DrawSpriteData<1, 1, 0x06>, &Renderer::T_DrawSpriteData<1, 1, 0x07>, &Renderer::T_DrawSpriteData<1, 1, 0x08>, &Renderer::T_DrawSpriteData<1, 1, 0x09>, &Renderer::T_DrawSpriteData<1, 1, 0x0a>, &Renderer::T_DrawSpriteData<1, 1, 0x0b>, &Renderer::T_DrawSpriteData<1, 1, 0x0c>, &Renderer::T_DrawSpriteData<1, 1, 0x0d>, &Renderer::T_DrawSpriteData<1, 1, 0x0e>, &Renderer::T_DrawSpriteData<1, 1, 0x0f>, &Renderer::T_DrawSpriteData<1, 1, 0x10>, &Renderer::T_DrawSpriteData<1, 1, 0x11>, &Renderer::T_DrawSpriteData<1, 1, 0x12>, &Renderer::T_DrawSpriteData<1, 1, 0x13>, &Renderer::T_DrawSpriteData<1, 1, 0x14>, &Renderer::T_DrawSpriteData<1, 1, 0x15>, &Renderer::T_DrawSpriteData<1, 1, 0x16>, &Renderer::T_DrawSpriteData<1, 1, 0x17>, &Renderer::T_DrawSpriteData<1, 1, 0x18>, &Renderer::T_DrawSpriteData<1, 1, 0x19>, &Renderer::T_DrawSpriteData<1, 1, 0x1a>, &Renderer::T_DrawSpriteData<1, 1, 0x1b>, &Renderer::T_DrawSpriteData<1, 1, 0x1c>, &Renderer::T_DrawSpriteData<1, 1, 0x1d>, &Renderer::T_DrawSpriteData<1, 1, 0x1e>, &Renderer::T_DrawSpriteData<1, 1, 0x1f>, &Renderer::T_DrawSpriteData<1, 1, 0x20>, &Renderer::T_DrawSpriteData<1, 1, 0x21>, &Renderer::T_DrawSpriteData<1, 1, 0x22>, &Renderer::T_DrawSpriteData<1, 1, 0x23>, &Renderer::T_DrawSpriteData<1, 1, 0x24>, &Renderer::T_DrawSpriteData<1, 1, 0x25>, &Renderer::T_DrawSpriteData<1, 1, 0x26>, &Renderer::T_DrawSpriteData<1, 1, 0x27>, &Renderer::T_DrawSpriteData<1, 1, 0x28>, &Renderer::T_DrawSpriteData<1, 1, 0x29>, &Renderer::T_DrawSpriteData<1, 1, 0x2a>, &Renderer::T_DrawSpriteData<1, 1, 0x2b>, &Renderer::T_DrawSpriteData<1, 1, 0x2c>, &Renderer::T_DrawSpriteData<1, 1, 0x2d>, &Renderer::T_DrawSpriteData<1, 1, 0x2e>, &Renderer::T_DrawSpriteData<1, 1, 0x2f>, &Renderer::T_DrawSpriteData<1, 1, 0x30>, &Renderer::T_DrawSpriteData<1, 1, 0x31>, &Renderer::T_DrawSpriteData<1, 1, 0x32>, &Renderer::T_DrawSpriteData<1, 1, 0x33>, &Renderer::T_DrawSpriteData<1, 1, 0x34>, &Renderer::T_DrawSpriteData<1, 1, 0x35>, &Renderer::T_DrawSpriteData<1, 1, 0x36>, &Renderer::T_DrawSpriteData<1, 1, 0x37>, &Renderer::T_DrawSpriteData<1, 1, 0x38>, &Renderer::T_DrawSpriteData<1, 1, 0x39>, &Renderer::T_DrawSpriteData<1, 1, 0x3a>, &Renderer::T_DrawSpriteData<1, 1, 0x3b>, &Renderer::T_DrawSpriteData<1, 1, 0x3c>, &Renderer::T_DrawSpriteData<1, 1, 0x3d>, &Renderer::T_DrawSpriteData<1, 1, 0x3e>, &Renderer::T_DrawSpriteData<1, 1, 0x3f> },
  }
 };
 
@@ -2378,7 +2437,7 @@ enum
 };
 
 template<bool TA_rbgdualen, unsigned TA_Special, bool TA_CCRTMD, bool TA_CCMD>
-static void T_MixIt(uint32* target, const unsigned vdp2_line, const unsigned w, const uint32 back_rgb24, const uint64* blursrc)
+void Renderer::T_MixIt(uint32* target, const unsigned vdp2_line, const unsigned w, const uint32 back_rgb24, const uint64* blursrc)
 {
  //printf("MixIt: %d, %d, %d, %d\n", TA_rbgdualen, TA_Special, TA_CCRTMD, TA_CCMD);
  const uint32* lclut = &ColorCache[CurLCColor &~ 0x7F];
@@ -2610,13 +2669,13 @@ static void T_MixIt(uint32* target, const unsigned vdp2_line, const unsigned w,
 }
 
 //template<bool TA_rbgdualen, unsigned TA_Special, bool TA_CCRTMD, bool TA_CCMD>
-static void (*MixIt[2][7][2][2])(uint32* target, const unsigned vdp2_line, const unsigned w, const uint32 back_rgb24, const uint64* blursrc) =
+static void (Renderer::*MixIt[2][7][2][2])(uint32* target, const unsigned vdp2_line, const unsigned w, const uint32 back_rgb24, const uint64* blursrc) =
 {
- {  {  { T_MixIt<0, 0, 0, 0>, T_MixIt<0, 0, 0, 1>,  },  { T_MixIt<0, 0, 1, 0>, T_MixIt<0, 0, 1, 1>,  },  },  {  { T_MixIt<0, 1, 0, 0>, T_MixIt<0, 1, 0, 1>,  },  { T_MixIt<0, 1, 1, 0>, T_MixIt<0, 1, 1, 1>,  },  },  {  { T_MixIt<0, 2, 0, 0>, T_MixIt<0, 2, 0, 1>,  },  { T_MixIt<0, 2, 1, 0>, T_MixIt<0, 2, 1, 1>,  },  },  {  { T_MixIt<0, 3, 0, 0>, T_MixIt<0, 3, 0, 1>,  },  { T_MixIt<0, 3, 1, 0>, T_MixIt<0, 3, 1, 1>,  },  },  {  { T_MixIt<0, 4, 0, 0>, T_MixIt<0, 4, 0, 1>,  },  { T_MixIt<0, 4, 1, 0>, T_MixIt<0, 4, 1, 1>,  },  },  {  { T_MixIt<0, 5, 0, 0>, T_MixIt<0, 5, 0, 1>,  },  { T_MixIt<0, 5, 1, 0>, T_MixIt<0, 5, 1, 1>,  },  },  {  { T_MixIt<0, 6, 0, 0>, T_MixIt<0, 6, 0, 1>,  },  { T_MixIt<0, 6, 1, 0>, T_MixIt<0, 6, 1, 1>,  },  },  },
- {  {  { T_MixIt<1, 0, 0, 0>, T_MixIt<1, 0, 0, 1>,  },  { T_MixIt<1, 0, 1, 0>, T_MixIt<1, 0, 1, 1>,  },  },  {  { T_MixIt<1, 1, 0, 0>, T_MixIt<1, 1, 0, 1>,  },  { T_MixIt<1, 1, 1, 0>, T_MixIt<1, 1, 1, 1>,  },  },  {  { T_MixIt<1, 2, 0, 0>, T_MixIt<1, 2, 0, 1>,  },  { T_MixIt<1, 2, 1, 0>, T_MixIt<1, 2, 1, 1>,  },  },  {  { T_MixIt<1, 3, 0, 0>, T_MixIt<1, 3, 0, 1>,  },  { T_MixIt<1, 3, 1, 0>, T_MixIt<1, 3, 1, 1>,  },  },  {  { T_MixIt<1, 4, 0, 0>, T_MixIt<1, 4, 0, 1>,  },  { T_MixIt<1, 4, 1, 0>, T_MixIt<1, 4, 1, 1>,  },  },  {  { T_MixIt<1, 5, 0, 0>, T_MixIt<1, 5, 0, 1>,  },  { T_MixIt<1, 5, 1, 0>, T_MixIt<1, 5, 1, 1>,  },  },  {  { T_MixIt<1, 6, 0, 0>, T_MixIt<1, 6, 0, 1>,  },  { T_MixIt<1, 6, 1, 0>, T_MixIt<1, 6, 1, 1>,  },  },  },
+ {  {  { &Renderer::T_MixIt<0, 0, 0, 0>, &Renderer::T_MixIt<0, 0, 0, 1>,  },  { &Renderer::T_MixIt<0, 0, 1, 0>, &Renderer::T_MixIt<0, 0, 1, 1>,  },  },  {  { &Renderer::T_MixIt<0, 1, 0, 0>, &Renderer::T_MixIt<0, 1, 0, 1>,  },  { &Renderer::T_MixIt<0, 1, 1, 0>, &Renderer::T_MixIt<0, 1, 1, 1>,  },  },  {  { &Renderer::T_MixIt<0, 2, 0, 0>, &Renderer::T_MixIt<0, 2, 0, 1>,  },  { &Renderer::T_MixIt<0, 2, 1, 0>, &Renderer::T_MixIt<0, 2, 1, 1>,  },  },  {  { &Renderer::T_MixIt<0, 3, 0, 0>, &Renderer::T_MixIt<0, 3, 0, 1>,  },  { &Renderer::T_MixIt<0, 3, 1, 0>, &Renderer::T_MixIt<0, 3, 1, 1>,  },  },  {  { &Renderer::T_MixIt<0, 4, 0, 0>, &Renderer::T_MixIt<0, 4, 0, 1>,  },  { &Renderer::T_MixIt<0, 4, 1, 0>, &Renderer::T_MixIt<0, 4, 1, 1>,  },  },  {  { &Renderer::T_MixIt<0, 5, 0, 0>, &Renderer::T_MixIt<0, 5, 0, 1>,  },  { &Renderer::T_MixIt<0, 5, 1, 0>, &Renderer::T_MixIt<0, 5, 1, 1>,  },  },  {  { &Renderer::T_MixIt<0, 6, 0, 0>, &Renderer::T_MixIt<0, 6, 0, 1>,  },  { &Renderer::T_MixIt<0, 6, 1, 0>, &Renderer::T_MixIt<0, 6, 1, 1>,  },  },  },
+ {  {  { &Renderer::T_MixIt<1, 0, 0, 0>, &Renderer::T_MixIt<1, 0, 0, 1>,  },  { &Renderer::T_MixIt<1, 0, 1, 0>, &Renderer::T_MixIt<1, 0, 1, 1>,  },  },  {  { &Renderer::T_MixIt<1, 1, 0, 0>, &Renderer::T_MixIt<1, 1, 0, 1>,  },  { &Renderer::T_MixIt<1, 1, 1, 0>, &Renderer::T_MixIt<1, 1, 1, 1>,  },  },  {  { &Renderer::T_MixIt<1, 2, 0, 0>, &Renderer::T_MixIt<1, 2, 0, 1>,  },  { &Renderer::T_MixIt<1, 2, 1, 0>, &Renderer::T_MixIt<1, 2, 1, 1>,  },  },  {  { &Renderer::T_MixIt<1, 3, 0, 0>, &Renderer::T_MixIt<1, 3, 0, 1>,  },  { &Renderer::T_MixIt<1, 3, 1, 0>, &Renderer::T_MixIt<1, 3, 1, 1>,  },  },  {  { &Renderer::T_MixIt<1, 4, 0, 0>, &Renderer::T_MixIt<1, 4, 0, 1>,  },  { &Renderer::T_MixIt<1, 4, 1, 0>, &Renderer::T_MixIt<1, 4, 1, 1>,  },  },  {  { &Renderer::T_MixIt<1, 5, 0, 0>, &Renderer::T_MixIt<1, 5, 0, 1>,  },  { &Renderer::T_MixIt<1, 5, 1, 0>, &Renderer::T_MixIt<1, 5, 1, 1>,  },  },  {  { &Renderer::T_MixIt<1, 6, 0, 0>, &Renderer::T_MixIt<1, 6, 0, 1>,  },  { &Renderer::T_MixIt<1, 6, 1, 0>, &Renderer::T_MixIt<1, 6, 1, 1>,  },  },  },
 };
 
-static int32 ApplyHBlend(uint32* const target, int32 w)
+INLINE int32 Renderer::ApplyHBlend(uint32* const target, int32 w)
 {
  #define BHALF(m, n) ((((uint64)(m) + (n)) - (((m) ^ (n)) & 0x01010101)) >> 1)
 
@@ -2694,9 +2753,9 @@ static void ReorderRGB(uint32* target, const unsigned w, const unsigned Rshift,
  }
 }
 
-static NO_INLINE void DrawLine(const uint16 out_line, const uint16 vdp2_line, const bool field)
+NO_INLINE void Renderer::DrawLine(const uint16 out_line, const uint16 vdp2_line, const bool field, const bool render)
 {
- uint32* target;
+ uint32* target = NULL;
  const int32 tvdw = ((!CorrectAspect || Clock28M) ? 352 : 330) << ((HRes & 0x2) >> 1);
  const unsigned rbg_w = ((HRes & 0x1) ? 352 : 320);
  const unsigned w = ((HRes & 0x1) ? 352 : 320) << ((HRes & 0x2) >> 1);
@@ -2704,21 +2763,24 @@ static NO_INLINE void DrawLine(const uint16 out_line, const uint16 vdp2_line, co
  uint32 back_rgb24;
  uint32 border_ncf;
 
- target = espec->surface->pixels + out_line * espec->surface->pitchinpix;
- espec->LineWidths[out_line] = tvdw;
-
- if(!ShowHOverscan)
+ if(render)
  {
-  const int32 ntdw = tvdw * 1024 / 1056;
-  const int32 tadj = std::max<int32>(0, espec->DisplayRect.x - ((tvdw - ntdw) >> 1));
+  target = espec->surface->pixels + out_line * espec->surface->pitchinpix;
+  espec->LineWidths[out_line] = tvdw;
 
-  //if(out_line == 100)
-  // printf("tvdw=%d, ntdw=%d, tadj=%d --- tvdw+tadj=%d\n", tvdw, ntdw, tadj, tvdw + tadj);
+  if(!ShowHOverscan)
+  {
+   const int32 ntdw = tvdw * 1024 / 1056;
+   const int32 tadj = std::max<int32>(0, espec->DisplayRect.x - ((tvdw - ntdw) >> 1));
 
-  assert((tvdw + tadj) <= 704);
+   //if(out_line == 100)
+   // printf("tvdw=%d, ntdw=%d, tadj=%d --- tvdw+tadj=%d\n", tvdw, ntdw, tadj, tvdw + tadj);
 
-  target += tadj;
-  espec->LineWidths[out_line] = ntdw;
+   assert((tvdw + tadj) <= 704);
+
+   target += tadj;
+   espec->LineWidths[out_line] = ntdw;
+  }
  }
 
  //
@@ -2780,8 +2842,11 @@ static NO_INLINE void DrawLine(const uint16 out_line, const uint16 vdp2_line, co
 
  if(vdp2_line == 0xFFFF)
  {
-  for(int32 i = 0; i < tvdw; i++)
-   target[i] = border_ncf;
+  if(render)
+  {
+   for(int32 i = 0; i < tvdw; i++)
+    target[i] = border_ncf;
+  }
  }
  else
  {
@@ -2914,103 +2979,106 @@ static NO_INLINE void DrawLine(const uint16 out_line, const uint16 vdp2_line, co
    //printf("WinControl[WINLAYER_CC]=%02x\n", WinControl[WINLAYER_CC]);
   }
 
-  //
-  // Process sprite data before NBG0-3 and RBG0-1, but defer applying the window until after NBG and RBG are handled(so the sprite window
-  // bit in the sprite linebuffer data isn't trashed prematurely).
-  //
-  if(MDFN_LIKELY(UserLayerEnableMask & (1U << 6)))
+  if(render)
   {
-   MakeSpriteCCLUT();
-   DrawSpriteData[(HRes & 0x2) >> 0x1][(SDCTL >> 8) & 0x1][SPCTL_Low](LIB[vdp2_line].vdp1_line, LIB[vdp2_line].vdp1_hires8, w);
-  }
-  else
-   MDFN_FastArraySet(LB.spr, 0, w);
-  //
-  //
-  //
-  //
-  //
-  //
-  //
-  if(BGON & 0x30)
-  {
-   MDFN_FastArraySet(LB.lc, CurLCColor & 0x7F, rbg_w);
-   SetupRotVars(LIB[vdp2_line].rv, rbg_w);
-   if(HRes & 0x2)
-    Doubleize(LB.lc, rbg_w);
-
-   // RBG0
-   if(MDFN_LIKELY(BGON & UserLayerEnableMask & 0x10))
+   //
+   // Process sprite data before NBG0-3 and RBG0-1, but defer applying the window until after NBG and RBG are handled(so the sprite window
+   // bit in the sprite linebuffer data isn't trashed prematurely).
+   //
+   if(MDFN_LIKELY(UserLayerEnableMask & (1U << 6)))
    {
-    const bool igntp = (BGON >> 12) & 1;
-    const bool bmen = (CHCTLB >> 9) & 1;
-    const unsigned colornum = std::min<unsigned>(4, (CHCTLB >> 12) & 0x7);	// TODO: Test 5 ... 7
-    const unsigned priomode = (SFPRMD >> 8) & 0x3;
-    const unsigned ccmode = (CCCTL & 0x10) ? ((SFCCMD >> 8) & 0x3) : 0;
-    const uint32 prio = RBG0PrioNum;
-    uint32 pix_base_or;
-
-    pix_base_or = ((colornum >= 3) << PIX_ISRGB_SHIFT);
-    pix_base_or |= ((ColorOffsEn >> 4) & 1) << PIX_COE_SHIFT;
-    pix_base_or |= ((ColorOffsSel >> 4) & 1) << PIX_COSEL_SHIFT;
-    pix_base_or |= ((LineColorEn >> 4) & 1) << PIX_LCE_SHIFT;
-    pix_base_or |= RBG0CCRatio << PIX_CCRATIO_SHIFT;
-    pix_base_or |= (((CCCTL >> 12) & 0x7) == 0x1) << PIX_GRAD_SHIFT;
-    pix_base_or |= ((CCCTL >> 4) & 1) << PIX_LAYER_CCE_SHIFT;
-    pix_base_or |= ((SDCTL >> 4) & 1) << PIX_SHADEN_SHIFT;
-
-    if(ccmode == 0)
-     pix_base_or |= ((CCCTL >> 4) & 1) << PIX_CCE_SHIFT;
-
-    if(priomode >= 1)
-     pix_base_or |= ((prio &~ 1) << PIX_PRIO_SHIFT);
-    else
-     pix_base_or |= (prio << PIX_PRIO_SHIFT);
-
-    DrawRBG[bmen][colornum][igntp][priomode % 3][ccmode](0, LB.rbg0, rbg_w, pix_base_or);
-    RBGPP(4, LB.rbg0, rbg_w);
+    MakeSpriteCCLUT();
+    (this->*DrawSpriteData[(HRes & 0x2) >> 0x1][(SDCTL >> 8) & 0x1][SPCTL_Low])(LIB[vdp2_line].vdp1_line, LIB[vdp2_line].vdp1_hires8, w);
    }
    else
-    MDFN_FastArraySet(LB.rbg0, 0, w);
-
-   // RBG1
-   if(BGON & UserLayerEnableMask & 0x20)
+    MDFN_FastArraySet(LB.spr, 0, w);
+   //
+   //
+   //
+   //
+   //
+   //
+   //
+   if(BGON & 0x30)
    {
-    const bool igntp = (BGON >> 8) & 1;
-    const unsigned colornum = std::min<unsigned>(4, (CHCTLA >> 4) & 0x7);	// TODO: Test 5 ... 7
-    const unsigned priomode = (SFPRMD >> 0) & 0x3;
-    const unsigned ccmode = (CCCTL & 0x01) ? ((SFCCMD >> 0) & 0x3) : 0;
-    const uint32 prio = NBGPrioNum[0];
-    uint32 pix_base_or;
-
-    pix_base_or = (false << PIX_ISRGB_SHIFT);
-    pix_base_or |= ((ColorOffsEn >> 0) & 1) << PIX_COE_SHIFT;
-    pix_base_or |= ((ColorOffsSel >> 0) & 1) << PIX_COSEL_SHIFT;
-    pix_base_or |= ((LineColorEn >> 0) & 1) << PIX_LCE_SHIFT;
-    pix_base_or |= NBGCCRatio[0] << PIX_CCRATIO_SHIFT;
-    pix_base_or |= (((CCCTL >> 12) & 0x7) == 0x2) << PIX_GRAD_SHIFT;
-    pix_base_or |= ((CCCTL >> 0) & 1) << PIX_LAYER_CCE_SHIFT;
-    pix_base_or |= ((SDCTL >> 0) & 1) << PIX_SHADEN_SHIFT;
-
-    if(ccmode == 0)
-     pix_base_or |= ((CCCTL >> 0) & 1) << PIX_CCE_SHIFT;
-
-    if(priomode >= 1)
-     pix_base_or |= ((prio &~ 1) << PIX_PRIO_SHIFT);
+    MDFN_FastArraySet(LB.lc, CurLCColor & 0x7F, rbg_w);
+    SetupRotVars(LIB[vdp2_line].rv, rbg_w);
+    if(HRes & 0x2)
+     Doubleize(LB.lc, rbg_w);
+
+    // RBG0
+    if(MDFN_LIKELY(BGON & UserLayerEnableMask & 0x10))
+    {
+     const bool igntp = (BGON >> 12) & 1;
+     const bool bmen = (CHCTLB >> 9) & 1;
+     const unsigned colornum = std::min<unsigned>(4, (CHCTLB >> 12) & 0x7);	// TODO: Test 5 ... 7
+     const unsigned priomode = (SFPRMD >> 8) & 0x3;
+     const unsigned ccmode = (CCCTL & 0x10) ? ((SFCCMD >> 8) & 0x3) : 0;
+     const uint32 prio = RBG0PrioNum;
+     uint32 pix_base_or;
+
+     pix_base_or = ((colornum >= 3) << PIX_ISRGB_SHIFT);
+     pix_base_or |= ((ColorOffsEn >> 4) & 1) << PIX_COE_SHIFT;
+     pix_base_or |= ((ColorOffsSel >> 4) & 1) << PIX_COSEL_SHIFT;
+     pix_base_or |= ((LineColorEn >> 4) & 1) << PIX_LCE_SHIFT;
+     pix_base_or |= RBG0CCRatio << PIX_CCRATIO_SHIFT;
+     pix_base_or |= (((CCCTL >> 12) & 0x7) == 0x1) << PIX_GRAD_SHIFT;
+     pix_base_or |= ((CCCTL >> 4) & 1) << PIX_LAYER_CCE_SHIFT;
+     pix_base_or |= ((SDCTL >> 4) & 1) << PIX_SHADEN_SHIFT;
+
+     if(ccmode == 0)
+      pix_base_or |= ((CCCTL >> 4) & 1) << PIX_CCE_SHIFT;
+
+     if(priomode >= 1)
+      pix_base_or |= ((prio &~ 1) << PIX_PRIO_SHIFT);
+     else
+      pix_base_or |= (prio << PIX_PRIO_SHIFT);
+
+     (this->*DrawRBG[bmen][colornum][igntp][priomode % 3][ccmode])(0, LB.rbg0, rbg_w, pix_base_or);
+     RBGPP(4, LB.rbg0, rbg_w);
+    }
     else
-     pix_base_or |= (prio << PIX_PRIO_SHIFT);
+     MDFN_FastArraySet(LB.rbg0, 0, w);
+
+    // RBG1
+    if(BGON & UserLayerEnableMask & 0x20)
+    {
+     const bool igntp = (BGON >> 8) & 1;
+     const unsigned colornum = std::min<unsigned>(4, (CHCTLA >> 4) & 0x7);	// TODO: Test 5 ... 7
+     const unsigned priomode = (SFPRMD >> 0) & 0x3;
+     const unsigned ccmode = (CCCTL & 0x01) ? ((SFCCMD >> 0) & 0x3) : 0;
+     const uint32 prio = NBGPrioNum[0];
+     uint32 pix_base_or;
 
-    MDFN_FastArraySet(LB.rotabsel, 1, rbg_w);
-    DrawRBG[false][colornum][igntp][priomode % 3][ccmode](1, LB.nbg[0] + 8, rbg_w, pix_base_or);
-    RBGPP(0, LB.nbg[0] + 8, rbg_w);
+     pix_base_or = (false << PIX_ISRGB_SHIFT);
+     pix_base_or |= ((ColorOffsEn >> 0) & 1) << PIX_COE_SHIFT;
+     pix_base_or |= ((ColorOffsSel >> 0) & 1) << PIX_COSEL_SHIFT;
+     pix_base_or |= ((LineColorEn >> 0) & 1) << PIX_LCE_SHIFT;
+     pix_base_or |= NBGCCRatio[0] << PIX_CCRATIO_SHIFT;
+     pix_base_or |= (((CCCTL >> 12) & 0x7) == 0x2) << PIX_GRAD_SHIFT;
+     pix_base_or |= ((CCCTL >> 0) & 1) << PIX_LAYER_CCE_SHIFT;
+     pix_base_or |= ((SDCTL >> 0) & 1) << PIX_SHADEN_SHIFT;
+
+     if(ccmode == 0)
+      pix_base_or |= ((CCCTL >> 0) & 1) << PIX_CCE_SHIFT;
+
+     if(priomode >= 1)
+      pix_base_or |= ((prio &~ 1) << PIX_PRIO_SHIFT);
+     else
+      pix_base_or |= (prio << PIX_PRIO_SHIFT);
+
+     MDFN_FastArraySet(LB.rotabsel, 1, rbg_w);
+     (this->*DrawRBG[false][colornum][igntp][priomode % 3][ccmode])(1, LB.nbg[0] + 8, rbg_w, pix_base_or);
+     RBGPP(0, LB.nbg[0] + 8, rbg_w);
+    }
+    else if(BGON & 0x20)
+     MDFN_FastArraySet(LB.nbg[0] + 8, 0, w);
+   }
+   else
+   {
+    MDFN_FastArraySet(LB.lc, CurLCColor & 0x7F, w);
+    MDFN_FastArraySet(LB.rbg0, 0, w);
    }
-   else if(BGON & 0x20)
-    MDFN_FastArraySet(LB.nbg[0] + 8, 0, w);
-  }
-  else
-  {
-   MDFN_FastArraySet(LB.lc, CurLCColor & 0x7F, w);
-   MDFN_FastArraySet(LB.rbg0, 0, w);
   }
   //
   //
@@ -3033,121 +3101,124 @@ static NO_INLINE void DrawLine(const uint16 out_line, const uint16 vdp2_line, co
   if(SCRCTL & 0x0101)
    FetchVCScroll(w);	// Call after handling line scroll, and before DrawNBG() stuff
 
-  if((BGON & 0x30) != 0x30)
+  if(render)
   {
-   for(unsigned n = (bool)(BGON & 0x20); n < 4; n++)
+   if((BGON & 0x30) != 0x30)
    {
-    if(((BGON >> n) & 1) && MDFN_LIKELY((UserLayerEnableMask >> n) & 1))
+    for(unsigned n = (bool)(BGON & 0x20); n < 4; n++)
     {
-     const bool igntp = (BGON >> (n + 8)) & 1;
-     bool bmen = false;
-     unsigned colornum;
-     unsigned priomode;
-     unsigned ccmode;
-
-     if(n < 2)
+     if(((BGON >> n) & 1) && MDFN_LIKELY((UserLayerEnableMask >> n) & 1))
      {
-      const unsigned nshift = (n & 1) << 3;
-
-      bmen = (CHCTLA >> (1 + nshift)) & 1;
-      colornum = (CHCTLA >> (4 + nshift)) & (n ? 0x3 : 0x7);
-     }
-     else	// n >= 2
-     {
-      const unsigned nshift = (n & 1) << 2;
-
-      colornum = (CHCTLB >> (1 + nshift)) & 1;
-     }
-
-     if(colornum > 4) // TODO: test 5 ... 7
-      colornum = 4;
+      const bool igntp = (BGON >> (n + 8)) & 1;
+      bool bmen = false;
+      unsigned colornum;
+      unsigned priomode;
+      unsigned ccmode;
 
-     priomode = (SFPRMD >> (n << 1)) & 0x3;
-     ccmode = (SFCCMD >> (n << 1)) & 0x3;
-     if(!((CCCTL >> n) & 1))
-      ccmode = 0;
-     //
-     //
-     const uint32 prio = NBGPrioNum[n];
-     uint32 pix_base_or;
-
-     pix_base_or = ((colornum >= 3) << PIX_ISRGB_SHIFT);
-     pix_base_or |= ((ColorOffsEn >> n) & 1) << PIX_COE_SHIFT;
-     pix_base_or |= ((ColorOffsSel >> n) & 1) << PIX_COSEL_SHIFT;
-     pix_base_or |= ((LineColorEn >> n) & 1) << PIX_LCE_SHIFT;
-     pix_base_or |= NBGCCRatio[n] << PIX_CCRATIO_SHIFT;
-     pix_base_or |= (((CCCTL >> 12) & 0x7) == (3 + n - !n)) << PIX_GRAD_SHIFT;
-     pix_base_or |= ((CCCTL >> n) & 1) << PIX_LAYER_CCE_SHIFT;
-     pix_base_or |= ((SDCTL >> n) & 1) << PIX_SHADEN_SHIFT;
+      if(n < 2)
+      {
+       const unsigned nshift = (n & 1) << 3;
 
-     if(ccmode == 0)
-      pix_base_or |= ((CCCTL >> n) & 1) << PIX_CCE_SHIFT;
+       bmen = (CHCTLA >> (1 + nshift)) & 1;
+       colornum = (CHCTLA >> (4 + nshift)) & (n ? 0x3 : 0x7);
+      }
+      else	// n >= 2
+      {
+       const unsigned nshift = (n & 1) << 2;
 
-     if(priomode >= 1)
-      pix_base_or |= ((prio &~ 1) << PIX_PRIO_SHIFT);
-     else
-      pix_base_or |= (prio << PIX_PRIO_SHIFT);
+       colornum = (CHCTLB >> (1 + nshift)) & 1;
+      }
 
-     if(n < 2)
-      DrawNBG[bmen][colornum][igntp][priomode % 3][ccmode](n, LB.nbg[n] + 8, w, pix_base_or);
+      if(colornum > 4) // TODO: test 5 ... 7
+       colornum = 4;
+
+      priomode = (SFPRMD >> (n << 1)) & 0x3;
+      ccmode = (SFCCMD >> (n << 1)) & 0x3;
+      if(!((CCCTL >> n) & 1))
+       ccmode = 0;
+      //
+      //
+      const uint32 prio = NBGPrioNum[n];
+      uint32 pix_base_or;
+
+      pix_base_or = ((colornum >= 3) << PIX_ISRGB_SHIFT);
+      pix_base_or |= ((ColorOffsEn >> n) & 1) << PIX_COE_SHIFT;
+      pix_base_or |= ((ColorOffsSel >> n) & 1) << PIX_COSEL_SHIFT;
+      pix_base_or |= ((LineColorEn >> n) & 1) << PIX_LCE_SHIFT;
+      pix_base_or |= NBGCCRatio[n] << PIX_CCRATIO_SHIFT;
+      pix_base_or |= (((CCCTL >> 12) & 0x7) == (3 + n - !n)) << PIX_GRAD_SHIFT;
+      pix_base_or |= ((CCCTL >> n) & 1) << PIX_LAYER_CCE_SHIFT;
+      pix_base_or |= ((SDCTL >> n) & 1) << PIX_SHADEN_SHIFT;
+
+      if(ccmode == 0)
+       pix_base_or |= ((CCCTL >> n) & 1) << PIX_CCE_SHIFT;
+
+      if(priomode >= 1)
+       pix_base_or |= ((prio &~ 1) << PIX_PRIO_SHIFT);
+      else
+       pix_base_or |= (prio << PIX_PRIO_SHIFT);
+
+      if(n < 2)
+       (this->*DrawNBG[bmen][colornum][igntp][priomode % 3][ccmode])(n, LB.nbg[n] + 8, w, pix_base_or);
+      else
+       (this->*DrawNBG23[colornum][igntp][priomode % 3][ccmode])(n, LB.nbg[n] + 8, w, pix_base_or);
+
+      ApplyHMosaic(n, LB.nbg[n] + 8, w);
+      ApplyWin(n, LB.nbg[n] + 8);
+     }
      else
-      DrawNBG23[colornum][igntp][priomode % 3][ccmode](n, LB.nbg[n] + 8, w, pix_base_or);
-
-     ApplyHMosaic(n, LB.nbg[n] + 8, w);
-     ApplyWin(n, LB.nbg[n] + 8);
+      MDFN_FastArraySet(LB.nbg[n] + 8, 0, w);
     }
-    else
-     MDFN_FastArraySet(LB.nbg[n] + 8, 0, w);
    }
-  }
 
-  //
-  //
-  //
-  //
-  //
-  // Apply window to sprite linebuffer after BG layers have windows applied.
-  ApplyWin(WINLAYER_SPRITE, LB.spr);
+   //
+   //
+   //
+   //
+   //
+   // Apply window to sprite linebuffer after BG layers have windows applied.
+   ApplyWin(WINLAYER_SPRITE, LB.spr);
 
-  //
-  for(int32 i = 0; i < tvxo; i++)
-   target[i] = border_ncf;
+   //
+   for(int32 i = 0; i < tvxo; i++)
+    target[i] = border_ncf;
 
-  for(int32 i = tvxo + w; i < tvdw; i++)
-   target[i] = border_ncf;
+   for(int32 i = tvxo + w; i < tvdw; i++)
+    target[i] = border_ncf;
 
-  {
-   const bool rbgdualen = ((BGON & 0x30) == 0x30);
-   unsigned special = MIXIT_SPECIAL_NONE;
-   const bool CCRTMD = (bool)(CCCTL & 0x0200);
-   const bool CCMD = (bool)(CCCTL & 0x0100);
-   static const uint64* blurremap[8] = { LB.spr, LB.rbg0, LB.nbg[0] + 8, /*Dummy:*/LB.spr,
-					 LB.nbg[1] + 8, LB.nbg[2] + 8, LB.nbg[3] + 8, /*Dummy:*/LB.spr
-				       };
-   const uint64* blursrc = blurremap[(CCCTL >> 12) & 0x7];
-
-   if(!(HRes & 0x6))
    {
-    if(CCCTL & 0x8000)
+    const bool rbgdualen = ((BGON & 0x30) == 0x30);
+    unsigned special = MIXIT_SPECIAL_NONE;
+    const bool CCRTMD = (bool)(CCCTL & 0x0200);
+    const bool CCMD = (bool)(CCCTL & 0x0100);
+    const uint64* const blurremap[8] = { LB.spr, LB.rbg0, LB.nbg[0] + 8, /*Dummy:*/LB.spr,
+ 					 LB.nbg[1] + 8, LB.nbg[2] + 8, LB.nbg[3] + 8, /*Dummy:*/LB.spr
+ 				       };
+    const uint64* blursrc = blurremap[(CCCTL >> 12) & 0x7];
+
+    if(!(HRes & 0x6))
     {
-     if(CRAM_Mode == 0)
-      special = MIXIT_SPECIAL_GRAD;
+     if(CCCTL & 0x8000)
+     {
+      if(CRAM_Mode == 0)
+       special = MIXIT_SPECIAL_GRAD;
+     }
+     else if(CCCTL & 0x0400)
+     {
+      special = 0x2;
+      special += (bool)CRAM_Mode;
+      special += (CCCTL >> 4) & 0x2;
+     }
     }
-    else if(CCCTL & 0x0400)
+    else
     {
-     special = 0x2;
-     special += (bool)CRAM_Mode;
-     special += (CCCTL >> 4) & 0x2;
+     if(CRAM_Mode)
+      special = MIXIT_SPECIAL_HIRES_CRAM12;
     }
-   }
-   else
-   {
-    if(CRAM_Mode)
-     special = MIXIT_SPECIAL_HIRES_CRAM12;
-   }
 
-   MixIt[rbgdualen][special][CCRTMD][CCMD](target + tvxo, vdp2_line, w, back_rgb24, blursrc);
-   ReorderRGB(target + tvxo, w, espec->surface->format.Rshift, espec->surface->format.Gshift, espec->surface->format.Bshift);
+    (this->*MixIt[rbgdualen][special][CCRTMD][CCMD])(target + tvxo, vdp2_line, w, back_rgb24, blursrc);
+    ReorderRGB(target + tvxo, w, espec->surface->format.Rshift, espec->surface->format.Gshift, espec->surface->format.Bshift);
+   }
   }
 
   //
@@ -3170,7 +3241,7 @@ static NO_INLINE void DrawLine(const uint16 out_line, const uint16 vdp2_line, co
  //
  //
  //
- if(DoHBlend)
+ if(render && DoHBlend)
  {
   espec->LineWidths[out_line] = ApplyHBlend(espec->surface->pixels + out_line * espec->surface->pitchinpix + espec->DisplayRect.x, espec->LineWidths[out_line]);
 
@@ -3182,7 +3253,21 @@ static NO_INLINE void DrawLine(const uint16 out_line, const uint16 vdp2_line, co
 //
 //
 //
-static MThreading::Thread* RThread = NULL;
+//
+// Rendering is split across up to 4 worker threads(ss.vdp2_threads), each with its own copy of the renderer state.  Every
+// worker consumes every entry in the write queue, so each sees the same register, VRAM, and CRAM writes at the same
+// points between lines, but only the worker that owns a line's band actually draws it; the others just advance the
+// per-line state(line scroll, line window, back and line color table addresses, vertical cell scroll, etc.) that the
+// next line depends on.
+//
+static const unsigned MaxWorkers = 4;
+static const unsigned LineBandShift = 4;	// 16 output lines per band.
+static const unsigned LineTimeHistSize = 10;
+
+static INLINE bool LineBandOwner(const uint16 out_line, const unsigned num_workers, const unsigned index)
+{
+ return ((out_line >> LineBandShift) % num_workers) == index;
+}
 
 enum
 {
@@ -3206,18 +3291,36 @@ struct WQ_Entry
  uint32 Arg32;
 };
 
+struct Worker
+{
+ Renderer* R;
+ MThreading::Thread* Thread;
+ MThreading::Sem* WakeupSem;
+ unsigned Index;
+
+ size_t ReadPos;
+ std::atomic_uint_least32_t InCount;
+ bool DoBusyWait;
+
+ // Time spent drawing each line this worker owns, in power-of-2 microsecond buckets: [0, 1), [1, 2), [2, 4), ..., [256, inf)
+ uint64 LineTimeHist[LineTimeHistSize];
+};
+
 static std::array<WQ_Entry, 0x80000> WQ;
-static size_t WQ_ReadPos, WQ_WritePos;
-static std::atomic_uint_least32_t WQ_InCount;
-static std::atomic_int_least32_t DrawCounter;
-static bool DoBusyWait;
-static MThreading::Sem* WakeupSem;
+static size_t WQ_WritePos;
+static Worker Workers[MaxWorkers];
+static unsigned NumWorkers = 0;
+static std::atomic_int_least32_t DrawCounter;	// Incremented by NumWorkers per line.
 static bool DoWakeupIfNecessary;
+static uint32 LIBPending[256 / 32];	// LIB[] entries handed off to the workers since they were last drained.
 
 static INLINE void WWQ(uint16 command, uint32 arg32 = 0, uint16 arg16 = 0)
 {
- while(MDFN_UNLIKELY(WQ_InCount.load(std::memory_order_acquire) == WQ.size()))
-  Time::SleepMS(1);
+ for(unsigned i = 0; i < NumWorkers; i++)
+ {
+  while(MDFN_UNLIKELY(Workers[i].InCount.load(std::memory_order_acquire) == WQ.size()))
+   Time::SleepMS(1);
+ }
 
  WQ_Entry* wqe = &WQ[WQ_WritePos];
 
@@ -3226,19 +3329,30 @@ static INLINE void WWQ(uint16 command, uint32 arg32 = 0, uint16 arg16 = 0)
  wqe->Arg32 = arg32;
 
  WQ_WritePos = (WQ_WritePos + 1) % WQ.size();
- WQ_InCount.fetch_add(1, std::memory_order_release);
+
+ for(unsigned i = 0; i < NumWorkers; i++)
+  Workers[i].InCount.fetch_add(1, std::memory_order_release);
+}
+
+static INLINE void WakeupWorkers(void)
+{
+ for(unsigned i = 0; i < NumWorkers; i++)
+  MThreading::Sem_Post(Workers[i].WakeupSem);
 }
 
 static int RThreadEntry(void* data)
 {
+ Worker* const w = (Worker*)data;
+ Renderer* const r = w->R;
+ const unsigned num_workers = NumWorkers;
  bool Running = true;
 
  while(MDFN_LIKELY(Running))
  {
-  while(MDFN_UNLIKELY(WQ_InCount.load(std::memory_order_acquire) == 0))
+  while(MDFN_UNLIKELY(w->InCount.load(std::memory_order_acquire) == 0))
   {
-   if(!DoBusyWait)
-    MThreading::Sem_TimedWait(WakeupSem, 1);
+   if(!w->DoBusyWait)
+    MThreading::Sem_TimedWait(w->WakeupSem, 1);
    else
    {
 #ifdef MDFN_SS_BUSYWAIT_PAUSE
@@ -3258,35 +3372,51 @@ static int RThreadEntry(void* data)
   //
   //
   //
-  WQ_Entry* wqe = &WQ[WQ_ReadPos];
+  WQ_Entry* wqe = &WQ[w->ReadPos];
 
   switch(wqe->Command)
   {
    case COMMAND_WRITE8:
-	MemW<uint8>(wqe->Arg32, wqe->Arg16);
+	r->MemW<uint8>(wqe->Arg32, wqe->Arg16);
 	break;
 
    case COMMAND_WRITE16:
-	MemW<uint16>(wqe->Arg32, wqe->Arg16);
+	r->MemW<uint16>(wqe->Arg32, wqe->Arg16);
 	break;
 
    case COMMAND_DRAW_LINE:
-	//for(unsigned i = 0; i < 2; i++)
-	DrawLine((uint16)wqe->Arg32, wqe->Arg32 >> 16, wqe->Arg16);
+	{
+	 const uint16 out_line = (uint16)wqe->Arg32;
+
+	 if(num_workers == 1)
+	  r->DrawLine(out_line, wqe->Arg32 >> 16, wqe->Arg16, true);
+	 else if(LineBandOwner(out_line, num_workers, w->Index))
+	 {
+	  const int64 start_time = Time::MonoUS();
+
+	  r->DrawLine(out_line, wqe->Arg32 >> 16, wqe->Arg16, true);
+
+	  const uint32 line_time = std::min<int64>(0xFFFFFFFF, Time::MonoUS() - start_time);
+
+	  w->LineTimeHist[std::min<unsigned>(LineTimeHistSize - 1, 32 - MDFN_lzcount32(line_time))]++;
+	 }
+	 else
+	  r->DrawLine(out_line, wqe->Arg32 >> 16, wqe->Arg16, false);
+	}
 	//
 	DrawCounter.fetch_sub(1, std::memory_order_release);
 	break;
 
    case COMMAND_RESET:
-	Reset(wqe->Arg32);
+	r->Reset(wqe->Arg32);
 	break;
 
    case COMMAND_SET_LEM:
-	UserLayerEnableMask = wqe->Arg32;
+	r->UserLayerEnableMask = wqe->Arg32;
 	break;
 
    case COMMAND_SET_BUSYWAIT:
-	DoBusyWait = wqe->Arg32;
+	w->DoBusyWait = wqe->Arg32;
 	break;
 
    case COMMAND_EXIT:
@@ -3296,8 +3426,8 @@ static int RThreadEntry(void* data)
   //
   //
   //
-  WQ_ReadPos = (WQ_ReadPos + 1) % WQ.size();
-  WQ_InCount.fetch_sub(1, std::memory_order_release);
+  w->ReadPos = (w->ReadPos + 1) % WQ.size();
+  w->InCount.fetch_sub(1, std::memory_order_release);
  }
 
  return 0;
@@ -3309,23 +3439,48 @@ static int RThreadEntry(void* data)
 //
 //
 //
-void VDP2REND_Init(const bool IsPAL, const uint64 affinity)
+void VDP2REND_Init(const bool IsPAL, const unsigned num_threads, const uint64* affinity)
 {
+ assert(num_threads >= 1 && num_threads <= MaxWorkers);
+ //
  PAL = IsPAL;
  VisibleLines = PAL ? 288 : 240;
  //
- UserLayerEnableMask = ~0U;
  Clock28M = false;
  //
- WQ_ReadPos = 0;
  WQ_WritePos = 0;
- WQ_InCount.store(0, std::memory_order_release); 
  DrawCounter.store(0, std::memory_order_release);
+ NumWorkers = num_threads;
+
+ for(unsigned i = 0; i < NumWorkers; i++)
+ {
+  Worker* const w = &Workers[i];
+
+  w->R = new Renderer();
+  w->R->UserLayerEnableMask = ~0U;
+  w->Thread = NULL;
+  w->WakeupSem = MThreading::Sem_Create();
+  w->Index = i;
+  w->ReadPos = 0;
+  w->InCount.store(0, std::memory_order_release);
+  w->DoBusyWait = false;
+  memset(w->LineTimeHist, 0, sizeof(w->LineTimeHist));
+ }
+
+ for(unsigned i = 0; i < NumWorkers; i++)
+ {
+  Worker* const w = &Workers[i];
+  char name[32];
 
- WakeupSem = MThreading::Sem_Create();
- RThread = MThreading::Thread_Create(RThreadEntry, NULL, "MDFN VDP2 Render");
- if(affinity)
-  MThreading::Thread_SetAffinity(RThread, affinity);
+  if(i)
+   snprintf(name, sizeof(name), "MDFN VDP2 Render %u", i);
+  else
+   snprintf(name, sizeof(name), "MDFN VDP2 Render");
+
+  w->Thread = MThreading::Thread_Create(RThreadEntry, w, name);
+  if(affinity[i])
+   MThreading::Thread_SetAffinity(w->Thread, affinity[i]);
+ }
 }
 
 // Needed for ss.correct_aspect == 0
@@ -3385,18 +3540,65 @@ void VDP2REND_SetGetVideoParams(MDFNGI* gi, const bool caspect, const int sls, c
  }
 }
 
-void VDP2REND_Kill(void)
+static void PrintLineTimeHist(void)
 {
- if(RThread != NULL)
+ MDFN_printf(_("VDP2 line render times(microseconds):\n"));
+ MDFN_AutoIndent aind(1);
+
+ for(unsigned b = 0; b < LineTimeHistSize; b++)
  {
-  WWQ(COMMAND_EXIT);
-  MThreading::Thread_Wait(RThread, NULL);
+  char range[32];
+
+  if(!b)
+   snprintf(range, sizeof(range), "<1");
+  else if(b == (LineTimeHistSize - 1))
+   snprintf(range, sizeof(range), ">=%u", 1U << (b - 1));
+  else
+   snprintf(range, sizeof(range), "%u-%u", 1U << (b - 1), (2U << (b - 1)) - 1);
+
+  MDFN_printf("%-8s", range);
+
+  for(unsigned i = 0; i < NumWorkers; i++)
+   MDFN_printf(" %12llu", (unsigned long long)Workers[i].LineTimeHist[b]);
+
+  MDFN_printf("\n");
  }
+}
 
- if(WakeupSem != NULL)
+void VDP2REND_Kill(void)
+{
+ if(NumWorkers)
  {
-  MThreading::Sem_Destroy(WakeupSem);
-  WakeupSem = NULL;
+  WWQ(COMMAND_EXIT);
+
+  for(unsigned i = 0; i < NumWorkers; i++)
+  {
+   if(Workers[i].Thread != NULL)
+   {
+    MThreading::Thread_Wait(Workers[i].Thread, NULL);
+    Workers[i].Thread = NULL;
+   }
+  }
+
+  if(NumWorkers > 1)
+   PrintLineTimeHist();
+
+  for(unsigned i = 0; i < NumWorkers; i++)
+  {
+   if(Workers[i].WakeupSem != NULL)
+   {
+    MThreading::Sem_Destroy(Workers[i].WakeupSem);
+    Workers[i].WakeupSem = NULL;
+   }
+
+   if(Workers[i].R != NULL)
+   {
+    delete Workers[i].R;
+    Workers[i].R = NULL;
+   }
+  }
+
+  NumWorkers = 0;
  }
 }
 
@@ -3430,6 +3632,8 @@ void VDP2REND_EndFrame(void)
   //Time::SleepMS(1);
  }
 
+ memset(LIBPending, 0, sizeof(LIBPending));
+
  WWQ(COMMAND_SET_BUSYWAIT, false);
 
  if(NextOutLine < VisibleLines)
@@ -3456,6 +3660,20 @@ VDP2Rend_LIB* VDP2REND_GetLIB(unsigned line)
 {
  assert(line < (PAL ? 256 : 240)); // NO: VisibleLines);
 
+ //
+ // VCounter can come back around to a line without passing through VDP2REND_EndFrame() when TVMD is changed at an inopportune
+ // time, so wait for the workers to catch up rather than overwrite an entry that one of them may not have read yet.
+ //
+ if(MDFN_UNLIKELY((LIBPending[line >> 5] >> (line & 0x1F)) & 1))
+ {
+  WakeupWorkers();
+  while(DrawCounter.load(std::memory_order_acquire) != 0)
+  {
+   //
+  }
+  memset(LIBPending, 0, sizeof(LIBPending));
+ }
+
  return &LIB[line];
 }
 
@@ -3470,14 +3688,17 @@ void VDP2REND_DrawLine(const int vdp2_line, const uint32 crt_line, const bool fi
   if(espec->InterlaceOn)
    out_line = (out_line << 1) | espec->InterlaceField;
 
-  auto wdcq = DrawCounter.fetch_add(1, std::memory_order_release);
+  auto wdcq = DrawCounter.fetch_add(NumWorkers, std::memory_order_release) / NumWorkers;
   WWQ(COMMAND_DRAW_LINE, ((uint16)vdp2_line << 16) | out_line, field);
+
+  if(vdp2_line >= 0)
+   LIBPending[vdp2_line >> 5] |= 1U << (vdp2_line & 0x1F);
   //
   //
   if(crt_line == bwthresh)
   {
    WWQ(COMMAND_SET_BUSYWAIT, true);
-   MThreading::Sem_Post(WakeupSem);
+   WakeupWorkers();
   }
   else if(crt_line < bwthresh)
   {
@@ -3486,7 +3707,7 @@ void VDP2REND_DrawLine(const int vdp2_line, const uint32 crt_line, const bool fi
    else if((wdcq + 1) >= 64 && DoWakeupIfNecessary)
    {
     //printf("Post Wakeup: %3d --- crt_line=%3d\n", wdcq + 1, crt_line);
-    MThreading::Sem_Post(WakeupSem);
+    WakeupWorkers();
     DoWakeupIfNecessary = false;
    }
   }
@@ -3521,13 +3742,8 @@ void VDP2REND_Write16_DB(uint32 A, uint16 DB)
  // MemW<uint16>(A, DB);
 }
 
-void VDP2REND_StateAction(StateMem* sm, const unsigned load, const bool data_only, uint16 (&rr)[0x100], uint16 (&cr)[2048], uint16 (&vr)[262144])
+void Renderer::StateAction(StateMem* sm, const unsigned load, const bool data_only, uint16 (&rr)[0x100], uint16 (&cr)[2048], uint16 (&vr)[262144])
 {
- while(MDFN_UNLIKELY(WQ_InCount.load(std::memory_order_acquire) != 0))
-  Time::SleepMS(1);
- //
- //
- //
  SFORMAT StateRegs[] =
  {
   SFVAR(Clock28M),	// DUBIOUS
@@ -3583,4 +3799,23 @@ void VDP2REND_StateAction(StateMem* sm, const unsigned load, const bool data_onl
  }
 }
 
+void VDP2REND_StateAction(StateMem* sm, const unsigned load, const bool data_only, uint16 (&rr)[0x100], uint16 (&cr)[2048], uint16 (&vr)[262144])
+{
+ for(unsigned i = 0; i < NumWorkers; i++)
+ {
+  while(MDFN_UNLIKELY(Workers[i].InCount.load(std::memory_order_acquire) != 0))
+   Time::SleepMS(1);
+ }
+ //
+ //
+ //
+ Workers[0].R->StateAction(sm, load, data_only, rr, cr, vr);
+
+ if(load)
+ {
+  for(unsigned i = 1; i < NumWorkers; i++)
+   *Workers[i].R = *Workers[0].R;
+ }
+}
+
 }
@@ -18,5 +18,16 @@ typedef struct
  uint32 w, h;
 } StateStatusStruct;
 
+//
+// Compression applied to save states written to files or memory buffers; also the values of the "filesys.state_comp_type"
+// setting.  The type is autodetected on load.
+//
+enum : unsigned
+{
+ MDFNSS_COMP_NONE = 0,
+ MDFNSS_COMP_ZSTD,
+ MDFNSS_COMP_GZIP
+};
+
 }
 #endif
@@ -6,6 +6,8 @@
 
 namespace Mednafen
 {
+class MemoryStream;
+
 //
 // "fname", when non-NULL, overrides the default save state filename generation.
 // "suffix", when non-NULL, just override the default suffix(mc0-mc9).
@@ -15,6 +17,35 @@ namespace Mednafen
 bool MDFNI_SaveState(const char *fname, const char *suffix, const MDFN_Surface *surface, const MDFN_Rect *DisplayRect, const int32 *LineWidths) noexcept;
 bool MDFNI_LoadState(const char *fname, const char *suffix) noexcept;
 
+//
+// Like MDFNI_SaveState(), but serializes into the caller-owned "dest" instead of a file, compressed with "comp"(MDFNSS_COMP_*).
+// "dest" is truncated first, so its allocation is reused when the same MemoryStream is passed in each time.
+//
+bool MDFNI_SaveStateMem(MemoryStream* dest, const unsigned comp, const MDFN_Surface *surface, const MDFN_Rect *DisplayRect, const int32 *LineWidths) noexcept;
+
+//
+// Loads a save state from memory(such as an mmap()'d file); the compression type is autodetected.  "scratch", when non-NULL, is used to hold
+// decompressed data, so its allocation can be reused.
+//
+bool MDFNI_LoadStateMem(const void* data, uint64 size, MemoryStream* scratch = nullptr) noexcept;
+
+//
+// Serializes the state synchronously, but compresses it with "comp" and writes it to "fname" on a worker thread.  Saves are
+// completed in the order they were started.
+//
+// "callback", when non-NULL, is called from the worker thread once the file has been written, with "error" set to NULL on success,
+// or to an error message otherwise.
+//
+// Returns false(and doesn't call "callback") if the state couldn't be serialized.
+//
+bool MDFNI_SaveStateAsync(const char* fname, const unsigned comp, void (*callback)(void* cb_data, const char* error), void* cb_data) noexcept;
+
+//
+// Waits for all pending MDFNI_SaveStateAsync() saves to finish.  Called automatically by MDFNI_LoadState(), but must be called
+// before reading a state file through other means.
+//
+void MDFNI_FlushStateSaves(void) noexcept;
+
 void MDFNI_SelectState(int) noexcept;
 
 void MDFND_SetStateStatus(StateStatusStruct *status) noexcept;
@@ -18,20 +18,30 @@
 #include "mednafen.h"
 
 #include <map>
+#include <atomic>
+#include <functional>
+#include <thread>
 
 #include <mednafen/Time.h>
+#include <mednafen/MThreading.h>
 
 #include "driver.h"
 #include "general.h"
 #include "state.h"
+#include "state-driver.h"
 #include "movie.h"
 #include "netplay.h"
 #include "video.h"
 #include "video/resize.h"
 
 #include "MemoryStream.h"
+#include "ExtMemStream.h"
+#include "FileStream.h"
 #include "compress/GZFileStream.h"
 
+#include <zlib.h>
+#include <zstd/zstd.h>
+
 namespace Mednafen
 {
 
@@ -40,6 +50,108 @@ struct StateSectionMapEntry
  uint64 pos;
  uint32 size;
  bool used;
+ bool has_hash;	// Only for sections listed in the table of contents.
+ uint64 hash;
+};
+
+struct StateTOCEntry
+{
+ char name[32];
+ uint32 offs;	// Relative to the start of the save state.
+ uint32 size;
+ uint64 hash;
+};
+
+//
+// Save states(data_only == false) end with a table of contents section, listing the position, size, and a hash of the data of every
+// other section, followed by a fixed-size trailer so it can be found from the end of the state.  Older versions just see an extra
+// unused section.
+//
+static const char StateTOCName[32] = "MDFNSS_TOC";
+static const uint8 StateTOCMagic[4] = { 'S', 'T', 'O', 'C' };
+static const unsigned StateTOCEntrySize = 32 + 4 + 4 + 8;
+static const unsigned StateTOCTrailerSize = 4 + 4;
+
+//
+// Fast, non-cryptographic, 64-bit hash of serialized section data; incremental, and independent of how the data is split
+// across update() calls.  Four independent lanes, so it's not bound by multiply latency.
+//
+struct StateHasher
+{
+ INLINE void update(const void* data, size_t len)
+ {
+  const uint8* d = (const uint8*)data;
+
+  total_len += len;
+
+  if(buf_len)
+  {
+   while(buf_len < sizeof(buf) && len)
+   {
+    buf[buf_len++] = *d++;
+    len--;
+   }
+
+   if(buf_len < sizeof(buf))
+    return;
+
+   Stripe(buf);
+   buf_len = 0;
+  }
+
+  while(len >= sizeof(buf))
+  {
+   Stripe(d);
+   d += sizeof(buf);
+   len -= sizeof(buf);
+  }
+
+  memcpy(buf, d, len);
+  buf_len = len;
+ }
+
+ uint64 finish(void)
+ {
+  uint64 ret = total_len;
+
+  memset(buf + buf_len, 0, sizeof(buf) - buf_len);
+  Stripe(buf);
+
+  for(unsigned i = 0; i < 4; i++)
+  {
+   ret ^= lane[i];
+   ret ^= ret >> 33;
+   ret *= 0xFF51AFD7ED558CCDULL;
+   ret ^= ret >> 33;
+   ret *= 0xC4CEB9FE1A85EC53ULL;
+   ret ^= ret >> 33;
+  }
+
+  return ret;
+ }
+
+ uint64 total_len = 0;
+
+ private:
+
+ static INLINE uint64 Round(uint64 acc, const uint64 w)
+ {
+  acc += w * 0xC2B2AE3D27D4EB4FULL;
+  acc = (acc << 31) | (acc >> 33);
+  acc *= 0x9E3779B185EBCA87ULL;
+
+  return acc;
+ }
+
+ INLINE void Stripe(const uint8* d)
+ {
+  for(unsigned i = 0; i < 4; i++)
+   lane[i] = Round(lane[i], MDFN_de64lsb(d + i * 8));
+ }
+
+ uint64 lane[4] = { 0x60EA27EEADC0B5D6ULL, 0xC2B2AE3D27D4EB4FULL, 0x0000000000000000ULL, 0x61C8864E7A143579ULL };
+ uint8 buf[32];
+ size_t buf_len = 0;
 };
 
 struct StateMem
@@ -53,6 +165,9 @@ struct StateMem
 
  std::map<std::string, StateSectionMapEntry> secmap; // For loads
 
+ int64 toc_base = -1;			// For saves; position of the start of the save state, or -1 if no table of contents is being built.
+ std::vector<StateTOCEntry> toc;
+
  std::exception_ptr deferred_error;
  void ThrowDeferred(void);
 };
@@ -71,7 +186,9 @@ static void MakeSectionMap(StateMem* sm, const uint64 sss_bound)
 
   sme.size = st->get_LE<uint32>();
   sme.pos = st->tell();
-  sme.used = false;
+  sme.used = !strncmp(sname_tmp, StateTOCName, 32);	// Only meaningful to ReadTOC().
+  sme.has_hash = false;
+  sme.hash = 0;
   st->seek(sme.size, SEEK_CUR);
   //
   std::string name_ss = sname_tmp;
@@ -83,9 +200,130 @@ static void MakeSectionMap(StateMem* sm, const uint64 sss_bound)
  }
 }
 
+//
+// Builds the section map from the table of contents, if the save state has a valid one, without walking the section data.
+// Returns false otherwise, and the caller should fall back to MakeSectionMap().
+//
+static bool ReadTOC(StateMem* sm, const uint64 start_pos, const uint64 sss_pos, const uint64 sss_bound)
+{
+ Stream* const st = sm->st;
+ uint8 trailer[StateTOCTrailerSize];
+ uint8 toc_header[32 + 4];
+ uint64 toc_pos;
+ uint32 count;
+
+ if((sss_bound - sss_pos) < sizeof(toc_header) + StateTOCTrailerSize)
+  return false;
+
+ st->seek(sss_bound - StateTOCTrailerSize, SEEK_SET);
+ st->read(trailer, sizeof(trailer));
+
+ if(memcmp(trailer + 4, StateTOCMagic, sizeof(StateTOCMagic)))
+  return false;
+
+ count = MDFN_de32lsb(trailer);
+
+ if(count > ((sss_bound - sss_pos - sizeof(toc_header) - StateTOCTrailerSize) / StateTOCEntrySize))
+  return false;
+
+ toc_pos = sss_bound - StateTOCTrailerSize - (uint64)count * StateTOCEntrySize;
+
+ st->seek(toc_pos - sizeof(toc_header), SEEK_SET);
+ st->read(toc_header, sizeof(toc_header));
+
+ if(memcmp(toc_header, StateTOCName, 32) || MDFN_de32lsb(toc_header + 32) != (sss_bound - toc_pos))
+  return false;
+ //
+ //
+ std::unique_ptr<uint8[]> toc(new uint8[(size_t)count * StateTOCEntrySize]);
+ std::map<std::string, StateSectionMapEntry> secmap;
+
+ st->read(toc.get(), (size_t)count * StateTOCEntrySize);
+
+ for(uint32 i = 0; i < count; i++)
+ {
+  const uint8* e = &toc[i * StateTOCEntrySize];
+  StateSectionMapEntry sme;
+  char sname_tmp[32 + 1];
+
+  memcpy(sname_tmp, e, 32);
+  sname_tmp[32] = 0;
+
+  sme.pos = start_pos + MDFN_de32lsb(e + 32);
+  sme.size = MDFN_de32lsb(e + 36);
+  sme.hash = MDFN_de64lsb(e + 40);
+  sme.has_hash = true;
+  sme.used = false;
+
+  if(sme.pos < (sss_pos + sizeof(toc_header)) || (sme.pos + sme.size) > (toc_pos - sizeof(toc_header)))
+   return false;
+  //
+  std::string name_ss = sname_tmp;
+
+  if(secmap.count(name_ss))
+   throw MDFN_Error(0, _("Duplicate section \"%s\" in save state!"), name_ss.c_str());
+  else
+   secmap[name_ss] = sme;
+ }
+
+ {
+  StateSectionMapEntry sme;
+
+  sme.pos = toc_pos;
+  sme.size = sss_bound - toc_pos;
+  sme.used = true;
+  sme.has_hash = false;
+  sme.hash = 0;
+
+  secmap[StateTOCName] = sme;
+ }
+
+ sm->secmap = std::move(secmap);
+
+ return true;
+}
+
+static void WriteTOC(StateMem* sm)
+{
+ Stream* const st = sm->st;
+ const uint32 toc_len = sm->toc.size() * StateTOCEntrySize + StateTOCTrailerSize;
+ std::unique_ptr<uint8[]> buf(new uint8[32 + 4 + toc_len]);
+ uint8* p = buf.get();
+
+ memcpy(p, StateTOCName, 32);
+ MDFN_en32lsb(p + 32, toc_len);
+ p += 32 + 4;
 
-static void SubWrite(Stream *st, const SFORMAT *sf)
+ for(const StateTOCEntry& e : sm->toc)
+ {
+  memcpy(p, e.name, 32);
+  MDFN_en32lsb(p + 32, e.offs);
+  MDFN_en32lsb(p + 36, e.size);
+  MDFN_en64lsb(p + 40, e.hash);
+  p += StateTOCEntrySize;
+ }
+
+ MDFN_en32lsb(p, sm->toc.size());
+ memcpy(p + 4, StateTOCMagic, sizeof(StateTOCMagic));
+
+ st->write(buf.get(), 32 + 4 + toc_len);
+}
+
+
+//
+// 'st' may be nullptr if only the hash is wanted.
+//
+static void SubWrite(Stream *st, const SFORMAT *sf, StateHasher* hasher = nullptr)
 {
+ auto out = [st, hasher](const void* data, size_t len)
+ {
+  if(st)
+   st->write(data, len);
+
+  if(hasher)
+   hasher->update(data, len);
+ };
+
  while(sf->size || sf->name)	// Size can sometimes be zero, so also check for the text name.  These two should both be zero only at the end of a struct.
  {
   if(!sf->size || !sf->data)
@@ -96,7 +334,7 @@ static void SubWrite(Stream *st, const SFORMAT *sf)
 
   if(sf->size == ~0U)		/* Link to another struct.	*/
   {
-   SubWrite(st, (const SFORMAT *)sf->data);
+   SubWrite(st, (const SFORMAT *)sf->data, hasher);
 
    sf++;
    continue;
@@ -115,8 +353,13 @@ static void SubWrite(Stream *st, const SFORMAT *sf)
   memcpy(&nameo[1], sf->name, slen);
   nameo[0] = slen;
 
-  st->write(nameo, 1 + nameo[0]);
-  st->put_LE<uint32>(bytesize * (repcount + 1));
+  out(nameo, 1 + nameo[0]);
+  {
+   uint8 size_tmp[4];
+
+   MDFN_en32lsb(size_tmp, bytesize * (repcount + 1));
+   out(size_tmp, 4);
+  }
 
   do
   {
@@ -127,12 +370,12 @@ static void SubWrite(Stream *st, const SFORMAT *sf)
     {
      uint8 tmp_bool = ((bool *)p)[bool_monster];
      //printf("Bool write: %.31s\n", sf->name);
-     st->write(&tmp_bool, 1);
+     out(&tmp_bool, 1);
     }
    }
    else
    {
-    st->write((void*)p, bytesize);
+    out((void*)p, bytesize);
    }
   } while(p += repstride, repcount--);
 
@@ -150,6 +393,27 @@ struct compare_cstr
 
 typedef std::map<const char *, const SFORMAT *, compare_cstr> SFMap_t;
 
+//
+// Counts variables and their total size, without touching the variables' data.
+//
+static void CountSF(const SFORMAT *sf, uint32* count, uint64* size)
+{
+ while(sf->size || sf->name)
+ {
+  if(sf->size && sf->data)
+  {
+   if(sf->size == ~0U)
+    CountSF((const SFORMAT *)sf->data, count, size);
+   else
+   {
+    (*count)++;
+    (*size) += (uint64)sf->size * (1 + sf->repcount);
+   }
+  }
+  sf++;
+ }
+}
+
 static void MakeSFMap(const SFORMAT *sf, SFMap_t &sfmap)
 {
  while(sf->size || sf->name) // Size can sometimes be zero, so also check for the text name.  These two should both be zero only at the end of a struct.
@@ -412,9 +676,36 @@ bool MDFNSS_StateAction(StateMem *sm, const unsigned load, const bool data_only,
     }
     else
     {
+     bool unchanged = false;
+
      msme->second.used = true;
-     st->seek(msme->second.pos, SEEK_SET);
-     ReadStateChunk(st, sf, sname, msme->second.size, sm->svbe, sm->fuzz);
+
+     //
+     // Skip sections whose data is identical to what the live state would serialize to.  Hashing is much cheaper than
+     // ReadStateChunk()'s per-variable lookups, but not than copying, so only bother for sections made up of many small
+     // variables(which tend to be the ones that don't change across repeated loads of the same state, anyway).
+     //
+     if(msme->second.has_hash && sm->fuzz == MDFNSS_FUZZ_DISABLED && sm->svbe == MDFN_IS_BIGENDIAN)
+     {
+      uint32 var_count = 0;
+      uint64 var_size = 0;
+
+      CountSF(sf, &var_count, &var_size);
+
+      if(var_count && (var_size / var_count) <= 4096)
+      {
+       StateHasher h;
+
+       SubWrite(nullptr, sf, &h);
+       unchanged = (h.total_len == msme->second.size && h.finish() == msme->second.hash);
+      }
+     }
+
+     if(!unchanged)
+     {
+      st->seek(msme->second.pos, SEEK_SET);
+      ReadStateChunk(st, sf, sname, msme->second.size, sm->svbe, sm->fuzz);
+     }
     }
    }
    else
@@ -435,8 +726,25 @@ bool MDFNSS_StateAction(StateMem *sm, const unsigned load, const bool data_only,
     st->put_LE<uint32>(0);                // We'll come back and write this later.
 
     data_start_pos = st->tell();
-    SubWrite(st, sf);
-    end_pos = st->tell();
+    if(sm->toc_base >= 0)
+    {
+     StateHasher h;
+     StateTOCEntry e;
+
+     SubWrite(st, sf, &h);
+     end_pos = st->tell();
+
+     memcpy(e.name, sname_tmp, 32);
+     e.offs = data_start_pos - sm->toc_base;
+     e.size = end_pos - data_start_pos;
+     e.hash = h.finish();
+     sm->toc.push_back(e);
+    }
+    else
+    {
+     SubWrite(st, sf);
+     end_pos = st->tell();
+    }
 
     st->seek(data_start_pos - 4, SEEK_SET);
     st->put_LE<uint32>(end_pos - data_start_pos);
@@ -568,8 +876,10 @@ void MDFNSS_SaveSM(Stream *st, bool data_only, const MDFN_Surface *surface, cons
           st->write((uint8*)dest_surface.pixels, 3 * neowidth * neoheight);
 	 }
 
+	 sm.toc_base = start_pos;
 	 MDFN_StateAction(&sm, 0, data_only);
 	 sm.ThrowDeferred();
+	 WriteTOC(&sm);
 
 	 {
 	  int64 end_pos = st->tell();
@@ -628,8 +938,13 @@ void MDFNSS_LoadSM(Stream *st, bool data_only, const int fuzz)
 
 	 {
 	  StateMem sm(st, svbe, fuzz);
+	  const uint64 sss_pos = st->tell();
 
-	  MakeSectionMap(&sm, start_pos + total_len);
+	  if(!ReadTOC(&sm, start_pos, sss_pos, start_pos + total_len))
+	  {
+	   st->seek(sss_pos, SEEK_SET);
+	   MakeSectionMap(&sm, start_pos + total_len);
+	  }
 
 	  MDFN_StateAction(&sm, stateversion, false);			// Load state data.
 
@@ -645,6 +960,600 @@ void MDFNSS_LoadSM(Stream *st, bool data_only, const int fuzz)
 	}
 }
 
+static const int StateZstdLevel = 1;
+
+unsigned MDFNSS_DetectComp(const void* data, uint64 size)
+{
+ const uint8* d = (const uint8*)data;
+
+ if(size >= 4 && MDFN_de32lsb(d) == 0xFD2FB528)
+  return MDFNSS_COMP_ZSTD;
+
+ if(size >= 2 && d[0] == 0x1F && d[1] == 0x8B)
+  return MDFNSS_COMP_GZIP;
+
+ return MDFNSS_COMP_NONE;
+}
+
+//
+// States larger than StateZstdChunkSize are split into independently-compressed frames, so that compression and decompression
+// can be spread across several threads(the bulk of e.g. a Saturn save state is work RAM, VDP1/VDP2 VRAM and the CD buffer, none
+// of which needs to be compressed as a whole to compress well).  The result is an ordinary multi-frame Zstandard stream, and every
+// frame records its decompressed size.
+//
+static const uint64 StateZstdChunkSize = 1U << 20;
+static const unsigned StateZstdMaxThreads = 8;
+
+//
+// Upper bound on the decompressed size of a save state, so that a corrupt or malicious state can't make MDFNSS_Decompress()
+// allocate an arbitrary amount of memory based on the sizes recorded in it.  The largest states(Saturn with an extended RAM
+// cartridge) are well under a tenth of this.
+//
+static const uint64 StateMaxDecompressedLen = 256U << 20;
+
+struct ZstdJobs
+{
+ std::function<void(unsigned, size_t)> func;	// (thread index, job index)
+ size_t count;
+
+ std::atomic<size_t> next;
+ std::atomic<bool> failed;
+ std::string error;	// Written once, by whichever job fails first.
+};
+
+struct ZstdWorker
+{
+ ZstdJobs* jobs;
+ unsigned index;
+};
+
+static unsigned ZstdThreadCount(const size_t count)
+{
+ const unsigned hc = std::max<unsigned>(1, std::thread::hardware_concurrency());
+
+ return std::max<size_t>(1, std::min<size_t>(count, std::min<unsigned>(hc, StateZstdMaxThreads)));
+}
+
+static int ZstdWorkerMain(void* arg)
+{
+ ZstdWorker* w = (ZstdWorker*)arg;
+ ZstdJobs* j = w->jobs;
+ size_t i;
+
+ while(!j->failed.load(std::memory_order_relaxed) && (i = j->next.fetch_add(1, std::memory_order_relaxed)) < j->count)
+ {
+  try
+  {
+   j->func(w->index, i);
+  }
+  catch(std::exception& e)
+  {
+   if(!j->failed.exchange(true))
+    j->error = e.what();
+  }
+ }
+
+ return 0;
+}
+
+//
+// Helper threads for RunZstdJobs() are started on first use and kept around until MDFNSS_EndZstdThreads(), so compressing or
+// decompressing a small state doesn't pay for creating and joining threads every time.  Only one caller at a time gets the
+// helpers; a concurrent caller(e.g. a synchronous save while an asynchronous one is being compressed) runs its jobs by itself.
+//
+struct ZstdHelper
+{
+ MThreading::Thread* thread;
+ MThreading::Sem* wakeup;
+ ZstdWorker worker;
+};
+
+static std::atomic_flag ZstdHelpersBusy = ATOMIC_FLAG_INIT;
+static ZstdHelper ZstdHelpers[StateZstdMaxThreads - 1];
+static unsigned ZstdNumHelpers = 0;
+static MThreading::Sem* ZstdDoneSem = nullptr;
+static bool ZstdHelpersExit = false;
+
+static int ZstdHelperMain(void* arg)
+{
+ ZstdHelper* h = (ZstdHelper*)arg;
+
+ for(;;)
+ {
+  MThreading::Sem_Wait(h->wakeup);
+
+  if(ZstdHelpersExit)
+   break;
+
+  ZstdWorkerMain(&h->worker);
+  MThreading::Sem_Post(ZstdDoneSem);
+ }
+
+ return 0;
+}
+
+static void StartZstdHelpers(const unsigned count)
+{
+ if(!ZstdDoneSem)
+  ZstdDoneSem = MThreading::Sem_Create();
+
+ while(ZstdNumHelpers < count)
+ {
+  ZstdHelper* h = &ZstdHelpers[ZstdNumHelpers];
+
+  h->wakeup = MThreading::Sem_Create();
+
+  try
+  {
+   h->thread = MThreading::Thread_Create(ZstdHelperMain, h, "MDFN State Zstd");
+  }
+  catch(...)
+  {
+   MThreading::Sem_Destroy(h->wakeup);
+   h->wakeup = nullptr;
+   throw;
+  }
+
+  ZstdNumHelpers++;
+ }
+}
+
+void MDFNSS_EndZstdThreads(void) noexcept
+{
+ while(ZstdHelpersBusy.test_and_set(std::memory_order_acquire))
+  Time::SleepMS(1);
+
+ ZstdHelpersExit = true;
+
+ for(unsigned i = 0; i < ZstdNumHelpers; i++)
+ {
+  ZstdHelper* h = &ZstdHelpers[i];
+
+  MThreading::Sem_Post(h->wakeup);
+  MThreading::Thread_Wait(h->thread, nullptr);
+  MThreading::Sem_Destroy(h->wakeup);
+  h->thread = nullptr;
+  h->wakeup = nullptr;
+ }
+ ZstdNumHelpers = 0;
+ ZstdHelpersExit = false;
+
+ if(ZstdDoneSem)
+ {
+  MThreading::Sem_Destroy(ZstdDoneSem);
+  ZstdDoneSem = nullptr;
+ }
+
+ ZstdHelpersBusy.clear(std::memory_order_release);
+}
+
+//
+// Runs all jobs, on up to 'num_threads' threads(including the calling thread), and rethrows the first error, if any, after all
+// threads have finished.
+//
+static void RunZstdJobs(ZstdJobs* j, const unsigned num_threads)
+{
+ ZstdWorker self;
+ unsigned num_helpers = 0;
+ bool have_helpers = false;
+
+ j->next = 0;
+ j->failed = false;
+
+ self.jobs = j;
+ self.index = 0;
+
+ if(num_threads > 1 && !ZstdHelpersBusy.test_and_set(std::memory_order_acquire))
+ {
+  have_helpers = true;
+
+  try
+  {
+   StartZstdHelpers(num_threads - 1);
+  }
+  catch(...)
+  {
+   // Not fatal; the helpers that were started, and the calling thread, pick up the slack.
+  }
+
+  num_helpers = std::min<unsigned>(ZstdNumHelpers, num_threads - 1);
+
+  for(unsigned i = 0; i < num_helpers; i++)
+  {
+   ZstdHelpers[i].worker.jobs = j;
+   ZstdHelpers[i].worker.index = 1 + i;
+   MThreading::Sem_Post(ZstdHelpers[i].wakeup);
+  }
+ }
+
+ ZstdWorkerMain(&self);
+
+ for(unsigned i = 0; i < num_helpers; i++)
+  MThreading::Sem_Wait(ZstdDoneSem);
+
+ if(have_helpers)
+  ZstdHelpersBusy.clear(std::memory_order_release);
+
+ if(j->failed)
+  throw MDFN_Error(0, "%s", j->error.c_str());
+}
+
+//
+// Zstandard compression is only available when linking with an external libzstd; the bundled copy is decompression-only.
+//
+#ifdef HAVE_EXTERNAL_LIBZSTD
+typedef std::unique_ptr<ZSTD_CCtx, size_t (*)(ZSTD_CCtx*)> ZstdCCtxPtr;
+
+static void CompressZstdChunked(Stream* dest, const void* src, uint64 src_len)
+{
+ const size_t num_chunks = (src_len + StateZstdChunkSize - 1) / StateZstdChunkSize;
+ const unsigned num_threads = ZstdThreadCount(num_chunks);
+ const size_t bound = ZSTD_compressBound(StateZstdChunkSize);
+ std::vector<ZstdCCtxPtr> zc;
+ std::unique_ptr<uint8[]> obuf(new uint8[bound * num_chunks]);
+ std::unique_ptr<size_t[]> olen(new size_t[num_chunks]);
+ ZstdJobs j;
+
+ for(unsigned i = 0; i < num_threads; i++)
+ {
+  zc.emplace_back(ZSTD_createCCtx(), ZSTD_freeCCtx);
+
+  if(!zc.back())
+   throw MDFN_Error(0, _("%s failed."), "ZSTD_createCCtx()");
+ }
+
+ j.count = num_chunks;
+ j.func = [&](unsigned t, size_t i)
+ {
+  const uint64 offs = i * StateZstdChunkSize;
+  const size_t len = std::min<uint64>(StateZstdChunkSize, src_len - offs);
+  const size_t res = ZSTD_compressCCtx(zc[t].get(), obuf.get() + i * bound, bound, (const uint8*)src + offs, len, StateZstdLevel);
+
+  if(ZSTD_isError(res))
+   throw MDFN_Error(0, _("%s failed: %s"), "ZSTD_compressCCtx()", ZSTD_getErrorName(res));
+
+  olen[i] = res;
+ };
+
+ RunZstdJobs(&j, num_threads);
+
+ for(size_t i = 0; i < num_chunks; i++)
+  dest->write(obuf.get() + i * bound, olen[i]);
+}
+#endif
+
+static void CompressZstd(Stream* dest, const void* src, uint64 src_len)
+{
+#ifdef HAVE_EXTERNAL_LIBZSTD
+ if(src_len > StateZstdChunkSize)
+ {
+  CompressZstdChunked(dest, src, src_len);
+  return;
+ }
+ //
+ //
+ ZstdCCtxPtr zc(ZSTD_createCCtx(), ZSTD_freeCCtx);
+ std::unique_ptr<uint8[]> obuf(new uint8[ZSTD_CStreamOutSize()]);
+ ZSTD_inBuffer ib;
+ size_t res;
+
+ if(!zc)
+  throw MDFN_Error(0, _("%s failed."), "ZSTD_createCCtx()");
+
+ ZSTD_CCtx_setParameter(zc.get(), ZSTD_c_compressionLevel, StateZstdLevel);
+ ZSTD_CCtx_setPledgedSrcSize(zc.get(), src_len);
+
+ ib.src = src;
+ ib.size = src_len;
+ ib.pos = 0;
+
+ do
+ {
+  ZSTD_outBuffer ob;
+
+  ob.dst = obuf.get();
+  ob.size = ZSTD_CStreamOutSize();
+  ob.pos = 0;
+
+  res = ZSTD_compressStream2(zc.get(), &ob, &ib, ZSTD_e_end);
+  if(ZSTD_isError(res))
+   throw MDFN_Error(0, _("%s failed: %s"), "ZSTD_compressStream2()", ZSTD_getErrorName(res));
+
+  dest->write(obuf.get(), ob.pos);
+ } while(res);
+#else
+ throw MDFN_Error(0, _("Zstandard save state compression is not supported in this build."));
+#endif
+}
+
+static void CompressGZip(Stream* dest, const void* src, uint64 src_len, const int level)
+{
+ z_stream zs;
+ uint8 obuf[16384];
+ int zr;
+
+ memset(&zs, 0, sizeof(zs));
+
+ // 15 + 16 for a gzip wrapper, the same as GZFileStream writes.
+ if(deflateInit2(&zs, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+  throw MDFN_Error(0, _("%s failed."), "deflateInit2()");
+
+ try
+ {
+  const uint8* sp = (const uint8*)src;
+
+  do
+  {
+   const uInt chunk = std::min<uint64>(src_len, 1U << 30);
+
+   zs.next_in = (Bytef*)sp;
+   zs.avail_in = chunk;
+   sp += chunk;
+   src_len -= chunk;
+
+   do
+   {
+    zs.next_out = obuf;
+    zs.avail_out = sizeof(obuf);
+
+    zr = deflate(&zs, src_len ? Z_NO_FLUSH : Z_FINISH);
+    if(zr == Z_STREAM_ERROR)
+     throw MDFN_Error(0, _("%s failed."), "deflate()");
+
+    dest->write(obuf, sizeof(obuf) - zs.avail_out);
+   } while(!zs.avail_out);
+  } while(src_len);
+
+  if(zr != Z_STREAM_END)
+   throw MDFN_Error(0, _("%s failed."), "deflate()");
+ }
+ catch(...)
+ {
+  deflateEnd(&zs);
+  throw;
+ }
+
+ deflateEnd(&zs);
+}
+
+void MDFNSS_Compress(Stream* dest, const void* src, uint64 src_len, const unsigned comp, const int level)
+{
+ switch(comp)
+ {
+  default:
+	throw MDFN_Error(0, _("Unknown save state compression type %u."), comp);
+
+  case MDFNSS_COMP_NONE:
+	dest->write(src, src_len);
+	break;
+
+  case MDFNSS_COMP_ZSTD:
+	CompressZstd(dest, src, src_len);
+	break;
+
+  case MDFNSS_COMP_GZIP:
+	if(level < 0)
+	 dest->write(src, src_len);
+	else
+	 CompressGZip(dest, src, src_len, level);
+	break;
+ }
+}
+
+//
+// Stops early, once at least 'max_len' bytes have been written to 'dest'.
+//
+static void DecompressZstdStream(MemoryStream* dest, const void* src, uint64 src_len, const uint64 max_len = ~(uint64)0)
+{
+ const uint64 start_pos = dest->tell();
+
+ std::unique_ptr<ZSTD_DStream, size_t (*)(ZSTD_DStream*)> zs(ZSTD_createDStream(), ZSTD_freeDStream);
+ uint8 obuf[16384];
+ ZSTD_inBuffer ib;
+ size_t res;
+
+ if(!zs)
+  throw MDFN_Error(0, _("%s failed."), "ZSTD_createDStream()");
+
+ ib.src = src;
+ ib.size = src_len;
+ ib.pos = 0;
+
+ do
+ {
+  ZSTD_outBuffer ob;
+
+  ob.dst = obuf;
+  ob.size = sizeof(obuf);
+  ob.pos = 0;
+
+  res = ZSTD_decompressStream(zs.get(), &ob, &ib);
+  if(ZSTD_isError(res))
+   throw MDFN_Error(0, _("%s failed: %s"), "ZSTD_decompressStream()", ZSTD_getErrorName(res));
+
+  dest->write(obuf, ob.pos);
+
+  if((dest->tell() - start_pos) > StateMaxDecompressedLen)
+   throw MDFN_Error(0, _("Save state data is too large."));
+
+  if(!ob.pos && ib.pos == ib.size && res)
+   throw MDFN_Error(0, _("Save state data is truncated."));
+ } while((res || ib.pos < ib.size) && (dest->tell() - start_pos) < max_len);	// Continue on to any following frames.
+}
+
+static void DecompressZstd(MemoryStream* dest, const void* src, uint64 src_len)
+{
+ struct ZstdFrame
+ {
+  uint64 src_offs;
+  size_t src_len;
+  uint64 dest_offs;
+  uint64 dest_len;
+ };
+ std::vector<ZstdFrame> frames;
+ uint64 total_len = 0;
+
+ for(uint64 offs = 0; offs < src_len;)
+ {
+  const uint8* fp = (const uint8*)src + offs;
+  const size_t flen = ZSTD_findFrameCompressedSize(fp, src_len - offs);
+  const unsigned long long ucs = ZSTD_getFrameContentSize(fp, src_len - offs);
+
+  if(ZSTD_isError(flen) || ucs == ZSTD_CONTENTSIZE_ERROR)
+  {
+   if(!offs)
+    throw MDFN_Error(0, _("Save state data is not a valid Zstandard frame."));
+
+   throw MDFN_Error(0, _("Save state data is truncated."));
+  }
+
+  //
+  // Written by something other than CompressZstd(), like the zstd command-line tool when reading from a pipe;
+  // fall back to serial streaming decompression.
+  //
+  if(ucs == ZSTD_CONTENTSIZE_UNKNOWN)
+  {
+   DecompressZstdStream(dest, src, src_len);
+   return;
+  }
+
+  if(ucs > (StateMaxDecompressedLen - total_len))
+   throw MDFN_Error(0, _("Save state data is too large."));
+
+  frames.push_back({ offs, flen, total_len, ucs });
+  offs += flen;
+  total_len += ucs;
+ }
+
+ const uint64 pos = dest->tell();
+ const unsigned num_threads = ZstdThreadCount(frames.size());
+ std::vector<std::unique_ptr<ZSTD_DCtx, size_t (*)(ZSTD_DCtx*)>> zd;
+ ZstdJobs j;
+
+ for(unsigned i = 0; i < num_threads; i++)
+ {
+  zd.emplace_back(ZSTD_createDCtx(), ZSTD_freeDCtx);
+
+  if(!zd.back())
+   throw MDFN_Error(0, _("%s failed."), "ZSTD_createDCtx()");
+ }
+
+ dest->truncate(pos + total_len);
+
+ uint8* const dbase = dest->map() + pos;
+
+ j.count = frames.size();
+ j.func = [&](unsigned t, size_t i)
+ {
+  const ZstdFrame& f = frames[i];
+  const size_t res = ZSTD_decompressDCtx(zd[t].get(), dbase + f.dest_offs, f.dest_len, (const uint8*)src + f.src_offs, f.src_len);
+
+  if(ZSTD_isError(res))
+   throw MDFN_Error(0, _("%s failed: %s"), "ZSTD_decompressDCtx()", ZSTD_getErrorName(res));
+
+  if(res != f.dest_len)
+   throw MDFN_Error(0, _("Save state data is corrupt."));
+ };
+
+ RunZstdJobs(&j, num_threads);
+
+ dest->seek(pos + total_len, SEEK_SET);
+}
+
+static void DecompressGZip(MemoryStream* dest, const void* src, uint64 src_len)
+{
+ z_stream zs;
+ uint8 obuf[16384];
+ int zr;
+
+ memset(&zs, 0, sizeof(zs));
+
+ if(inflateInit2(&zs, 15 + 16) != Z_OK)
+  throw MDFN_Error(0, _("%s failed."), "inflateInit2()");
+
+ try
+ {
+  const uint8* sp = (const uint8*)src;
+
+  do
+  {
+   if(!zs.avail_in)
+   {
+    const uInt chunk = std::min<uint64>(src_len, 1U << 30);
+
+    if(!chunk)
+     throw MDFN_Error(0, _("Save state data is truncated."));
+
+    zs.next_in = (Bytef*)sp;
+    zs.avail_in = chunk;
+    sp += chunk;
+    src_len -= chunk;
+   }
+
+   zs.next_out = obuf;
+   zs.avail_out = sizeof(obuf);
+
+   zr = inflate(&zs, Z_NO_FLUSH);
+   if(zr != Z_OK && zr != Z_STREAM_END)
+    throw MDFN_Error(0, _("%s failed: %s"), "inflate()", zs.msg ? zs.msg : "?");
+
+   dest->write(obuf, sizeof(obuf) - zs.avail_out);
+
+   if(zs.total_out > StateMaxDecompressedLen)
+    throw MDFN_Error(0, _("Save state data is too large."));
+  } while(zr != Z_STREAM_END);
+ }
+ catch(...)
+ {
+  inflateEnd(&zs);
+  throw;
+ }
+
+ inflateEnd(&zs);
+}
+
+void MDFNSS_Decompress(MemoryStream* dest, const void* src, uint64 src_len, const unsigned comp)
+{
+ switch(comp)
+ {
+  default:
+	throw MDFN_Error(0, _("Unknown save state compression type %u."), comp);
+
+  case MDFNSS_COMP_NONE:
+	dest->write(src, src_len);
+	break;
+
+  case MDFNSS_COMP_ZSTD:
+	DecompressZstd(dest, src, src_len);
+	break;
+
+  case MDFNSS_COMP_GZIP:
+	DecompressGZip(dest, src, src_len);
+	break;
+ }
+}
+
+void MDFNSS_LoadSMComp(const void* src, uint64 src_len, MemoryStream* scratch)
+{
+ const unsigned comp = MDFNSS_DetectComp(src, src_len);
+
+ if(comp == MDFNSS_COMP_NONE)
+ {
+  ExtMemStream ems(src, src_len);
+
+  MDFNSS_LoadSM(&ems, false);
+ }
+ else
+ {
+  scratch->truncate(0);
+  scratch->rewind();
+  MDFNSS_Decompress(scratch, src, src_len, comp);
+  scratch->rewind();
+
+  MDFNSS_LoadSM(scratch, false);
+ }
+}
+
 void MDFNSS_SaveInternal(Stream* st, void (*safunc)(StateMem*, const unsigned, const bool))
 {
  if(!MDFNGameInfo->StateAction)
@@ -707,6 +1616,40 @@ void MDFNSS_CheckStates(void)
 	MDFND_SetStateStatus(NULL);
 }
 
+//
+// Opens a save state file for reading.  gzip'd and uncompressed files are read through GZFileStream, while Zstandard-compressed
+// files are decompressed into memory up front; pass 'max_len' to only decompress(at least) that much, e.g. for just the header and
+// preview image.
+//
+static std::unique_ptr<Stream> OpenStateFile(const std::string& path, const uint64 max_len = ~(uint64)0)
+{
+ std::unique_ptr<FileStream> fp(new FileStream(path, FileStream::MODE_READ));
+ uint8 magic[4];
+ const uint64 magic_len = fp->read(magic, sizeof(magic), false);
+
+ if(MDFNSS_DetectComp(magic, magic_len) == MDFNSS_COMP_ZSTD)
+ {
+  std::unique_ptr<MemoryStream> ret(new MemoryStream());
+
+  fp->rewind();
+  {
+   MemoryStream cdata(fp.release());
+
+   if(max_len != ~(uint64)0)
+    DecompressZstdStream(ret.get(), cdata.map(), cdata.size(), max_len);
+   else
+    MDFNSS_Decompress(ret.get(), cdata.map(), cdata.size(), MDFNSS_COMP_ZSTD);
+  }
+  ret->rewind();
+
+  return std::move(ret);
+ }
+
+ fp.reset(nullptr);
+
+ return std::unique_ptr<Stream>(new GZFileStream(path, GZFileStream::MODE::READ));
+}
+
 void MDFNSS_GetStateInfo(const std::string& path, StateStatusStruct* status)
 {
  uint32 StateShowPBWidth;
@@ -715,10 +1658,10 @@ void MDFNSS_GetStateInfo(const std::string& path, StateStatusStruct* status)
 
  try
  {
-  GZFileStream fp(path, GZFileStream::MODE::READ);
+  std::unique_ptr<Stream> fp = OpenStateFile(path, 32 + 3 * 1024 * 1024);
   uint8 header[32];
 
-  fp.read(header, 32);
+  fp->read(header, 32);
 
   uint32 width = MDFN_de32lsb(header + 24);
   uint32 height = MDFN_de32lsb(header + 28);
@@ -730,7 +1673,7 @@ void MDFNSS_GetStateInfo(const std::string& path, StateStatusStruct* status)
    height = 1024;
 
   previewbuffer = new uint8[3 * width * height];
-  fp.read(previewbuffer, 3 * width * height);
+  fp->read(previewbuffer, 3 * width * height);
 
   StateShowPBWidth = width;
   StateShowPBHeight = height;
@@ -819,11 +1762,23 @@ bool MDFNI_SaveState(const char *fname, const char *suffix, const MDFN_Surface *
    //
    //
    //
-   GZFileStream gp(fname ? std::string(fname) : MDFN_MakeFName(MDFNMKF_STATE,CurrentState,suffix),
-			GZFileStream::MODE::WRITE, MDFN_GetSettingI("filesys.state_comp_level"));
+   const std::string path = fname ? std::string(fname) : MDFN_MakeFName(MDFNMKF_STATE,CurrentState,suffix);
+   const unsigned comp = MDFN_GetSettingUI("filesys.state_comp_type");
+
+   if(comp == MDFNSS_COMP_GZIP)
+   {
+    GZFileStream gp(path, GZFileStream::MODE::WRITE, MDFN_GetSettingI("filesys.state_comp_level"));
+
+    gp.write(st.map(), st.size());
+    gp.close();
+   }
+   else
+   {
+    FileStream fp(path, FileStream::MODE_WRITE);
 
-   gp.write(st.map(), st.size());
-   gp.close();
+    MDFNSS_Compress(&fp, st.map(), st.size(), comp);
+    fp.close();
+   }
   }
 
   MDFND_SetStateStatus(NULL);
@@ -863,12 +1818,14 @@ bool MDFNI_LoadState(const char *fname, const char *suffix) noexcept
      from this ;)).
   */
 
+  MDFNI_FlushStateSaves();
+
   {
-   GZFileStream st(fname ? std::string(fname) : MDFN_MakeFName(MDFNMKF_STATE,CurrentState,suffix), GZFileStream::MODE::READ);
+   std::unique_ptr<Stream> st = OpenStateFile(fname ? std::string(fname) : MDFN_MakeFName(MDFNMKF_STATE,CurrentState,suffix));
    uint8 header[32];
    uint32 st_len;
 
-   st.read(header, 32);
+   st->read(header, 32);
 
    st_len = MDFN_de32lsb(header + 16 + 4) & 0x7FFFFFFF;
 
@@ -878,7 +1835,7 @@ bool MDFNI_LoadState(const char *fname, const char *suffix) noexcept
    MemoryStream sm(st_len, -1);
 
    memcpy(sm.map(), header, 32);
-   st.read(sm.map() + 32, st_len - 32);
+   st->read(sm.map() + 32, st_len - 32);
 
    MDFNSS_LoadSM(&sm, false);
   }
@@ -923,4 +1880,77 @@ bool MDFNI_LoadState(const char *fname, const char *suffix) noexcept
  return(ret);
 }
 
+bool MDFNI_SaveStateMem(MemoryStream* dest, const unsigned comp, const MDFN_Surface *surface, const MDFN_Rect *DisplayRect, const int32 *LineWidths) noexcept
+{
+ bool ret = true;
+
+ try
+ {
+  if(MDFNnetplay && (MDFNGameInfo->SaveStateAltersState == true))
+  {
+   throw MDFN_Error(0, _("Module %s is not compatible with manual state saving during netplay."), MDFNGameInfo->shortname);
+  }
+
+  dest->truncate(0);
+  dest->rewind();
+
+  if(comp == MDFNSS_COMP_NONE)
+   MDFNSS_SaveSM(dest, false, surface, DisplayRect, LineWidths);
+  else
+  {
+   MemoryStream st(65536);
+
+   MDFNSS_SaveSM(&st, false, surface, DisplayRect, LineWidths);
+   MDFNSS_Compress(dest, st.map(), st.size(), comp, MDFN_GetSettingI("filesys.state_comp_level"));
+  }
+ }
+ catch(std::exception &e)
+ {
+  MDFND_OutputNotice(MDFN_NOTICE_ERROR, e.what());
+
+  if(MDFNnetplay)
+   MDFND_NetplayText(e.what(), false);
+
+  ret = false;
+ }
+
+ return(ret);
+}
+
+bool MDFNI_LoadStateMem(const void* data, uint64 size, MemoryStream* scratch) noexcept
+{
+ bool ret = true;
+
+ try
+ {
+  if(scratch)
+   MDFNSS_LoadSMComp(data, size, scratch);
+  else
+  {
+   MemoryStream tmp;
+
+   MDFNSS_LoadSMComp(data, size, &tmp);
+  }
+
+  if(MDFNnetplay)
+  {
+   NetplaySendState();
+  }
+
+  if(MDFNMOV_IsRecording())
+   MDFNMOV_RecordState();
+ }
+ catch(std::exception &e)
+ {
+  MDFND_OutputNotice(MDFN_NOTICE_ERROR, e.what());
+
+  if(MDFNnetplay)
+   MDFND_NetplayText(e.what(), false);
+
+  ret = false;
+ }
+
+ return(ret);
+}
+
 }
@@ -32,6 +32,7 @@ namespace Mednafen
 void MDFNSS_GetStateInfo(const std::string& path, StateStatusStruct* status);
 
 struct StateMem;
+class MemoryStream;
 
 enum : int
 {
@@ -59,6 +60,37 @@ enum : int
 void MDFNSS_SaveSM(Stream *st, bool data_only = false, const MDFN_Surface *surface = (MDFN_Surface *)NULL, const MDFN_Rect *DisplayRect = (MDFN_Rect*)NULL, const int32 *LineWidths = (int32*)NULL);
 void MDFNSS_LoadSM(Stream *st, bool data_only = false, const int fuzz = MDFNSS_FUZZ_DISABLED);
 
+//
+// Returns the MDFNSS_COMP_* type of the (possibly compressed) save state data, based on its magic number.
+//
+unsigned MDFNSS_DetectComp(const void* data, uint64 size);
+
+//
+// Compresses the save state in 'src'(as generated by MDFNSS_SaveSM() with data_only == false) with 'comp', and writes the result to 'dest'.
+// 'level' is the compression level, and is only used with MDFNSS_COMP_GZIP.
+//
+// throws exceptions on errors.
+//
+void MDFNSS_Compress(Stream* dest, const void* src, uint64 src_len, const unsigned comp, const int level = 6);
+
+//
+// Decompresses 'comp'-compressed save state data in 'src', writing the result to 'dest' at its current position.
+//
+// throws exceptions on errors.
+//
+void MDFNSS_Decompress(MemoryStream* dest, const void* src, uint64 src_len, const unsigned comp);
+
+//
+// Loads a save state from the possibly-compressed data in 'src', autodetecting the compression type.  Uncompressed data is loaded
+// in-place; otherwise it's decompressed into 'scratch', whose allocation may be reused across calls.
+//
+// throws exceptions on errors.
+//
+void MDFNSS_LoadSMComp(const void* src, uint64 src_len, MemoryStream* scratch);
+
+// Stops the helper threads used for compressing and decompressing Zstandard save states; they're restarted on demand.
+void MDFNSS_EndZstdThreads(void) noexcept;
+
 void MDFNSS_CheckStates(void);
 
 // For emulation modules' internal use.
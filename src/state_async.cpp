@@ -0,0 +1,265 @@
+/******************************************************************************/
+/* Mednafen - Multi-system Emulator                                           */
+/******************************************************************************/
+/* state_async.cpp - Off-thread save state compression and writing
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public License
+** as published by the Free Software Foundation; either version 2
+** of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software Foundation, Inc.,
+** 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+/*
+ The emulation thread only serializes the state into a MemoryStream(which is little more than a few memcpy()s), and the
+ compression and file writing is done on a worker thread.  Jobs are processed in order, so a later save to the same path
+ always wins.
+*/
+
+#include "mednafen.h"
+#include "driver.h"
+#include "netplay.h"
+#include "state.h"
+#include "state_async.h"
+#include "state-driver.h"
+
+#include <mednafen/MemoryStream.h>
+#include <mednafen/FileStream.h>
+#include <mednafen/MThreading.h>
+
+#include <deque>
+
+namespace Mednafen
+{
+
+struct AsyncSaveJob
+{
+ std::unique_ptr<MemoryStream> data;
+ std::string path;
+ unsigned comp;
+ int level;
+ void (*callback)(void* cb_data, const char* error);
+ void* cb_data;
+};
+
+static MThreading::Thread* SaveThread = nullptr;
+static MThreading::Mutex* SaveMutex = nullptr;
+static MThreading::Cond* JobCond = nullptr;	// Signaled when a job is queued, or the thread is asked to exit.
+static MThreading::Cond* DoneCond = nullptr;	// Signaled when a job is finished.
+
+//
+// Protected by SaveMutex
+//
+static std::deque<AsyncSaveJob> SaveQueue;
+static unsigned SavesPending = 0;	// Queued + in progress
+static bool SaveThreadExit = false;
+static std::unique_ptr<MemoryStream> SpareBuffer;	// Recycled from the last finished job, to avoid reallocating every save.
+
+static void RunJob(AsyncSaveJob* job)
+{
+ //
+ // Write to a temporary file in the same directory and rename it over the target, so a crash or write error can't leave a
+ // truncated state in place of the previous good one.
+ //
+ const std::string tmp_path = job->path + ".tmp";
+ std::string error;
+
+ try
+ {
+  {
+   FileStream fp(tmp_path, FileStream::MODE_WRITE);
+
+   MDFNSS_Compress(&fp, job->data->map(), job->data->size(), job->comp, job->level);
+   fp.close();
+  }
+
+  NVFS.rename(tmp_path, job->path);
+ }
+ catch(std::exception& e)
+ {
+  error = e.what();
+
+  try { NVFS.unlink(tmp_path); } catch(...) { }
+ }
+
+ if(job->callback)
+  job->callback(job->cb_data, error.size() ? error.c_str() : nullptr);
+}
+
+static int SaveThreadMain(void* arg)
+{
+ MThreading::Mutex_Lock(SaveMutex);
+
+ for(;;)
+ {
+  while(!SaveQueue.size() && !SaveThreadExit)
+   MThreading::Cond_Wait(JobCond, SaveMutex);
+
+  // Drain the queue before exiting.
+  if(!SaveQueue.size())
+   break;
+
+  AsyncSaveJob job = std::move(SaveQueue.front());
+  SaveQueue.pop_front();
+  MThreading::Mutex_Unlock(SaveMutex);
+  //
+  RunJob(&job);
+  //
+  MThreading::Mutex_Lock(SaveMutex);
+
+  if(!SpareBuffer)
+   SpareBuffer = std::move(job.data);
+
+  SavesPending--;
+  MThreading::Cond_Signal(DoneCond);
+ }
+
+ MThreading::Mutex_Unlock(SaveMutex);
+
+ return 0;
+}
+
+static void StartThread(void)
+{
+ if(SaveThread)
+  return;
+
+ try
+ {
+  SaveMutex = MThreading::Mutex_Create();
+  JobCond = MThreading::Cond_Create();
+  DoneCond = MThreading::Cond_Create();
+  SaveThreadExit = false;
+  SaveThread = MThreading::Thread_Create(SaveThreadMain, nullptr, "MDFN State Save");
+ }
+ catch(...)
+ {
+  if(DoneCond)
+  {
+   MThreading::Cond_Destroy(DoneCond);
+   DoneCond = nullptr;
+  }
+
+  if(JobCond)
+  {
+   MThreading::Cond_Destroy(JobCond);
+   JobCond = nullptr;
+  }
+
+  if(SaveMutex)
+  {
+   MThreading::Mutex_Destroy(SaveMutex);
+   SaveMutex = nullptr;
+  }
+  throw;
+ }
+}
+
+void MDFNSS_EndAsyncSaves(void) noexcept
+{
+ if(!SaveThread)
+  return;
+
+ MThreading::Mutex_Lock(SaveMutex);
+ SaveThreadExit = true;
+ MThreading::Cond_Signal(JobCond);
+ MThreading::Mutex_Unlock(SaveMutex);
+
+ MThreading::Thread_Wait(SaveThread, nullptr);
+ SaveThread = nullptr;
+
+ MThreading::Cond_Destroy(DoneCond);
+ DoneCond = nullptr;
+ MThreading::Cond_Destroy(JobCond);
+ JobCond = nullptr;
+ MThreading::Mutex_Destroy(SaveMutex);
+ SaveMutex = nullptr;
+
+ SpareBuffer.reset(nullptr);
+ SavesPending = 0;
+}
+
+void MDFNI_FlushStateSaves(void) noexcept
+{
+ if(!SaveThread)
+  return;
+
+ MThreading::Mutex_Lock(SaveMutex);
+
+ while(SavesPending)
+  MThreading::Cond_Wait(DoneCond, SaveMutex);
+
+ MThreading::Mutex_Unlock(SaveMutex);
+}
+
+bool MDFNI_SaveStateAsync(const char* fname, const unsigned comp, void (*callback)(void* cb_data, const char* error), void* cb_data) noexcept
+{
+ try
+ {
+  if(MDFNnetplay && (MDFNGameInfo->SaveStateAltersState == true))
+  {
+   throw MDFN_Error(0, _("Module %s is not compatible with manual state saving during netplay."), MDFNGameInfo->shortname);
+  }
+
+  StartThread();
+  //
+  AsyncSaveJob job;
+
+  MThreading::Mutex_Lock(SaveMutex);
+  job.data = std::move(SpareBuffer);
+  MThreading::Mutex_Unlock(SaveMutex);
+
+  if(!job.data)
+   job.data.reset(new MemoryStream(65536));
+  else
+  {
+   job.data->truncate(0);
+   job.data->rewind();
+  }
+
+  MDFNSS_SaveSM(job.data.get(), false);
+
+  job.path = fname;
+  job.comp = comp;
+  job.level = MDFN_GetSettingI("filesys.state_comp_level");
+  job.callback = callback;
+  job.cb_data = cb_data;
+
+  MThreading::Mutex_Lock(SaveMutex);
+
+  try
+  {
+   SaveQueue.push_back(std::move(job));
+  }
+  catch(...)
+  {
+   MThreading::Mutex_Unlock(SaveMutex);
+   throw;
+  }
+
+  SavesPending++;
+  MThreading::Cond_Signal(JobCond);
+  MThreading::Mutex_Unlock(SaveMutex);
+ }
+ catch(std::exception &e)
+ {
+  MDFND_OutputNotice(MDFN_NOTICE_ERROR, e.what());
+
+  if(MDFNnetplay)
+   MDFND_NetplayText(e.what(), false);
+
+  return false;
+ }
+
+ return true;
+}
+
+}
@@ -19,6 +19,18 @@
 ** 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 
+/*
+ The most recent state is kept uncompressed in ss_prev.  Every older state is stored as a record in a ring buffer allocated once
+ up-front(with a size of "srwbudget" MiB), holding the blocks that differ between it and the state that came after it, XOR'd
+ together, and compressed.  When the ring buffer is full, the oldest records are dropped.
+
+ Since only the newest state is kept whole and the chain of deltas is walked one record per rewind step, no separate keyframes
+ are needed; recording cost is instead amortized by only recording every "srwinterval" frames.
+
+ All buffers are reused, so once the first couple of states have been recorded, recording and rewinding don't allocate memory
+ anymore(unless the state size increases).
+*/
+
 #include "mednafen.h"
 #include "state.h"
 #include "movie.h"
@@ -26,6 +38,7 @@
 
 #include <mednafen/MemoryStream.h>
 #include <mednafen/quicklz/quicklz.h>
+#include <zstd/zstd.h>
 
 #if QLZ_COMPRESSION_LEVEL != 0
  #error "State rewinding code untested with QLZ_COMPRESSION_LEVEL != 0"
@@ -34,19 +47,48 @@
 namespace Mednafen
 {
 
-struct StateMemPacket
+// Granularity of the delta encoding.
+static const uint32 BlockSize = 4096;
+
+struct RecordHeader
 {
-	std::unique_ptr<MemoryStream> data;
-	uint32 uncompressed_len = 0;
+ uint64 prev;		// Arena offset of the previous(older) record.
+ uint32 size;		// Total size of this record in the arena, including the header.
+ uint32 state_len;	// Size of the state this record reconstructs, rounded up to BlockSize.
+ uint32 num_blocks;	// Number of blocks covered by the dirty block map.
+ uint32 raw_len;	// Size of the dirty block map + dirty block data.
+ uint32 comp_len;	// Size of the data following the header.
+ uint32 comp;		// SRW_COMP_*
 };
+static_assert(sizeof(RecordHeader) == 32, "Unexpected RecordHeader size.");
 
 static bool Active = false;
 static bool Enabled = false;
-static std::vector<StateMemPacket> bcs;
-static size_t bcs_pos;
 
-static uint32 SRW_AllocHint;
-static std::unique_ptr<MemoryStream> ss_prev;
+static unsigned Compressor;
+static uint32 MaxRecords;
+static uint32 Interval;
+static uint32 IntervalCounter;
+
+static std::unique_ptr<uint8[]> Arena;
+static uint64 ArenaSize;
+static uint64 ArenaHead;	// Where the next record will be written.
+static uint64 ArenaTail;	// Oldest record.
+static uint64 ArenaWrap;	// End of the data at the end of the arena, when ArenaWrapped is true.
+static bool ArenaWrapped;	// If true, records occupy [ArenaTail, ArenaWrap) and [0, ArenaHead), else [ArenaTail, ArenaHead).
+static uint64 ArenaNewest;	// Newest record.
+static uint32 ArenaCount;
+
+static std::unique_ptr<MemoryStream> ss_prev, ss_cur;
+static bool HavePrev;
+
+static std::unique_ptr<uint8[]> RawBuf, CompBuf;
+static uint64 RawBufSize, CompBufSize;
+
+#ifdef HAVE_EXTERNAL_LIBZSTD
+static ZSTD_CCtx* ZCCtx = nullptr;
+#endif
+static ZSTD_DCtx* ZDCtx = nullptr;
 
 static union
 {
@@ -56,8 +98,39 @@ static union
 
 static void Cleanup(void)
 {
- bcs.clear();
+ Arena.reset(nullptr);
+ ArenaSize = 0;
  ss_prev.reset(nullptr);
+ ss_cur.reset(nullptr);
+ HavePrev = false;
+ RawBuf.reset(nullptr);
+ RawBufSize = 0;
+ CompBuf.reset(nullptr);
+ CompBufSize = 0;
+
+#ifdef HAVE_EXTERNAL_LIBZSTD
+ if(ZCCtx)
+ {
+  ZSTD_freeCCtx(ZCCtx);
+  ZCCtx = nullptr;
+ }
+#endif
+
+ if(ZDCtx)
+ {
+  ZSTD_freeDCtx(ZDCtx);
+  ZDCtx = nullptr;
+ }
+}
+
+static void ResetArena(void)
+{
+ ArenaHead = 0;
+ ArenaTail = 0;
+ ArenaWrap = 0;
+ ArenaWrapped = false;
+ ArenaNewest = 0;
+ ArenaCount = 0;
 }
 
 void MDFNSRW_Begin(void) noexcept
@@ -69,11 +142,33 @@ void MDFNSRW_Begin(void) noexcept
  {
   try
   {
-   bcs.resize(std::max<size_t>(3, MDFN_GetSettingUI("srwframes")) - 1);
-   bcs_pos = 0;
-   memset(&qlz_scratch, 0, sizeof(qlz_scratch));
+   Compressor = MDFN_GetSettingUI("srwcompressor");
+   Interval = MDFN_GetSettingUI("srwinterval");
+   MaxRecords = std::max<uint32>(3, MDFN_GetSettingUI("srwframes") / Interval) - 1;
+   IntervalCounter = 0;
+
+#ifdef HAVE_EXTERNAL_LIBZSTD
+   if(Compressor == SRW_COMP_ZSTD && !(ZCCtx = ZSTD_createCCtx()))
+    throw MDFN_Error(ErrnoHolder(ENOMEM));
+#else
+   if(Compressor == SRW_COMP_ZSTD)
+   {
+    MDFN_Notify(MDFN_NOTICE_WARNING, _("Zstandard compression is not available in this build, using QuickLZ for state rewinding."));
+    Compressor = SRW_COMP_QUICKLZ;
+   }
+#endif
+   if(!(ZDCtx = ZSTD_createDCtx()))
+    throw MDFN_Error(ErrnoHolder(ENOMEM));
 
-   SRW_AllocHint = 8192;
+   ArenaSize = (uint64)MDFN_GetSettingUI("srwbudget") << 20;
+   Arena.reset(new uint8[ArenaSize]);
+   ResetArena();
+
+   ss_prev.reset(new MemoryStream(65536));
+   ss_cur.reset(new MemoryStream(65536));
+   HavePrev = false;
+
+   memset(&qlz_scratch, 0, sizeof(qlz_scratch));
 
    Active = true;
   }
@@ -101,24 +196,128 @@ bool MDFNSRW_IsRunning(void) noexcept
  return Active;
 }
 
-static INLINE void DoXORFilter(MemoryStream* prev, MemoryStream* cur) noexcept
+static INLINE RecordHeader* GetRecord(uint64 offset)
 {
- MDFN_FastMemXOR(prev->map(), cur->map(), std::min(prev->size(), cur->size()));
+ return (RecordHeader*)&Arena[offset];
 }
 
+static void DropOldestRecord(void)
+{
+ assert(ArenaCount);
+
+ ArenaCount--;
+
+ if(!ArenaCount)
+ {
+  ResetArena();
+  return;
+ }
 
-static INLINE std::unique_ptr<MemoryStream> DoCompress(MemoryStream* data)
+ ArenaTail += GetRecord(ArenaTail)->size;
+
+ if(ArenaWrapped && ArenaTail == ArenaWrap)
+ {
+  ArenaTail = 0;
+  ArenaWrapped = false;
+ }
+}
+
+//
+// Returns a pointer to "size" bytes of space for a new record at the head of the arena, dropping old records to make
+// room as necessary.
+//
+static RecordHeader* AllocRecord(const uint32 size)
 {
- const uint32 uncompressed_len = data->size();
- const uint32 max_compressed_len = (uncompressed_len + 400);
- std::unique_ptr<MemoryStream> tmp_buf(new MemoryStream(max_compressed_len, -1));
- uint32 dst_len;
+ if(size > ArenaSize)
+  throw MDFN_Error(0, _("State rewinding memory budget of %llu MiB is too small."), (unsigned long long)(ArenaSize >> 20));
 
- dst_len = qlz_compress(data->map(), (char*)tmp_buf->map(), uncompressed_len, qlz_scratch.compress);
- tmp_buf->truncate(dst_len);
- tmp_buf->shrink_to_fit();
+ if(ArenaCount >= MaxRecords)
+  DropOldestRecord();
 
- return tmp_buf;
+ for(;;)
+ {
+  if(!ArenaWrapped)
+  {
+   if((ArenaHead + size) <= ArenaSize)
+    break;
+
+   if(!ArenaCount)
+   {
+    ArenaHead = ArenaTail = 0;
+    break;
+   }
+
+   ArenaWrap = ArenaHead;
+   ArenaHead = 0;
+   ArenaWrapped = true;
+  }
+
+  if(ArenaWrapped)
+  {
+   if((ArenaHead + size) <= ArenaTail)
+    break;
+
+   DropOldestRecord();
+  }
+ }
+
+ RecordHeader* ret = GetRecord(ArenaHead);
+
+ ret->prev = ArenaNewest;
+ ret->size = size;
+
+ ArenaNewest = ArenaHead;
+ ArenaHead += size;
+ ArenaCount++;
+
+ return ret;
+}
+
+static void PopNewestRecord(void)
+{
+ assert(ArenaCount);
+
+ ArenaCount--;
+
+ if(!ArenaCount)
+ {
+  ResetArena();
+  return;
+ }
+
+ ArenaHead = ArenaNewest;
+ ArenaNewest = GetRecord(ArenaNewest)->prev;
+
+ if(ArenaWrapped && !ArenaHead)
+ {
+  ArenaHead = ArenaWrap;
+  ArenaWrapped = false;
+ }
+}
+
+static INLINE void ReserveBuf(std::unique_ptr<uint8[]>* buf, uint64* buf_size, uint64 size)
+{
+ if(*buf_size < size)
+ {
+  buf->reset(nullptr);
+  buf->reset(new uint8[size]);
+  *buf_size = size;
+ }
+}
+
+// The dirty block data is kept aligned, for MDFN_FastMemXOR()'s sake.
+static INLINE uint32 MapLen(const uint32 num_blocks)
+{
+ return (((num_blocks + 7) >> 3) + 15) &~ 15;
+}
+
+static INLINE uint64 PadState(MemoryStream* ms, uint64 len)
+{
+ len = (len + BlockSize - 1) &~ (uint64)(BlockSize - 1);
+
+ ms->truncate(len);	// Zero-fills any new space.
+
+ return len;
 }
 
 //
@@ -129,7 +328,7 @@ static bool DoRewind(void)
  //
  // No save states available.
  //
- if(!ss_prev)
+ if(!HavePrev)
   return false;
 
  //
@@ -139,20 +338,59 @@ static bool DoRewind(void)
  MDFNSS_LoadSM(ss_prev.get(), true);
 
  //
- // If a compressed state exists, decompress it.
+ // If an older state exists, reconstruct it from the most recent one.
  //
- StateMemPacket* smp = &bcs[(bcs_pos + bcs.size() - 1) % bcs.size()];
-
- if(smp->data)
+ if(ArenaCount)
  {
-  std::unique_ptr<MemoryStream> tmp(new MemoryStream(smp->uncompressed_len, -1));
-  qlz_decompress((char*)smp->data->map(), tmp->map(), qlz_scratch.decompress);
-  smp->data.reset(nullptr);
-  bcs_pos = (bcs_pos + bcs.size() - 1) % bcs.size();
-  //
-  DoXORFilter(tmp.get(), ss_prev.get());
+  const RecordHeader* rec = GetRecord(ArenaNewest);
+  const uint8* comp_data = (const uint8*)(rec + 1);
+  const uint8* raw;
+
+  ReserveBuf(&RawBuf, &RawBufSize, rec->raw_len);
+
+  switch(rec->comp)
+  {
+   default:
+	throw MDFN_Error(0, _("Unknown compression type %u in state rewinding record."), rec->comp);
+
+   case SRW_COMP_NONE:
+	raw = comp_data;
+	break;
+
+   case SRW_COMP_QUICKLZ:
+	qlz_decompress((const char*)comp_data, RawBuf.get(), qlz_scratch.decompress);
+	raw = RawBuf.get();
+	break;
+
+   case SRW_COMP_ZSTD:
+	{
+	 size_t zr = ZSTD_decompressDCtx(ZDCtx, RawBuf.get(), rec->raw_len, comp_data, rec->comp_len);
+
+	 if(ZSTD_isError(zr) || zr != rec->raw_len)
+	  throw MDFN_Error(0, _("Zstandard decompression error in state rewinding."));
+
+	 raw = RawBuf.get();
+	}
+	break;
+  }
   //
-  ss_prev = std::move(tmp);
+  const uint32 num_blocks = rec->num_blocks;
+  const uint8* map = raw;
+  const uint8* block_data = raw + MapLen(num_blocks);
+
+  PadState(ss_prev.get(), std::max<uint64>(ss_prev->size(), (uint64)num_blocks * BlockSize));
+
+  for(uint32 i = 0; i < num_blocks; i++)
+  {
+   if((map[i >> 3] >> (i & 7)) & 1)
+   {
+    MDFN_FastMemXOR(ss_prev->map() + (uint64)i * BlockSize, block_data, BlockSize);
+    block_data += BlockSize;
+   }
+  }
+
+  ss_prev->truncate(rec->state_len);
+  PopNewestRecord();
  }
 
  return true;
@@ -166,30 +404,103 @@ static void DoRecord(void)
  //
  // Save current state
  //
- std::unique_ptr<MemoryStream> ss_cur(new MemoryStream(SRW_AllocHint));
-
+ ss_cur->rewind();
+ ss_cur->truncate(0);
  MDFNSS_SaveSM(ss_cur.get(), true);
 
- SRW_AllocHint = std::max<uint32>(SRW_AllocHint, ss_cur->size());
-
  //
- // Compress previous state if it exists.
+ // Store the difference between the previous state and the current state, if the previous state exists.
  //
- if(ss_prev)
+ if(HavePrev)
  {
-  DoXORFilter(ss_prev.get(), ss_cur.get());
+  const uint64 prev_len = PadState(ss_prev.get(), ss_prev->size());
+  const uint64 cur_len = PadState(ss_cur.get(), ss_cur->size());
+  const uint64 len = std::max<uint64>(prev_len, cur_len);
 
-  //printf("Compress: %zu\n", ss_prev->size());
+  if(len > 0xFFFFFFFF)
+   throw MDFN_Error(0, _("State is too large for rewinding."));
+
+  const uint32 num_blocks = len / BlockSize;
+  const uint32 map_len = MapLen(num_blocks);
+
+  ReserveBuf(&RawBuf, &RawBufSize, map_len + len);
+  //
+  // Temporarily pad out the shorter state so the blocks can be compared; ss_cur is trimmed back below, and ss_prev will be
+  // overwritten with the next state anyway.
+  //
+  ss_prev->truncate(len);
+  ss_cur->truncate(len);
 
-  bcs[bcs_pos].data = DoCompress(ss_prev.get());
-  bcs[bcs_pos].uncompressed_len = ss_prev->size();
-  bcs_pos = (bcs_pos + 1) % bcs.size();
+  uint8* map = RawBuf.get();
+  uint8* block_data = map + map_len;
+  const uint8* pp = ss_prev->map();
+  const uint8* cp = ss_cur->map();
+
+  memset(map, 0, map_len);
+
+  for(uint32 i = 0; i < num_blocks; i++)
+  {
+   const uint64 offs = (uint64)i * BlockSize;
+
+   if(memcmp(pp + offs, cp + offs, BlockSize))
+   {
+    map[i >> 3] |= 1 << (i & 7);
+    memcpy(block_data, pp + offs, BlockSize);
+    MDFN_FastMemXOR(block_data, cp + offs, BlockSize);
+    block_data += BlockSize;
+   }
+  }
+
+  ss_cur->truncate(cur_len);
+  //
+  // Compress
+  //
+  const uint32 raw_len = block_data - map;
+  uint32 comp = Compressor;
+  uint32 comp_len = 0;
+
+  if(comp == SRW_COMP_QUICKLZ)
+  {
+   ReserveBuf(&CompBuf, &CompBufSize, (uint64)raw_len + 400);
+   comp_len = qlz_compress(RawBuf.get(), (char*)CompBuf.get(), raw_len, qlz_scratch.compress);
+  }
+#ifdef HAVE_EXTERNAL_LIBZSTD
+  else if(comp == SRW_COMP_ZSTD)
+  {
+   ReserveBuf(&CompBuf, &CompBufSize, ZSTD_compressBound(raw_len));
+
+   size_t zr = ZSTD_compressCCtx(ZCCtx, CompBuf.get(), CompBufSize, RawBuf.get(), raw_len, 1);
+
+   if(ZSTD_isError(zr))
+    throw MDFN_Error(0, _("Zstandard compression error in state rewinding: %s"), ZSTD_getErrorName(zr));
+
+   comp_len = zr;
+  }
+#endif
+
+  if(comp == SRW_COMP_NONE || comp_len >= raw_len)
+  {
+   comp = SRW_COMP_NONE;
+   comp_len = raw_len;
+  }
+  //
+  // Store
+  //
+  RecordHeader* rec = AllocRecord((sizeof(RecordHeader) + comp_len + 15) &~ 15);
+
+  rec->state_len = prev_len;
+  rec->num_blocks = num_blocks;
+  rec->raw_len = raw_len;
+  rec->comp_len = comp_len;
+  rec->comp = comp;
+  memcpy(rec + 1, (comp == SRW_COMP_NONE) ? RawBuf.get() : CompBuf.get(), comp_len);
  }
 
  //
  // Make current state previous for next time.
  //
- ss_prev = std::move(ss_cur);
+ std::swap(ss_prev, ss_cur);
+ HavePrev = true;
 }
 
 bool MDFNSRW_Frame(bool rewind) noexcept
@@ -201,11 +512,19 @@ bool MDFNSRW_Frame(bool rewind) noexcept
  {
   if(rewind)
   {
+   IntervalCounter = 0;
    return DoRewind();
   }
   else
   {
-   DoRecord();
+   //
+   // Only record every "srwinterval" frames to spread out the cost; each rewind step then goes back that many frames.
+   //
+   if(++IntervalCounter >= Interval)
+   {
+    IntervalCounter = 0;
+    DoRecord();
+   }
    return false;
   }
  }
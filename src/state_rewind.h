@@ -24,6 +24,14 @@
 
 namespace Mednafen
 {
+// Values of the "srwcompressor" setting.
+enum : unsigned
+{
+ SRW_COMP_NONE = 0,
+ SRW_COMP_QUICKLZ,
+ SRW_COMP_ZSTD
+};
+
 bool MDFNSRW_IsRunning(void) noexcept;
 void MDFNSRW_Begin(void) noexcept;
 void MDFNSRW_End(void) noexcept;
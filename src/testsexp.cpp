@@ -29,9 +29,11 @@
 #include <mednafen/compress/GZFileStream.h>
 #include <mednafen/compress/ZLInflateFilter.h>
 #include <mednafen/MThreading.h>
+#include <mednafen/EventQueue.h>
 #include <mednafen/sound/SwiftResampler.h>
 #include <mednafen/sound/OwlResampler.h>
 #include <mednafen/sound/WAVRecord.h>
+#include <mednafen/cputest/cputest.h>
 
 #ifdef WIN32
  #include <mednafen/win32-common.h>
@@ -39,6 +41,20 @@
 
 #include "testsexp.h"
 
+#ifdef WANT_PSX_EMU
+namespace MDFN_IEN_PSX
+{
+ unsigned GPU_TestSpanSIMD(void);
+}
+#endif
+
+#ifdef WANT_SS_EMU
+namespace MDFN_IEN_SS
+{
+ unsigned SOUND_TestDSPSkipNOPs(void);
+}
+#endif
+
 #include <atomic>
 
 #undef NDEBUG
@@ -175,6 +191,277 @@ void MDFNI_RunOwlResamplerTest(void)
  }
 }
 
+//
+// Resampling throughput of each OwlResampler MAC kernel the CPU supports, at each quality level.  Output is compared against the
+// first kernel run(SSE on x86, which pads the filter to the same length as the AVX/FMA/AVX-512 kernels; the plain C kernel pads
+// it less, so a small difference there is expected).
+//
+void MDFNI_RunOwlResamplerBenchmark(void)
+{
+ static const uint32 kernel_flags[] =
+ {
+  CPUTEST_FLAG_SSE,
+  0,
+  CPUTEST_FLAG_SSE | CPUTEST_FLAG_AVX,
+  CPUTEST_FLAG_SSE | CPUTEST_FLAG_AVX | CPUTEST_FLAG_AVX2 | CPUTEST_FLAG_FMA3,
+  CPUTEST_FLAG_SSE | CPUTEST_FLAG_AVX | CPUTEST_FLAG_AVX2 | CPUTEST_FLAG_FMA3 | CPUTEST_FLAG_AVX512,
+ };
+ const uint32 cpuext = cputest_get_flags();
+ const bool resamp_avx512 = MDFN_GetSettingB("resamp_avx512");
+ const double irate = 1789772.72727272;
+ const int32 orate = 48000;
+ const double rate_error = 0.00004;
+ const int32 inlen = 16384;
+ const int32 total_inlen = inlen * 256;
+ std::unique_ptr<int16[]> ref_obuf(new int16[total_inlen]);
+ std::unique_ptr<int16[]> obuf(new int16[total_inlen]);
+
+ for(int quality = 0; quality <= 5; quality++)
+ {
+  int32 ref_count = -1;
+
+  for(const uint32 flags : kernel_flags)
+  {
+   if((cpuext & flags) != flags)
+    continue;
+
+   cputest_force_flags(flags);
+   MDFNI_SetSettingB("resamp_avx512", (bool)(flags & CPUTEST_FLAG_AVX512));
+   std::unique_ptr<OwlResampler> res(new OwlResampler(irate, orate, rate_error, 0, quality));
+   std::unique_ptr<OwlBuffer> ibuf(new OwlBuffer());
+   double phase = 0;
+   double phase_inc = 0.000;
+   double phase_inc_inc = 0.000000001;
+   int32 count = 0;
+   uint64 us = 0;
+
+   for(int32 base_i = 0; base_i < total_inlen; base_i += inlen)
+   {
+    for(int32 i = 0; i < inlen; i++)
+    {
+     ibuf->BufPudding()[i].f = 256 * 32767 * 0.95 * sin(phase);
+     phase += phase_inc;
+     phase_inc += phase_inc_inc;
+    }
+    const uint64 begin_us = Time::MonoUS();
+    const int32 outlen = res->Resample(ibuf.get(), inlen, &obuf[count * 2], total_inlen - count * 2);
+    us += Time::MonoUS() - begin_us;
+
+    for(int32 i = 0; i < outlen; i++)
+     obuf[count + i] = obuf[(count + i) * 2];
+
+    count += outlen;
+   }
+
+   int32 max_diff = 0;
+
+   if(ref_count < 0)
+   {
+    memcpy(&ref_obuf[0], &obuf[0], count * sizeof(int16));
+    ref_count = count;
+   }
+   else
+   {
+    for(int32 i = 0; i < std::min<int32>(count, ref_count); i++)
+     max_diff = std::max<int32>(max_diff, abs(obuf[i] - ref_obuf[i]));
+   }
+
+   printf("Quality %d, %-20s: %7.2f Msamples/s in, %6.3f Msamples/s out, max difference: %d\n", quality, res->GetSIMDType(), (double)total_inlen / us, (double)count / us, max_diff);
+  }
+ }
+
+ cputest_force_flags(cpuext);
+ MDFNI_SetSettingB("resamp_avx512", resamp_avx512);
+}
+
+//
+// Sorted doubly-linked event list, as formerly used by the PSX and SS event systems; reference for MDFNI_RunEventQueueBenchmark().
+//
+template<unsigned count>
+struct EventListRef
+{
+ struct Entry
+ {
+  int32 event_time;
+  Entry* prev;
+  Entry* next;
+ };
+
+ Entry events[count + 2];
+
+ void Reset(const int32 t)
+ {
+  for(unsigned i = 0; i < count + 2; i++)
+  {
+   events[i].event_time = (i == 0) ? INT32_MIN : ((i == count + 1) ? INT32_MAX : t);
+   events[i].prev = i ? &events[i - 1] : nullptr;
+   events[i].next = (i < count + 1) ? &events[i + 1] : nullptr;
+  }
+ }
+
+ INLINE unsigned Top(void) const { return events[0].next - &events[1]; }
+ INLINE int32 TopTime(void) const { return events[0].next->event_time; }
+
+ INLINE void Set(const unsigned which, const int32 next_timestamp)
+ {
+  Entry* e = &events[1 + which];
+
+  if(next_timestamp < e->event_time)
+  {
+   Entry* fe = e;
+
+   do
+   {
+    fe = fe->prev;
+   } while(next_timestamp < fe->event_time);
+
+   e->prev->next = e->next;
+   e->next->prev = e->prev;
+
+   e->prev = fe;
+   e->next = fe->next;
+   fe->next->prev = e;
+   fe->next = e;
+
+   e->event_time = next_timestamp;
+  }
+  else if(next_timestamp > e->event_time)
+  {
+   Entry* fe = e;
+
+   do
+   {
+    fe = fe->next;
+   } while(next_timestamp > fe->event_time);
+
+   e->prev->next = e->next;
+   e->next->prev = e->prev;
+
+   e->prev = fe->prev;
+   e->next = fe;
+   fe->prev->next = e;
+   fe->prev = e;
+
+   e->event_time = next_timestamp;
+  }
+ }
+
+ void Rebase(const int32 delta, const int32 fixed_t)
+ {
+  for(unsigned i = 1; i <= count; i++)
+  {
+   if(events[i].event_time != fixed_t)
+    events[i].event_time -= delta;
+  }
+ }
+};
+
+//
+// Fires events and reschedules them, mostly a short time ahead with many ties, sometimes far ahead or disabled,
+// and sometimes reschedules a random event as register writes do; returns a hash of the firing order.
+//
+template<typename Q>
+static NO_INLINE uint64 EventQueueChurn(Q* q, const unsigned count, const unsigned iterations)
+{
+ const int32 disabled_ts = 0x7FFFFFFF;
+ uint64 lcg_save = lcg;
+ uint64 hash = 0;
+ int32 now = 0;
+
+ TestRandInit();
+ q->Reset(0);
+
+ for(unsigned i = 0; i < iterations; i++)
+ {
+  const uint32 r = TestRand();
+
+  if(r & 0x3)
+  {
+   const unsigned which = q->Top();
+   const int32 t = q->TopTime();
+
+   if(t != disabled_ts)
+    now = t;
+
+   hash = (hash * 31) + which;
+
+   if((r >> 2) & 0xF)
+    q->Set(which, now + 1 + ((r >> 8) & 0x3F));
+   else if((r >> 6) & 0x3)
+    q->Set(which, now + 1 + ((r >> 8) & 0xFFFF));
+   else
+    q->Set(which, disabled_ts);
+  }
+  else
+   q->Set((r >> 8) % count, (r & 0x80000000) ? disabled_ts : now + 1 + ((r >> 2) & 0x7));
+
+  if(now >= 0x10000000)
+  {
+   q->Rebase(now, disabled_ts);
+   now = 0;
+  }
+ }
+
+ lcg = lcg_save;
+
+ return hash;
+}
+
+template<unsigned count>
+static void EventQueueBench(const unsigned iterations)
+{
+ std::unique_ptr<EventListRef<count>> list(new EventListRef<count>());
+ std::unique_ptr<EventQueue<count>> heap(new EventQueue<count>());
+ uint64 us[2];
+ uint64 hash[2];
+
+ us[0] = Time::MonoUS();
+ hash[0] = EventQueueChurn(list.get(), count, iterations);
+ us[0] = Time::MonoUS() - us[0];
+
+ us[1] = Time::MonoUS();
+ hash[1] = EventQueueChurn(heap.get(), count, iterations);
+ us[1] = Time::MonoUS() - us[1];
+
+ printf("%2u events: linked list %.2fns/op, EventQueue %.2fns/op\n", count, us[0] * 1000.0 / iterations, us[1] * 1000.0 / iterations);
+ assert(hash[0] == hash[1]);
+}
+
+void MDFNI_RunEventQueueBenchmark(void)
+{
+ static const unsigned iterations = 20000000;
+
+ EventQueueBench<5>(iterations);
+ EventQueueBench<11>(iterations);
+ EventQueueBench<32>(iterations);
+}
+
+//
+// PS1 GPU SIMD polygon span drawing vs. the per-pixel path.
+//
+void MDFNI_RunPSXSpanTest(void)
+{
+#ifdef WANT_PSX_EMU
+ const unsigned failed = MDFN_IEN_PSX::GPU_TestSpanSIMD();
+
+ printf("PS1 GPU span test: %u drawing mode(s) mismatched\n", failed);
+ assert(!failed);
+#endif
+}
+
+//
+// Saturn SCSP DSP with redundant NOP steps skipped vs. all 128 steps run.
+//
+void MDFNI_RunSSDSPTest(void)
+{
+#ifdef WANT_SS_EMU
+ const unsigned failed = MDFN_IEN_SS::SOUND_TestDSPSkipNOPs();
+
+ printf("Saturn SCSP DSP test: %u seed(s) mismatched\n", failed);
+ assert(!failed);
+#endif
+}
+
 #if 0
 static void TestMTStreamReader(void)
 {
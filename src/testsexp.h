@@ -6,6 +6,10 @@ namespace Mednafen
  void MDFNI_RunExpensiveTests(const char* dirpath) MDFN_COLD;
  void MDFNI_RunSwiftResamplerTest(void) MDFN_COLD;
  void MDFNI_RunOwlResamplerTest(void) MDFN_COLD;
+ void MDFNI_RunOwlResamplerBenchmark(void) MDFN_COLD;
+ void MDFNI_RunEventQueueBenchmark(void) MDFN_COLD;
+ void MDFNI_RunPSXSpanTest(void) MDFN_COLD;
+ void MDFNI_RunSSDSPTest(void) MDFN_COLD;
  //
  void MDFN_RunExceptionTests(const unsigned thread_count, const unsigned thread_delay); // Called from tests.cpp
 }
@@ -1085,4 +1085,5 @@ MDFN_HIDE extern const MDFNGI EmulatedVB =
  256,	// Framebuffer height
 
  2,     // Number of output sound channels
+ true,  // Honors EmulateSpecStruct::skip
 };
@@ -714,5 +714,6 @@ MDFN_HIDE extern const MDFNGI EmulatedWSwan =
  144,	// Framebuffer height
 
  2,     // Number of output sound channels
+ true,  // Honors EmulateSpecStruct::skip
 };
 